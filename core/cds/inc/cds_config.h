@@ -64,6 +64,13 @@ enum cfg_sub_20_channel_width {
  * @tx_flow_stop_queue_th: Threshold to stop queue in percentage
  * @tx_flow_start_queue_offset: Start queue offset in percentage
  * @enable_dp_rx_threads: enable dp rx threads
+ * @dp_rx_thread_budget: max packets a dp rx thread delivers per wakeup
+ * @dp_rx_gro_flush_pkt_budget: packets a dp rx thread delivers between GRO
+ *				flushes
+ * @dp_rx_gro_flush_time_budget_us: max time a dp rx thread holds packets in
+ *				    GRO
+ * @dp_rx_gro_low_latency: flush GRO after every dp rx thread delivery
+ * @dp_rx_refill_predictive: enable predictive replenish in rx refill thread
  * @is_lpass_enabled: Indicate whether LPASS is enabled or not
  * @tx_chain_mask_cck: Tx chain mask enabled or not
  * @sub_20_channel_width: Sub 20 MHz ch width, ini intersected with fw cap
@@ -91,6 +98,11 @@ struct cds_config_info {
 	uint32_t tx_flow_start_queue_offset;
 #endif
 	uint8_t enable_dp_rx_threads;
+	uint32_t dp_rx_thread_budget;
+	uint32_t dp_rx_gro_flush_pkt_budget;
+	uint32_t dp_rx_gro_flush_time_budget_us;
+	bool dp_rx_gro_low_latency;
+	bool dp_rx_refill_predictive;
 #ifdef WLAN_FEATURE_LPSS
 	bool is_lpass_enabled;
 #endif
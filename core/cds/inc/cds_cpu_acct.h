@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2021 The Linux Foundation. All rights reserved.
+ *
+ * Permission to use, copy, modify, and/or distribute this software for
+ * any purpose with or without fee is hereby granted, provided that the
+ * above copyright notice and this permission notice appear in all
+ * copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+ * WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+ * AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+ * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR
+ * PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+ * TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/**
+ * DOC: cds_cpu_acct.h
+ *
+ * CPU usage accounting of the rx contexts.
+ *
+ * An rx context (a NAPI instance or an rx thread) brackets each run, a
+ * NAPI poll or a thread wakeup, with cds_cpu_acct_start() and
+ * cds_cpu_acct_end(). The time spent, the packets handled and whether the
+ * run ended with its budget exhausted are accumulated per CPU the run
+ * ended on, to back the tuning of the rx CPU affinity masks.
+ *
+ * A context must not run on two CPUs at once, which holds for a NAPI
+ * instance and for a thread, so the counters need no locking.
+ */
+
+#ifndef __CDS_CPU_ACCT_H
+#define __CDS_CPU_ACCT_H
+
+#include <qdf_types.h>
+#include <qdf_time.h>
+#include <qdf_util.h>
+
+/*
+ * CPUs accounted separately, as many as the rx affinity masks cover. Runs
+ * on higher CPUs are accounted in the last entry.
+ */
+#define CDS_CPU_ACCT_MAX_CPUS 8
+
+#ifdef WLAN_RX_CPU_ACCT
+/**
+ * struct cds_cpu_acct_entry - rx context usage of one CPU
+ * @runs: number of polls or thread wakeups
+ * @pkts: packets handled
+ * @budget_exhausted: runs which ended with the budget consumed
+ * @time_ns: total time spent
+ * @max_time_ns: longest run
+ */
+struct cds_cpu_acct_entry {
+	uint64_t runs;
+	uint64_t pkts;
+	uint64_t budget_exhausted;
+	uint64_t time_ns;
+	uint64_t max_time_ns;
+};
+
+/**
+ * struct cds_cpu_acct - CPU usage of an rx context
+ * @cpu: usage per CPU
+ */
+struct cds_cpu_acct {
+	struct cds_cpu_acct_entry cpu[CDS_CPU_ACCT_MAX_CPUS];
+};
+
+/**
+ * cds_cpu_acct_start() - start accounting a run
+ *
+ * Return: start time to pass to cds_cpu_acct_end()
+ */
+static inline uint64_t cds_cpu_acct_start(void)
+{
+	return qdf_get_monotonic_boottime_ns();
+}
+
+/**
+ * cds_cpu_acct_end() - account a run
+ * @acct: usage of the rx context
+ * @start_ns: return value of cds_cpu_acct_start()
+ * @pkts: packets handled in the run
+ * @budget_exhausted: the run stopped with work left
+ *
+ * Return: None
+ */
+static inline void cds_cpu_acct_end(struct cds_cpu_acct *acct,
+				    uint64_t start_ns, uint32_t pkts,
+				    bool budget_exhausted)
+{
+	struct cds_cpu_acct_entry *entry;
+	uint64_t time_ns = qdf_get_monotonic_boottime_ns() - start_ns;
+	int cpu = qdf_get_cpu();
+
+	entry = &acct->cpu[qdf_min(cpu, CDS_CPU_ACCT_MAX_CPUS - 1)];
+	entry->runs++;
+	entry->pkts += pkts;
+	if (budget_exhausted)
+		entry->budget_exhausted++;
+	entry->time_ns += time_ns;
+	if (time_ns > entry->max_time_ns)
+		entry->max_time_ns = time_ns;
+}
+
+/**
+ * cds_cpu_acct_scnprintf() - format the usage of a CPU
+ * @acct: usage of the rx context
+ * @cpu: CPU, below CDS_CPU_ACCT_MAX_CPUS
+ * @buf: buffer to fill
+ * @len: size of @buf
+ *
+ * Lists the runs, packets, packets per run, budget exhaustions and their
+ * rate, the total and longest run time and the time per packet.
+ *
+ * Return: number of characters written, 0 if the context never ran on @cpu
+ */
+int cds_cpu_acct_scnprintf(struct cds_cpu_acct *acct, int cpu,
+			   char *buf, size_t len);
+#else
+struct cds_cpu_acct {
+};
+
+static inline uint64_t cds_cpu_acct_start(void)
+{
+	return 0;
+}
+
+static inline void cds_cpu_acct_end(struct cds_cpu_acct *acct,
+				    uint64_t start_ns, uint32_t pkts,
+				    bool budget_exhausted)
+{
+}
+
+static inline int cds_cpu_acct_scnprintf(struct cds_cpu_acct *acct, int cpu,
+					 char *buf, size_t len)
+{
+	return 0;
+}
+#endif /* WLAN_RX_CPU_ACCT */
+
+#endif /* __CDS_CPU_ACCT_H */
@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2021 The Linux Foundation. All rights reserved.
+ *
+ * Permission to use, copy, modify, and/or distribute this software for
+ * any purpose with or without fee is hereby granted, provided that the
+ * above copyright notice and this permission notice appear in all
+ * copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+ * WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+ * AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+ * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR
+ * PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+ * TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/**
+ * DOC: cds_lock_prof.h
+ *
+ * Lock contention profiler.
+ *
+ * Hot spinlocks are taken through the cds_lock_prof_spin_lock_bh() and
+ * cds_lock_prof_spin_unlock_bh() wrappers, naming the lock site. While
+ * profiling is on, the wrappers record per site and per CPU the number of
+ * acquisitions and contended acquisitions, and the wait and hold times.
+ * While it is off, which is the default, the wrappers cost a patched out
+ * branch on top of the plain lock operation.
+ *
+ * The hold time is measured per lock instance, so locks of the same site
+ * nesting on one CPU are each timed from their own acquisition.
+ */
+
+#ifndef __CDS_LOCK_PROF_H
+#define __CDS_LOCK_PROF_H
+
+#include <linux/version.h>
+#include <linux/jump_label.h>
+#include <qdf_types.h>
+#include <qdf_lock.h>
+
+/**
+ * enum cds_lock_site - profiled lock site
+ * @CDS_LOCK_SITE_HTT_RX_HASH: htt rx hash list, rx_hash_lock
+ * @CDS_LOCK_SITE_OL_TX_FLOW_POOL: ol tx flow pools, flow_pool_lock
+ * @CDS_LOCK_SITE_OL_TX_QUEUE: ol HL tx queues, tx_queue_spinlock
+ * @CDS_LOCK_SITE_HDD_STA_OBJ: hdd station info list, sta_obj_lock
+ * @CDS_LOCK_SITE_DP_FISA_FT: FISA SW flow table, dp_rx_sw_ft_lock
+ * @CDS_LOCK_SITE_MAX: number of lock sites
+ */
+enum cds_lock_site {
+	CDS_LOCK_SITE_HTT_RX_HASH,
+	CDS_LOCK_SITE_OL_TX_FLOW_POOL,
+	CDS_LOCK_SITE_OL_TX_QUEUE,
+	CDS_LOCK_SITE_HDD_STA_OBJ,
+	CDS_LOCK_SITE_DP_FISA_FT,
+	CDS_LOCK_SITE_MAX,
+};
+
+#ifdef WLAN_LOCK_PROF
+#if (LINUX_VERSION_CODE >= KERNEL_VERSION(4, 3, 0))
+DECLARE_STATIC_KEY_FALSE(cds_lock_prof_key);
+
+/**
+ * cds_lock_prof_enabled() - check if lock profiling is on
+ *
+ * Return: true if the lock wrappers need to record
+ */
+static inline bool cds_lock_prof_enabled(void)
+{
+	return static_branch_unlikely(&cds_lock_prof_key);
+}
+#else
+extern bool cds_lock_prof_on;
+
+static inline bool cds_lock_prof_enabled(void)
+{
+	return READ_ONCE(cds_lock_prof_on);
+}
+#endif
+
+/**
+ * __cds_lock_prof_spin_lock_bh() - take a spinlock and record the wait
+ * @lock: lock to take
+ * @site: lock site of @lock
+ *
+ * Return: None
+ */
+void __cds_lock_prof_spin_lock_bh(qdf_spinlock_t *lock,
+				  enum cds_lock_site site);
+
+/**
+ * __cds_lock_prof_spin_unlock_bh() - release a spinlock and record the hold
+ * @lock: lock to release
+ * @site: lock site of @lock
+ *
+ * Return: None
+ */
+void __cds_lock_prof_spin_unlock_bh(qdf_spinlock_t *lock,
+				    enum cds_lock_site site);
+
+/**
+ * cds_lock_prof_spin_lock_bh() - qdf_spin_lock_bh() of a profiled site
+ * @lock: lock to take
+ * @site: lock site of @lock
+ *
+ * Return: None
+ */
+static inline void cds_lock_prof_spin_lock_bh(qdf_spinlock_t *lock,
+					      enum cds_lock_site site)
+{
+	if (cds_lock_prof_enabled())
+		__cds_lock_prof_spin_lock_bh(lock, site);
+	else
+		qdf_spin_lock_bh(lock);
+}
+
+/**
+ * cds_lock_prof_spin_unlock_bh() - qdf_spin_unlock_bh() of a profiled site
+ * @lock: lock to release
+ * @site: lock site of @lock
+ *
+ * Return: None
+ */
+static inline void cds_lock_prof_spin_unlock_bh(qdf_spinlock_t *lock,
+						enum cds_lock_site site)
+{
+	if (cds_lock_prof_enabled())
+		__cds_lock_prof_spin_unlock_bh(lock, site);
+	else
+		qdf_spin_unlock_bh(lock);
+}
+
+/**
+ * cds_lock_prof_debugfs_init() - create the lock profiler debugfs file
+ *
+ * Creates <debugfs>/<qdf root>/lock_prof/sites. Writing 1 clears the
+ * stats and starts profiling, writing 0 stops it; reading lists the sites
+ * ranked by total wait time.
+ *
+ * Return: None
+ */
+void cds_lock_prof_debugfs_init(void);
+
+/**
+ * cds_lock_prof_debugfs_deinit() - stop profiling and remove the debugfs file
+ *
+ * Return: None
+ */
+void cds_lock_prof_debugfs_deinit(void);
+#else
+static inline void cds_lock_prof_spin_lock_bh(qdf_spinlock_t *lock,
+					      enum cds_lock_site site)
+{
+	qdf_spin_lock_bh(lock);
+}
+
+static inline void cds_lock_prof_spin_unlock_bh(qdf_spinlock_t *lock,
+						enum cds_lock_site site)
+{
+	qdf_spin_unlock_bh(lock);
+}
+
+static inline void cds_lock_prof_debugfs_init(void)
+{
+}
+
+static inline void cds_lock_prof_debugfs_deinit(void)
+{
+}
+#endif /* WLAN_LOCK_PROF */
+
+#endif /* __CDS_LOCK_PROF_H */
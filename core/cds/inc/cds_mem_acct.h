@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2021 The Linux Foundation. All rights reserved.
+ *
+ * Permission to use, copy, modify, and/or distribute this software for
+ * any purpose with or without fee is hereby granted, provided that the
+ * above copyright notice and this permission notice appear in all
+ * copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+ * WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+ * AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+ * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR
+ * PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+ * TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/**
+ * DOC: cds_mem_acct.h
+ *
+ * Per subsystem memory accounting.
+ *
+ * Subsystems report the memory they allocate and free under a tag, which
+ * keeps the current and peak usage and the number of allocations of each
+ * tag. Allocation failures can be injected per tag, every Nth allocation
+ * of the tag failing, to exercise the error paths under memory pressure.
+ */
+
+#ifndef __CDS_MEM_ACCT_H
+#define __CDS_MEM_ACCT_H
+
+#include <qdf_types.h>
+#include <qdf_mem.h>
+
+/**
+ * enum cds_mem_tag - accounted subsystem
+ * @CDS_MEM_TAG_DP_TX_DESC: ol tx descriptor pool
+ * @CDS_MEM_TAG_DP_RX_BUF: rx buffers posted to the ol rx ring
+ * @CDS_MEM_TAG_SCAN_CACHE: scan cache
+ * @CDS_MEM_TAG_PE_SESSION: PE session tables and templates
+ * @CDS_MEM_TAG_WMI_BUF: WMI command buffers
+ * @CDS_MEM_TAG_PKTLOG: packet log buffers
+ * @CDS_MEM_TAG_FISA: FISA flow search table
+ * @CDS_MEM_TAG_MAX: number of tags
+ */
+enum cds_mem_tag {
+	CDS_MEM_TAG_DP_TX_DESC,
+	CDS_MEM_TAG_DP_RX_BUF,
+	CDS_MEM_TAG_SCAN_CACHE,
+	CDS_MEM_TAG_PE_SESSION,
+	CDS_MEM_TAG_WMI_BUF,
+	CDS_MEM_TAG_PKTLOG,
+	CDS_MEM_TAG_FISA,
+	CDS_MEM_TAG_MAX,
+};
+
+/**
+ * struct cds_mem_acct_snapshot - accounting of one tag
+ * @cur: bytes currently allocated
+ * @peak: highest value of @cur since load or the last peak reset
+ * @allocs: number of allocations
+ * @alloc_rate: allocations per second since the previous snapshot
+ * @fail_interval: every Nth allocation fails, 0 if injection is off
+ * @injected: number of injected allocation failures
+ */
+struct cds_mem_acct_snapshot {
+	uint64_t cur;
+	uint64_t peak;
+	uint64_t allocs;
+	uint32_t alloc_rate;
+	uint32_t fail_interval;
+	uint64_t injected;
+};
+
+#ifdef WLAN_MEM_ACCT
+/* bitmap of the tags with failure injection on */
+extern uint32_t cds_mem_acct_fail_tags;
+
+/**
+ * cds_mem_acct_alloc() - account an allocation
+ * @tag: subsystem the memory belongs to
+ * @size: allocated bytes
+ * @count: number of allocations @size is made of
+ *
+ * Return: None
+ */
+void cds_mem_acct_alloc(enum cds_mem_tag tag, size_t size, uint32_t count);
+
+/**
+ * cds_mem_acct_free() - account a release
+ * @tag: subsystem the memory belongs to
+ * @size: released bytes
+ *
+ * Return: None
+ */
+void cds_mem_acct_free(enum cds_mem_tag tag, size_t size);
+
+/**
+ * __cds_mem_acct_inject_fail() - count an allocation towards injection
+ * @tag: subsystem about to allocate
+ *
+ * Return: true if the allocation has to fail
+ */
+bool __cds_mem_acct_inject_fail(enum cds_mem_tag tag);
+
+/**
+ * cds_mem_acct_inject_fail() - check if an allocation has to fail
+ * @tag: subsystem about to allocate
+ *
+ * To be called before each allocation of @tag which has an error path.
+ *
+ * Return: true if the allocation has to fail
+ */
+static inline bool cds_mem_acct_inject_fail(enum cds_mem_tag tag)
+{
+	if (qdf_likely(!(READ_ONCE(cds_mem_acct_fail_tags) & BIT(tag))))
+		return false;
+
+	return __cds_mem_acct_inject_fail(tag);
+}
+
+/**
+ * cds_mem_acct_set_fail_interval() - configure failure injection of a tag
+ * @tag: subsystem to inject failures into
+ * @interval: fail every @interval-th allocation, 0 to stop injecting
+ *
+ * Return: None
+ */
+void cds_mem_acct_set_fail_interval(enum cds_mem_tag tag, uint32_t interval);
+
+/**
+ * cds_mem_acct_reset_peak() - restart peak tracking of a tag
+ * @tag: subsystem to reset
+ *
+ * Return: None
+ */
+void cds_mem_acct_reset_peak(enum cds_mem_tag tag);
+
+/**
+ * cds_mem_acct_get() - read the accounting of a tag
+ * @tag: subsystem to read
+ * @snap: filled with the accounting of @tag
+ *
+ * The allocation rate is computed over the time since the previous call
+ * for @tag.
+ *
+ * Return: None
+ */
+void cds_mem_acct_get(enum cds_mem_tag tag,
+		      struct cds_mem_acct_snapshot *snap);
+
+/**
+ * cds_mem_acct_tag_name() - printable name of a tag
+ * @tag: subsystem
+ *
+ * Return: tag name
+ */
+const char *cds_mem_acct_tag_name(enum cds_mem_tag tag);
+#else
+static inline
+void cds_mem_acct_alloc(enum cds_mem_tag tag, size_t size, uint32_t count)
+{
+}
+
+static inline void cds_mem_acct_free(enum cds_mem_tag tag, size_t size)
+{
+}
+
+static inline bool cds_mem_acct_inject_fail(enum cds_mem_tag tag)
+{
+	return false;
+}
+
+static inline
+void cds_mem_acct_set_fail_interval(enum cds_mem_tag tag, uint32_t interval)
+{
+}
+
+static inline void cds_mem_acct_reset_peak(enum cds_mem_tag tag)
+{
+}
+
+static inline void cds_mem_acct_get(enum cds_mem_tag tag,
+				    struct cds_mem_acct_snapshot *snap)
+{
+	qdf_mem_zero(snap, sizeof(*snap));
+}
+
+static inline const char *cds_mem_acct_tag_name(enum cds_mem_tag tag)
+{
+	return "UNKNOWN";
+}
+#endif /* WLAN_MEM_ACCT */
+
+#endif /* __CDS_MEM_ACCT_H */
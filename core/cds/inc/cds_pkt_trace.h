@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2021 The Linux Foundation. All rights reserved.
+ *
+ * Permission to use, copy, modify, and/or distribute this software for
+ * any purpose with or without fee is hereby granted, provided that the
+ * above copyright notice and this permission notice appear in all
+ * copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+ * WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+ * AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+ * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR
+ * PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+ * TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/**
+ * DOC: cds_pkt_trace.h
+ *
+ * Per packet trace hooks of the data path.
+ *
+ * All per packet trace hooks (DP trace, packet dump, host diag events, per
+ * CPU trace ring) sit behind a single static key which is only enabled
+ * while at least one trace user is active, so a disabled hook costs a
+ * patched out branch.
+ * The per CPU trace ring is written without locks and merged by timestamp
+ * when read.
+ */
+
+#ifndef __CDS_PKT_TRACE_H
+#define __CDS_PKT_TRACE_H
+
+#include <linux/version.h>
+#include <linux/jump_label.h>
+#include <qdf_types.h>
+#include <qdf_nbuf.h>
+
+/* Legacy DP trace, including the protocol event logging */
+#define CDS_PKT_TRACE_USER_DP_TRACE	BIT(0)
+/* Packet dump callbacks of the packet fate logging */
+#define CDS_PKT_TRACE_USER_PKT_DUMP	BIT(1)
+/* Host diag packet events, active while multicast logging is enabled */
+#define CDS_PKT_TRACE_USER_DIAG		BIT(2)
+/* Per CPU packet trace ring */
+#define CDS_PKT_TRACE_USER_RING		BIT(3)
+
+/* Records per CPU, must be a power of 2 */
+#define CDS_PKT_TRACE_RING_SIZE		512
+
+/**
+ * enum cds_pkt_trace_event - trace point of a packet trace record
+ * @CDS_PKT_TRACE_EVENT_OL_TX: frame handed to the target, fast path
+ * @CDS_PKT_TRACE_EVENT_OL_RX: frame received from the target
+ * @CDS_PKT_TRACE_EVENT_MAX: number of trace points
+ */
+enum cds_pkt_trace_event {
+	CDS_PKT_TRACE_EVENT_OL_TX,
+	CDS_PKT_TRACE_EVENT_OL_RX,
+	CDS_PKT_TRACE_EVENT_MAX,
+};
+
+/**
+ * struct cds_pkt_trace_rec - packet trace record
+ * @ts_ns: monotonic boottime of the event, in nsec
+ * @seq: position of the record in its ring, 0 while being written
+ * @len: frame length
+ * @msdu_id: tx descriptor id, 0 if not applicable
+ * @event: enum cds_pkt_trace_event
+ * @vdev_id: vdev of the frame
+ * @status: trace point specific status, e.g. rx packet fate
+ * @cpu: CPU the record was written on, filled by cds_pkt_trace_read()
+ */
+struct cds_pkt_trace_rec {
+	uint64_t ts_ns;
+	uint32_t seq;
+	uint16_t len;
+	uint16_t msdu_id;
+	uint8_t event;
+	uint8_t vdev_id;
+	uint8_t status;
+	uint8_t cpu;
+};
+
+/* bitmap of CDS_PKT_TRACE_USER_*, only updated by cds_pkt_trace_user_set */
+extern uint32_t cds_pkt_trace_users;
+
+#if (LINUX_VERSION_CODE >= KERNEL_VERSION(4, 3, 0))
+DECLARE_STATIC_KEY_FALSE(cds_pkt_trace_key);
+
+/**
+ * cds_pkt_trace_enabled() - check if any per packet trace user is active
+ *
+ * Return: true if the per packet trace hooks need to run
+ */
+static inline bool cds_pkt_trace_enabled(void)
+{
+	return static_branch_unlikely(&cds_pkt_trace_key);
+}
+#else
+static inline bool cds_pkt_trace_enabled(void)
+{
+	return READ_ONCE(cds_pkt_trace_users);
+}
+#endif
+
+/**
+ * cds_pkt_trace_user_enabled() - check if a packet trace user is active
+ * @user: one of CDS_PKT_TRACE_USER_*
+ *
+ * Only meaningful behind cds_pkt_trace_enabled().
+ *
+ * Return: true if @user is active
+ */
+static inline bool cds_pkt_trace_user_enabled(uint32_t user)
+{
+	return READ_ONCE(cds_pkt_trace_users) & user;
+}
+
+/**
+ * cds_pkt_trace_user_set() - activate or deactivate a packet trace user
+ * @user: one of CDS_PKT_TRACE_USER_*
+ * @enable: true to activate @user
+ *
+ * Flips the packet trace static key when the first user is activated or
+ * the last one is deactivated, and allocates the trace rings the first
+ * time CDS_PKT_TRACE_USER_RING is activated. Must be called from process
+ * context.
+ *
+ * Return: 0 on success, errno on failure
+ */
+int cds_pkt_trace_user_set(uint32_t user, bool enable);
+
+/**
+ * __cds_pkt_trace_record() - append a record to the local CPU trace ring
+ * @event: trace point, enum cds_pkt_trace_event
+ * @nbuf: traced frame
+ * @vdev_id: vdev of the frame
+ * @msdu_id: tx descriptor id, 0 if not applicable
+ * @status: trace point specific status
+ *
+ * Lockless: a slot is claimed with a per CPU increment, so writers from
+ * any context on the same CPU do not need to exclude each other.
+ *
+ * Return: None
+ */
+void __cds_pkt_trace_record(enum cds_pkt_trace_event event, qdf_nbuf_t nbuf,
+			    uint8_t vdev_id, uint16_t msdu_id, uint8_t status);
+
+/**
+ * cds_pkt_trace_record() - record a frame in the packet trace ring
+ * @event: trace point, enum cds_pkt_trace_event
+ * @nbuf: traced frame
+ * @vdev_id: vdev of the frame
+ * @msdu_id: tx descriptor id, 0 if not applicable
+ * @status: trace point specific status
+ *
+ * Return: None
+ */
+static inline void cds_pkt_trace_record(enum cds_pkt_trace_event event,
+					qdf_nbuf_t nbuf, uint8_t vdev_id,
+					uint16_t msdu_id, uint8_t status)
+{
+	if (cds_pkt_trace_enabled() &&
+	    cds_pkt_trace_user_enabled(CDS_PKT_TRACE_USER_RING))
+		__cds_pkt_trace_record(event, nbuf, vdev_id, msdu_id, status);
+}
+
+/**
+ * cds_pkt_trace_read() - read the most recent packet trace records
+ * @out: filled with the records, oldest first
+ * @max: capacity of @out
+ *
+ * Merges the per CPU rings by timestamp and returns the @max most recent
+ * records. Records overwritten while being read are skipped.
+ *
+ * Return: number of records written to @out
+ */
+uint32_t cds_pkt_trace_read(struct cds_pkt_trace_rec *out, uint32_t max);
+
+/**
+ * cds_pkt_trace_clear() - drop all records of the packet trace rings
+ *
+ * Return: None
+ */
+void cds_pkt_trace_clear(void);
+
+/**
+ * cds_pkt_trace_event_name() - printable name of a packet trace event
+ * @event: enum cds_pkt_trace_event
+ *
+ * Return: event name
+ */
+const char *cds_pkt_trace_event_name(uint8_t event);
+
+/**
+ * cds_pkt_trace_deinit() - deactivate all users and free the trace rings
+ *
+ * Return: None
+ */
+void cds_pkt_trace_deinit(void);
+
+#endif /* __CDS_PKT_TRACE_H */
@@ -38,6 +38,7 @@
 #endif
 #include <qdf_types.h>
 #include "qdf_lock.h"
+#include "cds_cpu_acct.h"
 #include "qdf_mc_timer.h"
 #include "cds_config.h"
 #include "qdf_cpuhp.h"
@@ -117,6 +118,12 @@ typedef struct _cds_sched_context {
 	/* Rx buffer queue */
 	struct list_head ol_rx_thread_queue;
 
+	/* Number of entries in ol_rx_thread_queue */
+	uint32_t ol_rx_thread_queue_len;
+
+	/* CPU usage of the OL rx thread */
+	struct cds_cpu_acct ol_rx_thread_acct;
+
 	/* Spinlock to synchronize between tasklet and thread */
 	spinlock_t ol_rx_queue_lock;
 
@@ -324,6 +331,20 @@ void cds_free_ol_rx_pkt(p_cds_sched_context pSchedContext,
    \sa cds_free_ol_rx_pkt_freeq()
    -------------------------------------------------------------------------*/
 void cds_free_ol_rx_pkt_freeq(p_cds_sched_context pSchedContext);
+
+/**
+ * cds_get_ol_rx_queue_len() - get the backlog of the OL rx thread
+ *
+ * Return: number of rx packet batches queued to the OL rx thread
+ */
+uint32_t cds_get_ol_rx_queue_len(void);
+
+/**
+ * cds_ol_rx_thread_dump_stats() - print the CPU usage of the OL rx thread
+ *
+ * Return: none
+ */
+void cds_ol_rx_thread_dump_stats(void);
 #else
 /**
  * cds_sched_handle_rx_thread_affinity_req - rx thread affinity req handler
@@ -431,6 +452,15 @@ void cds_free_ol_rx_pkt_freeq(p_cds_sched_context pSchedContext)
 {
 }
 
+static inline uint32_t cds_get_ol_rx_queue_len(void)
+{
+	return 0;
+}
+
+static inline void cds_ol_rx_thread_dump_stats(void)
+{
+}
+
 static inline int cds_sched_handle_throughput_req(
 	bool high_tput_required)
 {
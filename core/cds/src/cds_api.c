@@ -46,6 +46,8 @@
 #include "hif.h"
 #include "wlan_policy_mgr_api.h"
 #include "cds_utils.h"
+#include "cds_pkt_trace.h"
+#include "cds_lock_prof.h"
 #include "wlan_logging_sock_svc.h"
 #include "wma.h"
 #include "pktlog_ac.h"
@@ -255,6 +257,8 @@ QDF_STATUS cds_init(void)
 	qdf_register_drv_supported_callback(cds_is_drv_supported);
 	qdf_register_wmi_send_recv_qmi_callback(cds_wmi_send_recv_qmi);
 
+	cds_lock_prof_debugfs_init();
+
 	return QDF_STATUS_SUCCESS;
 
 deinit:
@@ -288,6 +292,8 @@ void cds_deinit(void)
 	/* currently, no ssr_protect_deinit */
 
 	cds_recovery_work_deinit();
+	cds_pkt_trace_deinit();
+	cds_lock_prof_debugfs_deinit();
 
 	gp_cds_context = NULL;
 	qdf_mem_zero(&g_cds_context, sizeof(g_cds_context));
@@ -948,6 +954,16 @@ QDF_STATUS cds_dp_open(struct wlan_objmgr_psoc *psoc)
 	dp_config.enable_rx_threads =
 		(cds_get_conparam() == QDF_GLOBAL_MONITOR_MODE) ?
 		false : gp_cds_context->cds_cfg->enable_dp_rx_threads;
+	dp_config.rx_thread_budget =
+		gp_cds_context->cds_cfg->dp_rx_thread_budget;
+	dp_config.rx_gro_flush_pkt_budget =
+		gp_cds_context->cds_cfg->dp_rx_gro_flush_pkt_budget;
+	dp_config.rx_gro_flush_time_budget_us =
+		gp_cds_context->cds_cfg->dp_rx_gro_flush_time_budget_us;
+	dp_config.rx_gro_low_latency =
+		gp_cds_context->cds_cfg->dp_rx_gro_low_latency;
+	dp_config.rx_refill_predictive =
+		gp_cds_context->cds_cfg->dp_rx_refill_predictive;
 
 	qdf_status = dp_txrx_init(cds_get_context(QDF_MODULE_ID_SOC),
 				  OL_TXRX_PDEV_ID,
@@ -2172,13 +2188,15 @@ enum wifi_driver_log_level cds_get_ring_log_level(uint32_t ring_id)
  *
  * Set the multicast logging value which will indicate
  * whether to multicast host and fw messages even
- * without any registration by userspace entity
+ * without any registration by userspace entity. The host diag packet
+ * events are only generated while multicast logging is enabled.
  *
  * Return: None
  */
 void cds_set_multicast_logging(uint8_t value)
 {
 	cds_multicast_logging = value;
+	cds_pkt_trace_user_set(CDS_PKT_TRACE_USER_DIAG, value);
 }
 
 /**
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2021 The Linux Foundation. All rights reserved.
+ *
+ * Permission to use, copy, modify, and/or distribute this software for
+ * any purpose with or without fee is hereby granted, provided that the
+ * above copyright notice and this permission notice appear in all
+ * copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+ * WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+ * AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+ * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR
+ * PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+ * TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/**
+ * DOC: cds_cpu_acct.c
+ *
+ * CPU usage accounting of the rx contexts
+ */
+
+#include <linux/math64.h>
+#include <cds_cpu_acct.h>
+
+int cds_cpu_acct_scnprintf(struct cds_cpu_acct *acct, int cpu,
+			   char *buf, size_t len)
+{
+	struct cds_cpu_acct_entry entry;
+
+	if (cpu < 0 || cpu >= CDS_CPU_ACCT_MAX_CPUS)
+		return 0;
+
+	/* snapshot, the context may be running or cleared meanwhile */
+	entry = acct->cpu[cpu];
+	if (!entry.runs)
+		return 0;
+
+	return qdf_scnprintf(buf, len,
+			     "runs:%llu pkts:%llu pkts/run:%llu budget_exhausted:%llu(%llu%%) time_us:%llu max_us:%llu ns/pkt:%llu",
+			     entry.runs, entry.pkts,
+			     div64_u64(entry.pkts, entry.runs),
+			     entry.budget_exhausted,
+			     div64_u64(entry.budget_exhausted * 100,
+				       entry.runs),
+			     div_u64(entry.time_ns, NSEC_PER_USEC),
+			     div_u64(entry.max_time_ns, NSEC_PER_USEC),
+			     entry.pkts ?
+				div64_u64(entry.time_ns, entry.pkts) : 0);
+}
@@ -0,0 +1,337 @@
+/*
+ * Copyright (c) 2021 The Linux Foundation. All rights reserved.
+ *
+ * Permission to use, copy, modify, and/or distribute this software for
+ * any purpose with or without fee is hereby granted, provided that the
+ * above copyright notice and this permission notice appear in all
+ * copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+ * WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+ * AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+ * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR
+ * PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+ * TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/**
+ * DOC: cds_lock_prof.c
+ *
+ * Lock contention profiler of the named driver lock sites
+ */
+
+#include <linux/percpu.h>
+#include <linux/mutex.h>
+#include <linux/math64.h>
+#include <qdf_mem.h>
+#include <qdf_time.h>
+#include <qdf_debugfs.h>
+#include <cds_utils.h>
+#include <cds_lock_prof.h>
+
+#define CDS_LOCK_PROF_DEBUGFS_PERMS	(QDF_FILE_USR_READ |	\
+					 QDF_FILE_USR_WRITE |	\
+					 QDF_FILE_GRP_READ |	\
+					 QDF_FILE_OTH_READ)
+
+/**
+ * struct cds_lock_prof_stats - lock site stats of one CPU
+ * @acquired: number of acquisitions
+ * @contended: acquisitions which found the lock taken
+ * @wait_ns: total time spent waiting for the lock
+ * @max_wait_ns: longest wait
+ * @hold_ns: total time the lock was held
+ * @max_hold_ns: longest hold
+ */
+struct cds_lock_prof_stats {
+	uint64_t acquired;
+	uint64_t contended;
+	uint64_t wait_ns;
+	uint64_t max_wait_ns;
+	uint64_t hold_ns;
+	uint64_t max_hold_ns;
+};
+
+/* profiled locks one CPU may hold at a time, deeper ones are not timed */
+#define CDS_LOCK_PROF_MAX_HELD 4
+
+/**
+ * struct cds_lock_prof_held - profiled locks held by one CPU
+ * @depth: number of valid entries in @lock and @lock_ts_ns
+ * @lock: held locks, in acquisition order
+ * @lock_ts_ns: time each lock of @lock was taken
+ *
+ * The hold start is kept per lock instance, so that locks of one site
+ * nesting on a CPU, like the two FT shard locks of a flow migration,
+ * are each timed from their own acquisition.
+ */
+struct cds_lock_prof_held {
+	int depth;
+	qdf_spinlock_t *lock[CDS_LOCK_PROF_MAX_HELD];
+	uint64_t lock_ts_ns[CDS_LOCK_PROF_MAX_HELD];
+};
+
+static DEFINE_PER_CPU(struct cds_lock_prof_stats[CDS_LOCK_SITE_MAX],
+		      cds_lock_prof_stats);
+static DEFINE_PER_CPU(struct cds_lock_prof_held, cds_lock_prof_held);
+/* serializes profiling on/off against the readers */
+static DEFINE_MUTEX(cds_lock_prof_lock);
+static qdf_dentry_t cds_lock_prof_debugfs_dir;
+static struct qdf_debugfs_fops cds_lock_prof_debugfs_fops;
+
+static const char * const cds_lock_prof_site_names[] = {
+	[CDS_LOCK_SITE_HTT_RX_HASH] = "htt_rx_hash",
+	[CDS_LOCK_SITE_OL_TX_FLOW_POOL] = "ol_tx_flow_pool",
+	[CDS_LOCK_SITE_OL_TX_QUEUE] = "ol_tx_queue",
+	[CDS_LOCK_SITE_HDD_STA_OBJ] = "hdd_sta_obj",
+	[CDS_LOCK_SITE_DP_FISA_FT] = "dp_fisa_ft",
+};
+
+#if (LINUX_VERSION_CODE >= KERNEL_VERSION(4, 3, 0))
+DEFINE_STATIC_KEY_FALSE(cds_lock_prof_key);
+
+static inline void cds_lock_prof_set(bool enable)
+{
+	if (enable)
+		static_branch_enable(&cds_lock_prof_key);
+	else
+		static_branch_disable(&cds_lock_prof_key);
+}
+#else
+bool cds_lock_prof_on;
+
+static inline void cds_lock_prof_set(bool enable)
+{
+	WRITE_ONCE(cds_lock_prof_on, enable);
+}
+#endif
+
+void __cds_lock_prof_spin_lock_bh(qdf_spinlock_t *lock,
+				  enum cds_lock_site site)
+{
+	struct cds_lock_prof_stats *stats;
+	struct cds_lock_prof_held *held;
+	uint64_t start_ns, now_ns;
+	bool contended = false;
+
+	start_ns = qdf_get_monotonic_boottime_ns();
+	if (!qdf_spin_trylock_bh(lock)) {
+		qdf_spin_lock_bh(lock);
+		contended = true;
+	}
+	now_ns = qdf_get_monotonic_boottime_ns();
+
+	/* bottom halves are off while the lock is held, so no migration */
+	stats = &this_cpu_ptr(&cds_lock_prof_stats)[0][site];
+	stats->acquired++;
+	if (contended) {
+		stats->contended++;
+		stats->wait_ns += now_ns - start_ns;
+		if (now_ns - start_ns > stats->max_wait_ns)
+			stats->max_wait_ns = now_ns - start_ns;
+	}
+
+	held = this_cpu_ptr(&cds_lock_prof_held);
+	if (held->depth < CDS_LOCK_PROF_MAX_HELD) {
+		held->lock[held->depth] = lock;
+		held->lock_ts_ns[held->depth] = now_ns;
+		held->depth++;
+	}
+}
+
+void __cds_lock_prof_spin_unlock_bh(qdf_spinlock_t *lock,
+				    enum cds_lock_site site)
+{
+	struct cds_lock_prof_stats *stats;
+	struct cds_lock_prof_held *held;
+	uint64_t hold_ns;
+	int i;
+
+	held = this_cpu_ptr(&cds_lock_prof_held);
+	for (i = held->depth - 1; i >= 0; i--)
+		if (held->lock[i] == lock)
+			break;
+
+	/* not found if taken before profiling was turned on */
+	if (i >= 0) {
+		hold_ns = qdf_get_monotonic_boottime_ns() -
+			  held->lock_ts_ns[i];
+		stats = &this_cpu_ptr(&cds_lock_prof_stats)[0][site];
+		stats->hold_ns += hold_ns;
+		if (hold_ns > stats->max_hold_ns)
+			stats->max_hold_ns = hold_ns;
+
+		/* locks need not be released in reverse order */
+		held->depth--;
+		for (; i < held->depth; i++) {
+			held->lock[i] = held->lock[i + 1];
+			held->lock_ts_ns[i] = held->lock_ts_ns[i + 1];
+		}
+	}
+
+	qdf_spin_unlock_bh(lock);
+}
+
+/**
+ * cds_lock_prof_enable() - turn lock profiling on or off
+ * @enable: true to clear the stats and start profiling
+ *
+ * Return: None
+ */
+static void cds_lock_prof_enable(bool enable)
+{
+	int cpu;
+
+	mutex_lock(&cds_lock_prof_lock);
+	if (enable == cds_lock_prof_enabled())
+		goto unlock;
+
+	/*
+	 * the stats are only written while profiling is on, locks released
+	 * while it was off left their entries in the held stacks
+	 */
+	if (enable) {
+		for_each_possible_cpu(cpu) {
+			qdf_mem_zero(per_cpu_ptr(&cds_lock_prof_stats, cpu),
+				     sizeof(cds_lock_prof_stats));
+			per_cpu_ptr(&cds_lock_prof_held, cpu)->depth = 0;
+		}
+	}
+	cds_lock_prof_set(enable);
+	cds_debug("lock profiling %s", enable ? "on" : "off");
+
+unlock:
+	mutex_unlock(&cds_lock_prof_lock);
+}
+
+/**
+ * cds_lock_prof_site_get() - sum the stats of a lock site over all CPUs
+ * @site: lock site
+ * @total: filled with the stats of @site
+ *
+ * Return: None
+ */
+static void cds_lock_prof_site_get(enum cds_lock_site site,
+				   struct cds_lock_prof_stats *total)
+{
+	struct cds_lock_prof_stats *stats;
+	int cpu;
+
+	qdf_mem_zero(total, sizeof(*total));
+	for_each_possible_cpu(cpu) {
+		stats = &per_cpu_ptr(&cds_lock_prof_stats, cpu)[0][site];
+		total->acquired += stats->acquired;
+		total->contended += stats->contended;
+		total->wait_ns += stats->wait_ns;
+		total->hold_ns += stats->hold_ns;
+		total->max_wait_ns = max(total->max_wait_ns,
+					 stats->max_wait_ns);
+		total->max_hold_ns = max(total->max_hold_ns,
+					 stats->max_hold_ns);
+	}
+}
+
+/**
+ * cds_lock_prof_read_debugfs() - dump the lock sites ranked by wait time
+ * @file: qdf debugfs file handler
+ * @arg: unused
+ *
+ * Return: QDF_STATUS
+ */
+static QDF_STATUS cds_lock_prof_read_debugfs(qdf_debugfs_file_t file,
+					     void *arg)
+{
+	struct cds_lock_prof_stats total[CDS_LOCK_SITE_MAX];
+	bool shown[CDS_LOCK_SITE_MAX] = {0};
+	struct cds_lock_prof_stats *st;
+	int site, next, i;
+
+	mutex_lock(&cds_lock_prof_lock);
+	for (site = 0; site < CDS_LOCK_SITE_MAX; site++)
+		cds_lock_prof_site_get(site, &total[site]);
+	qdf_debugfs_printf(file, "profiling %s\n",
+			   cds_lock_prof_enabled() ? "on" : "off");
+	mutex_unlock(&cds_lock_prof_lock);
+
+	qdf_debugfs_printf(file, "%-16s %12s %12s %12s %12s %12s %12s\n",
+			   "site", "acquired", "contended", "wait_us",
+			   "max_wait_ns", "avg_hold_ns", "max_hold_ns");
+
+	for (i = 0; i < CDS_LOCK_SITE_MAX; i++) {
+		next = -1;
+		for (site = 0; site < CDS_LOCK_SITE_MAX; site++) {
+			if (shown[site])
+				continue;
+			if (next < 0 ||
+			    total[site].wait_ns > total[next].wait_ns)
+				next = site;
+		}
+		shown[next] = true;
+
+		st = &total[next];
+		qdf_debugfs_printf(file,
+				   "%-16s %12llu %12llu %12llu %12llu %12llu %12llu\n",
+				   cds_lock_prof_site_names[next],
+				   st->acquired, st->contended,
+				   div_u64(st->wait_ns, NSEC_PER_USEC),
+				   st->max_wait_ns,
+				   st->acquired ?
+					div64_u64(st->hold_ns, st->acquired) : 0,
+				   st->max_hold_ns);
+	}
+
+	return QDF_STATUS_SUCCESS;
+}
+
+/**
+ * cds_lock_prof_write_debugfs() - turn lock profiling on or off
+ * @priv: unused
+ * @buf: user buffer, "1" to clear the stats and start, "0" to stop
+ * @len: buf length
+ *
+ * Return: QDF_STATUS
+ */
+static QDF_STATUS cds_lock_prof_write_debugfs(void *priv, const char *buf,
+					      qdf_size_t len)
+{
+	uint32_t enable;
+
+	if (kstrtou32(buf, 0, &enable))
+		return QDF_STATUS_E_INVAL;
+
+	cds_lock_prof_enable(!!enable);
+
+	return QDF_STATUS_SUCCESS;
+}
+
+void cds_lock_prof_debugfs_init(void)
+{
+	cds_lock_prof_debugfs_fops.show = cds_lock_prof_read_debugfs;
+	cds_lock_prof_debugfs_fops.write = cds_lock_prof_write_debugfs;
+	cds_lock_prof_debugfs_fops.priv = NULL;
+
+	cds_lock_prof_debugfs_dir = qdf_debugfs_create_dir("lock_prof", NULL);
+	if (!cds_lock_prof_debugfs_dir) {
+		cds_err("error while creating debugfs dir for lock_prof");
+		return;
+	}
+
+	if (!qdf_debugfs_create_file("sites", CDS_LOCK_PROF_DEBUGFS_PERMS,
+				     cds_lock_prof_debugfs_dir,
+				     &cds_lock_prof_debugfs_fops)) {
+		cds_err("lock_prof sites debugfs entry creation failed");
+		qdf_debugfs_remove_dir_recursive(cds_lock_prof_debugfs_dir);
+		cds_lock_prof_debugfs_dir = NULL;
+	}
+}
+
+void cds_lock_prof_debugfs_deinit(void)
+{
+	cds_lock_prof_enable(false);
+
+	if (cds_lock_prof_debugfs_dir)
+		qdf_debugfs_remove_dir_recursive(cds_lock_prof_debugfs_dir);
+	cds_lock_prof_debugfs_dir = NULL;
+}
@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2021 The Linux Foundation. All rights reserved.
+ *
+ * Permission to use, copy, modify, and/or distribute this software for
+ * any purpose with or without fee is hereby granted, provided that the
+ * above copyright notice and this permission notice appear in all
+ * copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+ * WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+ * AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+ * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR
+ * PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+ * TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/**
+ * DOC: cds_mem_acct.c
+ *
+ * Per subsystem memory accounting and allocation failure injection
+ */
+
+#include <linux/atomic.h>
+#include <linux/mutex.h>
+#include <qdf_time.h>
+#include <qdf_util.h>
+#include <cds_utils.h>
+#include <cds_mem_acct.h>
+
+/**
+ * struct cds_mem_acct_entry - accounting state of one tag
+ * @cur: bytes currently allocated
+ * @peak: highest value of @cur
+ * @allocs: number of allocations
+ * @injected: number of injected allocation failures
+ * @fail_cnt: allocations seen while injection is on
+ * @fail_interval: every Nth allocation fails, 0 if injection is off
+ * @last_allocs: @allocs at the previous snapshot
+ * @last_ts_ns: time of the previous snapshot, 0 if there was none
+ */
+struct cds_mem_acct_entry {
+	atomic64_t cur;
+	atomic64_t peak;
+	atomic64_t allocs;
+	atomic64_t injected;
+	atomic_t fail_cnt;
+	uint32_t fail_interval;
+	uint64_t last_allocs;
+	uint64_t last_ts_ns;
+};
+
+uint32_t cds_mem_acct_fail_tags;
+static struct cds_mem_acct_entry cds_mem_acct[CDS_MEM_TAG_MAX];
+/* serializes the snapshots and the configuration of the tags */
+static DEFINE_MUTEX(cds_mem_acct_lock);
+
+static const char * const cds_mem_acct_tag_names[] = {
+	[CDS_MEM_TAG_DP_TX_DESC] = "dp_tx_desc",
+	[CDS_MEM_TAG_DP_RX_BUF] = "dp_rx_buf",
+	[CDS_MEM_TAG_SCAN_CACHE] = "scan_cache",
+	[CDS_MEM_TAG_PE_SESSION] = "pe_session",
+	[CDS_MEM_TAG_WMI_BUF] = "wmi_buf",
+	[CDS_MEM_TAG_PKTLOG] = "pktlog",
+	[CDS_MEM_TAG_FISA] = "fisa",
+};
+
+void cds_mem_acct_alloc(enum cds_mem_tag tag, size_t size, uint32_t count)
+{
+	struct cds_mem_acct_entry *entry;
+	int64_t cur, peak, prev;
+
+	if (tag >= CDS_MEM_TAG_MAX)
+		return;
+
+	entry = &cds_mem_acct[tag];
+	atomic64_add(count, &entry->allocs);
+	cur = atomic64_add_return(size, &entry->cur);
+
+	peak = atomic64_read(&entry->peak);
+	while (cur > peak) {
+		prev = atomic64_cmpxchg(&entry->peak, peak, cur);
+		if (prev == peak)
+			break;
+		peak = prev;
+	}
+}
+
+void cds_mem_acct_free(enum cds_mem_tag tag, size_t size)
+{
+	if (tag >= CDS_MEM_TAG_MAX)
+		return;
+
+	atomic64_sub(size, &cds_mem_acct[tag].cur);
+}
+
+bool __cds_mem_acct_inject_fail(enum cds_mem_tag tag)
+{
+	struct cds_mem_acct_entry *entry;
+	uint32_t interval;
+
+	if (tag >= CDS_MEM_TAG_MAX)
+		return false;
+
+	entry = &cds_mem_acct[tag];
+	interval = READ_ONCE(entry->fail_interval);
+	if (!interval ||
+	    (uint32_t)atomic_inc_return(&entry->fail_cnt) % interval)
+		return false;
+
+	atomic64_inc(&entry->injected);
+	cds_debug("injected %s allocation failure",
+		  cds_mem_acct_tag_names[tag]);
+
+	return true;
+}
+
+void cds_mem_acct_set_fail_interval(enum cds_mem_tag tag, uint32_t interval)
+{
+	struct cds_mem_acct_entry *entry;
+
+	if (tag >= CDS_MEM_TAG_MAX)
+		return;
+
+	entry = &cds_mem_acct[tag];
+
+	mutex_lock(&cds_mem_acct_lock);
+	atomic_set(&entry->fail_cnt, 0);
+	WRITE_ONCE(entry->fail_interval, interval);
+	if (interval)
+		WRITE_ONCE(cds_mem_acct_fail_tags,
+			   cds_mem_acct_fail_tags | BIT(tag));
+	else
+		WRITE_ONCE(cds_mem_acct_fail_tags,
+			   cds_mem_acct_fail_tags & ~BIT(tag));
+	mutex_unlock(&cds_mem_acct_lock);
+
+	cds_debug("%s fail interval %u", cds_mem_acct_tag_names[tag],
+		  interval);
+}
+
+void cds_mem_acct_reset_peak(enum cds_mem_tag tag)
+{
+	struct cds_mem_acct_entry *entry;
+
+	if (tag >= CDS_MEM_TAG_MAX)
+		return;
+
+	entry = &cds_mem_acct[tag];
+	atomic64_set(&entry->peak, atomic64_read(&entry->cur));
+}
+
+void cds_mem_acct_get(enum cds_mem_tag tag,
+		      struct cds_mem_acct_snapshot *snap)
+{
+	struct cds_mem_acct_entry *entry;
+	uint64_t now_ns;
+	uint32_t elapsed_ms;
+
+	qdf_mem_zero(snap, sizeof(*snap));
+	if (tag >= CDS_MEM_TAG_MAX)
+		return;
+
+	entry = &cds_mem_acct[tag];
+
+	mutex_lock(&cds_mem_acct_lock);
+	snap->cur = atomic64_read(&entry->cur);
+	snap->peak = atomic64_read(&entry->peak);
+	snap->allocs = atomic64_read(&entry->allocs);
+	snap->fail_interval = entry->fail_interval;
+	snap->injected = atomic64_read(&entry->injected);
+
+	now_ns = qdf_get_monotonic_boottime_ns();
+	elapsed_ms = qdf_do_div(now_ns - entry->last_ts_ns, NSEC_PER_MSEC);
+	if (entry->last_ts_ns && elapsed_ms)
+		snap->alloc_rate = qdf_do_div((snap->allocs -
+					       entry->last_allocs) * 1000,
+					      elapsed_ms);
+	entry->last_allocs = snap->allocs;
+	entry->last_ts_ns = now_ns;
+	mutex_unlock(&cds_mem_acct_lock);
+}
+
+const char *cds_mem_acct_tag_name(enum cds_mem_tag tag)
+{
+	if (tag >= CDS_MEM_TAG_MAX)
+		return "UNKNOWN";
+
+	return cds_mem_acct_tag_names[tag];
+}
@@ -0,0 +1,281 @@
+/*
+ * Copyright (c) 2021 The Linux Foundation. All rights reserved.
+ *
+ * Permission to use, copy, modify, and/or distribute this software for
+ * any purpose with or without fee is hereby granted, provided that the
+ * above copyright notice and this permission notice appear in all
+ * copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+ * WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+ * AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+ * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR
+ * PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+ * TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/**
+ * DOC: cds_pkt_trace.c
+ *
+ * Static key gated per packet trace hooks and per CPU trace rings
+ */
+
+#include <linux/percpu.h>
+#include <linux/mutex.h>
+#include <linux/rcupdate.h>
+#include <qdf_mem.h>
+#include <qdf_time.h>
+#include <cds_utils.h>
+#include <cds_pkt_trace.h>
+
+/**
+ * struct cds_pkt_trace_ring - packet trace records of one CPU
+ * @head: number of records ever claimed on this CPU
+ * @rec: records, record n (counting from 1) lives in slot (n - 1) % size
+ */
+struct cds_pkt_trace_ring {
+	uint32_t head;
+	struct cds_pkt_trace_rec rec[CDS_PKT_TRACE_RING_SIZE];
+};
+
+/**
+ * struct cds_pkt_trace_cursor - read position in the ring of one CPU
+ * @seq: record to be read next, 0 once the ring is exhausted
+ * @floor: oldest record which may still be present in the ring
+ * @rec: copy of record @seq
+ */
+struct cds_pkt_trace_cursor {
+	uint32_t seq;
+	uint32_t floor;
+	struct cds_pkt_trace_rec rec;
+};
+
+uint32_t cds_pkt_trace_users;
+static struct cds_pkt_trace_ring __percpu *cds_pkt_trace_rings;
+static DEFINE_MUTEX(cds_pkt_trace_lock);
+
+static const char * const cds_pkt_trace_event_names[] = {
+	[CDS_PKT_TRACE_EVENT_OL_TX] = "OL_TX",
+	[CDS_PKT_TRACE_EVENT_OL_RX] = "OL_RX",
+};
+
+#if (LINUX_VERSION_CODE >= KERNEL_VERSION(4, 3, 0))
+DEFINE_STATIC_KEY_FALSE(cds_pkt_trace_key);
+
+static inline void cds_pkt_trace_key_enable(void)
+{
+	static_branch_enable(&cds_pkt_trace_key);
+}
+
+static inline void cds_pkt_trace_key_disable(void)
+{
+	static_branch_disable(&cds_pkt_trace_key);
+}
+#else
+static inline void cds_pkt_trace_key_enable(void)
+{
+}
+
+static inline void cds_pkt_trace_key_disable(void)
+{
+}
+#endif
+
+int cds_pkt_trace_user_set(uint32_t user, bool enable)
+{
+	uint32_t users;
+
+	mutex_lock(&cds_pkt_trace_lock);
+
+	if (enable && (user & CDS_PKT_TRACE_USER_RING) &&
+	    !cds_pkt_trace_rings) {
+		cds_pkt_trace_rings = alloc_percpu(struct cds_pkt_trace_ring);
+		if (!cds_pkt_trace_rings) {
+			mutex_unlock(&cds_pkt_trace_lock);
+			cds_err("packet trace ring alloc failed");
+			return -ENOMEM;
+		}
+	}
+
+	users = cds_pkt_trace_users;
+	if (enable)
+		users |= user;
+	else
+		users &= ~user;
+
+	/* publish the users before the hooks can observe the key */
+	if (users && !cds_pkt_trace_users) {
+		WRITE_ONCE(cds_pkt_trace_users, users);
+		cds_pkt_trace_key_enable();
+	} else if (!users && cds_pkt_trace_users) {
+		cds_pkt_trace_key_disable();
+		WRITE_ONCE(cds_pkt_trace_users, users);
+	} else {
+		WRITE_ONCE(cds_pkt_trace_users, users);
+	}
+
+	mutex_unlock(&cds_pkt_trace_lock);
+
+	cds_debug("packet trace users 0x%x", users);
+
+	return 0;
+}
+
+void __cds_pkt_trace_record(enum cds_pkt_trace_event event, qdf_nbuf_t nbuf,
+			    uint8_t vdev_id, uint16_t msdu_id, uint8_t status)
+{
+	struct cds_pkt_trace_ring __percpu *rings;
+	struct cds_pkt_trace_ring *ring;
+	struct cds_pkt_trace_rec *rec;
+	uint32_t seq;
+
+	/* rings are only freed on deinit, once no hook can run anymore */
+	rings = READ_ONCE(cds_pkt_trace_rings);
+	if (!rings)
+		return;
+
+	ring = get_cpu_ptr(rings);
+	/* irq safe on the local CPU, nested writers get their own slot */
+	seq = this_cpu_inc_return(rings->head);
+	if (qdf_unlikely(!seq))
+		seq = this_cpu_inc_return(rings->head);
+	rec = &ring->rec[(seq - 1) & (CDS_PKT_TRACE_RING_SIZE - 1)];
+
+	WRITE_ONCE(rec->seq, 0);
+	smp_wmb();
+	rec->ts_ns = qdf_get_monotonic_boottime_ns();
+	rec->len = qdf_nbuf_len(nbuf);
+	rec->msdu_id = msdu_id;
+	rec->event = event;
+	rec->vdev_id = vdev_id;
+	rec->status = status;
+	smp_wmb();
+	WRITE_ONCE(rec->seq, seq);
+
+	put_cpu_ptr(rings);
+}
+
+/**
+ * cds_pkt_trace_cursor_load() - load the next valid record of a cursor
+ * @ring: ring the cursor walks
+ * @cursor: cursor positioned on the record to load
+ *
+ * Walks from cursor->seq towards older records until one is found which
+ * was neither being written nor overwritten while it was copied.
+ *
+ * Return: true if a record was loaded, false once the ring is exhausted
+ */
+static bool cds_pkt_trace_cursor_load(struct cds_pkt_trace_ring *ring,
+				      struct cds_pkt_trace_cursor *cursor)
+{
+	struct cds_pkt_trace_rec *rec;
+	uint32_t seq;
+
+	for (; cursor->seq && cursor->seq != cursor->floor; cursor->seq--) {
+		rec = &ring->rec[(cursor->seq - 1) &
+				 (CDS_PKT_TRACE_RING_SIZE - 1)];
+		seq = READ_ONCE(rec->seq);
+		smp_rmb();
+		cursor->rec = *rec;
+		smp_rmb();
+		if (seq == cursor->seq && READ_ONCE(rec->seq) == seq)
+			return true;
+	}
+
+	cursor->seq = 0;
+	return false;
+}
+
+uint32_t cds_pkt_trace_read(struct cds_pkt_trace_rec *out, uint32_t max)
+{
+	struct cds_pkt_trace_cursor *cursors;
+	struct cds_pkt_trace_ring *ring;
+	uint32_t n = max;
+	int cpu, latest;
+
+	mutex_lock(&cds_pkt_trace_lock);
+	if (!cds_pkt_trace_rings || !max)
+		goto unlock;
+
+	cursors = qdf_mem_malloc(nr_cpu_ids * sizeof(*cursors));
+	if (!cursors)
+		goto unlock;
+
+	for_each_possible_cpu(cpu) {
+		ring = per_cpu_ptr(cds_pkt_trace_rings, cpu);
+		cursors[cpu].seq = READ_ONCE(ring->head);
+		cursors[cpu].floor = cursors[cpu].seq - CDS_PKT_TRACE_RING_SIZE;
+		cds_pkt_trace_cursor_load(ring, &cursors[cpu]);
+	}
+
+	/* merge from the newest record backwards, so the newest are kept */
+	while (n) {
+		latest = -1;
+		for_each_possible_cpu(cpu) {
+			if (!cursors[cpu].seq)
+				continue;
+			if (latest < 0 || cursors[cpu].rec.ts_ns >
+					  cursors[latest].rec.ts_ns)
+				latest = cpu;
+		}
+		if (latest < 0)
+			break;
+
+		out[--n] = cursors[latest].rec;
+		out[n].cpu = latest;
+
+		ring = per_cpu_ptr(cds_pkt_trace_rings, latest);
+		cursors[latest].seq--;
+		cds_pkt_trace_cursor_load(ring, &cursors[latest]);
+	}
+
+	qdf_mem_free(cursors);
+
+	if (n)
+		memmove(out, out + n, (max - n) * sizeof(*out));
+
+unlock:
+	mutex_unlock(&cds_pkt_trace_lock);
+
+	return max - n;
+}
+
+void cds_pkt_trace_clear(void)
+{
+	struct cds_pkt_trace_ring *ring;
+	int cpu, i;
+
+	mutex_lock(&cds_pkt_trace_lock);
+	if (cds_pkt_trace_rings) {
+		for_each_possible_cpu(cpu) {
+			ring = per_cpu_ptr(cds_pkt_trace_rings, cpu);
+			for (i = 0; i < CDS_PKT_TRACE_RING_SIZE; i++)
+				WRITE_ONCE(ring->rec[i].seq, 0);
+		}
+	}
+	mutex_unlock(&cds_pkt_trace_lock);
+}
+
+const char *cds_pkt_trace_event_name(uint8_t event)
+{
+	if (event >= CDS_PKT_TRACE_EVENT_MAX)
+		return "UNKNOWN";
+
+	return cds_pkt_trace_event_names[event];
+}
+
+void cds_pkt_trace_deinit(void)
+{
+	mutex_lock(&cds_pkt_trace_lock);
+	if (cds_pkt_trace_users) {
+		cds_pkt_trace_key_disable();
+		WRITE_ONCE(cds_pkt_trace_users, 0);
+	}
+	/* let in flight hooks finish before the rings go away */
+	synchronize_rcu();
+	free_percpu(cds_pkt_trace_rings);
+	cds_pkt_trace_rings = NULL;
+	mutex_unlock(&cds_pkt_trace_lock);
+}
@@ -495,6 +495,9 @@ QDF_STATUS cds_sched_open(void *p_cds_context,
 	spin_lock_init(&pSchedContext->ol_rx_queue_lock);
 	spin_lock_init(&pSchedContext->cds_ol_rx_pkt_freeq_lock);
 	INIT_LIST_HEAD(&pSchedContext->ol_rx_thread_queue);
+	pSchedContext->ol_rx_thread_queue_len = 0;
+	qdf_mem_zero(&pSchedContext->ol_rx_thread_acct,
+		     sizeof(pSchedContext->ol_rx_thread_acct));
 	spin_lock_bh(&pSchedContext->cds_ol_rx_pkt_freeq_lock);
 	INIT_LIST_HEAD(&pSchedContext->cds_ol_rx_pkt_freeq);
 	spin_unlock_bh(&pSchedContext->cds_ol_rx_pkt_freeq_lock);
@@ -667,11 +670,37 @@ cds_indicate_rxpkt(p_cds_sched_context pSchedContext,
 {
 	spin_lock_bh(&pSchedContext->ol_rx_queue_lock);
 	list_add_tail(&pkt->list, &pSchedContext->ol_rx_thread_queue);
+	pSchedContext->ol_rx_thread_queue_len++;
 	spin_unlock_bh(&pSchedContext->ol_rx_queue_lock);
 	set_bit(RX_POST_EVENT, &pSchedContext->ol_rx_event_flag);
 	wake_up_interruptible(&pSchedContext->ol_rx_wait_queue);
 }
 
+uint32_t cds_get_ol_rx_queue_len(void)
+{
+	if (!gp_cds_sched_context)
+		return 0;
+
+	return READ_ONCE(gp_cds_sched_context->ol_rx_thread_queue_len);
+}
+
+void cds_ol_rx_thread_dump_stats(void)
+{
+	struct cds_cpu_acct *acct;
+	char buf[192];
+	int cpu;
+
+	if (!gp_cds_sched_context)
+		return;
+
+	acct = &gp_cds_sched_context->ol_rx_thread_acct;
+	for (cpu = 0; cpu < CDS_CPU_ACCT_MAX_CPUS; cpu++) {
+		if (!cds_cpu_acct_scnprintf(acct, cpu, buf, sizeof(buf)))
+			continue;
+		cds_nofl_info("ol_rx_thread - cpu:%d %s", cpu, buf);
+	}
+}
+
 /**
  * cds_close_rx_thread() - close the Rx thread
  *
@@ -728,8 +757,10 @@ void cds_drop_rxpkt_by_staid(p_cds_sched_context pSchedContext, uint16_t staId)
 	}
 	list_for_each_entry_safe(pkt, tmp, &pSchedContext->ol_rx_thread_queue,
 								list) {
-		if (pkt->staId == staId || staId == WLAN_MAX_STA_COUNT)
+		if (pkt->staId == staId || staId == WLAN_MAX_STA_COUNT) {
 			list_move_tail(&pkt->list, &local_list);
+			pSchedContext->ol_rx_thread_queue_len--;
+		}
 	}
 	spin_unlock_bh(&pSchedContext->ol_rx_queue_lock);
 
@@ -752,11 +783,13 @@ void cds_drop_rxpkt_by_staid(p_cds_sched_context pSchedContext, uint16_t staId)
  * This api traverses the pending buffer list and calling the callback.
  * This callback would essentially send the packet to HDD.
  *
- * Return: none
+ * Return: number of rx packets processed
  */
-static void cds_rx_from_queue(p_cds_sched_context pSchedContext)
+static uint32_t cds_rx_from_queue(p_cds_sched_context pSchedContext)
 {
 	struct cds_ol_rx_pkt *pkt;
+	qdf_nbuf_t nbuf;
+	uint32_t pkts = 0;
 	uint16_t sta_id;
 
 	spin_lock_bh(&pSchedContext->ol_rx_queue_lock);
@@ -764,13 +797,18 @@ static void cds_rx_from_queue(p_cds_sched_context pSchedContext)
 		pkt = list_first_entry(&pSchedContext->ol_rx_thread_queue,
 				       struct cds_ol_rx_pkt, list);
 		list_del(&pkt->list);
+		pSchedContext->ol_rx_thread_queue_len--;
 		spin_unlock_bh(&pSchedContext->ol_rx_queue_lock);
+		for (nbuf = pkt->Rxpkt; nbuf; nbuf = qdf_nbuf_next(nbuf))
+			pkts++;
 		sta_id = pkt->staId;
 		pkt->callback(pkt->context, pkt->Rxpkt, sta_id);
 		cds_free_ol_rx_pkt(pSchedContext, pkt);
 		spin_lock_bh(&pSchedContext->ol_rx_queue_lock);
 	}
 	spin_unlock_bh(&pSchedContext->ol_rx_queue_lock);
+
+	return pkts;
 }
 
 /**
@@ -785,6 +823,8 @@ static int cds_ol_rx_thread(void *arg)
 {
 	p_cds_sched_context pSchedContext = (p_cds_sched_context) arg;
 	bool shutdown = false;
+	uint64_t start_ns;
+	uint32_t pkts;
 	int status;
 
 #ifdef RX_THREAD_PRIORITY
@@ -827,7 +867,11 @@ static int cds_ol_rx_thread(void *arg)
 				shutdown = true;
 				break;
 			}
-			cds_rx_from_queue(pSchedContext);
+			start_ns = cds_cpu_acct_start();
+			pkts = cds_rx_from_queue(pSchedContext);
+			/* the OL rx thread has no budget */
+			cds_cpu_acct_end(&pSchedContext->ol_rx_thread_acct,
+					 start_ns, pkts, false);
 
 			if (test_bit(RX_SUSPEND_EVENT,
 				     &pSchedContext->ol_rx_event_flag)) {
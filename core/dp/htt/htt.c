@@ -864,6 +864,13 @@ void htt_rx_refill_failure(htt_pdev_handle pdev)
 	QDF_BUG(qdf_atomic_read(&pdev->rx_ring.refill_debt));
 }
 
+void htt_rx_ring_fill_get(htt_pdev_handle pdev, uint32_t *fill_cnt,
+			  uint32_t *fill_level)
+{
+	*fill_cnt = qdf_atomic_read(&pdev->rx_ring.fill_cnt);
+	*fill_level = pdev->rx_ring.fill_level;
+}
+
 #if HTT_DEBUG_LEVEL > 5
 void htt_display(htt_pdev_handle pdev, int indent)
 {
@@ -25,6 +25,7 @@
 #include <htc_api.h>            /* HTC_PACKET */
 
 #include <htt_types.h>
+#include <cds_mem_acct.h>
 
 /* htt_rx.c */
 #define RX_MSDU_END_4_FIRST_MSDU_MASK \
@@ -1099,6 +1100,7 @@ htt_rx_in_order_netbuf_pop(htt_pdev_handle pdev, qdf_dma_addr_t paddr)
 {
 	HTT_ASSERT1(htt_rx_in_order_ring_elems(pdev) != 0);
 	qdf_atomic_dec(&pdev->rx_ring.fill_cnt);
+	cds_mem_acct_free(CDS_MEM_TAG_DP_RX_BUF, HTT_RX_BUF_SIZE);
 	paddr = htt_paddr_trim_to_37(paddr);
 	return htt_rx_hash_list_lookup(pdev, paddr);
 }
@@ -30,6 +30,9 @@
 
 #include <cds_ieee80211_common.h>   /* ieee80211_frame, ieee80211_qoscntl */
 #include <cds_utils.h>
+#include <cds_pkt_trace.h>
+#include <cds_mem_acct.h>
+#include <cds_lock_prof.h>
 #include <wlan_policy_mgr_api.h>
 #include "ol_txrx_types.h"
 #ifdef DEBUG_DMA_DONE
@@ -125,6 +128,7 @@ static inline qdf_nbuf_t htt_rx_netbuf_pop(htt_pdev_handle pdev)
 	idx &= pdev->rx_ring.size_mask;
 	pdev->rx_ring.sw_rd_idx.msdu_payld = idx;
 	qdf_atomic_dec(&pdev->rx_ring.fill_cnt);
+	cds_mem_acct_free(CDS_MEM_TAG_DP_RX_BUF, HTT_RX_BUF_SIZE);
 	return msdu;
 }
 
@@ -311,6 +315,9 @@ static qdf_nbuf_t htt_rx_ring_buf_attach(struct htt_pdev_t *pdev)
 	qdf_nbuf_t net_buf = NULL;
 	bool allocated = true;
 
+	if (cds_mem_acct_inject_fail(CDS_MEM_TAG_DP_RX_BUF))
+		return NULL;
+
 	net_buf =
 		qdf_nbuf_alloc(pdev->osdev, HTT_RX_BUF_SIZE,
 			       0, 4, false);
@@ -507,6 +514,10 @@ update_alloc_idx:
 	*pdev->rx_ring.alloc_idx.vaddr = idx;
 	htt_rx_dbg_rxbuf_indupd(pdev, idx);
 
+	if (filled)
+		cds_mem_acct_alloc(CDS_MEM_TAG_DP_RX_BUF,
+				   filled * HTT_RX_BUF_SIZE, filled);
+
 	return filled;
 }
 
@@ -1100,7 +1111,8 @@ htt_rx_hash_list_insert(struct htt_pdev_t *pdev,
 	int rc = 0;
 	struct htt_rx_hash_entry *hash_element = NULL;
 
-	qdf_spin_lock_bh(&pdev->rx_ring.rx_hash_lock);
+	cds_lock_prof_spin_lock_bh(&pdev->rx_ring.rx_hash_lock,
+				   CDS_LOCK_SITE_HTT_RX_HASH);
 
 	/* get rid of the marking bits if they are available */
 	paddr = htt_paddr_trim_to_37(paddr);
@@ -1146,7 +1158,8 @@ htt_rx_hash_list_insert(struct htt_pdev_t *pdev,
 	HTT_RX_HASH_COUNT_PRINT(pdev->rx_ring.hash_table[i]);
 
 hli_end:
-	qdf_spin_unlock_bh(&pdev->rx_ring.rx_hash_lock);
+	cds_lock_prof_spin_unlock_bh(&pdev->rx_ring.rx_hash_lock,
+				     CDS_LOCK_SITE_HTT_RX_HASH);
 	return rc;
 }
 
@@ -1163,10 +1176,12 @@ qdf_nbuf_t htt_rx_hash_list_lookup(struct htt_pdev_t *pdev,
 	qdf_nbuf_t netbuf = NULL;
 	struct htt_rx_hash_entry *hash_entry;
 
-	qdf_spin_lock_bh(&pdev->rx_ring.rx_hash_lock);
+	cds_lock_prof_spin_lock_bh(&pdev->rx_ring.rx_hash_lock,
+				   CDS_LOCK_SITE_HTT_RX_HASH);
 
 	if (!pdev->rx_ring.hash_table) {
-		qdf_spin_unlock_bh(&pdev->rx_ring.rx_hash_lock);
+		cds_lock_prof_spin_unlock_bh(&pdev->rx_ring.rx_hash_lock,
+					     CDS_LOCK_SITE_HTT_RX_HASH);
 		return NULL;
 	}
 
@@ -1208,7 +1223,8 @@ qdf_nbuf_t htt_rx_hash_list_lookup(struct htt_pdev_t *pdev,
 			      (unsigned long long)paddr, netbuf, (int)i));
 	HTT_RX_HASH_COUNT_PRINT(pdev->rx_ring.hash_table[i]);
 
-	qdf_spin_unlock_bh(&pdev->rx_ring.rx_hash_lock);
+	cds_lock_prof_spin_unlock_bh(&pdev->rx_ring.rx_hash_lock,
+				     CDS_LOCK_SITE_HTT_RX_HASH);
 
 	if (!netbuf) {
 		qdf_print("rx hash: no entry found for %llx!\n",
@@ -1597,7 +1613,7 @@ htt_rx_amsdu_rx_in_order_pop_ll(htt_pdev_handle pdev,
 						NEXT_FIELD_OFFSET_IN32));
 
 		/* calling callback function for packet logging */
-		if (pdev->rx_pkt_dump_cb) {
+		if (cds_pkt_trace_enabled() && pdev->rx_pkt_dump_cb) {
 			if (qdf_unlikely(RX_DESC_MIC_ERR_IS_SET &&
 					 !RX_DESC_DISCARD_IS_SET))
 				status = RX_PKT_FATE_FW_DROP_INVALID;
@@ -2224,6 +2240,10 @@ void htt_rx_detach(struct htt_pdev_t *pdev)
 	qdf_timer_free(&pdev->rx_ring.refill_retry_timer);
 	htt_rx_dbg_rxbuf_deinit(pdev);
 
+	cds_mem_acct_free(CDS_MEM_TAG_DP_RX_BUF,
+			  qdf_atomic_read(&pdev->rx_ring.fill_cnt) *
+			  HTT_RX_BUF_SIZE);
+
 	if (qdf_mem_smmu_s1_enabled(pdev->osdev) && pdev->is_ipa_uc_enabled &&
 	    pdev->rx_ring.smmu_map)
 		ipa_smmu = true;
@@ -200,6 +200,17 @@ void htt_log_rx_ring_info(htt_pdev_handle pdev);
  */
 void htt_rx_refill_failure(htt_pdev_handle pdev);
 
+/**
+ * htt_rx_ring_fill_get() - get the fill state of the htt rx ring
+ * @pdev: handle to the HTT instance
+ * @fill_cnt: filled with the number of buffers in the ring
+ * @fill_level: filled with the number of buffers the ring is kept filled with
+ *
+ * Return: None
+ */
+void htt_rx_ring_fill_get(htt_pdev_handle pdev, uint32_t *fill_cnt,
+			  uint32_t *fill_level);
+
 #ifndef HTT_DEBUG_LEVEL
 #if defined(DEBUG)
 #define HTT_DEBUG_LEVEL 10
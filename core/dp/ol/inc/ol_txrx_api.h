@@ -75,4 +75,123 @@ void ol_register_timestamp_callback(tp_ol_timestamp_cb ol_tx_timestamp_cb);
  */
 void ol_deregister_timestamp_callback(void);
 #endif
+
+/**
+ * struct ol_txrx_stall_signals - host datapath state watched for data stalls
+ * @rx_thread_queue_len: rx packet batches queued to the OL rx thread
+ * @tx_desc_pool_size: number of tx descriptors
+ * @tx_desc_free: tx descriptors not in flight, including the ones held by
+ *	the tx flow pools
+ * @tx_flow_pools_paused: number of tx flow pools paused for lack of
+ *	descriptors
+ * @tx_compl_age_ms: time since the last tx completion
+ * @rx_ring_fill_cnt: buffers posted to the rx ring
+ * @rx_ring_fill_level: buffers the rx ring is kept filled with
+ */
+struct ol_txrx_stall_signals {
+	uint32_t rx_thread_queue_len;
+	uint16_t tx_desc_pool_size;
+	uint16_t tx_desc_free;
+	uint32_t tx_flow_pools_paused;
+	uint32_t tx_compl_age_ms;
+	uint32_t rx_ring_fill_cnt;
+	uint32_t rx_ring_fill_level;
+};
+
+#ifdef WLAN_DP_STALL_DETECT
+/**
+ * ol_txrx_get_stall_signals() - sample the datapath state for stall detection
+ * @signals: filled with the current datapath state
+ *
+ * Return: QDF_STATUS_SUCCESS if @signals was filled
+ */
+QDF_STATUS ol_txrx_get_stall_signals(struct ol_txrx_stall_signals *signals);
+#else
+static inline
+QDF_STATUS ol_txrx_get_stall_signals(struct ol_txrx_stall_signals *signals)
+{
+	return QDF_STATUS_E_NOSUPPORT;
+}
+#endif
+
+/**
+ * struct ol_txrx_vdev_tx_load - tx descriptor usage of a vdev
+ * @inflight: tx descriptors handed to the target and not completed yet
+ * @completed: tx descriptors freed since attach, wraps around
+ *
+ * A TSO frame takes one descriptor per segment. Without tx flow control v2
+ * the descriptors are shared by the vdevs and the counts cover the pdev.
+ */
+struct ol_txrx_vdev_tx_load {
+	uint32_t inflight;
+	uint32_t completed;
+};
+
+#ifdef WLAN_OL_TX_VDEV_LOAD
+/**
+ * ol_txrx_get_vdev_tx_load() - read the tx descriptor usage of a vdev
+ * @vdev_id: vdev to read
+ * @load: filled with the descriptor counts
+ *
+ * Return: QDF_STATUS_SUCCESS if @load was filled
+ */
+QDF_STATUS ol_txrx_get_vdev_tx_load(uint8_t vdev_id,
+				    struct ol_txrx_vdev_tx_load *load);
+
+/**
+ * ol_txrx_vdev_tx_load_supported() - check if the vdev tx load is tracked
+ *
+ * Return: true if ol_txrx_get_vdev_tx_load() can fill a load
+ */
+static inline bool ol_txrx_vdev_tx_load_supported(void)
+{
+	return true;
+}
+#else
+static inline
+QDF_STATUS ol_txrx_get_vdev_tx_load(uint8_t vdev_id,
+				    struct ol_txrx_vdev_tx_load *load)
+{
+	return QDF_STATUS_E_NOSUPPORT;
+}
+
+static inline bool ol_txrx_vdev_tx_load_supported(void)
+{
+	return false;
+}
+#endif
+
+#ifdef WLAN_OL_TX_LAT_HIST
+/**
+ * ol_txrx_tx_lat_scnprintf() - format the tx latency histograms of a vdev
+ * @vdev_id: vdev whose peers are listed
+ * @buf: buffer to fill
+ * @len: size of @buf
+ *
+ * One line per peer and access category with traffic; column n holds the
+ * number of frames completed within [2^n, 2^(n + 1)) us of their tx
+ * descriptor allocation.
+ *
+ * Return: number of characters written
+ */
+int ol_txrx_tx_lat_scnprintf(uint8_t vdev_id, char *buf, size_t len);
+
+/**
+ * ol_txrx_tx_lat_reset() - reset the tx latency histograms of a vdev
+ * @vdev_id: vdev whose peers are reset
+ *
+ * Return: None
+ */
+void ol_txrx_tx_lat_reset(uint8_t vdev_id);
+#else
+static inline
+int ol_txrx_tx_lat_scnprintf(uint8_t vdev_id, char *buf, size_t len)
+{
+	return 0;
+}
+
+static inline void ol_txrx_tx_lat_reset(uint8_t vdev_id)
+{
+}
+#endif
 #endif /* _OL_TXRX_API__H_ */
@@ -58,6 +58,7 @@
 #include <htt_internal.h>
 #include <wlan_pkt_capture_ucfg_api.h>
 #include <wlan_cfr_ucfg_api.h>
+#include <cds_pkt_trace.h>
 
 #ifndef OL_RX_INDICATION_MAX_RECORDS
 #define OL_RX_INDICATION_MAX_RECORDS 2048
@@ -1753,6 +1754,9 @@ void ol_rx_pkt_dump_call(
 		return;
 	}
 
+	cds_pkt_trace_record(CDS_PKT_TRACE_EVENT_OL_RX, msdu,
+			     peer->vdev->vdev_id, 0, status);
+
 	packetdump_cb = pdev->ol_rx_packetdump_cb;
 	if (packetdump_cb &&
 	    wlan_op_mode_sta == peer->vdev->opmode)
@@ -21,9 +21,7 @@
 #include <qdf_util.h>           /* qdf_assert */
 #include <qdf_lock.h>           /* qdf_spinlock */
 #include <qdf_trace.h>          /* qdf_tso_seg_dbg stuff */
-#ifdef QCA_COMPUTE_TX_DELAY
 #include <qdf_time.h>           /* qdf_system_ticks */
-#endif
 
 #include <ol_htt_tx_api.h>      /* htt_tx_desc_id */
 
@@ -33,6 +31,9 @@
 #include <ol_txrx_encap.h>      /* OL_TX_RESTORE_HDR, etc */
 #endif
 #include <ol_txrx.h>
+#include <ol_txrx_api.h>
+#include <cds_api.h>
+#include <cds_lock_prof.h>
 
 #ifdef QCA_SUPPORT_TXDESC_SANITY_CHECKS
 static inline void ol_tx_desc_sanity_checks(struct ol_txrx_pdev_t *pdev,
@@ -91,6 +92,26 @@ static inline void ol_tx_desc_update_tx_ts(struct ol_tx_desc_t *tx_desc)
 }
 #endif
 
+#ifdef QCA_SUPPORT_TXRX_LOCAL_PEER_ID
+/**
+ * ol_tx_desc_set_enqueue_ts() - Record when the frame entered the tx path
+ * @tx_desc: tx descriptor
+ *
+ * The timestamp is consumed on tx completion for the per peer tx
+ * completion latency histograms.
+ *
+ * Return: None
+ */
+static inline void ol_tx_desc_set_enqueue_ts(struct ol_tx_desc_t *tx_desc)
+{
+	tx_desc->enqueue_ts_us = (uint32_t)qdf_get_monotonic_boottime();
+}
+#else
+static inline void ol_tx_desc_set_enqueue_ts(struct ol_tx_desc_t *tx_desc)
+{
+}
+#endif
+
 /**
  * ol_tx_desc_vdev_update() - vedv assign.
  * @tx_desc: tx descriptor pointer
@@ -249,6 +270,7 @@ struct ol_tx_desc_t *ol_tx_desc_alloc(struct ol_txrx_pdev_t *pdev,
 		ol_tx_desc_vdev_update(tx_desc, vdev);
 		ol_tx_desc_count_inc(vdev);
 		ol_tx_desc_update_tx_ts(tx_desc);
+		ol_tx_desc_set_enqueue_ts(tx_desc);
 		qdf_atomic_inc(&tx_desc->ref_cnt);
 	}
 	qdf_spin_unlock_bh(&pdev->tx_mutex);
@@ -292,7 +314,8 @@ struct ol_tx_desc_t *ol_tx_desc_alloc(struct ol_txrx_pdev_t *pdev,
 		goto end;
 	}
 
-	qdf_spin_lock_bh(&pool->flow_pool_lock);
+	cds_lock_prof_spin_lock_bh(&pool->flow_pool_lock,
+				   CDS_LOCK_SITE_OL_TX_FLOW_POOL);
 	if (pool->avail_desc) {
 		tx_desc = ol_tx_get_desc_flow_pool(pool);
 		ol_tx_desc_dup_detect_set(pdev, tx_desc);
@@ -314,16 +337,19 @@ struct ol_tx_desc_t *ol_tx_desc_alloc(struct ol_txrx_pdev_t *pdev,
 				       WLAN_DATA_FLOW_CONTROL_PRIORITY);
 		}
 
-		qdf_spin_unlock_bh(&pool->flow_pool_lock);
+		cds_lock_prof_spin_unlock_bh(&pool->flow_pool_lock,
+					     CDS_LOCK_SITE_OL_TX_FLOW_POOL);
 
 		ol_tx_desc_sanity_checks(pdev, tx_desc);
 		ol_tx_desc_compute_delay(tx_desc);
 		ol_tx_desc_update_tx_ts(tx_desc);
+		ol_tx_desc_set_enqueue_ts(tx_desc);
 		ol_tx_desc_vdev_update(tx_desc, vdev);
 		qdf_atomic_inc(&tx_desc->ref_cnt);
 	} else {
 		pool->pkt_drop_no_desc++;
-		qdf_spin_unlock_bh(&pool->flow_pool_lock);
+		cds_lock_prof_spin_unlock_bh(&pool->flow_pool_lock,
+					     CDS_LOCK_SITE_OL_TX_FLOW_POOL);
 	}
 
 end:
@@ -538,6 +564,7 @@ void ol_tx_desc_free(struct ol_txrx_pdev_t *pdev, struct ol_tx_desc_t *tx_desc)
 	ol_tx_desc_free_common(pdev, tx_desc);
 
 	ol_tx_put_desc_global_pool(pdev, tx_desc);
+	pdev->tx_desc.num_freed++;
 	ol_tx_desc_vdev_rm(tx_desc);
 	ol_tx_do_pdev_flow_control_unpause(pdev);
 
@@ -591,10 +618,12 @@ void ol_tx_desc_free(struct ol_txrx_pdev_t *pdev, struct ol_tx_desc_t *tx_desc)
 	bool distribute_desc = false;
 	struct ol_tx_flow_pool_t *pool = tx_desc->pool;
 
-	qdf_spin_lock_bh(&pool->flow_pool_lock);
+	cds_lock_prof_spin_lock_bh(&pool->flow_pool_lock,
+				   CDS_LOCK_SITE_OL_TX_FLOW_POOL);
 
 	ol_tx_desc_free_common(pdev, tx_desc);
 	distribute_desc = ol_tx_update_free_desc_to_pool(pdev, tx_desc);
+	pool->freed_desc++;
 
 	switch (pool->status) {
 	case FLOW_POOL_ACTIVE_PAUSED:
@@ -616,7 +645,9 @@ void ol_tx_desc_free(struct ol_txrx_pdev_t *pdev, struct ol_tx_desc_t *tx_desc)
 		break;
 	case FLOW_POOL_INVALID:
 		if (pool->avail_desc == pool->flow_pool_size) {
-			qdf_spin_unlock_bh(&pool->flow_pool_lock);
+			cds_lock_prof_spin_unlock_bh(
+					&pool->flow_pool_lock,
+					CDS_LOCK_SITE_OL_TX_FLOW_POOL);
 			ol_tx_free_invalid_flow_pool(pool);
 			qdf_print("pool is INVALID State!!");
 			return;
@@ -629,7 +660,8 @@ void ol_tx_desc_free(struct ol_txrx_pdev_t *pdev, struct ol_tx_desc_t *tx_desc)
 		break;
 	};
 
-	qdf_spin_unlock_bh(&pool->flow_pool_lock);
+	cds_lock_prof_spin_unlock_bh(&pool->flow_pool_lock,
+				     CDS_LOCK_SITE_OL_TX_FLOW_POOL);
 
 	if (unlikely(distribute_desc))
 		ol_tx_distribute_descs_to_deficient_pools_from_global_pool();
@@ -637,6 +669,78 @@ void ol_tx_desc_free(struct ol_txrx_pdev_t *pdev, struct ol_tx_desc_t *tx_desc)
 }
 #endif
 
+#ifdef WLAN_OL_TX_VDEV_LOAD
+#ifdef QCA_LL_TX_FLOW_CONTROL_V2
+/**
+ * ol_tx_vdev_load_get() - read the descriptor counts of a vdev flow pool
+ * @pdev: pdev handle
+ * @vdev_id: vdev the flow pool belongs to
+ * @load: filled with the descriptor counts of the pool
+ *
+ * Return: QDF_STATUS_SUCCESS if the vdev has a flow pool
+ */
+static QDF_STATUS ol_tx_vdev_load_get(struct ol_txrx_pdev_t *pdev,
+				      uint8_t vdev_id,
+				      struct ol_txrx_vdev_tx_load *load)
+{
+	struct ol_tx_flow_pool_t *pool;
+	QDF_STATUS status = QDF_STATUS_E_INVAL;
+	int inflight;
+
+	qdf_spin_lock_bh(&pdev->tx_desc.flow_pool_list_lock);
+	TAILQ_FOREACH(pool, &pdev->tx_desc.flow_pool_list,
+		      flow_pool_list_elem) {
+		if (pool->flow_pool_id != vdev_id ||
+		    pool->flow_type != FLOW_TYPE_VDEV)
+			continue;
+
+		qdf_spin_lock_bh(&pool->flow_pool_lock);
+		/* descriptors owed to the pool were never handed out */
+		inflight = pool->flow_pool_size - pool->deficient_desc +
+			   pool->overflow_desc - pool->avail_desc;
+		load->inflight = qdf_max(inflight, 0);
+		load->completed = pool->freed_desc;
+		qdf_spin_unlock_bh(&pool->flow_pool_lock);
+		status = QDF_STATUS_SUCCESS;
+		break;
+	}
+	qdf_spin_unlock_bh(&pdev->tx_desc.flow_pool_list_lock);
+
+	return status;
+}
+#else
+static QDF_STATUS ol_tx_vdev_load_get(struct ol_txrx_pdev_t *pdev,
+				      uint8_t vdev_id,
+				      struct ol_txrx_vdev_tx_load *load)
+{
+	qdf_spin_lock_bh(&pdev->tx_mutex);
+	load->inflight = pdev->tx_desc.pool_size - pdev->tx_desc.num_free;
+	load->completed = pdev->tx_desc.num_freed;
+	qdf_spin_unlock_bh(&pdev->tx_mutex);
+
+	return QDF_STATUS_SUCCESS;
+}
+#endif
+
+QDF_STATUS ol_txrx_get_vdev_tx_load(uint8_t vdev_id,
+				    struct ol_txrx_vdev_tx_load *load)
+{
+	struct ol_txrx_soc_t *soc = cds_get_context(QDF_MODULE_ID_SOC);
+	ol_txrx_pdev_handle pdev;
+
+	qdf_mem_zero(load, sizeof(*load));
+
+	if (qdf_unlikely(!soc))
+		return QDF_STATUS_E_INVAL;
+
+	pdev = ol_txrx_get_pdev_from_pdev_id(soc, OL_TXRX_PDEV_ID);
+	if (!pdev)
+		return QDF_STATUS_E_INVAL;
+
+	return ol_tx_vdev_load_get(pdev, vdev_id, load);
+}
+#endif /* WLAN_OL_TX_VDEV_LOAD */
+
 const uint32_t htt_to_ce_pkt_type[] = {
 	[htt_pkt_type_raw] = tx_pkt_type_raw,
 	[htt_pkt_type_native_wifi] = tx_pkt_type_native_wifi,
@@ -47,6 +47,7 @@
 #include <htt_types.h>        /* htc_endpoint */
 #include <cdp_txrx_peer_ops.h>
 #include <cdp_txrx_handle.h>
+#include <cds_pkt_trace.h>
 
 #if defined(HIF_PCI) || defined(HIF_SNOC) || defined(HIF_AHB) || \
     defined(HIF_IPCI)
@@ -95,11 +96,22 @@ ol_tx_ll_wrapper(ol_txrx_vdev_handle vdev, qdf_nbuf_t msdu_list)
  * @msdu_id: msdu_id of the packet
  * @vdev_id: vdev_id of the packet
  *
+ * Patched out by the packet trace static key while no trace user is active.
+ *
  * Return: None
  */
 static inline void ol_tx_trace_pkt(qdf_nbuf_t skb, uint16_t msdu_id,
 				   uint8_t vdev_id)
 {
+	if (!cds_pkt_trace_enabled())
+		return;
+
+	cds_pkt_trace_record(CDS_PKT_TRACE_EVENT_OL_TX, skb, vdev_id,
+			     msdu_id, 0);
+
+	if (!cds_pkt_trace_user_enabled(CDS_PKT_TRACE_USER_DP_TRACE))
+		return;
+
 	DPTRACE(qdf_dp_trace_ptr(skb,
 				 QDF_DP_TRACE_TXRX_FAST_PACKET_PTR_RECORD,
 				 QDF_TRACE_DEFAULT_PDEV_ID,
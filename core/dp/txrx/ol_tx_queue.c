@@ -36,6 +36,7 @@
 #include "cdp_txrx_flow_ctrl_legacy.h"
 #include <ol_txrx_peer_find.h>
 #include <cdp_txrx_handle.h>
+#include <cds_lock_prof.h>
 #if defined(CONFIG_HL_SUPPORT)
 
 #ifndef offsetof
@@ -274,7 +275,8 @@ ol_tx_enqueue(
 		ol_tx_desc_frame_list_free(pdev, &tx_descs, 1 /* error */);
 	}
 
-	qdf_spin_lock_bh(&pdev->tx_queue_spinlock);
+	cds_lock_prof_spin_lock_bh(&pdev->tx_queue_spinlock,
+				   CDS_LOCK_SITE_OL_TX_QUEUE);
 	TAILQ_INSERT_TAIL(&txq->head, tx_desc, tx_desc_list_elem);
 
 	bytes = qdf_nbuf_len(tx_desc->netbuf);
@@ -296,7 +298,8 @@ ol_tx_enqueue(
 	if (!ETHERTYPE_IS_EAPOL_WAPI(tx_msdu_info->htt.info.ethertype))
 		OL_TX_QUEUE_ADDBA_CHECK(pdev, txq, tx_msdu_info);
 
-	qdf_spin_unlock_bh(&pdev->tx_queue_spinlock);
+	cds_lock_prof_spin_unlock_bh(&pdev->tx_queue_spinlock,
+				     CDS_LOCK_SITE_OL_TX_QUEUE);
 	TX_SCHED_DEBUG_PRINT("Leave");
 }
 
@@ -31,6 +31,7 @@
 #include <qdf_types.h>
 #include <qdf_mem.h>         /* qdf_os_mem_alloc_consistent et al */
 #include <cdp_txrx_handle.h>
+#include <cds_lock_prof.h>
 #if defined(CONFIG_HL_SUPPORT)
 
 #if defined(DEBUG_HL_LOGGING)
@@ -1491,9 +1492,11 @@ ol_tx_sched(struct ol_txrx_pdev_t *pdev)
 	u_int32_t credit;
 
 	TX_SCHED_DEBUG_PRINT("Enter");
-	qdf_spin_lock_bh(&pdev->tx_queue_spinlock);
+	cds_lock_prof_spin_lock_bh(&pdev->tx_queue_spinlock,
+				   CDS_LOCK_SITE_OL_TX_QUEUE);
 	if (pdev->tx_sched.tx_sched_status != ol_tx_scheduler_idle) {
-		qdf_spin_unlock_bh(&pdev->tx_queue_spinlock);
+		cds_lock_prof_spin_unlock_bh(&pdev->tx_queue_spinlock,
+					     CDS_LOCK_SITE_OL_TX_QUEUE);
 		return;
 	}
 	pdev->tx_sched.tx_sched_status = ol_tx_scheduler_running;
@@ -1504,7 +1507,8 @@ ol_tx_sched(struct ol_txrx_pdev_t *pdev)
 	 *ol_tx_queues_display(pdev);
 	 */
 	replenish_tx_pad_credit(pdev);
-	qdf_spin_unlock_bh(&pdev->tx_queue_spinlock);
+	cds_lock_prof_spin_unlock_bh(&pdev->tx_queue_spinlock,
+				     CDS_LOCK_SITE_OL_TX_QUEUE);
 
 	TAILQ_INIT(&sctx.head);
 	sctx.frms = 0;
@@ -1513,7 +1517,8 @@ ol_tx_sched(struct ol_txrx_pdev_t *pdev)
 	while (qdf_atomic_read(&pdev->target_tx_credit) > 0) {
 		int num_credits;
 
-		qdf_spin_lock_bh(&pdev->tx_queue_spinlock);
+		cds_lock_prof_spin_lock_bh(&pdev->tx_queue_spinlock,
+					   CDS_LOCK_SITE_OL_TX_QUEUE);
 		replenish_tx_pad_credit(pdev);
 		credit = qdf_atomic_read(&pdev->target_tx_credit);
 		num_credits = ol_tx_sched_select_batch(pdev, &sctx, credit);
@@ -1535,21 +1540,24 @@ ol_tx_sched(struct ol_txrx_pdev_t *pdev)
 
 			qdf_atomic_add(-num_credits, &pdev->target_tx_credit);
 		}
-		qdf_spin_unlock_bh(&pdev->tx_queue_spinlock);
+		cds_lock_prof_spin_unlock_bh(&pdev->tx_queue_spinlock,
+					     CDS_LOCK_SITE_OL_TX_QUEUE);
 
 		if (num_credits == 0)
 			break;
 	}
 	ol_tx_sched_dispatch(pdev, &sctx);
 
-	qdf_spin_lock_bh(&pdev->tx_queue_spinlock);
+	cds_lock_prof_spin_lock_bh(&pdev->tx_queue_spinlock,
+				   CDS_LOCK_SITE_OL_TX_QUEUE);
 	/*
 	 *adf_os_print("AFTER tx sched:\n");
 	 *ol_tx_queues_display(pdev);
 	 */
 
 	pdev->tx_sched.tx_sched_status = ol_tx_scheduler_idle;
-	qdf_spin_unlock_bh(&pdev->tx_queue_spinlock);
+	cds_lock_prof_spin_unlock_bh(&pdev->tx_queue_spinlock,
+				     CDS_LOCK_SITE_OL_TX_QUEUE);
 	TX_SCHED_DEBUG_PRINT("Leave");
 }
 
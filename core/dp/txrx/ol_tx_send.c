@@ -51,9 +51,11 @@
 #endif
 #include <ol_tx_queue.h>
 #include <ol_txrx.h>
+#include <ol_txrx_peer_find.h>  /* ol_txrx_peer_find_mac_addr_cmp */
 #include <pktlog_ac_fmt.h>
 #include <cdp_txrx_handle.h>
 #include <wlan_pkt_capture_ucfg_api.h>
+#include <cds_lock_prof.h>
 #ifdef TX_CREDIT_RECLAIM_SUPPORT
 
 #define OL_TX_CREDIT_RECLAIM(pdev)					\
@@ -576,7 +578,8 @@ void ol_tx_flow_pool_lock(struct ol_tx_desc_t *tx_desc)
 	struct ol_tx_flow_pool_t *pool;
 
 	pool = tx_desc->pool;
-	qdf_spin_lock_bh(&pool->flow_pool_lock);
+	cds_lock_prof_spin_lock_bh(&pool->flow_pool_lock,
+				   CDS_LOCK_SITE_OL_TX_FLOW_POOL);
 }
 
 /**
@@ -591,7 +594,8 @@ void ol_tx_flow_pool_unlock(struct ol_tx_desc_t *tx_desc)
 	struct ol_tx_flow_pool_t *pool;
 
 	pool = tx_desc->pool;
-	qdf_spin_unlock_bh(&pool->flow_pool_lock);
+	cds_lock_prof_spin_unlock_bh(&pool->flow_pool_lock,
+				     CDS_LOCK_SITE_OL_TX_FLOW_POOL);
 }
 #else
 static inline
@@ -956,6 +960,242 @@ static void ol_tx_update_connectivity_stats(struct ol_tx_desc_t *tx_desc,
 	}
 }
 
+/**
+ * struct ol_tx_lat_peer_cache - local peer ID found for the last completion
+ * @key: lookup key the ID was found for, 0 if none
+ * @local_id: local peer ID, -1 if no peer matched
+ *
+ * The completions of one HTT message mostly belong to the same flow, so
+ * the ID found for one frame is reused for the following ones.
+ */
+struct ol_tx_lat_peer_cache {
+	uint64_t key;
+	int local_id;
+};
+
+#ifdef QCA_SUPPORT_TXRX_LOCAL_PEER_ID
+/*
+ * Tx latency lookup key of a local peer ID: the peer MAC address in bits
+ * 0..47, the vdev ID in bits 48..55, OL_TX_LAT_KEY_ASSOC if the peer is
+ * the AP of a STA vdev and OL_TX_LAT_KEY_VALID while the ID is in use.
+ */
+#define OL_TX_LAT_KEY_VDEV_SHIFT	48
+#define OL_TX_LAT_KEY_ASSOC	BIT_ULL(56)
+#define OL_TX_LAT_KEY_VALID	BIT_ULL(63)
+#define OL_TX_LAT_KEY_VDEV_MASK \
+	(OL_TX_LAT_KEY_VALID | (0xffULL << OL_TX_LAT_KEY_VDEV_SHIFT))
+
+/**
+ * ol_tx_lat_key() - Build the tx latency lookup key of a vdev and address
+ * @vdev_id: vdev ID
+ * @mac: MAC address, or NULL for the vdev part of the key only
+ *
+ * Return: lookup key, with OL_TX_LAT_KEY_VALID set
+ */
+static uint64_t ol_tx_lat_key(uint8_t vdev_id, const uint8_t *mac)
+{
+	uint64_t key = OL_TX_LAT_KEY_VALID |
+		       (uint64_t)vdev_id << OL_TX_LAT_KEY_VDEV_SHIFT;
+	int i;
+
+	for (i = 0; mac && i < QDF_MAC_ADDR_SIZE; i++)
+		key |= (uint64_t)mac[i] << (8 * i);
+
+	return key;
+}
+
+/**
+ * ol_tx_lat_peer_find() - Find the local peer ID a frame is accounted to
+ * @pdev: pdev handle
+ * @key: ol_tx_lat_key() of the vdev and destination address of the frame
+ *
+ * The peer owning the destination address if there is one, else the AP
+ * if the vdev is a STA vdev. This runs without any lock: the keys are
+ * written with WRITE_ONCE() when the local peer IDs change hands.
+ *
+ * Return: local peer ID, -1 if the frame is not accounted
+ */
+static int ol_tx_lat_peer_find(struct ol_txrx_pdev_t *pdev, uint64_t key)
+{
+	uint64_t peer_key;
+	int i, assoc_id = -1;
+
+	for (i = 0; i < OL_TXRX_NUM_LOCAL_PEER_IDS; i++) {
+		peer_key = READ_ONCE(pdev->tx_lat_key[i]);
+		if ((peer_key & OL_TX_LAT_KEY_VDEV_MASK) !=
+		    (key & OL_TX_LAT_KEY_VDEV_MASK))
+			continue;
+
+		if ((peer_key & ~OL_TX_LAT_KEY_ASSOC) == key)
+			return i;
+		if (peer_key & OL_TX_LAT_KEY_ASSOC)
+			assoc_id = i;
+	}
+
+	return assoc_id;
+}
+
+void ol_tx_lat_attach(struct ol_txrx_pdev_t *pdev)
+{
+	int i;
+
+	for (i = 0; i < OL_TXRX_NUM_LOCAL_PEER_IDS; i++)
+		pdev->tx_lat_key[i] = 0;
+
+	pdev->tx_lat = __alloc_percpu(sizeof(struct ol_tx_peer_lat) *
+				      OL_TXRX_NUM_LOCAL_PEER_IDS,
+				      __alignof__(struct ol_tx_peer_lat));
+	if (!pdev->tx_lat)
+		ol_txrx_err("tx latency histogram alloc failed");
+}
+
+void ol_tx_lat_detach(struct ol_txrx_pdev_t *pdev)
+{
+	free_percpu(pdev->tx_lat);
+	pdev->tx_lat = NULL;
+}
+
+void ol_tx_lat_peer_add(struct ol_txrx_pdev_t *pdev,
+			struct ol_txrx_peer_t *peer)
+{
+	struct ol_txrx_vdev_t *vdev = peer->vdev;
+	uint64_t key = ol_tx_lat_key(vdev->vdev_id, peer->mac_addr.raw);
+	int cpu;
+
+	if (peer->local_id >= OL_TXRX_NUM_LOCAL_PEER_IDS)
+		return;
+
+	/* the first real peer of a STA vdev is the AP, later ones are TDLS */
+	if (vdev->opmode == wlan_op_mode_sta &&
+	    ol_txrx_peer_find_mac_addr_cmp(&vdev->mac_addr, &peer->mac_addr) &&
+	    ol_tx_lat_peer_find(pdev, ol_tx_lat_key(vdev->vdev_id, NULL)) < 0)
+		key |= OL_TX_LAT_KEY_ASSOC;
+
+	if (pdev->tx_lat)
+		for_each_possible_cpu(cpu)
+			qdf_mem_zero(per_cpu_ptr(pdev->tx_lat, cpu) +
+				     peer->local_id,
+				     sizeof(struct ol_tx_peer_lat));
+
+	WRITE_ONCE(pdev->tx_lat_key[peer->local_id], key);
+}
+
+void ol_tx_lat_peer_remove(struct ol_txrx_pdev_t *pdev,
+			   struct ol_txrx_peer_t *peer)
+{
+	if (peer->local_id >= OL_TXRX_NUM_LOCAL_PEER_IDS)
+		return;
+
+	WRITE_ONCE(pdev->tx_lat_key[peer->local_id], 0);
+}
+
+void ol_tx_peer_lat_get(struct ol_txrx_pdev_t *pdev,
+			struct ol_txrx_peer_t *peer,
+			struct ol_tx_peer_lat *lat)
+{
+	struct ol_tx_peer_lat *cpu_lat;
+	int cpu, ac, bucket;
+
+	qdf_mem_zero(lat, sizeof(*lat));
+	if (!pdev->tx_lat || peer->local_id >= OL_TXRX_NUM_LOCAL_PEER_IDS)
+		return;
+
+	for_each_possible_cpu(cpu) {
+		cpu_lat = per_cpu_ptr(pdev->tx_lat, cpu) + peer->local_id;
+		for (ac = 0; ac < TXRX_NUM_WMM_AC; ac++)
+			for (bucket = 0; bucket < OL_TX_LAT_HIST_BUCKETS;
+			     bucket++)
+				lat->hist[ac][bucket] +=
+					cpu_lat->hist[ac][bucket];
+	}
+}
+
+void ol_tx_lat_clear(struct ol_txrx_pdev_t *pdev, int vdev_id)
+{
+	uint64_t vdev_key = ol_tx_lat_key(vdev_id, NULL);
+	int i, cpu;
+
+	if (!pdev->tx_lat)
+		return;
+
+	for (i = 0; i < OL_TXRX_NUM_LOCAL_PEER_IDS; i++) {
+		if (vdev_id != OL_TX_LAT_ALL_VDEVS &&
+		    (READ_ONCE(pdev->tx_lat_key[i]) &
+		     OL_TX_LAT_KEY_VDEV_MASK) != vdev_key)
+			continue;
+
+		for_each_possible_cpu(cpu)
+			qdf_mem_zero(per_cpu_ptr(pdev->tx_lat, cpu) + i,
+				     sizeof(struct ol_tx_peer_lat));
+	}
+}
+
+/**
+ * ol_tx_lat_record() - Account tx completion latency of a frame to its peer
+ * @pdev: pdev handle
+ * @cache: peer cache of the completion batch
+ * @tx_desc: completed tx descriptor
+ * @now_us: completion time, in usec
+ *
+ * Frames on STA vdevs are accounted to the AP, unless they are addressed
+ * to another peer of the vdev (e.g. a TDLS peer); frames on other vdevs to
+ * the peer owning the destination address. Group addressed frames on
+ * other vdevs, and frames whose destination cannot be parsed, are not
+ * accounted. Only the vdev ID and the frame are used, so the vdev may go
+ * away meanwhile.
+ *
+ * Return: None
+ */
+static void ol_tx_lat_record(struct ol_txrx_pdev_t *pdev,
+			     struct ol_tx_lat_peer_cache *cache,
+			     struct ol_tx_desc_t *tx_desc, uint32_t now_us)
+{
+	uint8_t *dest = NULL;
+	uint64_t key;
+	uint32_t lat_us;
+	uint8_t tid, ac, bucket;
+
+	if (!pdev->tx_lat || tx_desc->vdev_id == OL_TXRX_INVALID_VDEV_ID)
+		return;
+
+	if (pdev->frame_format == wlan_frm_fmt_802_3) {
+		dest = qdf_nbuf_data(tx_desc->netbuf);
+		if (IEEE80211_IS_MULTICAST(dest))
+			dest = NULL;
+	}
+
+	key = ol_tx_lat_key(tx_desc->vdev_id, dest);
+	if (cache->key != key ||
+	    (cache->local_id >= 0 &&
+	     (READ_ONCE(pdev->tx_lat_key[cache->local_id]) &
+	      OL_TX_LAT_KEY_VDEV_MASK) != (key & OL_TX_LAT_KEY_VDEV_MASK))) {
+		cache->key = key;
+		cache->local_id = ol_tx_lat_peer_find(pdev, key);
+	}
+
+	if (cache->local_id < 0)
+		return;
+
+	lat_us = now_us - tx_desc->enqueue_ts_us;
+	bucket = lat_us ? fls(lat_us) - 1 : 0;
+	if (bucket >= OL_TX_LAT_HIST_BUCKETS)
+		bucket = OL_TX_LAT_HIST_BUCKETS - 1;
+
+	tid = qdf_nbuf_get_tid(tx_desc->netbuf);
+	ac = tid < OL_TX_NUM_QOS_TIDS ? TXRX_TID_TO_WMM_AC(tid) :
+					TXRX_WMM_AC_BE;
+
+	this_cpu_inc(pdev->tx_lat[cache->local_id].hist[ac][bucket]);
+}
+#else
+static inline void ol_tx_lat_record(struct ol_txrx_pdev_t *pdev,
+				    struct ol_tx_lat_peer_cache *cache,
+				    struct ol_tx_desc_t *tx_desc,
+				    uint32_t now_us)
+{
+}
+#endif /* QCA_SUPPORT_TXRX_LOCAL_PEER_ID */
+
 /**
  * WARNING: ol_tx_inspect_handler()'s behavior is similar to that of
  * ol_tx_completion_handler().
@@ -991,8 +1231,11 @@ ol_tx_completion_handler(ol_txrx_pdev_handle pdev,
 	uint64_t tx_tsf64;
 	uint8_t tid;
 	uint8_t dp_status;
+	struct ol_tx_lat_peer_cache lat_cache = { 0 };
+	uint32_t comp_ts_us = (uint32_t)qdf_get_monotonic_boottime();
 
 	TAILQ_INIT(&tx_descs);
+	pdev->tx_compl_ts_us = comp_ts_us;
 
 	tid = HTT_TX_COMPL_IND_TID_GET(*msg_word);
 
@@ -1026,6 +1269,8 @@ ol_tx_completion_handler(ol_txrx_pdev_handle pdev,
 		tx_desc->status = status;
 		netbuf = tx_desc->netbuf;
 
+		ol_tx_lat_record(pdev, &lat_cache, tx_desc, comp_ts_us);
+
 		if (txtstamp64_list) {
 			tx_tsf64 =
 			(u_int64_t)txtstamp64_list[i].tx_tsf64_high << 32 |
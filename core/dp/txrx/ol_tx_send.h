@@ -83,6 +83,87 @@ ol_tx_send_nonstd(struct ol_txrx_pdev_t *pdev,
 		  struct ol_tx_desc_t *tx_desc,
 		  qdf_nbuf_t msdu, enum htt_pkt_type pkt_type);
 
+/* ol_tx_lat_clear() vdev_id resetting the histograms of all vdevs */
+#define OL_TX_LAT_ALL_VDEVS (-1)
+
+#ifdef QCA_SUPPORT_TXRX_LOCAL_PEER_ID
+/**
+ * ol_tx_lat_attach() - Allocate the tx completion latency histograms
+ * @pdev: pdev handle
+ *
+ * The histograms are kept per local peer ID. On allocation failure the
+ * tx completion latency is simply not accounted.
+ *
+ * Return: None
+ */
+void ol_tx_lat_attach(struct ol_txrx_pdev_t *pdev);
+
+/**
+ * ol_tx_lat_detach() - Free the tx completion latency histograms
+ * @pdev: pdev handle
+ *
+ * Return: None
+ */
+void ol_tx_lat_detach(struct ol_txrx_pdev_t *pdev);
+
+/**
+ * ol_tx_lat_peer_add() - Start accounting tx completion latency to a peer
+ * @pdev: pdev handle
+ * @peer: peer which was just given its local peer ID
+ *
+ * Resets the histograms of the local peer ID and publishes the lookup key
+ * of the peer. Called with the local peer ID lock held.
+ *
+ * Return: None
+ */
+void ol_tx_lat_peer_add(struct ol_txrx_pdev_t *pdev,
+			struct ol_txrx_peer_t *peer);
+
+/**
+ * ol_tx_lat_peer_remove() - Stop accounting tx completion latency to a peer
+ * @pdev: pdev handle
+ * @peer: peer about to release its local peer ID
+ *
+ * Called with the local peer ID lock held.
+ *
+ * Return: None
+ */
+void ol_tx_lat_peer_remove(struct ol_txrx_pdev_t *pdev,
+			   struct ol_txrx_peer_t *peer);
+
+/**
+ * ol_tx_peer_lat_get() - Sum the per CPU latency histograms of a peer
+ * @pdev: pdev handle
+ * @peer: peer of interest
+ * @lat: filled with the histograms summed over all CPUs
+ *
+ * Return: None
+ */
+void ol_tx_peer_lat_get(struct ol_txrx_pdev_t *pdev,
+			struct ol_txrx_peer_t *peer,
+			struct ol_tx_peer_lat *lat);
+
+/**
+ * ol_tx_lat_clear() - Reset tx completion latency histograms
+ * @pdev: pdev handle
+ * @vdev_id: vdev whose peers are reset, or OL_TX_LAT_ALL_VDEVS
+ *
+ * Return: None
+ */
+void ol_tx_lat_clear(struct ol_txrx_pdev_t *pdev, int vdev_id);
+#else
+static inline void ol_tx_peer_lat_get(struct ol_txrx_pdev_t *pdev,
+				      struct ol_txrx_peer_t *peer,
+				      struct ol_tx_peer_lat *lat)
+{
+	qdf_mem_zero(lat, sizeof(*lat));
+}
+
+static inline void ol_tx_lat_clear(struct ol_txrx_pdev_t *pdev, int vdev_id)
+{
+}
+#endif /* QCA_SUPPORT_TXRX_LOCAL_PEER_ID */
+
 #ifdef QCA_COMPUTE_TX_DELAY
 /**
  * ol_tx_set_compute_interval() - update compute interval period for TSM stats
@@ -87,6 +87,8 @@
 #include <qdf_notifier.h>
 #include <qdf_hang_event_notifier.h>
 #endif
+#include <cds_pkt_trace.h>
+#include <cds_mem_acct.h>
 
 #define DPT_DEBUGFS_PERMS	(QDF_FILE_USR_READ |	\
 				QDF_FILE_USR_WRITE |	\
@@ -587,6 +589,8 @@ static void ol_txrx_local_peer_id_pool_init(struct ol_txrx_pdev_t *pdev)
 	pdev->local_peer_ids.pool[i] = i;
 
 	qdf_spinlock_create(&pdev->local_peer_ids.lock);
+
+	ol_tx_lat_attach(pdev);
 }
 
 static void
@@ -605,6 +609,7 @@ ol_txrx_local_peer_id_alloc(struct ol_txrx_pdev_t *pdev,
 		peer->local_id = i;
 		pdev->local_peer_ids.freelist = pdev->local_peer_ids.pool[i];
 		pdev->local_peer_ids.map[i] = peer;
+		ol_tx_lat_peer_add(pdev, peer);
 	}
 	qdf_spin_unlock_bh(&pdev->local_peer_ids.lock);
 }
@@ -621,6 +626,7 @@ ol_txrx_local_peer_id_free(struct ol_txrx_pdev_t *pdev,
 	}
 	/* put this ID on the head of the freelist */
 	qdf_spin_lock_bh(&pdev->local_peer_ids.lock);
+	ol_tx_lat_peer_remove(pdev, peer);
 	pdev->local_peer_ids.pool[i] = pdev->local_peer_ids.freelist;
 	pdev->local_peer_ids.freelist = i;
 	pdev->local_peer_ids.map[i] = NULL;
@@ -629,6 +635,7 @@ ol_txrx_local_peer_id_free(struct ol_txrx_pdev_t *pdev,
 
 static void ol_txrx_local_peer_id_cleanup(struct ol_txrx_pdev_t *pdev)
 {
+	ol_tx_lat_detach(pdev);
 	qdf_spinlock_destroy(&pdev->local_peer_ids.lock);
 }
 
@@ -804,8 +811,123 @@ static QDF_STATUS ol_txrx_write_dpt_buff_debugfs(void *priv,
 	return QDF_STATUS_SUCCESS;
 }
 
+/**
+ * ol_txrx_print_peer_tx_lat() - dump tx completion latency of one peer
+ * @file: qdf debugfs file handler
+ * @vdev: vdev of the peer
+ * @peer: peer of interest
+ *
+ * Return: None
+ */
+static void ol_txrx_print_peer_tx_lat(qdf_debugfs_file_t file,
+				      struct ol_txrx_vdev_t *vdev,
+				      struct ol_txrx_peer_t *peer)
+{
+	static const char * const ac_name[TXRX_NUM_WMM_AC] = {
+		"BE", "BK", "VI", "VO"
+	};
+	struct ol_tx_peer_lat lat;
+	uint32_t *hist;
+	uint32_t total;
+	int ac, bucket;
+
+	ol_tx_peer_lat_get(vdev->pdev, peer, &lat);
+	for (ac = 0; ac < TXRX_NUM_WMM_AC; ac++) {
+		hist = lat.hist[ac];
+		total = 0;
+		for (bucket = 0; bucket < OL_TX_LAT_HIST_BUCKETS; bucket++)
+			total += hist[bucket];
+		if (!total)
+			continue;
+
+		qdf_debugfs_printf(file, "%u " QDF_MAC_ADDR_FMT " %s:",
+				   vdev->vdev_id,
+				   QDF_MAC_ADDR_REF(peer->mac_addr.raw),
+				   ac_name[ac]);
+		for (bucket = 0; bucket < OL_TX_LAT_HIST_BUCKETS; bucket++)
+			qdf_debugfs_printf(file, " %u", hist[bucket]);
+		qdf_debugfs_printf(file, "\n");
+	}
+}
+
+/**
+ * ol_txrx_read_tx_lat_debugfs() - dump tx completion latency histograms
+ * @file: qdf debugfs file handler
+ * @arg: pdev object
+ *
+ * One line per peer and access category with traffic; column n holds the
+ * number of frames completed within [2^n, 2^(n + 1)) us of their tx
+ * descriptor allocation.
+ *
+ * Return: QDF_STATUS
+ */
+static QDF_STATUS ol_txrx_read_tx_lat_debugfs(qdf_debugfs_file_t file,
+					      void *arg)
+{
+	struct ol_txrx_pdev_t *pdev = (struct ol_txrx_pdev_t *)arg;
+	struct ol_txrx_vdev_t *vdev;
+	struct ol_txrx_peer_t *peer;
+
+	qdf_debugfs_printf(file, "vdev peer ac: log2 usec buckets 0..%d\n",
+			   OL_TX_LAT_HIST_BUCKETS - 1);
+
+	qdf_spin_lock_bh(&pdev->peer_ref_mutex);
+	TAILQ_FOREACH(vdev, &pdev->vdev_list, vdev_list_elem)
+		TAILQ_FOREACH(peer, &vdev->peer_list, peer_list_elem)
+			ol_txrx_print_peer_tx_lat(file, vdev, peer);
+	qdf_spin_unlock_bh(&pdev->peer_ref_mutex);
+
+	return QDF_STATUS_SUCCESS;
+}
+
+/**
+ * ol_txrx_write_tx_lat_debugfs() - reset tx completion latency histograms
+ * @priv: pdev object
+ * @buf: user buffer, content is ignored
+ * @len: buf length
+ *
+ * Return: QDF_STATUS
+ */
+static QDF_STATUS ol_txrx_write_tx_lat_debugfs(void *priv,
+					       const char *buf,
+					       qdf_size_t len)
+{
+	ol_tx_lat_clear((struct ol_txrx_pdev_t *)priv, OL_TX_LAT_ALL_VDEVS);
+
+	return QDF_STATUS_SUCCESS;
+}
+
+/**
+ * ol_txrx_tx_lat_debugfs_init() - create the tx latency histogram file
+ * @pdev: pdev object
+ *
+ * Return: None
+ */
+static void ol_txrx_tx_lat_debugfs_init(struct ol_txrx_pdev_t *pdev)
+{
+	pdev->tx_lat_debugfs_fops.show = ol_txrx_read_tx_lat_debugfs;
+	pdev->tx_lat_debugfs_fops.write = ol_txrx_write_tx_lat_debugfs;
+	pdev->tx_lat_debugfs_fops.priv = pdev;
+
+	pdev->tx_lat_debugfs_dir = qdf_debugfs_create_dir("ol_tx_lat", NULL);
+	if (!pdev->tx_lat_debugfs_dir) {
+		ol_txrx_err("error while creating debugfs dir for ol_tx_lat");
+		return;
+	}
+
+	if (!qdf_debugfs_create_file("peer_hist", DPT_DEBUGFS_PERMS,
+				     pdev->tx_lat_debugfs_dir,
+				     &pdev->tx_lat_debugfs_fops)) {
+		ol_txrx_err("peer_hist debugfs entry creation failed");
+		qdf_debugfs_remove_dir_recursive(pdev->tx_lat_debugfs_dir);
+		pdev->tx_lat_debugfs_dir = NULL;
+	}
+}
+
 static int ol_txrx_debugfs_init(struct ol_txrx_pdev_t *pdev)
 {
+	ol_txrx_tx_lat_debugfs_init(pdev);
+
 	pdev->dpt_debugfs_fops.show = ol_txrx_read_dpt_buff_debugfs;
 	pdev->dpt_debugfs_fops.write = ol_txrx_write_dpt_buff_debugfs;
 	pdev->dpt_debugfs_fops.priv = pdev;
@@ -836,6 +958,8 @@ static int ol_txrx_debugfs_init(struct ol_txrx_pdev_t *pdev)
 
 static void ol_txrx_debugfs_exit(ol_txrx_pdev_handle pdev)
 {
+	if (pdev->tx_lat_debugfs_dir)
+		qdf_debugfs_remove_dir_recursive(pdev->tx_lat_debugfs_dir);
 	qdf_debugfs_remove_dir_recursive(pdev->dpt_stats_log_dir);
 }
 #else
@@ -849,6 +973,110 @@ static inline void ol_txrx_debugfs_exit(ol_txrx_pdev_handle pdev)
 }
 #endif
 
+#ifdef WLAN_OL_TX_LAT_HIST
+/**
+ * ol_txrx_tx_lat_pdev_get() - get the pdev of the tx latency histograms
+ *
+ * Return: pdev handle, NULL if the datapath is not attached
+ */
+static struct ol_txrx_pdev_t *ol_txrx_tx_lat_pdev_get(void)
+{
+	struct ol_txrx_soc_t *soc = cds_get_context(QDF_MODULE_ID_SOC);
+
+	if (qdf_unlikely(!soc))
+		return NULL;
+
+	return ol_txrx_get_pdev_from_pdev_id(soc, OL_TXRX_PDEV_ID);
+}
+
+/**
+ * ol_txrx_tx_lat_peer_scnprintf() - format the tx latency of one peer
+ * @pdev: pdev handle
+ * @peer: peer of interest
+ * @lat: scratch histograms
+ * @buf: buffer to fill
+ * @len: size of @buf
+ *
+ * Return: number of characters written
+ */
+static int ol_txrx_tx_lat_peer_scnprintf(struct ol_txrx_pdev_t *pdev,
+					 struct ol_txrx_peer_t *peer,
+					 struct ol_tx_peer_lat *lat,
+					 char *buf, size_t len)
+{
+	static const char * const ac_name[TXRX_NUM_WMM_AC] = {
+		"BE", "BK", "VI", "VO"
+	};
+	uint32_t *hist;
+	uint32_t total;
+	int ac, bucket;
+	int ret = 0;
+
+	ol_tx_peer_lat_get(pdev, peer, lat);
+	for (ac = 0; ac < TXRX_NUM_WMM_AC; ac++) {
+		hist = lat->hist[ac];
+		total = 0;
+		for (bucket = 0; bucket < OL_TX_LAT_HIST_BUCKETS; bucket++)
+			total += hist[bucket];
+		if (!total)
+			continue;
+
+		ret += scnprintf(buf + ret, len - ret, QDF_MAC_ADDR_FMT " %s:",
+				 QDF_MAC_ADDR_REF(peer->mac_addr.raw),
+				 ac_name[ac]);
+		for (bucket = 0; bucket < OL_TX_LAT_HIST_BUCKETS; bucket++)
+			ret += scnprintf(buf + ret, len - ret, " %u",
+					 hist[bucket]);
+		ret += scnprintf(buf + ret, len - ret, "\n");
+	}
+
+	return ret;
+}
+
+int ol_txrx_tx_lat_scnprintf(uint8_t vdev_id, char *buf, size_t len)
+{
+	struct ol_txrx_pdev_t *pdev = ol_txrx_tx_lat_pdev_get();
+	struct ol_txrx_vdev_t *vdev;
+	struct ol_txrx_peer_t *peer;
+	struct ol_tx_peer_lat *lat;
+	int ret;
+
+	if (!pdev)
+		return 0;
+
+	lat = qdf_mem_malloc(sizeof(*lat));
+	if (!lat)
+		return 0;
+
+	ret = scnprintf(buf, len, "peer ac: log2 usec buckets 0..%d\n",
+			OL_TX_LAT_HIST_BUCKETS - 1);
+
+	qdf_spin_lock_bh(&pdev->peer_ref_mutex);
+	TAILQ_FOREACH(vdev, &pdev->vdev_list, vdev_list_elem) {
+		if (vdev->vdev_id != vdev_id)
+			continue;
+
+		TAILQ_FOREACH(peer, &vdev->peer_list, peer_list_elem)
+			ret += ol_txrx_tx_lat_peer_scnprintf(pdev, peer, lat,
+							     buf + ret,
+							     len - ret);
+	}
+	qdf_spin_unlock_bh(&pdev->peer_ref_mutex);
+
+	qdf_mem_free(lat);
+
+	return ret;
+}
+
+void ol_txrx_tx_lat_reset(uint8_t vdev_id)
+{
+	struct ol_txrx_pdev_t *pdev = ol_txrx_tx_lat_pdev_get();
+
+	if (pdev)
+		ol_tx_lat_clear(pdev, vdev_id);
+}
+#endif /* WLAN_OL_TX_LAT_HIST */
+
 /**
  * ol_txrx_pdev_attach() - allocate txrx pdev
  * @soc_hdl: datapath soc handle
@@ -1153,8 +1381,11 @@ ol_txrx_pdev_post_attach(struct cdp_soc_t *soc_hdl, uint8_t pdev_id)
 
 	/* Calculate single element reserved size power of 2 */
 	pdev->tx_desc.desc_reserved_size = qdf_get_pwr2(desc_element_size);
-	qdf_mem_multi_pages_alloc(pdev->osdev, &pdev->tx_desc.desc_pages,
-		pdev->tx_desc.desc_reserved_size, desc_pool_size, 0, true);
+	if (!cds_mem_acct_inject_fail(CDS_MEM_TAG_DP_TX_DESC))
+		qdf_mem_multi_pages_alloc(pdev->osdev,
+					  &pdev->tx_desc.desc_pages,
+					  pdev->tx_desc.desc_reserved_size,
+					  desc_pool_size, 0, true);
 	if ((0 == pdev->tx_desc.desc_pages.num_pages) ||
 		(!pdev->tx_desc.desc_pages.cacheable_pages)) {
 		QDF_TRACE(QDF_MODULE_ID_TXRX, QDF_TRACE_LEVEL_ERROR,
@@ -1162,6 +1393,9 @@ ol_txrx_pdev_post_attach(struct cdp_soc_t *soc_hdl, uint8_t pdev_id)
 		ret = -ENOMEM;
 		goto page_alloc_fail;
 	}
+	cds_mem_acct_alloc(CDS_MEM_TAG_DP_TX_DESC,
+			   pdev->tx_desc.desc_reserved_size * desc_pool_size,
+			   1);
 	desc_per_page = pdev->tx_desc.desc_pages.num_element_per_page;
 	pdev->tx_desc.offset_filter = desc_per_page - 1;
 	/* Calculate page divider to find page number */
@@ -1567,6 +1801,8 @@ desc_alloc_fail:
 
 	qdf_mem_multi_pages_free(pdev->osdev,
 		&pdev->tx_desc.desc_pages, 0, true);
+	cds_mem_acct_free(CDS_MEM_TAG_DP_TX_DESC,
+			  pdev->tx_desc.desc_reserved_size * desc_pool_size);
 
 page_alloc_fail:
 	if (ol_cfg_ipa_uc_offload_enabled(pdev->ctrl_pdev))
@@ -1747,6 +1983,9 @@ static void ol_txrx_pdev_pre_detach(struct cdp_soc_t *soc_hdl, uint8_t pdev_id,
 
 	qdf_mem_multi_pages_free(pdev->osdev,
 		&pdev->tx_desc.desc_pages, 0, true);
+	cds_mem_acct_free(CDS_MEM_TAG_DP_TX_DESC,
+			  pdev->tx_desc.desc_reserved_size *
+			  pdev->tx_desc.pool_size);
 	pdev->tx_desc.freelist = NULL;
 
 	/* Detach micro controller data path offload resource */
@@ -4884,6 +5123,7 @@ static QDF_STATUS ol_txrx_clear_stats(struct cdp_soc_t *soc_hdl,
 	switch (value) {
 	case CDP_TXRX_PATH_STATS:
 		ol_txrx_stats_clear(pdev);
+		ol_tx_lat_clear(pdev, OL_TX_LAT_ALL_VDEVS);
 		break;
 	case CDP_TXRX_TSO_STATS:
 		ol_txrx_tso_stats_clear(pdev);
@@ -6071,6 +6311,8 @@ void ol_register_packetdump_callback(struct cdp_soc_t *soc_hdl, uint8_t pdev_id,
 
 	pdev->ol_tx_packetdump_cb = ol_tx_packetdump_cb;
 	pdev->ol_rx_packetdump_cb = ol_rx_packetdump_cb;
+	cds_pkt_trace_user_set(CDS_PKT_TRACE_USER_PKT_DUMP,
+			       ol_rx_packetdump_cb);
 }
 
 /**
@@ -6100,6 +6342,7 @@ void ol_deregister_packetdump_callback(struct cdp_soc_t *soc_hdl,
 
 	pdev->ol_tx_packetdump_cb = NULL;
 	pdev->ol_rx_packetdump_cb = NULL;
+	cds_pkt_trace_user_set(CDS_PKT_TRACE_USER_PKT_DUMP, false);
 }
 
 static struct cdp_cmn_ops ol_ops_cmn = {
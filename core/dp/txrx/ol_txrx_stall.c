@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2021 The Linux Foundation. All rights reserved.
+ *
+ * Permission to use, copy, modify, and/or distribute this software for
+ * any purpose with or without fee is hereby granted, provided that the
+ * above copyright notice and this permission notice appear in all
+ * copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+ * WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+ * AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+ * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR
+ * PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+ * TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/**
+ * DOC: ol_txrx_stall.c
+ *
+ * Sampling of the ol datapath state for the host data stall detector
+ */
+
+#include <qdf_types.h>
+#include <qdf_time.h>
+#include <cds_api.h>
+#include <cds_sched.h>
+#include <ol_htt_api.h>
+#include <ol_txrx_api.h>
+#include <ol_txrx_types.h>
+#include <ol_txrx_internal.h>
+#include <ol_txrx.h>
+
+#ifdef QCA_LL_TX_FLOW_CONTROL_V2
+/**
+ * ol_txrx_stall_tx_pools_get() - sample the tx flow pools
+ * @pdev: pdev handle
+ * @signals: tx descriptor signals to update
+ *
+ * Descriptors held by the flow pools are free for the purpose of the
+ * stall detector; they are only counted out of the global pool.
+ *
+ * Return: None
+ */
+static void ol_txrx_stall_tx_pools_get(struct ol_txrx_pdev_t *pdev,
+				       struct ol_txrx_stall_signals *signals)
+{
+	struct ol_tx_flow_pool_t *pool;
+	uint32_t tx_desc_free = pdev->tx_desc.num_free;
+
+	qdf_spin_lock_bh(&pdev->tx_desc.flow_pool_list_lock);
+	TAILQ_FOREACH(pool, &pdev->tx_desc.flow_pool_list,
+		      flow_pool_list_elem) {
+		tx_desc_free += READ_ONCE(pool->avail_desc);
+		if (pool->status == FLOW_POOL_ACTIVE_PAUSED ||
+		    pool->status == FLOW_POOL_NON_PRIO_PAUSED)
+			signals->tx_flow_pools_paused++;
+	}
+	qdf_spin_unlock_bh(&pdev->tx_desc.flow_pool_list_lock);
+
+	signals->tx_desc_free = qdf_min(tx_desc_free,
+					(uint32_t)pdev->tx_desc.pool_size);
+}
+#elif defined(QCA_LL_PDEV_TX_FLOW_CONTROL)
+static void ol_txrx_stall_tx_pools_get(struct ol_txrx_pdev_t *pdev,
+				       struct ol_txrx_stall_signals *signals)
+{
+	signals->tx_desc_free = pdev->tx_desc.num_free;
+	if (pdev->tx_desc.status == FLOW_POOL_ACTIVE_PAUSED ||
+	    pdev->tx_desc.status == FLOW_POOL_NON_PRIO_PAUSED)
+		signals->tx_flow_pools_paused = 1;
+}
+#else
+static void ol_txrx_stall_tx_pools_get(struct ol_txrx_pdev_t *pdev,
+				       struct ol_txrx_stall_signals *signals)
+{
+	signals->tx_desc_free = pdev->tx_desc.num_free;
+}
+#endif
+
+QDF_STATUS ol_txrx_get_stall_signals(struct ol_txrx_stall_signals *signals)
+{
+	struct ol_txrx_soc_t *soc = cds_get_context(QDF_MODULE_ID_SOC);
+	ol_txrx_pdev_handle pdev;
+	uint32_t now_us;
+
+	qdf_mem_zero(signals, sizeof(*signals));
+
+	if (qdf_unlikely(!soc))
+		return QDF_STATUS_E_INVAL;
+
+	pdev = ol_txrx_get_pdev_from_pdev_id(soc, OL_TXRX_PDEV_ID);
+	if (!pdev)
+		return QDF_STATUS_E_INVAL;
+
+	signals->rx_thread_queue_len = cds_get_ol_rx_queue_len();
+
+	signals->tx_desc_pool_size = pdev->tx_desc.pool_size;
+	ol_txrx_stall_tx_pools_get(pdev, signals);
+
+	/* 0 until the first tx completion */
+	if (pdev->tx_compl_ts_us) {
+		now_us = (uint32_t)qdf_get_monotonic_boottime();
+		signals->tx_compl_age_ms = (now_us - pdev->tx_compl_ts_us) /
+					   USEC_PER_MSEC;
+	}
+
+	if (pdev->htt_pdev)
+		htt_rx_ring_fill_get(pdev->htt_pdev,
+				     &signals->rx_ring_fill_cnt,
+				     &signals->rx_ring_fill_level);
+
+	return QDF_STATUS_SUCCESS;
+}
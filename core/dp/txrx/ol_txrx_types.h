@@ -168,6 +168,10 @@ struct ol_tx_desc_t {
 #ifdef QCA_COMPUTE_TX_DELAY
 	uint32_t entry_timestamp_ticks;
 #endif
+#ifdef QCA_SUPPORT_TXRX_LOCAL_PEER_ID
+	/* descriptor allocation time, for the tx completion latency */
+	uint32_t enqueue_ts_us;
+#endif
 
 #ifdef DESC_TIMESTAMP_DEBUG_INFO
 	struct {
@@ -261,6 +265,22 @@ enum txrx_wmm_ac {
 		(((_tid) ^ ((_tid) >> 1)) & 0x1) ? TXRX_WMM_AC_BK : \
 		TXRX_WMM_AC_BE)
 
+/*
+ * Tx completion latency histogram: log2 buckets of the time between tx
+ * descriptor allocation and tx completion, in usec. Bucket 0 counts
+ * latencies below 2 us, bucket n counts [2^n, 2^(n + 1)) us and the last
+ * bucket everything from 2^(OL_TX_LAT_HIST_BUCKETS - 1) us (~0.5 s) up.
+ */
+#define OL_TX_LAT_HIST_BUCKETS 20
+
+/**
+ * struct ol_tx_peer_lat - tx completion latency of a peer on one CPU
+ * @hist: log2 latency histogram per WMM access category
+ */
+struct ol_tx_peer_lat {
+	uint32_t hist[TXRX_NUM_WMM_AC][OL_TX_LAT_HIST_BUCKETS];
+};
+
 enum {
 	OL_TX_SCHED_WRR_ADV_CAT_BE,
 	OL_TX_SCHED_WRR_ADV_CAT_BK,
@@ -511,6 +531,7 @@ struct ol_txrx_pool_stats {
  * @ref_cnt: pool's ref count
  * @stop_priority_th: Threshold to stop priority queue
  * @start_priority_th: Threshold to start priority queue
+ * @freed_desc: descriptors freed back to the pool, wraps around
  */
 struct ol_tx_flow_pool_t {
 	TAILQ_ENTRY(ol_tx_flow_pool_t) flow_pool_list_elem;
@@ -530,6 +551,7 @@ struct ol_tx_flow_pool_t {
 	qdf_atomic_t ref_cnt;
 	uint16_t stop_priority_th;
 	uint16_t start_priority_th;
+	uint32_t freed_desc;
 };
 #endif
 
@@ -788,6 +810,8 @@ struct ol_txrx_pdev_t {
 	struct {
 		uint16_t pool_size;
 		uint16_t num_free;
+		/* descriptors freed back to the pool, wraps around */
+		uint32_t num_freed;
 		union ol_tx_desc_list_elem_t *array;
 		union ol_tx_desc_list_elem_t *freelist;
 #ifdef QCA_LL_TX_FLOW_CONTROL_V2
@@ -977,6 +1001,13 @@ struct ol_txrx_pdev_t {
 		qdf_spinlock_t lock;
 		ol_txrx_peer_handle map[OL_TXRX_NUM_LOCAL_PEER_IDS];
 	} local_peer_ids;
+	/*
+	 * tx completion latency, indexed by local peer ID: the per CPU
+	 * histograms (NULL if the alloc failed) and the lookup key of the
+	 * peer owning each ID, read locklessly in the tx completion path
+	 */
+	struct ol_tx_peer_lat __percpu *tx_lat;
+	uint64_t tx_lat_key[OL_TXRX_NUM_LOCAL_PEER_IDS];
 #endif
 
 #ifdef QCA_COMPUTE_TX_DELAY
@@ -1092,6 +1123,10 @@ struct ol_txrx_pdev_t {
 	struct dentry *dpt_stats_log_dir;
 	enum qdf_dpt_debugfs_state state;
 	struct qdf_debugfs_fops dpt_debugfs_fops;
+	struct dentry *tx_lat_debugfs_dir;
+	struct qdf_debugfs_fops tx_lat_debugfs_fops;
+	/* time of the last tx completion, in usec */
+	uint32_t tx_compl_ts_us;
 
 #ifdef IPA_OFFLOAD
 	ipa_uc_op_cb_type ipa_uc_op_cb;
@@ -0,0 +1,588 @@
+/*
+ * Copyright (c) 2021 The Linux Foundation. All rights reserved.
+ *
+ * Permission to use, copy, modify, and/or distribute this software for
+ * any purpose with or without fee is hereby granted, provided that the
+ * above copyright notice and this permission notice appear in all
+ * copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+ * WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+ * AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+ * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR
+ * PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+ * TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/**
+ * DOC: ol_txrx_bench.c
+ *
+ * Microbenchmarks of the ol rx paths and the packet trace hook.
+ *
+ * The suite needs the driver loaded for its config, qdf device and soc,
+ * but no attached pdev or target: it runs on the fake htt and txrx pdevs
+ * of ol_txrx_bench_htt.c, which own a real rx ring. With full reorder
+ * offload, synthetic in order rx indications are handed to
+ * ol_rx_in_order_indication_handler() and, with the fast path, to
+ * htt_t2h_msg_handler_fast() as the CE would deliver them.
+ *
+ * The tx fast path and the tx completions are not covered: ol_tx_ll_fast()
+ * posts straight to the CE ring and ol_tx_completion_handler() releases
+ * HTC runtime PM votes and flow pool descriptors, all of which belong to
+ * an attached pdev.
+ *
+ * Frames go through a private vdev and peer, so none reaches the network
+ * stack. Frames delivered by the datapath are collected by a sink in place
+ * of the OS shim. Allocations are read from the global nbuf count.
+ */
+
+#include <qdf_mem.h>
+#include <qdf_nbuf.h>
+#include <qdf_time.h>
+#include <qdf_trace.h>
+#include <qdf_util.h>
+#include <cds_api.h>
+#include <cds_pkt_trace.h>
+#include <htt_internal.h>
+#include <ol_cfg.h>
+#include <ol_txrx_htt_api.h>
+#include <ol_txrx_types.h>
+#include <ol_rx_reorder.h>
+#include <ol_txrx_bench.h>
+#include <ol_txrx_bench_htt.h>
+
+/* frames allocated and not yet freed, from the global nbuf count */
+#define ol_txrx_bench_nbufs() ((int64_t)qdf_nbuf_count_get())
+
+/* frames per round, one full block ack window */
+#define OL_TXRX_BENCH_WIN_SZ 64
+#define OL_TXRX_BENCH_ROUNDS 2000
+#define OL_TXRX_BENCH_TID 0
+#define OL_TXRX_BENCH_PEER_ID 1
+#define OL_TXRX_BENCH_FRAME_LEN 64
+
+/**
+ * struct ol_txrx_bench_ctx - benchmark state
+ * @htt: fake htt and txrx pdevs
+ * @vdev: private vdev of the fake txrx pdev
+ * @peer: private peer of @vdev
+ * @array: rx reorder array of the benchmark tid
+ * @pool: injected frames
+ * @returned: whether pool frame i came back in the current round
+ * @delivered: frames handed to the sink in the current round
+ * @num_delivered: number of valid entries of @delivered
+ * @overflow: frames delivered beyond the capacity of @delivered
+ */
+struct ol_txrx_bench_ctx {
+	struct ol_txrx_bench_htt htt;
+	struct ol_txrx_vdev_t vdev;
+	struct ol_txrx_peer_t peer;
+	struct ol_rx_reorder_array_elem_t array[OL_TXRX_BENCH_WIN_SZ];
+	qdf_nbuf_t pool[OL_TXRX_BENCH_WIN_SZ];
+	bool returned[OL_TXRX_BENCH_WIN_SZ];
+	qdf_nbuf_t delivered[OL_TXRX_BENCH_WIN_SZ];
+	uint32_t num_delivered;
+	uint32_t overflow;
+};
+
+/**
+ * struct ol_txrx_bench_result - outcome of one benchmark
+ * @ns: time spent in the measured code, in nsec
+ * @pkts: frames processed
+ * @allocs: nbufs allocated and not freed by the measured code
+ */
+struct ol_txrx_bench_result {
+	uint64_t ns;
+	uint32_t pkts;
+	uint32_t allocs;
+};
+
+static void ol_txrx_bench_rx_sink(struct ol_txrx_vdev_t *vdev,
+				  struct ol_txrx_peer_t *peer,
+				  unsigned int tid, qdf_nbuf_t msdu_list)
+{
+	struct ol_txrx_bench_ctx *ctx =
+		qdf_container_of(vdev, struct ol_txrx_bench_ctx, vdev);
+	qdf_nbuf_t msdu = msdu_list;
+	qdf_nbuf_t next;
+
+	while (msdu) {
+		next = qdf_nbuf_next(msdu);
+		qdf_nbuf_set_next(msdu, NULL);
+		if (ctx->num_delivered < OL_TXRX_BENCH_WIN_SZ) {
+			ctx->delivered[ctx->num_delivered++] = msdu;
+		} else {
+			ctx->overflow++;
+			qdf_nbuf_free(msdu);
+		}
+		msdu = next;
+	}
+}
+
+static qdf_nbuf_t ol_txrx_bench_frame_alloc(void)
+{
+	qdf_nbuf_t nbuf;
+
+	nbuf = qdf_nbuf_alloc(NULL, HTT_RX_BUF_SIZE, 0, 4, false);
+	if (!nbuf)
+		return NULL;
+
+	/* zeroed rx descriptor: seq num 0, no error, not a fragment */
+	qdf_mem_zero(htt_rx_desc(nbuf), sizeof(struct htt_host_rx_desc_base));
+	qdf_nbuf_reserve(nbuf, HTT_RX_STD_DESC_RESERVATION);
+	qdf_nbuf_put_tail(nbuf, OL_TXRX_BENCH_FRAME_LEN);
+
+	return nbuf;
+}
+
+/**
+ * ol_txrx_bench_measure() - account the measured section of one round
+ * @result: benchmark outcome to update
+ * @start_ns: time the section started at
+ * @start_nbufs: ol_txrx_bench_nbufs() at the start of the section
+ * @pkts: frames processed in the section
+ *
+ * Return: None
+ */
+static void ol_txrx_bench_measure(struct ol_txrx_bench_result *result,
+				  uint64_t start_ns, int64_t start_nbufs,
+				  uint32_t pkts)
+{
+	int64_t allocs = ol_txrx_bench_nbufs() - start_nbufs;
+
+	result->ns += qdf_get_monotonic_boottime_ns() - start_ns;
+	result->pkts += pkts;
+	if (allocs > 0)
+		result->allocs += allocs;
+}
+
+/**
+ * ol_txrx_bench_collect() - check the frames delivered in one round
+ * @ctx: benchmark state
+ * @expected: number of frames the round should have delivered
+ *
+ * Not part of the measured time. Frees the delivered frames which were
+ * not injected and replaces the injected frames the datapath consumed.
+ *
+ * Return: 0 if @expected frames were delivered, 1 otherwise
+ */
+static uint32_t ol_txrx_bench_collect(struct ol_txrx_bench_ctx *ctx,
+				      uint32_t expected)
+{
+	uint32_t delivered = ctx->num_delivered + ctx->overflow;
+	uint32_t i, j;
+
+	qdf_mem_zero(ctx->returned, sizeof(ctx->returned));
+
+	for (i = 0; i < ctx->num_delivered; i++) {
+		for (j = 0; j < OL_TXRX_BENCH_WIN_SZ; j++) {
+			if (ctx->pool[j] == ctx->delivered[i]) {
+				ctx->returned[j] = true;
+				break;
+			}
+		}
+		if (j == OL_TXRX_BENCH_WIN_SZ)
+			qdf_nbuf_free(ctx->delivered[i]);
+	}
+
+	for (j = 0; j < OL_TXRX_BENCH_WIN_SZ; j++) {
+		if (ctx->returned[j])
+			continue;
+		ctx->pool[j] = ol_txrx_bench_frame_alloc();
+		if (!ctx->pool[j])
+			return 1;
+	}
+
+	ctx->num_delivered = 0;
+	ctx->overflow = 0;
+
+	if (delivered != expected) {
+		qdf_nofl_err("ol_txrx_bench: delivered %u frames, expected %u",
+			     delivered, expected);
+		return 1;
+	}
+
+	return 0;
+}
+
+/**
+ * ol_txrx_bench_drain() - free the frames delivered in one round
+ * @ctx: benchmark state
+ * @expected: number of frames the round should have delivered
+ *
+ * Not part of the measured time. Used by the benchmarks whose frames come
+ * from the rx ring rather than from @ctx->pool.
+ *
+ * Return: 0 if @expected frames were delivered, 1 otherwise
+ */
+static uint32_t ol_txrx_bench_drain(struct ol_txrx_bench_ctx *ctx,
+				    uint32_t expected)
+{
+	uint32_t delivered = ctx->num_delivered + ctx->overflow;
+	uint32_t i;
+
+	for (i = 0; i < ctx->num_delivered; i++)
+		qdf_nbuf_free(ctx->delivered[i]);
+
+	ctx->num_delivered = 0;
+	ctx->overflow = 0;
+
+	if (delivered != expected) {
+		qdf_nofl_err("ol_txrx_bench: delivered %u frames, expected %u",
+			     delivered, expected);
+		return 1;
+	}
+
+	return 0;
+}
+
+/**
+ * ol_txrx_bench_rx_ind_msg() - have the fake target indicate one window
+ * @ctx: benchmark state
+ * @htc_hdr: whether the message comes through the CE fast path
+ *
+ * Return: the rx in order indication, NULL on error
+ */
+static qdf_nbuf_t ol_txrx_bench_rx_ind_msg(struct ol_txrx_bench_ctx *ctx,
+					   bool htc_hdr)
+{
+	qdf_nbuf_t msg;
+
+	msg = ol_txrx_bench_htt_rx_in_ord_ind(&ctx->htt, OL_TXRX_BENCH_WIN_SZ,
+					      OL_TXRX_BENCH_FRAME_LEN,
+					      htc_hdr);
+	if (!msg)
+		qdf_nofl_err("ol_txrx_bench: rx ring holds less than %u bufs",
+			     OL_TXRX_BENCH_WIN_SZ);
+
+	return msg;
+}
+
+/**
+ * ol_txrx_bench_rx_reorder_in_order() - store and release one MPDU at a time
+ * @ctx: benchmark state
+ * @result: benchmark outcome
+ *
+ * The common case of an aggregate arriving in order: every MPDU is
+ * released right after it is stored.
+ *
+ * Return: number of errors
+ */
+static uint32_t
+ol_txrx_bench_rx_reorder_in_order(struct ol_txrx_bench_ctx *ctx,
+				  struct ol_txrx_bench_result *result)
+{
+	struct ol_txrx_pdev_t *pdev = ctx->vdev.pdev;
+	uint32_t errors = 0;
+	int64_t nbufs;
+	uint64_t start;
+	int round, idx;
+
+	for (round = 0; round < OL_TXRX_BENCH_ROUNDS; round++) {
+		nbufs = ol_txrx_bench_nbufs();
+		start = qdf_get_monotonic_boottime_ns();
+		for (idx = 0; idx < OL_TXRX_BENCH_WIN_SZ; idx++) {
+			ol_rx_reorder_store(pdev, &ctx->peer,
+					    OL_TXRX_BENCH_TID, idx,
+					    ctx->pool[idx], ctx->pool[idx]);
+			ol_rx_reorder_release(&ctx->vdev, &ctx->peer,
+					      OL_TXRX_BENCH_TID, idx, idx + 1);
+		}
+		ol_txrx_bench_measure(result, start, nbufs,
+				      OL_TXRX_BENCH_WIN_SZ);
+
+		errors += ol_txrx_bench_collect(ctx, OL_TXRX_BENCH_WIN_SZ);
+		if (errors)
+			break;
+	}
+
+	return errors;
+}
+
+/**
+ * ol_txrx_bench_rx_reorder_burst() - store a reversed window, release once
+ * @ctx: benchmark state
+ * @result: benchmark outcome
+ *
+ * The worst case of an aggregate arriving in reverse order: the whole
+ * window is buffered and released by a single call.
+ *
+ * Return: number of errors
+ */
+static uint32_t
+ol_txrx_bench_rx_reorder_burst(struct ol_txrx_bench_ctx *ctx,
+			       struct ol_txrx_bench_result *result)
+{
+	struct ol_txrx_pdev_t *pdev = ctx->vdev.pdev;
+	uint32_t errors = 0;
+	int64_t nbufs;
+	uint64_t start;
+	int round, idx;
+
+	for (round = 0; round < OL_TXRX_BENCH_ROUNDS; round++) {
+		nbufs = ol_txrx_bench_nbufs();
+		start = qdf_get_monotonic_boottime_ns();
+		for (idx = OL_TXRX_BENCH_WIN_SZ - 1; idx >= 0; idx--)
+			ol_rx_reorder_store(pdev, &ctx->peer,
+					    OL_TXRX_BENCH_TID, idx,
+					    ctx->pool[idx], ctx->pool[idx]);
+		/* idx_end == idx_start releases the full window */
+		ol_rx_reorder_release(&ctx->vdev, &ctx->peer,
+				      OL_TXRX_BENCH_TID, 0, 0);
+		ol_txrx_bench_measure(result, start, nbufs,
+				      OL_TXRX_BENCH_WIN_SZ);
+
+		errors += ol_txrx_bench_collect(ctx, OL_TXRX_BENCH_WIN_SZ);
+		if (errors)
+			break;
+	}
+
+	return errors;
+}
+
+/**
+ * ol_txrx_bench_rx_in_ord_ind() - handle in order rx indications
+ * @ctx: benchmark state
+ * @result: benchmark outcome
+ *
+ * One indication of a full window per round, from the ring pop to the
+ * delivery to the peer, including the rx ring replenish.
+ *
+ * Return: number of errors
+ */
+static uint32_t
+ol_txrx_bench_rx_in_ord_ind(struct ol_txrx_bench_ctx *ctx,
+			    struct ol_txrx_bench_result *result)
+{
+	uint32_t errors = 0;
+	qdf_nbuf_t msg;
+	int64_t nbufs;
+	uint64_t start;
+	int round;
+
+	for (round = 0; round < OL_TXRX_BENCH_ROUNDS; round++) {
+		msg = ol_txrx_bench_rx_ind_msg(ctx, false);
+		if (!msg)
+			return errors + 1;
+
+		nbufs = ol_txrx_bench_nbufs();
+		start = qdf_get_monotonic_boottime_ns();
+		ol_rx_in_order_indication_handler(ctx->htt.txrx_pdev, msg,
+						  OL_TXRX_BENCH_PEER_ID,
+						  OL_TXRX_BENCH_TID, 0);
+		ol_txrx_bench_measure(result, start, nbufs,
+				      OL_TXRX_BENCH_WIN_SZ);
+
+		errors += ol_txrx_bench_drain(ctx, OL_TXRX_BENCH_WIN_SZ);
+		if (errors)
+			break;
+	}
+
+	return errors;
+}
+
+#ifdef WLAN_FEATURE_FASTPATH
+/**
+ * ol_txrx_bench_htt_t2h_fast() - in order rx indications from the CE
+ * @ctx: benchmark state
+ * @result: benchmark outcome
+ *
+ * As ol_txrx_bench_rx_in_ord_ind(), entered through the HTT fast path
+ * handler with the message laid out as the CE delivers it.
+ *
+ * Return: number of errors
+ */
+static uint32_t
+ol_txrx_bench_htt_t2h_fast(struct ol_txrx_bench_ctx *ctx,
+			   struct ol_txrx_bench_result *result)
+{
+	uint32_t errors = 0;
+	qdf_nbuf_t msg;
+	int64_t nbufs;
+	uint64_t start;
+	int round;
+
+	for (round = 0; round < OL_TXRX_BENCH_ROUNDS; round++) {
+		msg = ol_txrx_bench_rx_ind_msg(ctx, true);
+		if (!msg)
+			return errors + 1;
+
+		nbufs = ol_txrx_bench_nbufs();
+		start = qdf_get_monotonic_boottime_ns();
+		htt_t2h_msg_handler_fast(ctx->htt.htt_pdev, &msg, 1);
+		ol_txrx_bench_measure(result, start, nbufs,
+				      OL_TXRX_BENCH_WIN_SZ);
+
+		errors += ol_txrx_bench_drain(ctx, OL_TXRX_BENCH_WIN_SZ);
+		if (errors)
+			break;
+	}
+
+	return errors;
+}
+#endif /* WLAN_FEATURE_FASTPATH */
+
+/**
+ * ol_txrx_bench_pkt_trace_ring() - cost of an enabled packet trace hook
+ * @ctx: benchmark state
+ * @result: benchmark outcome
+ *
+ * Return: number of errors
+ */
+static uint32_t
+ol_txrx_bench_pkt_trace_ring(struct ol_txrx_bench_ctx *ctx,
+			     struct ol_txrx_bench_result *result)
+{
+	bool was_enabled = cds_pkt_trace_user_enabled(CDS_PKT_TRACE_USER_RING);
+	uint32_t i, num = OL_TXRX_BENCH_ROUNDS * OL_TXRX_BENCH_WIN_SZ;
+	int64_t nbufs;
+	uint64_t start;
+
+	if (cds_pkt_trace_user_set(CDS_PKT_TRACE_USER_RING, true))
+		return 1;
+
+	nbufs = ol_txrx_bench_nbufs();
+	start = qdf_get_monotonic_boottime_ns();
+	for (i = 0; i < num; i++)
+		cds_pkt_trace_record(CDS_PKT_TRACE_EVENT_OL_TX,
+				     ctx->pool[i & (OL_TXRX_BENCH_WIN_SZ - 1)],
+				     ctx->vdev.vdev_id, i, 0);
+	ol_txrx_bench_measure(result, start, nbufs, num);
+
+	if (!was_enabled) {
+		cds_pkt_trace_user_set(CDS_PKT_TRACE_USER_RING, false);
+		cds_pkt_trace_clear();
+	}
+
+	return 0;
+}
+
+static void ol_txrx_bench_destroy(struct ol_txrx_bench_ctx *ctx)
+{
+	int i;
+
+	for (i = 0; i < OL_TXRX_BENCH_WIN_SZ; i++)
+		if (ctx->pool[i])
+			qdf_nbuf_free(ctx->pool[i]);
+
+	ol_txrx_bench_htt_detach(&ctx->htt);
+	qdf_mem_free(ctx);
+}
+
+static struct ol_txrx_bench_ctx *ol_txrx_bench_create(void)
+{
+	struct ol_txrx_bench_ctx *ctx;
+	struct ol_rx_reorder_t *rx_reorder;
+	int i;
+
+	if (!cds_get_context(QDF_MODULE_ID_SOC)) {
+		qdf_nofl_err("ol_txrx_bench: soc is NULL");
+		return NULL;
+	}
+
+	ctx = qdf_mem_malloc(sizeof(*ctx));
+	if (!ctx)
+		return NULL;
+
+	if (QDF_IS_STATUS_ERROR(ol_txrx_bench_htt_attach(&ctx->htt,
+							 &ctx->peer,
+							 OL_TXRX_BENCH_PEER_ID,
+							 OL_TXRX_BENCH_TID))) {
+		qdf_nofl_err("ol_txrx_bench: fake htt pdev attach failed");
+		qdf_mem_free(ctx);
+		return NULL;
+	}
+
+	ctx->vdev.pdev = ctx->htt.txrx_pdev;
+	ctx->peer.vdev = &ctx->vdev;
+	ctx->peer.rx_opt_proc = ol_txrx_bench_rx_sink;
+
+	rx_reorder = &ctx->peer.tids_rx_reorder[OL_TXRX_BENCH_TID];
+	ol_rx_reorder_init(rx_reorder, OL_TXRX_BENCH_TID);
+	rx_reorder->array = ctx->array;
+	rx_reorder->win_sz = OL_TXRX_BENCH_WIN_SZ;
+	rx_reorder->win_sz_mask = OL_TXRX_BENCH_WIN_SZ - 1;
+
+	for (i = 0; i < OL_TXRX_BENCH_WIN_SZ; i++) {
+		ctx->pool[i] = ol_txrx_bench_frame_alloc();
+		if (!ctx->pool[i]) {
+			ol_txrx_bench_destroy(ctx);
+			return NULL;
+		}
+	}
+
+	return ctx;
+}
+
+typedef uint32_t (*ol_txrx_bench_fn)(struct ol_txrx_bench_ctx *ctx,
+				     struct ol_txrx_bench_result *result);
+
+static uint32_t ol_txrx_bench_run(struct ol_txrx_bench_ctx *ctx,
+				  const char *name, ol_txrx_bench_fn fn)
+{
+	struct ol_txrx_bench_result result = { 0 };
+	uint32_t errors;
+	uint32_t allocs_milli;
+
+	errors = fn(ctx, &result);
+	if (errors || !result.pkts) {
+		qdf_nofl_err("ol_txrx_bench: %s failed", name);
+		return errors ? errors : 1;
+	}
+
+	allocs_milli = (uint32_t)qdf_do_div((uint64_t)result.allocs * 1000,
+					    result.pkts);
+	qdf_nofl_info("ol_txrx_bench: %s: %u pkts %llu ns/pkt %u.%03u allocs/pkt",
+		      name, result.pkts, qdf_do_div(result.ns, result.pkts),
+		      allocs_milli / 1000, allocs_milli % 1000);
+
+	return 0;
+}
+
+uint32_t ol_txrx_bench(void)
+{
+	struct cdp_cfg *ctrl_pdev = cds_get_context(QDF_MODULE_ID_CFG);
+	struct ol_txrx_bench_ctx *ctx;
+	uint32_t errors = 0;
+
+	if (!ctrl_pdev) {
+		qdf_nofl_err("ol_txrx_bench: cfg is NULL");
+		return 1;
+	}
+
+	if (ol_cfg_is_high_latency(ctrl_pdev)) {
+		qdf_nofl_info("ol_txrx_bench: skipped, low latency only");
+		return 0;
+	}
+
+	ctx = ol_txrx_bench_create();
+	if (!ctx)
+		return 1;
+
+	errors += ol_txrx_bench_run(ctx, "rx_reorder_in_order",
+				    ol_txrx_bench_rx_reorder_in_order);
+	errors += ol_txrx_bench_run(ctx, "rx_reorder_burst",
+				    ol_txrx_bench_rx_reorder_burst);
+
+	/* monitor mode indications go to the self peer, not to ours */
+	if (!ctx->htt.htt_pdev->cfg.is_full_reorder_offload ||
+	    cds_get_conparam() == QDF_GLOBAL_MONITOR_MODE) {
+		qdf_nofl_info("ol_txrx_bench: rx_in_ord_ind skipped");
+	} else {
+		errors += ol_txrx_bench_run(ctx, "rx_in_ord_ind",
+					    ol_txrx_bench_rx_in_ord_ind);
+#ifdef WLAN_FEATURE_FASTPATH
+		errors += ol_txrx_bench_run(ctx, "htt_t2h_fast_rx_in_ord_ind",
+					    ol_txrx_bench_htt_t2h_fast);
+#endif
+	}
+
+	errors += ol_txrx_bench_run(ctx, "pkt_trace_ring",
+				    ol_txrx_bench_pkt_trace_ring);
+
+	ol_txrx_bench_destroy(ctx);
+
+	return errors;
+}
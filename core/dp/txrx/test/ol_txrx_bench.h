@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2021 The Linux Foundation. All rights reserved.
+ *
+ * Permission to use, copy, modify, and/or distribute this software for
+ * any purpose with or without fee is hereby granted, provided that the
+ * above copyright notice and this permission notice appear in all
+ * copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+ * WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+ * AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+ * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR
+ * PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+ * TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef __OL_TXRX_BENCH_H
+#define __OL_TXRX_BENCH_H
+
+#ifdef WLAN_OL_TXRX_BENCH
+/**
+ * ol_txrx_bench() - run the ol rx and packet trace microbenchmarks
+ *
+ * Needs a loaded LL driver but no attached pdev: the rx paths run on a fake
+ * htt pdev, fed with synthetic HTT messages. The tx fast path and the tx
+ * completions are not covered. Logs ns/packet and nbuf allocations/packet
+ * of each benchmark.
+ *
+ * Return: number of failed benchmarks
+ */
+uint32_t ol_txrx_bench(void);
+#else
+static inline uint32_t ol_txrx_bench(void)
+{
+	return 0;
+}
+#endif /* WLAN_OL_TXRX_BENCH */
+
+#endif /* __OL_TXRX_BENCH_H */
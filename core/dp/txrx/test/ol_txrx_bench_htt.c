@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2021 The Linux Foundation. All rights reserved.
+ *
+ * Permission to use, copy, modify, and/or distribute this software for
+ * any purpose with or without fee is hereby granted, provided that the
+ * above copyright notice and this permission notice appear in all
+ * copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+ * WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+ * AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+ * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR
+ * PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+ * TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/**
+ * DOC: ol_txrx_bench_htt.c
+ *
+ * Fake htt pdev and target for the ol datapath benchmarks.
+ *
+ * The htt pdev owns a real rx ring, allocated and refilled by the htt rx
+ * code, but is not connected to HTC: the benchmarks play the target by
+ * consuming ring buffers and writing the target to host messages which
+ * the CE would deliver, then hand them to the HTT message handlers.
+ */
+
+#include <qdf_mem.h>
+#include <qdf_nbuf.h>
+#include <cds_api.h>
+#include <htc_api.h>            /* HTC_HEADER_LEN */
+#include <htc.h>                /* HTC_HDR_ALIGNMENT_PADDING */
+#include <htt.h>                /* HTT_T2H_MSG_TYPE, etc. */
+#include <ol_cfg.h>
+#include <ol_txrx_peer_find.h>
+#include <ol_txrx_bench_htt.h>
+
+/* size of the CE rx buffers of the HTT target to host pipe */
+#define OL_TXRX_BENCH_HTT_MSG_SIZE 2048
+
+QDF_STATUS ol_txrx_bench_htt_attach(struct ol_txrx_bench_htt *htt,
+				    struct ol_txrx_peer_t *peer,
+				    uint16_t peer_id, uint8_t tid)
+{
+	struct cdp_cfg *ctrl_pdev = cds_get_context(QDF_MODULE_ID_CFG);
+	qdf_device_t osdev = cds_get_context(QDF_MODULE_ID_QDF_DEVICE);
+	struct ol_txrx_pdev_t *txrx_pdev;
+	struct htt_pdev_t *htt_pdev;
+
+	qdf_mem_zero(htt, sizeof(*htt));
+
+	if (!ctrl_pdev || !osdev) {
+		qdf_nofl_err("ol_txrx_bench: cfg or qdf device is NULL");
+		return QDF_STATUS_E_INVAL;
+	}
+
+	if (peer_id > ol_cfg_max_peer_id(ctrl_pdev))
+		return QDF_STATUS_E_INVAL;
+
+	txrx_pdev = qdf_mem_malloc(sizeof(*txrx_pdev));
+	if (!txrx_pdev)
+		return QDF_STATUS_E_NOMEM;
+
+	htt_pdev = qdf_mem_malloc(sizeof(*htt_pdev));
+	if (!htt_pdev)
+		goto free_txrx_pdev;
+
+	/* the fields ol_txrx_pdev_attach() and htt_pdev_alloc() set for rx */
+	txrx_pdev->ctrl_pdev = ctrl_pdev;
+	txrx_pdev->osdev = osdev;
+	txrx_pdev->id = OL_TXRX_PDEV_ID;
+	txrx_pdev->htt_pdev = htt_pdev;
+	txrx_pdev->cfg.is_high_latency = ol_cfg_is_high_latency(ctrl_pdev);
+	qdf_spinlock_create(&txrx_pdev->peer_ref_mutex);
+
+	htt_pdev->osdev = osdev;
+	htt_pdev->ctrl_pdev = ctrl_pdev;
+	htt_pdev->txrx_pdev = txrx_pdev;
+	htt_pdev->cfg.is_high_latency = txrx_pdev->cfg.is_high_latency;
+	htt_pdev->cfg.is_full_reorder_offload =
+		ol_cfg_is_full_reorder_offload(ctrl_pdev);
+
+	if (ol_txrx_peer_find_attach(txrx_pdev))
+		goto free_htt_pdev;
+
+	txrx_pdev->peer_id_to_obj_map[peer_id].peer = peer;
+	peer->valid = 1;
+
+	/* same config as the attached pdev, so the htt_rx_* ops stay put */
+	if (htt_rx_attach(htt_pdev))
+		goto peer_find_detach;
+
+	htt->msg = qdf_nbuf_alloc(osdev, OL_TXRX_BENCH_HTT_MSG_SIZE, 0, 4,
+				  false);
+	if (!htt->msg)
+		goto rx_detach;
+
+	if (QDF_IS_STATUS_ERROR(qdf_nbuf_map_single(osdev, htt->msg,
+						    QDF_DMA_FROM_DEVICE))) {
+		qdf_nbuf_free(htt->msg);
+		goto rx_detach;
+	}
+
+	htt->msg_vaddr = qdf_nbuf_data(htt->msg);
+	htt->msg_paddr = QDF_NBUF_CB_PADDR(htt->msg);
+	htt->htt_pdev = htt_pdev;
+	htt->txrx_pdev = txrx_pdev;
+	htt->peer_id = peer_id;
+	htt->tid = tid;
+
+	return QDF_STATUS_SUCCESS;
+
+rx_detach:
+	htt_rx_detach(htt_pdev);
+peer_find_detach:
+	ol_txrx_peer_find_detach(txrx_pdev);
+free_htt_pdev:
+	qdf_mem_free(htt_pdev);
+free_txrx_pdev:
+	qdf_spinlock_destroy(&txrx_pdev->peer_ref_mutex);
+	qdf_mem_free(txrx_pdev);
+	qdf_mem_zero(htt, sizeof(*htt));
+
+	return QDF_STATUS_E_NOMEM;
+}
+
+void ol_txrx_bench_htt_detach(struct ol_txrx_bench_htt *htt)
+{
+	if (!htt->htt_pdev)
+		return;
+
+	/* undo the HTC header adjustment of the last fast path message */
+	QDF_NBUF_CB_PADDR(htt->msg) = htt->msg_paddr;
+	qdf_nbuf_unmap_single(htt->txrx_pdev->osdev, htt->msg,
+			      QDF_DMA_FROM_DEVICE);
+	qdf_nbuf_free(htt->msg);
+
+	htt_rx_detach(htt->htt_pdev);
+	ol_txrx_peer_find_detach(htt->txrx_pdev);
+	qdf_spinlock_destroy(&htt->txrx_pdev->peer_ref_mutex);
+	qdf_mem_free(htt->htt_pdev);
+	qdf_mem_free(htt->txrx_pdev);
+	qdf_mem_zero(htt, sizeof(*htt));
+}
+
+#ifdef WLAN_FULL_REORDER_OFFLOAD
+qdf_nbuf_t ol_txrx_bench_htt_rx_in_ord_ind(struct ol_txrx_bench_htt *htt,
+					   uint32_t num_msdus,
+					   uint16_t msdu_len, bool htc_hdr)
+{
+	struct htt_pdev_t *pdev = htt->htt_pdev;
+	qdf_nbuf_t msg = htt->msg;
+	uint32_t hdr_len = 0;
+	uint32_t msg_len;
+	uint32_t *msg_word;
+	uint32_t idx, i;
+	uint64_t paddr;
+
+	if (!pdev->cfg.is_full_reorder_offload ||
+	    htt_rx_in_order_ring_elems(pdev) < num_msdus)
+		return NULL;
+
+	if (htc_hdr)
+		hdr_len = HTC_HEADER_LEN + HTC_HDR_ALIGNMENT_PADDING;
+	msg_len = HTT_RX_IN_ORD_PADDR_IND_HDR_BYTES +
+		  num_msdus * HTT_RX_IN_ORD_PADDR_IND_MSDU_DWORDS *
+		  sizeof(uint32_t);
+
+	qdf_nbuf_set_pktlen(msg, 0);
+	if (!qdf_nbuf_put_tail(msg, hdr_len + msg_len))
+		return NULL;
+	qdf_mem_zero(qdf_nbuf_data(msg), hdr_len + msg_len);
+
+	/*
+	 * The CE hands the HTT message over with its bus address past the
+	 * HTC header, which HTT_T2H_MSG_BUF_REINIT() rewinds after handling.
+	 */
+	if (htc_hdr)
+		QDF_NBUF_CB_PADDR(msg) = htt->msg_paddr + hdr_len +
+			(qdf_nbuf_data(msg) - htt->msg_vaddr);
+
+	msg_word = (uint32_t *)(qdf_nbuf_data(msg) + hdr_len);
+	HTT_T2H_MSG_TYPE_SET(*msg_word, HTT_T2H_MSG_TYPE_RX_IN_ORD_PADDR_IND);
+	HTT_RX_IN_ORD_PADDR_IND_PEER_ID_SET(*msg_word, htt->peer_id);
+	HTT_RX_IN_ORD_PADDR_IND_EXT_TID_SET(*msg_word, htt->tid);
+	HTT_RX_IN_ORD_PADDR_IND_MSDU_CNT_SET(*(msg_word + 1), num_msdus);
+	msg_word = (uint32_t *)((uint8_t *)msg_word +
+				HTT_RX_IN_ORD_PADDR_IND_HDR_BYTES);
+
+	/* consume the buffers the host posted, as the MAC DMA would */
+	idx = *pdev->rx_ring.target_idx.vaddr;
+	for (i = 0; i < num_msdus; i++) {
+		paddr = pdev->rx_ring.buf.paddrs_ring[idx];
+		HTT_RX_IN_ORD_PADDR_IND_PADDR_SET(*msg_word, (uint32_t)paddr);
+#if HTT_PADDR64
+		HTT_RX_IN_ORD_PADDR_IND_PADDR_SET(*(msg_word + 1),
+						  (uint32_t)(paddr >> 32));
+#endif
+		HTT_RX_IN_ORD_PADDR_IND_MSDU_LEN_SET(
+				*(msg_word + NEXT_FIELD_OFFSET_IN32), msdu_len);
+		msg_word += HTT_RX_IN_ORD_PADDR_IND_MSDU_DWORDS;
+		idx = (idx + 1) & pdev->rx_ring.size_mask;
+	}
+	*pdev->rx_ring.target_idx.vaddr = idx;
+
+	return msg;
+}
+#endif /* WLAN_FULL_REORDER_OFFLOAD */
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2021 The Linux Foundation. All rights reserved.
+ *
+ * Permission to use, copy, modify, and/or distribute this software for
+ * any purpose with or without fee is hereby granted, provided that the
+ * above copyright notice and this permission notice appear in all
+ * copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+ * WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+ * AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+ * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR
+ * PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+ * TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef __OL_TXRX_BENCH_HTT_H
+#define __OL_TXRX_BENCH_HTT_H
+
+#include <qdf_nbuf.h>
+#include <qdf_status.h>
+#include <htt_internal.h>
+#include <ol_txrx_types.h>
+
+/**
+ * struct ol_txrx_bench_htt - fake htt pdev and target of the ol benchmarks
+ * @htt_pdev: htt pdev with a real rx ring, not connected to HTC
+ * @txrx_pdev: txrx pdev owning @htt_pdev, with a private peer id map
+ * @msg: target to host message buffer, mapped like a CE rx buffer
+ * @msg_vaddr: data pointer of @msg when it was mapped
+ * @msg_paddr: bus address of @msg_vaddr
+ * @peer_id: peer id the rx indications are sent for
+ * @tid: tid the rx indications are sent for
+ */
+struct ol_txrx_bench_htt {
+	struct htt_pdev_t *htt_pdev;
+	struct ol_txrx_pdev_t *txrx_pdev;
+	qdf_nbuf_t msg;
+	uint8_t *msg_vaddr;
+	qdf_dma_addr_t msg_paddr;
+	uint16_t peer_id;
+	uint8_t tid;
+};
+
+/**
+ * ol_txrx_bench_htt_attach() - create the fake htt and txrx pdevs
+ * @htt: shim to initialize
+ * @peer: peer to register at @peer_id in the txrx pdev
+ * @peer_id: peer id of @peer
+ * @tid: tid of the rx indications
+ *
+ * The rx ring of the htt pdev is allocated and filled by htt_rx_attach()
+ * from the config of the loaded driver, as for the attached pdev. Neither
+ * pdev is known to the soc, HTC or the target.
+ *
+ * Return: QDF_STATUS_SUCCESS on success, an error otherwise
+ */
+QDF_STATUS ol_txrx_bench_htt_attach(struct ol_txrx_bench_htt *htt,
+				    struct ol_txrx_peer_t *peer,
+				    uint16_t peer_id, uint8_t tid);
+
+/**
+ * ol_txrx_bench_htt_detach() - free the fake pdevs and their rx ring
+ * @htt: shim set up by ol_txrx_bench_htt_attach()
+ *
+ * Return: None
+ */
+void ol_txrx_bench_htt_detach(struct ol_txrx_bench_htt *htt);
+
+/**
+ * ol_txrx_bench_htt_rx_in_ord_ind() - fake target rx in order indication
+ * @htt: shim set up by ol_txrx_bench_htt_attach()
+ * @num_msdus: number of rx ring buffers to indicate
+ * @msdu_len: length of each MSDU
+ * @htc_hdr: leave room for the HTC header, as the CE fast path delivers
+ *
+ * Acts as the target: takes the next @num_msdus buffers of the rx ring,
+ * advances the target index and writes an in order rx indication carrying
+ * their addresses into @htt->msg. Only the full reorder offload ring is
+ * supported.
+ *
+ * Return: the message, or NULL if the ring holds less than @num_msdus
+ *	buffers
+ */
+#ifdef WLAN_FULL_REORDER_OFFLOAD
+qdf_nbuf_t ol_txrx_bench_htt_rx_in_ord_ind(struct ol_txrx_bench_htt *htt,
+					   uint32_t num_msdus,
+					   uint16_t msdu_len, bool htc_hdr);
+#else
+static inline qdf_nbuf_t
+ol_txrx_bench_htt_rx_in_ord_ind(struct ol_txrx_bench_htt *htt,
+				uint32_t num_msdus,
+				uint16_t msdu_len, bool htc_hdr)
+{
+	return NULL;
+}
+#endif /* WLAN_FULL_REORDER_OFFLOAD */
+
+#endif /* __OL_TXRX_BENCH_HTT_H */
@@ -22,6 +22,7 @@
 #include <enet.h>
 #include <linux/skbuff.h>
 #include "hif.h"
+#include <cds_lock_prof.h>
 
 static void dp_rx_fisa_flush_flow_wrap(struct dp_fisa_rx_sw_ft *sw_ft);
 
@@ -289,42 +290,169 @@ dp_rx_fisa_setup_hw_fse(struct dp_rx_fst *fisa_hdl,
 }
 
 #ifdef DP_FT_LOCK_HISTORY
-struct dp_ft_lock_history ft_lock_hist[MAX_REO_DEST_RINGS];
+static struct dp_ft_lock_stats ft_lock_stats[MAX_REO_DEST_RINGS];
 
 /**
- * dp_rx_fisa_record_ft_lock_event() - Record FT lock/unlock events
+ * dp_rx_fisa_ft_lock_hold_bucket() - Get histogram bucket of a hold time
+ * @hold_us: lock hold time in us
+ *
+ * Return: enum dp_ft_lock_hold_bucket
+ */
+static inline enum dp_ft_lock_hold_bucket
+dp_rx_fisa_ft_lock_hold_bucket(uint32_t hold_us)
+{
+	if (hold_us < 1)
+		return DP_FT_LOCK_HOLD_BUCKET_1_US;
+	if (hold_us < 10)
+		return DP_FT_LOCK_HOLD_BUCKET_10_US;
+	if (hold_us < 100)
+		return DP_FT_LOCK_HOLD_BUCKET_100_US;
+	if (hold_us < 1000)
+		return DP_FT_LOCK_HOLD_BUCKET_1_MS;
+
+	return DP_FT_LOCK_HOLD_BUCKET_1_MS_PLUS;
+}
+
+/**
+ * dp_rx_fisa_ft_lock_busy() - Check if a SW FT shard lock is already held
+ * @fisa_hdl: Handle to fisa context
+ * @reo_id: REO ID
+ *
+ * Sampled before the lock is taken, for the contention count of the shard.
+ *
+ * Return: true if the lock of @reo_id shard is held
+ */
+static inline bool
+dp_rx_fisa_ft_lock_busy(struct dp_rx_fst *fisa_hdl, uint8_t reo_id)
+{
+	return qdf_spin_is_locked(&fisa_hdl->dp_rx_sw_ft_lock[reo_id]);
+}
+
+/**
+ * dp_rx_fisa_record_ft_lock_acquire() - Record a SW FT shard lock acquisition
+ * @reo_id: REO ID
+ * @contended: the lock was found held before it was taken
+ *
+ * Must be called with the lock of @reo_id shard held.
+ *
+ * Return: None
+ */
+static inline void
+dp_rx_fisa_record_ft_lock_acquire(uint8_t reo_id, bool contended)
+{
+	struct dp_ft_lock_stats *lock_stats;
+
+	if (reo_id >= MAX_REO_DEST_RINGS)
+		return;
+
+	/* stats of a shard are only updated with its lock held */
+	lock_stats = &ft_lock_stats[reo_id];
+	lock_stats->acquired++;
+	if (contended)
+		lock_stats->contended++;
+	lock_stats->lock_ts = qdf_get_log_timestamp_usecs();
+}
+
+/**
+ * dp_rx_fisa_record_ft_lock_release() - Record the hold time of a SW FT
+ *					 shard lock about to be released
  * @reo_id: REO ID
  * @func: caller function
- * @type: lock/unlock event type
+ *
+ * Must be called with the lock of @reo_id shard held.
  *
  * Return: None
  */
-static void dp_rx_fisa_record_ft_lock_event(uint8_t reo_id, const char *func,
-					    enum dp_ft_lock_event_type type)
+static inline void
+dp_rx_fisa_record_ft_lock_release(uint8_t reo_id, const char *func)
 {
-	struct dp_ft_lock_history *lock_hist;
-	struct dp_ft_lock_record *record;
-	uint32_t record_idx;
+	struct dp_ft_lock_stats *lock_stats;
+	uint32_t hold_us;
 
 	if (reo_id >= MAX_REO_DEST_RINGS)
 		return;
 
-	lock_hist = &ft_lock_hist[reo_id];
-	record_idx = lock_hist->record_idx % DP_FT_LOCK_MAX_RECORDS;
-	ft_lock_hist->record_idx++;
+	lock_stats = &ft_lock_stats[reo_id];
+	hold_us = qdf_get_log_timestamp_usecs() - lock_stats->lock_ts;
+	lock_stats->hold_hist[dp_rx_fisa_ft_lock_hold_bucket(hold_us)]++;
+	if (hold_us > lock_stats->max_hold_us) {
+		lock_stats->max_hold_us = hold_us;
+		lock_stats->max_hold_func = func;
+	}
+}
+
+/**
+ * dp_rx_fisa_record_ft_migration() - Record a flow migrating between shards
+ * @reo_id: REO ID of the shard the flow migrates into
+ *
+ * Must be called with the lock of @reo_id shard held.
+ *
+ * Return: None
+ */
+static inline void dp_rx_fisa_record_ft_migration(uint8_t reo_id)
+{
+	if (reo_id < MAX_REO_DEST_RINGS)
+		ft_lock_stats[reo_id].migrations++;
+}
 
-	record = &lock_hist->ft_lock_rec[record_idx];
+/**
+ * dp_rx_fisa_dump_ft_lock_stats() - Dump per REO ring FT lock stats
+ *
+ * Return: None
+ */
+static void dp_rx_fisa_dump_ft_lock_stats(void)
+{
+	struct dp_ft_lock_stats *lock_stats;
+	int i;
 
-	record->func = func;
-	record->cpu_id = qdf_get_cpu();
-	record->timestamp = qdf_get_log_timestamp();
-	record->type = type;
+	for (i = 0; i < MAX_REO_DEST_RINGS; i++) {
+		lock_stats = &ft_lock_stats[i];
+		if (!lock_stats->acquired)
+			continue;
+
+		dp_info("FT lock[%d] acquired %u contended %u migrations %u max_hold %uus (%s) hold <1us %u <10us %u <100us %u <1ms %u >=1ms %u",
+			i, lock_stats->acquired, lock_stats->contended,
+			lock_stats->migrations, lock_stats->max_hold_us,
+			lock_stats->max_hold_func ?
+				lock_stats->max_hold_func : "none",
+			lock_stats->hold_hist[DP_FT_LOCK_HOLD_BUCKET_1_US],
+			lock_stats->hold_hist[DP_FT_LOCK_HOLD_BUCKET_10_US],
+			lock_stats->hold_hist[DP_FT_LOCK_HOLD_BUCKET_100_US],
+			lock_stats->hold_hist[DP_FT_LOCK_HOLD_BUCKET_1_MS],
+			lock_stats->hold_hist[DP_FT_LOCK_HOLD_BUCKET_1_MS_PLUS]);
+	}
+}
+#else
+static inline bool
+dp_rx_fisa_ft_lock_busy(struct dp_rx_fst *fisa_hdl, uint8_t reo_id)
+{
+	return false;
+}
+
+static inline void
+dp_rx_fisa_record_ft_lock_acquire(uint8_t reo_id, bool contended)
+{
+}
+
+static inline void
+dp_rx_fisa_record_ft_lock_release(uint8_t reo_id, const char *func)
+{
+}
+
+static inline void dp_rx_fisa_record_ft_migration(uint8_t reo_id)
+{
 }
 
+static inline void dp_rx_fisa_dump_ft_lock_stats(void)
+{
+}
+#endif /* DP_FT_LOCK_HISTORY */
+
 /**
  * __dp_rx_fisa_acquire_ft_lock() - Acquire lock which protects SW FT entries
  * @fisa_hdl: Handle to fisa context
  * @reo_id: REO ID
+ * @func: caller function
  *
  * Return: None
  */
@@ -332,17 +460,22 @@ static inline void
 __dp_rx_fisa_acquire_ft_lock(struct dp_rx_fst *fisa_hdl,
 			     uint8_t reo_id, const char *func)
 {
+	bool contended;
+
 	if (!fisa_hdl->flow_deletion_supported)
 		return;
 
-	qdf_spin_lock_bh(&fisa_hdl->dp_rx_sw_ft_lock[reo_id]);
-	dp_rx_fisa_record_ft_lock_event(reo_id, func, DP_FT_LOCK_EVENT);
+	contended = dp_rx_fisa_ft_lock_busy(fisa_hdl, reo_id);
+	cds_lock_prof_spin_lock_bh(&fisa_hdl->dp_rx_sw_ft_lock[reo_id],
+				   CDS_LOCK_SITE_DP_FISA_FT);
+	dp_rx_fisa_record_ft_lock_acquire(reo_id, contended);
 }
 
 /**
  * __dp_rx_fisa_release_ft_lock() - Release lock which protects SW FT entries
  * @fisa_hdl: Handle to fisa context
  * @reo_id: REO ID
+ * @func: caller function
  *
  * Return: None
  */
@@ -353,8 +486,9 @@ __dp_rx_fisa_release_ft_lock(struct dp_rx_fst *fisa_hdl,
 	if (!fisa_hdl->flow_deletion_supported)
 		return;
 
-	qdf_spin_unlock_bh(&fisa_hdl->dp_rx_sw_ft_lock[reo_id]);
-	dp_rx_fisa_record_ft_lock_event(reo_id, func, DP_FT_UNLOCK_EVENT);
+	dp_rx_fisa_record_ft_lock_release(reo_id, func);
+	cds_lock_prof_spin_unlock_bh(&fisa_hdl->dp_rx_sw_ft_lock[reo_id],
+				     CDS_LOCK_SITE_DP_FISA_FT);
 }
 
 #define dp_rx_fisa_acquire_ft_lock(fisa_hdl, reo_id) \
@@ -363,35 +497,67 @@ __dp_rx_fisa_release_ft_lock(struct dp_rx_fst *fisa_hdl,
 #define dp_rx_fisa_release_ft_lock(fisa_hdl, reo_id) \
 	__dp_rx_fisa_release_ft_lock(fisa_hdl, reo_id, __func__)
 
-#else
 /**
- * dp_rx_fisa_acquire_ft_lock() - Acquire lock which protects SW FT entries
+ * dp_rx_fisa_acquire_ft_migrate_lock() - Acquire SW FT locks to migrate a
+ *					  flow between REO rings
  * @fisa_hdl: Handle to fisa context
- * @reo_id: REO ID
+ * @src_reo_id: REO ID currently owning the flow
+ * @dst_reo_id: REO ID the flow is moving to
+ *
+ * Each REO ring owns the SW FT entries of the flows steered to it, so only
+ * a migration needs both shards locked. The locks are always taken in
+ * increasing REO ID order to avoid an ABBA deadlock between two migrations.
  *
  * Return: None
  */
-static inline void
-dp_rx_fisa_acquire_ft_lock(struct dp_rx_fst *fisa_hdl, uint8_t reo_id)
+static void
+dp_rx_fisa_acquire_ft_migrate_lock(struct dp_rx_fst *fisa_hdl,
+				   uint8_t src_reo_id, uint8_t dst_reo_id)
 {
-	if (fisa_hdl->flow_deletion_supported)
-		qdf_spin_lock_bh(&fisa_hdl->dp_rx_sw_ft_lock[reo_id]);
+	if (src_reo_id == dst_reo_id ||
+	    dst_reo_id >= MAX_REO_DEST_RINGS) {
+		dp_rx_fisa_acquire_ft_lock(fisa_hdl, src_reo_id);
+		return;
+	}
+
+	if (src_reo_id < dst_reo_id) {
+		dp_rx_fisa_acquire_ft_lock(fisa_hdl, src_reo_id);
+		dp_rx_fisa_acquire_ft_lock(fisa_hdl, dst_reo_id);
+	} else {
+		dp_rx_fisa_acquire_ft_lock(fisa_hdl, dst_reo_id);
+		dp_rx_fisa_acquire_ft_lock(fisa_hdl, src_reo_id);
+	}
+
+	dp_rx_fisa_record_ft_migration(dst_reo_id);
 }
 
 /**
- * dp_rx_fisa_release_ft_lock() - Release lock which protects SW FT entries
+ * dp_rx_fisa_release_ft_migrate_lock() - Release SW FT locks taken by
+ *					  dp_rx_fisa_acquire_ft_migrate_lock()
  * @fisa_hdl: Handle to fisa context
- * @reo_id: REO ID
+ * @src_reo_id: REO ID which owned the flow
+ * @dst_reo_id: REO ID the flow moved to
  *
  * Return: None
  */
-static inline void
-dp_rx_fisa_release_ft_lock(struct dp_rx_fst *fisa_hdl, uint8_t reo_id)
+static void
+dp_rx_fisa_release_ft_migrate_lock(struct dp_rx_fst *fisa_hdl,
+				   uint8_t src_reo_id, uint8_t dst_reo_id)
 {
-	if (fisa_hdl->flow_deletion_supported)
-		qdf_spin_unlock_bh(&fisa_hdl->dp_rx_sw_ft_lock[reo_id]);
+	if (src_reo_id == dst_reo_id ||
+	    dst_reo_id >= MAX_REO_DEST_RINGS) {
+		dp_rx_fisa_release_ft_lock(fisa_hdl, src_reo_id);
+		return;
+	}
+
+	if (src_reo_id < dst_reo_id) {
+		dp_rx_fisa_release_ft_lock(fisa_hdl, dst_reo_id);
+		dp_rx_fisa_release_ft_lock(fisa_hdl, src_reo_id);
+	} else {
+		dp_rx_fisa_release_ft_lock(fisa_hdl, src_reo_id);
+		dp_rx_fisa_release_ft_lock(fisa_hdl, dst_reo_id);
+	}
 }
-#endif /* DP_FT_LOCK_HISTORY */
 
 /**
  * dp_rx_fisa_setup_cmem_fse() - Setup the flow search entry in HW CMEM
@@ -709,7 +875,8 @@ dp_fisa_rx_delete_flow(struct dp_rx_fst *fisa_hdl,
 				fisa_hdl->base)[hashed_flow_idx]);
 	reo_id = sw_ft_entry->napi_id;
 
-	dp_rx_fisa_acquire_ft_lock(fisa_hdl, reo_id);
+	/* the new flow may be steered to a different REO ring */
+	dp_rx_fisa_acquire_ft_migrate_lock(fisa_hdl, reo_id, elem->reo_id);
 
 	/* Flush the flow before deletion */
 	dp_rx_fisa_flush_flow_wrap(sw_ft_entry);
@@ -737,7 +904,7 @@ dp_fisa_rx_delete_flow(struct dp_rx_fst *fisa_hdl,
 	sw_ft_entry->is_flow_tcp = elem->is_tcp_flow;
 	sw_ft_entry->is_flow_udp = elem->is_udp_flow;
 
-	dp_rx_fisa_release_ft_lock(fisa_hdl, reo_id);
+	dp_rx_fisa_release_ft_migrate_lock(fisa_hdl, reo_id, elem->reo_id);
 
 	fisa_hdl->add_flow_count++;
 	fisa_hdl->del_flow_count++;
@@ -1986,6 +2153,8 @@ QDF_STATUS dp_rx_dump_fisa_stats(struct dp_soc *soc)
 		rx_fst->del_flow_count,
 		rx_fst->hash_collision_cnt);
 
+	dp_rx_fisa_dump_ft_lock_stats();
+
 	for (i = 0; i < ft_size; i++, sw_ft_entry++) {
 		if (!sw_ft_entry->is_populated)
 			continue;
@@ -40,8 +40,6 @@
 #define IPSEC_PORT 500
 #define IPSEC_NAT_PORT 4500
 
-#define DP_FT_LOCK_MAX_RECORDS 32
-
 struct dp_fisa_rx_fst_update_elem {
 	/* Do not add new entries here */
 	qdf_list_node_t node;
@@ -54,21 +52,42 @@ struct dp_fisa_rx_fst_update_elem {
 	u8 reo_id;
 };
 
-enum dp_ft_lock_event_type {
-	DP_FT_LOCK_EVENT,
-	DP_FT_UNLOCK_EVENT,
-};
-
-struct dp_ft_lock_record {
-	const char *func;
-	int cpu_id;
-	uint64_t timestamp;
-	enum dp_ft_lock_event_type type;
+/**
+ * enum dp_ft_lock_hold_bucket - FT lock hold time buckets
+ * @DP_FT_LOCK_HOLD_BUCKET_1_US: held less than 1us
+ * @DP_FT_LOCK_HOLD_BUCKET_10_US: held 1us to 9us
+ * @DP_FT_LOCK_HOLD_BUCKET_100_US: held 10us to 99us
+ * @DP_FT_LOCK_HOLD_BUCKET_1_MS: held 100us to 999us
+ * @DP_FT_LOCK_HOLD_BUCKET_1_MS_PLUS: held 1ms or more
+ * @DP_FT_LOCK_HOLD_BUCKET_MAX: max bucket, used as array size
+ */
+enum dp_ft_lock_hold_bucket {
+	DP_FT_LOCK_HOLD_BUCKET_1_US,
+	DP_FT_LOCK_HOLD_BUCKET_10_US,
+	DP_FT_LOCK_HOLD_BUCKET_100_US,
+	DP_FT_LOCK_HOLD_BUCKET_1_MS,
+	DP_FT_LOCK_HOLD_BUCKET_1_MS_PLUS,
+	DP_FT_LOCK_HOLD_BUCKET_MAX
 };
 
-struct dp_ft_lock_history {
-	uint32_t record_idx;
-	struct dp_ft_lock_record ft_lock_rec[DP_FT_LOCK_MAX_RECORDS];
+/**
+ * struct dp_ft_lock_stats - lock stats of one REO ring's SW FT shard
+ * @acquired: number of times the shard lock was taken
+ * @contended: number of times the shard lock was found already held
+ * @migrations: flows migrated into this shard from another REO ring
+ * @lock_ts: timestamp (us) at which the current holder took the lock
+ * @max_hold_us: longest hold time seen
+ * @max_hold_func: function which held the lock for @max_hold_us
+ * @hold_hist: histogram of lock hold times
+ */
+struct dp_ft_lock_stats {
+	uint32_t acquired;
+	uint32_t contended;
+	uint32_t migrations;
+	uint64_t lock_ts;
+	uint32_t max_hold_us;
+	const char *max_hold_func;
+	uint32_t hold_hist[DP_FT_LOCK_HOLD_BUCKET_MAX];
 };
 
 /**
@@ -25,6 +25,7 @@
 #include "dp_internal.h"
 #include "hif.h"
 #include "dp_txrx.h"
+#include "cds_mem_acct.h"
 
 /* Timeout in milliseconds to wait for CMEM FST HTT response */
 #define DP_RX_FST_CMEM_RESP_TIMEOUT 2000
@@ -170,6 +171,50 @@ static void dp_rx_fst_cmem_deinit(struct dp_rx_fst *fst)
 		qdf_spinlock_destroy(&fst->dp_rx_sw_ft_lock[i]);
 }
 
+/**
+ * dp_rx_sw_ft_lock_create() - Create the lock of a SW FT shard
+ * @fst: Pointer to DP FST
+ * @reo_id: REO ID of the shard
+ *
+ * A flow migration holds two shard locks, always taken in increasing REO
+ * ID order. qdf_spinlock_create() gives each of its call sites its own
+ * lockdep class, so each shard lock is created from a call site of its own
+ * to keep lockdep from reporting the migration as a recursive lock.
+ *
+ * Return: None
+ */
+static void dp_rx_sw_ft_lock_create(struct dp_rx_fst *fst, uint8_t reo_id)
+{
+	qdf_spinlock_t *lock = &fst->dp_rx_sw_ft_lock[reo_id];
+
+	switch (reo_id) {
+	case 0:
+		qdf_spinlock_create(lock);
+		break;
+	case 1:
+		qdf_spinlock_create(lock);
+		break;
+	case 2:
+		qdf_spinlock_create(lock);
+		break;
+	case 3:
+		qdf_spinlock_create(lock);
+		break;
+	case 4:
+		qdf_spinlock_create(lock);
+		break;
+	case 5:
+		qdf_spinlock_create(lock);
+		break;
+	case 6:
+		qdf_spinlock_create(lock);
+		break;
+	default:
+		qdf_spinlock_create(lock);
+		break;
+	}
+}
+
 /**
  * dp_rx_fst_cmem_init() - Initialize CMEM parameters
  * @fst: Pointer to DP FST
@@ -193,7 +238,7 @@ static QDF_STATUS dp_rx_fst_cmem_init(struct dp_rx_fst *fst)
 	qdf_event_create(&fst->cmem_resp_event);
 
 	for (i = 0; i < MAX_REO_DEST_RINGS; i++)
-		qdf_spinlock_create(&fst->dp_rx_sw_ft_lock[i]);
+		dp_rx_sw_ft_lock_create(fst, i);
 
 	return QDF_STATUS_SUCCESS;
 }
@@ -235,6 +280,23 @@ dp_rx_sw_fst_hist_detach(struct dp_rx_fst *fst)
 	for (i = 0; i < fst->max_entries; i++)
 		qdf_mem_free(ft_entry[i].pkt_hist);
 }
+
+/**
+ * dp_rx_sw_fst_hist_size() - Size of the pkt history of the sw ft entries
+ * @fst: pointer to rx fst info
+ * @num_entries: number of sw ft entries
+ *
+ * Return: size in bytes
+ */
+static size_t
+dp_rx_sw_fst_hist_size(struct dp_rx_fst *fst, uint32_t num_entries)
+{
+	struct dp_fisa_rx_sw_ft *ft_entry;
+
+	ft_entry = (struct dp_fisa_rx_sw_ft *)fst->base;
+
+	return sizeof(*ft_entry->pkt_hist) * num_entries;
+}
 #else
 static inline void
 dp_rx_sw_fst_hist_attach(struct dp_rx_fst *fst)
@@ -245,8 +307,35 @@ static inline void
 dp_rx_sw_fst_hist_detach(struct dp_rx_fst *fst)
 {
 }
+
+static inline size_t
+dp_rx_sw_fst_hist_size(struct dp_rx_fst *fst, uint32_t num_entries)
+{
+	return 0;
+}
 #endif
 
+/**
+ * dp_rx_sw_fst_mem_size() - Host memory used by the sw flow search table
+ * @soc: SoC handle
+ * @fst: pointer to rx fst info
+ *
+ * Sized from the INI table size, which the table is allocated with, as
+ * fst->max_entries may shrink once the FST moves to CMEM.
+ *
+ * Return: size in bytes
+ */
+static size_t
+dp_rx_sw_fst_mem_size(struct dp_soc *soc, struct dp_rx_fst *fst)
+{
+	uint32_t num_entries =
+		wlan_cfg_get_rx_flow_search_table_size(soc->wlan_cfg_ctx);
+
+	return sizeof(*fst) +
+	       DP_RX_GET_SW_FT_ENTRY_SIZE * num_entries +
+	       dp_rx_sw_fst_hist_size(fst, num_entries);
+}
+
 /**
  * dp_rx_fst_attach() - Initialize Rx FST and setup necessary parameters
  * @soc: SoC handle
@@ -285,6 +374,9 @@ QDF_STATUS dp_rx_fst_attach(struct dp_soc *soc, struct dp_pdev *pdev)
 		return QDF_STATUS_SUCCESS;
 	}
 
+	if (cds_mem_acct_inject_fail(CDS_MEM_TAG_FISA))
+		return QDF_STATUS_E_NOMEM;
+
 	fst = qdf_mem_malloc(sizeof(struct dp_rx_fst));
 	if (!fst)
 		return QDF_STATUS_E_NOMEM;
@@ -341,6 +433,9 @@ QDF_STATUS dp_rx_fst_attach(struct dp_soc *soc, struct dp_pdev *pdev)
 	soc->fisa_enable = true;
 	qdf_atomic_init(&soc->skip_fisa_param.skip_fisa);
 
+	cds_mem_acct_alloc(CDS_MEM_TAG_FISA,
+			   dp_rx_sw_fst_mem_size(soc, fst), 1);
+
 	QDF_TRACE(QDF_MODULE_ID_ANY, QDF_TRACE_LEVEL_ERROR,
 		  "Rx FST attach successful, #entries:%d\n",
 		  fst->max_entries);
@@ -447,6 +542,8 @@ void dp_rx_fst_detach(struct dp_soc *soc, struct dp_pdev *pdev)
 		else
 			hal_rx_fst_detach(dp_fst->hal_rx_fst, soc->osdev);
 
+		cds_mem_acct_free(CDS_MEM_TAG_FISA,
+				  dp_rx_sw_fst_mem_size(soc, dp_fst));
 		dp_rx_sw_fst_hist_detach(dp_fst);
 		dp_context_free_mem(soc, DP_FISA_RX_FT_TYPE, dp_fst->base);
 		qdf_spinlock_destroy(&dp_fst->dp_rx_fst_lock);
@@ -24,6 +24,16 @@
 #include <cdp_txrx_peer_ops.h>
 #include <cds_sched.h>
 
+/*
+ * Predictive refill: refill requests arriving closer than this apart mean
+ * the rx path is running at high rate and the refill thread replenishes
+ * ahead of demand.
+ */
+#define DP_RX_REFILL_PREDICT_INTERVAL_US 10000
+
+/* Predictive refill is stopped if no request is seen for this long */
+#define DP_RX_REFILL_PREDICT_IDLE_US 100000
+
 /* Timeout in ms to wait for a DP rx thread */
 #ifdef HAL_CONFIG_SLUB_DEBUG_ON
 #define DP_RX_THREAD_WAIT_TIMEOUT 4000
@@ -88,6 +98,8 @@ static void dp_rx_tm_thread_dump_stats(struct dp_rx_thread *rx_thread)
 	uint8_t reo_ring_num;
 	uint32_t off = 0;
 	char nbuf_queued_string[100];
+	char acct_string[192];
+	int cpu;
 	uint32_t total_queued = 0;
 	uint32_t temp = 0;
 
@@ -125,6 +137,33 @@ static void dp_rx_tm_thread_dump_stats(struct dp_rx_thread *rx_thread)
 		rx_thread->stats.dropped_invalid_os_rx_handles,
 		rx_thread->stats.dropped_others,
 		rx_thread->stats.dropped_enq_fail);
+
+	dp_info("thread:%u - budget exhausted:%u batch hist(1:%u 2-7:%u 8-31:%u 32-127:%u 128-511:%u 512+:%u)",
+		rx_thread->id,
+		rx_thread->stats.budget_exhausted,
+		rx_thread->stats.batch_hist[DP_RX_THREAD_BATCH_1],
+		rx_thread->stats.batch_hist[DP_RX_THREAD_BATCH_2_7],
+		rx_thread->stats.batch_hist[DP_RX_THREAD_BATCH_8_31],
+		rx_thread->stats.batch_hist[DP_RX_THREAD_BATCH_32_127],
+		rx_thread->stats.batch_hist[DP_RX_THREAD_BATCH_128_511],
+		rx_thread->stats.batch_hist[DP_RX_THREAD_BATCH_512_PLUS]);
+
+	dp_info("thread:%u - gro flush reason(batch:%u low_tput:%u pkt_budget:%u time_budget:%u low_latency:%u vdev_del:%u)",
+		rx_thread->id,
+		rx_thread->stats.gro_flush_reason[DP_RX_GRO_FLUSH_END_OF_BATCH],
+		rx_thread->stats.gro_flush_reason[DP_RX_GRO_FLUSH_LOW_TPUT],
+		rx_thread->stats.gro_flush_reason[DP_RX_GRO_FLUSH_PKT_BUDGET],
+		rx_thread->stats.gro_flush_reason[DP_RX_GRO_FLUSH_TIME_BUDGET],
+		rx_thread->stats.gro_flush_reason[DP_RX_GRO_FLUSH_LOW_LATENCY],
+		rx_thread->stats.gro_flush_reason[DP_RX_GRO_FLUSH_VDEV_DEL]);
+
+	for (cpu = 0; cpu < CDS_CPU_ACCT_MAX_CPUS; cpu++) {
+		if (!cds_cpu_acct_scnprintf(&rx_thread->stats.cpu_acct, cpu,
+					    acct_string, sizeof(acct_string)))
+			continue;
+		dp_info("thread:%u - cpu:%d %s", rx_thread->id, cpu,
+			acct_string);
+	}
 }
 
 QDF_STATUS dp_rx_tm_dump_stats(struct dp_rx_tm_handle *rx_tm_hdl)
@@ -216,6 +255,25 @@ QDF_STATUS dp_check_and_update_pending(struct dp_rx_tm_handle_cmn
 }
 #endif
 
+/**
+ * dp_rx_tm_qdepth_ind() - indicate an rx thread queue depth crossing
+ * @rx_tm_hdl: dp_rx_tm_handle containing the overall thread infrastructure
+ * @qlen: rx thread queue length
+ *
+ * The callback and its context are read under the lock, so they cannot be
+ * deregistered while the callback is running.
+ *
+ * Return: None
+ */
+static void dp_rx_tm_qdepth_ind(struct dp_rx_tm_handle *rx_tm_hdl,
+				uint32_t qlen)
+{
+	qdf_spin_lock_bh(&rx_tm_hdl->qdepth_ind_lock);
+	if (rx_tm_hdl->qdepth_ind_cb)
+		rx_tm_hdl->qdepth_ind_cb(rx_tm_hdl->qdepth_ind_ctx, qlen);
+	qdf_spin_unlock_bh(&rx_tm_hdl->qdepth_ind_lock);
+}
+
 /**
  * dp_rx_tm_thread_enqueue() - enqueue nbuf list into rx_thread
  * @rx_thread - rx_thread in which the nbuf needs to be queued
@@ -234,10 +292,11 @@ static QDF_STATUS dp_rx_tm_thread_enqueue(struct dp_rx_thread *rx_thread,
 					  qdf_nbuf_t nbuf_list)
 {
 	qdf_nbuf_t head_ptr, next_ptr_list;
-	uint32_t temp_qlen;
+	uint32_t temp_qlen, prev_qlen;
 	uint32_t num_elements_in_nbuf;
 	uint32_t nbuf_queued;
 	struct dp_rx_tm_handle_cmn *tm_handle_cmn;
+	struct dp_rx_tm_handle *rx_tm_hdl;
 	uint8_t reo_ring_num = QDF_NBUF_CB_RX_CTX_ID(nbuf_list);
 	qdf_wait_queue_head_t *wait_q_ptr;
 	uint8_t allow_dropping;
@@ -260,6 +319,7 @@ static QDF_STATUS dp_rx_tm_thread_enqueue(struct dp_rx_thread *rx_thread,
 
 	num_elements_in_nbuf = QDF_NBUF_CB_RX_NUM_ELEMENTS_IN_LIST(nbuf_list);
 	nbuf_queued = num_elements_in_nbuf;
+	prev_qlen = qdf_nbuf_queue_head_qlen(&rx_thread->nbuf_queue);
 
 	allow_dropping = qdf_atomic_read(
 		&((struct dp_rx_tm_handle *)tm_handle_cmn)->allow_dropping);
@@ -316,6 +376,12 @@ enq_done:
 	if (temp_qlen > rx_thread->stats.nbufq_max_len)
 		rx_thread->stats.nbufq_max_len = temp_qlen;
 
+	rx_tm_hdl = (struct dp_rx_tm_handle *)tm_handle_cmn;
+	if (qdf_unlikely(rx_tm_hdl->qdepth_ind_thresh) &&
+	    prev_qlen < rx_tm_hdl->qdepth_ind_thresh &&
+	    temp_qlen >= rx_tm_hdl->qdepth_ind_thresh)
+		dp_rx_tm_qdepth_ind(rx_tm_hdl, temp_qlen);
+
 	dp_debug("enqueue packet thread %pK wait queue %pK qlen %u",
 		 rx_thread, wait_q_ptr,
 		 qdf_nbuf_queue_head_qlen(&rx_thread->nbuf_queue));
@@ -390,11 +456,126 @@ static qdf_nbuf_t dp_rx_tm_thread_dequeue(struct dp_rx_thread *rx_thread)
 	return head;
 }
 
+/**
+ * dp_rx_thread_update_batch_hist() - account packets delivered in a wakeup
+ * @rx_thread: rx_thread which delivered the packets
+ * @num_pkts: number of packets delivered to the stack in this wakeup
+ *
+ * Returns: None
+ */
+static void dp_rx_thread_update_batch_hist(struct dp_rx_thread *rx_thread,
+					   uint32_t num_pkts)
+{
+	enum dp_rx_thread_batch_bucket bucket;
+
+	if (!num_pkts)
+		return;
+
+	if (num_pkts == 1)
+		bucket = DP_RX_THREAD_BATCH_1;
+	else if (num_pkts < 8)
+		bucket = DP_RX_THREAD_BATCH_2_7;
+	else if (num_pkts < 32)
+		bucket = DP_RX_THREAD_BATCH_8_31;
+	else if (num_pkts < 128)
+		bucket = DP_RX_THREAD_BATCH_32_127;
+	else if (num_pkts < 512)
+		bucket = DP_RX_THREAD_BATCH_128_511;
+	else
+		bucket = DP_RX_THREAD_BATCH_512_PLUS;
+
+	rx_thread->stats.batch_hist[bucket]++;
+}
+
+/**
+ * dp_rx_thread_gro_flush() - flush GRO packets for the RX thread
+ * @rx_thread: rx_thread to be processed
+ * @gro_flush_code: flush code to differentiating flushes
+ * @reason: event which triggered the flush
+ *
+ * Return: void
+ */
+static void dp_rx_thread_gro_flush(struct dp_rx_thread *rx_thread,
+				   enum dp_rx_gro_flush_code gro_flush_code,
+				   enum dp_rx_gro_flush_reason reason)
+{
+	dp_debug("flushing packets for thread %u reason %d",
+		 rx_thread->id, reason);
+
+	local_bh_disable();
+	dp_rx_napi_gro_flush(&rx_thread->napi, gro_flush_code);
+	local_bh_enable();
+
+	rx_thread->stats.gro_flushes++;
+	rx_thread->stats.gro_flush_reason[reason]++;
+
+	/* low tput flush leaves the GRO held packets in place */
+	if (gro_flush_code != DP_RX_GRO_LOW_TPUT_FLUSH)
+		rx_thread->gro_pending_pkts = 0;
+}
+
+/**
+ * dp_rx_thread_gro_flush_sched() - decide on a GRO flush after a delivery
+ * @rx_thread: rx_thread which delivered the packets
+ * @config: dp txrx configuration
+ * @num_pkts: packets delivered to the stack by the last stack_fn call
+ *
+ * All packets handed to the stack are accounted, not only the ones held by
+ * GRO, which keeps the check cheap and errs on the side of flushing early.
+ * In low latency mode GRO is flushed after every nbuf list. Otherwise it is
+ * flushed once the packet budget is consumed or the time budget elapsed
+ * since the first packet delivered after the last flush. Flushes at the
+ * end of a batch stay driven by the flush indication of the rx path.
+ *
+ * Returns: None
+ */
+static void dp_rx_thread_gro_flush_sched(struct dp_rx_thread *rx_thread,
+					 struct dp_txrx_config *config,
+					 uint32_t num_pkts)
+{
+	uint64_t now_us;
+
+	if (!rx_thread->napi.poll)
+		return;
+
+	if (config->rx_gro_low_latency) {
+		dp_rx_thread_gro_flush(rx_thread, DP_RX_GRO_NORMAL_FLUSH,
+				       DP_RX_GRO_FLUSH_LOW_LATENCY);
+		return;
+	}
+
+	if (!rx_thread->gro_pending_pkts &&
+	    config->rx_gro_flush_time_budget_us)
+		rx_thread->gro_pending_ts_us = qdf_get_log_timestamp_usecs();
+	rx_thread->gro_pending_pkts += num_pkts;
+
+	if (config->rx_gro_flush_pkt_budget &&
+	    rx_thread->gro_pending_pkts >= config->rx_gro_flush_pkt_budget) {
+		dp_rx_thread_gro_flush(rx_thread, DP_RX_GRO_NORMAL_FLUSH,
+				       DP_RX_GRO_FLUSH_PKT_BUDGET);
+		return;
+	}
+
+	if (!config->rx_gro_flush_time_budget_us)
+		return;
+
+	now_us = qdf_get_log_timestamp_usecs();
+	if (now_us - rx_thread->gro_pending_ts_us >=
+	    config->rx_gro_flush_time_budget_us)
+		dp_rx_thread_gro_flush(rx_thread, DP_RX_GRO_NORMAL_FLUSH,
+				       DP_RX_GRO_FLUSH_TIME_BUDGET);
+}
+
 /**
  * dp_rx_thread_process_nbufq() - process nbuf queue of a thread
  * @rx_thread - rx_thread whose nbuf queue needs to be processed
  *
- * Returns: 0 on success, error code on failure
+ * The queue is drained until it is empty or until the configured rx thread
+ * budget is consumed. In the latter case the RX_POST_EVENT is re-armed so
+ * that the thread comes back for the remaining packets after yielding.
+ *
+ * Returns: 0 when the queue is drained, -EAGAIN when the budget got
+ *	    exhausted with packets still pending, error code on failure
  */
 static int dp_rx_thread_process_nbufq(struct dp_rx_thread *rx_thread)
 {
@@ -404,6 +585,10 @@ static int dp_rx_thread_process_nbufq(struct dp_rx_thread *rx_thread)
 	ol_osif_vdev_handle osif_vdev;
 	ol_txrx_soc_handle soc;
 	uint32_t num_list_elements = 0;
+	uint32_t num_processed = 0;
+	uint32_t num_delivered = 0;
+	struct dp_txrx_config *config;
+	int ret = 0;
 
 	struct dp_txrx_handle_cmn *txrx_handle_cmn;
 
@@ -417,6 +602,8 @@ static int dp_rx_thread_process_nbufq(struct dp_rx_thread *rx_thread)
 		return -EFAULT;
 	}
 
+	config = &dp_txrx_get_ext_hdl_frm_cmn_hdl(txrx_handle_cmn)->config;
+
 	dp_debug("enter: qlen  %u",
 		 qdf_nbuf_queue_head_qlen(&rx_thread->nbuf_queue));
 
@@ -427,6 +614,7 @@ static int dp_rx_thread_process_nbufq(struct dp_rx_thread *rx_thread)
 		/* count aggregated RX frame into stats */
 		num_list_elements += qdf_nbuf_get_gso_segs(nbuf_list);
 		rx_thread->stats.nbuf_dequeued += num_list_elements;
+		num_processed += num_list_elements;
 
 		vdev_id = QDF_NBUF_CB_RX_VDEV_ID(nbuf_list);
 		cdp_get_os_rx_handles_from_vdev(soc, vdev_id, &stack_fn,
@@ -441,33 +629,28 @@ static int dp_rx_thread_process_nbufq(struct dp_rx_thread *rx_thread)
 		} else {
 			rx_thread->stats.nbuf_sent_to_stack +=
 							num_list_elements;
+			num_delivered += num_list_elements;
+			dp_rx_thread_gro_flush_sched(rx_thread, config,
+						     num_list_elements);
+		}
+
+		if (config->rx_thread_budget &&
+		    num_processed >= config->rx_thread_budget &&
+		    qdf_nbuf_queue_head_qlen(&rx_thread->nbuf_queue)) {
+			rx_thread->stats.budget_exhausted++;
+			qdf_set_bit(RX_POST_EVENT, &rx_thread->event_flag);
+			ret = -EAGAIN;
+			break;
 		}
 		nbuf_list = dp_rx_tm_thread_dequeue(rx_thread);
 	}
 
+	dp_rx_thread_update_batch_hist(rx_thread, num_delivered);
+
 	dp_debug("exit: qlen  %u",
 		 qdf_nbuf_queue_head_qlen(&rx_thread->nbuf_queue));
 
-	return 0;
-}
-
-/**
- * dp_rx_thread_gro_flush() - flush GRO packets for the RX thread
- * @rx_thread: rx_thread to be processed
- * @gro_flush_code: flush code to differentiating flushes
- *
- * Return: void
- */
-static void dp_rx_thread_gro_flush(struct dp_rx_thread *rx_thread,
-				   enum dp_rx_gro_flush_code gro_flush_code)
-{
-	dp_debug("flushing packets for thread %u", rx_thread->id);
-
-	local_bh_disable();
-	dp_rx_napi_gro_flush(&rx_thread->napi, gro_flush_code);
-	local_bh_enable();
-
-	rx_thread->stats.gro_flushes++;
+	return ret;
 }
 
 /**
@@ -485,6 +668,10 @@ static void dp_rx_thread_gro_flush(struct dp_rx_thread *rx_thread,
 static int dp_rx_thread_sub_loop(struct dp_rx_thread *rx_thread, bool *shutdown)
 {
 	enum dp_rx_gro_flush_code gro_flush_code;
+	enum dp_rx_gro_flush_reason reason;
+	unsigned int dequeued;
+	uint64_t start_ns;
+	bool yield;
 
 	while (true) {
 		if (qdf_atomic_test_and_clear_bit(RX_SHUTDOWN_EVENT,
@@ -500,17 +687,32 @@ static int dp_rx_thread_sub_loop(struct dp_rx_thread *rx_thread, bool *shutdown)
 			break;
 		}
 
-		dp_rx_thread_process_nbufq(rx_thread);
+		start_ns = cds_cpu_acct_start();
+		dequeued = rx_thread->stats.nbuf_dequeued;
+		yield = dp_rx_thread_process_nbufq(rx_thread) == -EAGAIN;
 
 		gro_flush_code = qdf_atomic_read(&rx_thread->gro_flush_ind);
 
-		if (gro_flush_code ||
-		    qdf_atomic_test_bit(RX_VDEV_DEL_EVENT,
-					&rx_thread->event_flag)) {
-			dp_rx_thread_gro_flush(rx_thread, gro_flush_code);
+		if (qdf_atomic_test_bit(RX_VDEV_DEL_EVENT,
+					&rx_thread->event_flag))
+			reason = DP_RX_GRO_FLUSH_VDEV_DEL;
+		else if (gro_flush_code == DP_RX_GRO_LOW_TPUT_FLUSH)
+			reason = DP_RX_GRO_FLUSH_LOW_TPUT;
+		else if (gro_flush_code)
+			reason = DP_RX_GRO_FLUSH_END_OF_BATCH;
+		else
+			reason = DP_RX_GRO_FLUSH_REASON_MAX;
+
+		if (reason != DP_RX_GRO_FLUSH_REASON_MAX) {
+			dp_rx_thread_gro_flush(rx_thread, gro_flush_code,
+					       reason);
 			qdf_atomic_set(&rx_thread->gro_flush_ind, 0);
 		}
 
+		cds_cpu_acct_end(&rx_thread->stats.cpu_acct, start_ns,
+				 rx_thread->stats.nbuf_dequeued - dequeued,
+				 yield);
+
 		if (qdf_atomic_test_and_clear_bit(RX_VDEV_DEL_EVENT,
 						  &rx_thread->event_flag)) {
 			rx_thread->stats.gro_flushes_by_vdev_del++;
@@ -528,6 +730,10 @@ static int dp_rx_thread_sub_loop(struct dp_rx_thread *rx_thread, bool *shutdown)
 				 qdf_get_current_pid());
 			qdf_wait_single_event(&rx_thread->resume_event, 0);
 		}
+
+		/* budget consumed, let other runnable threads in */
+		if (yield)
+			cond_resched();
 		break;
 	}
 	return 0;
@@ -590,8 +796,143 @@ static int dp_rx_thread_loop(void *arg)
 	return 0;
 }
 
+#ifdef WLAN_FEATURE_RX_PREALLOC_BUFFER_POOL
+/**
+ * dp_rx_refill_pool_empty() - check if the refill buffer pool ran dry
+ * @refill_thread: rx refill thread
+ *
+ * Return: true if the pool has no pre-allocated buffer left
+ */
+static bool dp_rx_refill_pool_empty(struct dp_rx_refill_thread *refill_thread)
+{
+	struct dp_soc *soc = refill_thread->soc;
+
+	return !READ_ONCE(soc->rx_refill_buff_pool.bufq_len);
+}
+#else
+static bool dp_rx_refill_pool_empty(struct dp_rx_refill_thread *refill_thread)
+{
+	return false;
+}
+#endif
+
+void dp_rx_refill_thread_sched_ind(struct dp_rx_refill_thread *refill_thread)
+{
+	uint64_t now_us = qdf_get_log_timestamp_usecs();
+	uint64_t interval_us;
+	bool empty = dp_rx_refill_pool_empty(refill_thread);
+
+	qdf_spin_lock_bh(&refill_thread->lock);
+	refill_thread->stats.sched_ind++;
+	if (empty)
+		refill_thread->stats.empty_ring++;
+
+	if (refill_thread->last_sched_ts_us &&
+	    now_us > refill_thread->last_sched_ts_us) {
+		interval_us = now_us - refill_thread->last_sched_ts_us;
+		/* seed with the first interval, then 1/8 weight per sample */
+		if (!refill_thread->sched_interval_us)
+			refill_thread->sched_interval_us = interval_us;
+		else
+			refill_thread->sched_interval_us =
+				(refill_thread->sched_interval_us * 7 +
+				 interval_us) >> 3;
+	}
+	refill_thread->last_sched_ts_us = now_us;
+
+	if (qdf_atomic_test_and_set_bit(RX_REFILL_POST_EVENT,
+					&refill_thread->event_flag)) {
+		refill_thread->stats.sched_while_pending++;
+		qdf_spin_unlock_bh(&refill_thread->lock);
+		return;
+	}
+
+	refill_thread->sched_ts_us = now_us;
+	qdf_spin_unlock_bh(&refill_thread->lock);
+	qdf_wake_up_interruptible(&refill_thread->wait_q);
+}
+
+QDF_STATUS
+dp_rx_refill_thread_dump_stats(struct dp_rx_refill_thread *refill_thread)
+{
+	struct dp_rx_refill_thread_stats stats;
+	uint64_t interval_us;
+
+	qdf_spin_lock_bh(&refill_thread->lock);
+	stats = refill_thread->stats;
+	interval_us = refill_thread->sched_interval_us;
+	qdf_spin_unlock_bh(&refill_thread->lock);
+
+	dp_info("refill thread - predictive:%u sched:%u sched_while_pending:%u empty_ring:%u refills:%u predictive_refills:%u interval:%llu us latency(avg:%llu max:%llu us)",
+		refill_thread->predictive, stats.sched_ind,
+		stats.sched_while_pending, stats.empty_ring, stats.refills,
+		stats.predictive_refills, interval_us,
+		stats.refills ?
+			qdf_do_div(stats.latency_total_us, stats.refills) : 0,
+		stats.latency_max_us);
+
+	return QDF_STATUS_SUCCESS;
+}
+
+/**
+ * dp_rx_refill_thread_predict_timeout() - get the predictive wait timeout
+ * @rx_thread: rx refill thread
+ *
+ * Return: time in ms after which the refill thread should replenish on its
+ *	   own, 0 if the thread should wait for the next refill request
+ */
+static uint32_t
+dp_rx_refill_thread_predict_timeout(struct dp_rx_refill_thread *rx_thread)
+{
+	uint64_t now_us;
+	uint64_t interval_us;
+	uint64_t last_sched_ts_us;
+
+	if (!rx_thread->predictive)
+		return 0;
+
+	qdf_spin_lock_bh(&rx_thread->lock);
+	interval_us = rx_thread->sched_interval_us;
+	last_sched_ts_us = rx_thread->last_sched_ts_us;
+	qdf_spin_unlock_bh(&rx_thread->lock);
+
+	if (!interval_us || interval_us > DP_RX_REFILL_PREDICT_INTERVAL_US)
+		return 0;
+
+	now_us = qdf_get_log_timestamp_usecs();
+	if (now_us - last_sched_ts_us > DP_RX_REFILL_PREDICT_IDLE_US)
+		return 0;
+
+	/* wake up half way to the next expected request, at least 1 ms */
+	return qdf_max((uint32_t)(interval_us / 2000), (uint32_t)1);
+}
+
+/**
+ * dp_rx_refill_thread_update_latency() - account a served refill request
+ * @rx_thread: rx refill thread
+ *
+ * Return: None
+ */
+static void
+dp_rx_refill_thread_update_latency(struct dp_rx_refill_thread *rx_thread)
+{
+	uint64_t latency_us;
+
+	qdf_spin_lock_bh(&rx_thread->lock);
+	rx_thread->stats.refills++;
+	if (rx_thread->sched_ts_us) {
+		latency_us = qdf_get_log_timestamp_usecs() -
+			     rx_thread->sched_ts_us;
+		rx_thread->sched_ts_us = 0;
+		rx_thread->stats.latency_total_us += latency_us;
+		if (latency_us > rx_thread->stats.latency_max_us)
+			rx_thread->stats.latency_max_us = latency_us;
+	}
+	qdf_spin_unlock_bh(&rx_thread->lock);
+}
+
 static int dp_rx_refill_thread_sub_loop(struct dp_rx_refill_thread *rx_thread,
-					bool *shutdown)
+					bool *shutdown, bool predicted)
 {
 	while (true) {
 		if (qdf_atomic_test_and_clear_bit(RX_REFILL_SHUTDOWN_EVENT,
@@ -607,6 +948,13 @@ static int dp_rx_refill_thread_sub_loop(struct dp_rx_refill_thread *rx_thread,
 		}
 
 		dp_rx_refill_buff_pool_enqueue((struct dp_soc *)rx_thread->soc);
+		if (predicted) {
+			qdf_spin_lock_bh(&rx_thread->lock);
+			rx_thread->stats.predictive_refills++;
+			qdf_spin_unlock_bh(&rx_thread->lock);
+		} else {
+			dp_rx_refill_thread_update_latency(rx_thread);
+		}
 
 		if (qdf_atomic_test_and_clear_bit(RX_REFILL_SUSPEND_EVENT,
 						  &rx_thread->event_flag)) {
@@ -628,7 +976,9 @@ static int dp_rx_refill_thread_loop(void *arg)
 {
 	struct dp_rx_refill_thread *rx_thread = arg;
 	bool shutdown = false;
-	int status;
+	bool predicted;
+	uint32_t timeout_ms;
+	long status;
 
 	if (!arg) {
 		dp_err("bad Args passed");
@@ -643,19 +993,34 @@ static int dp_rx_refill_thread_loop(void *arg)
 		qdf_get_current_pid());
 	while (!shutdown) {
 		/* This implements the execution model algorithm */
-		status =
-		    qdf_wait_queue_interruptible
+		predicted = false;
+		timeout_ms = dp_rx_refill_thread_predict_timeout(rx_thread);
+		if (timeout_ms) {
+			status = qdf_wait_queue_timeout
+				(rx_thread->wait_q,
+				 qdf_atomic_test_bit(RX_REFILL_POST_EVENT,
+						     &rx_thread->event_flag) ||
+				 qdf_atomic_test_bit(RX_REFILL_SUSPEND_EVENT,
+						     &rx_thread->event_flag),
+				 qdf_system_msecs_to_ticks(timeout_ms));
+			/* timed out, replenish ahead of the next request */
+			if (!status)
+				predicted = true;
+		} else {
+			status =
+			    qdf_wait_queue_interruptible
 				(rx_thread->wait_q,
 				 qdf_atomic_test_bit(RX_REFILL_POST_EVENT,
 						     &rx_thread->event_flag) ||
 				 qdf_atomic_test_bit(RX_REFILL_SUSPEND_EVENT,
 						     &rx_thread->event_flag));
+		}
 
 		if (status == -ERESTARTSYS) {
 			QDF_DEBUG_PANIC("wait_event_interruptible returned -ERESTARTSYS");
 			break;
 		}
-		dp_rx_refill_thread_sub_loop(rx_thread, &shutdown);
+		dp_rx_refill_thread_sub_loop(rx_thread, &shutdown, predicted);
 		qdf_atomic_clear_bit(RX_REFILL_POST_EVENT, &rx_thread->event_flag);
 	}
 
@@ -795,6 +1160,11 @@ QDF_STATUS dp_rx_refill_thread_init(struct dp_rx_refill_thread *refill_thread)
 
 	refill_thread->state = DP_RX_REFILL_THREAD_INVALID;
 	refill_thread->event_flag = 0;
+	refill_thread->sched_ts_us = 0;
+	refill_thread->last_sched_ts_us = 0;
+	refill_thread->sched_interval_us = 0;
+	qdf_mem_zero(&refill_thread->stats, sizeof(refill_thread->stats));
+	qdf_spinlock_create(&refill_thread->lock);
 	qdf_event_create(&refill_thread->start_event);
 	qdf_event_create(&refill_thread->suspend_event);
 	qdf_event_create(&refill_thread->resume_event);
@@ -833,6 +1203,7 @@ QDF_STATUS dp_rx_refill_thread_deinit(struct dp_rx_refill_thread *refill_thread)
 	qdf_event_destroy(&refill_thread->suspend_event);
 	qdf_event_destroy(&refill_thread->resume_event);
 	qdf_event_destroy(&refill_thread->shutdown_event);
+	qdf_spinlock_destroy(&refill_thread->lock);
 
 	refill_thread->state = DP_RX_REFILL_THREAD_INVALID;
 	return QDF_STATUS_SUCCESS;
@@ -864,6 +1235,8 @@ QDF_STATUS dp_rx_tm_init(struct dp_rx_tm_handle *rx_tm_hdl,
 		goto ret;
 	}
 
+	qdf_spinlock_create(&rx_tm_hdl->qdepth_ind_lock);
+
 	for (i = 0; i < rx_tm_hdl->num_dp_rx_threads; i++) {
 		rx_tm_hdl->rx_thread[i] =
 			(struct dp_rx_thread *)
@@ -1046,7 +1419,8 @@ QDF_STATUS dp_rx_thread_flush_by_vdev_id(struct dp_rx_thread *rx_thread,
 		 * while net_vdev will be freed soon.
 		 */
 		dp_rx_thread_gro_flush(rx_thread,
-				       DP_RX_GRO_NORMAL_FLUSH);
+				       DP_RX_GRO_NORMAL_FLUSH,
+				       DP_RX_GRO_FLUSH_VDEV_DEL);
 	} else
 		dp_err("thread:%d failed while waiting for napi gro flush",
 		       rx_thread->id);
@@ -1235,6 +1609,8 @@ QDF_STATUS dp_rx_tm_deinit(struct dp_rx_tm_handle *rx_tm_hdl)
 	qdf_mem_free(rx_tm_hdl->rx_thread);
 	rx_tm_hdl->rx_thread = NULL;
 
+	qdf_spinlock_destroy(&rx_tm_hdl->qdepth_ind_lock);
+
 	return QDF_STATUS_SUCCESS;
 }
 
@@ -1293,6 +1669,30 @@ dp_rx_tm_gro_flush_ind(struct dp_rx_tm_handle *rx_tm_hdl, int rx_ctx_id,
 	return QDF_STATUS_SUCCESS;
 }
 
+QDF_STATUS dp_rx_tm_register_qdepth_ind_cb(struct dp_rx_tm_handle *rx_tm_hdl,
+					   uint32_t thresh,
+					   dp_rx_tm_qdepth_ind_cb cb,
+					   void *ctx)
+{
+	if (!thresh || !cb) {
+		qdf_spin_lock_bh(&rx_tm_hdl->qdepth_ind_lock);
+		rx_tm_hdl->qdepth_ind_cb = NULL;
+		rx_tm_hdl->qdepth_ind_thresh = 0;
+		rx_tm_hdl->qdepth_ind_ctx = NULL;
+		qdf_spin_unlock_bh(&rx_tm_hdl->qdepth_ind_lock);
+		return QDF_STATUS_SUCCESS;
+	}
+
+	qdf_spin_lock_bh(&rx_tm_hdl->qdepth_ind_lock);
+	rx_tm_hdl->qdepth_ind_ctx = ctx;
+	rx_tm_hdl->qdepth_ind_thresh = thresh;
+	rx_tm_hdl->qdepth_ind_cb = cb;
+	qdf_spin_unlock_bh(&rx_tm_hdl->qdepth_ind_lock);
+	dp_info("rx thread qdepth indication at %u", thresh);
+
+	return QDF_STATUS_SUCCESS;
+}
+
 struct napi_struct *dp_rx_tm_get_napi_context(struct dp_rx_tm_handle *rx_tm_hdl,
 					      uint8_t rx_ctx_id)
 {
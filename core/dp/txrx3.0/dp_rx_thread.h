@@ -23,6 +23,7 @@
 #include <qdf_event.h>
 #include <qdf_threads.h>
 #include <wlan_objmgr_vdev_obj.h>
+#include <cds_cpu_acct.h>
 
 /* Maximum number of REO rings supported (for stats tracking) */
 #define DP_RX_TM_MAX_REO_RINGS 4
@@ -30,6 +31,49 @@
 /* Number of DP RX threads supported */
 #define DP_MAX_RX_THREADS DP_RX_TM_MAX_REO_RINGS
 
+/**
+ * enum dp_rx_thread_batch_bucket - buckets of packets delivered per wakeup
+ * @DP_RX_THREAD_BATCH_1: single packet
+ * @DP_RX_THREAD_BATCH_2_7: 2 to 7 packets
+ * @DP_RX_THREAD_BATCH_8_31: 8 to 31 packets
+ * @DP_RX_THREAD_BATCH_32_127: 32 to 127 packets
+ * @DP_RX_THREAD_BATCH_128_511: 128 to 511 packets
+ * @DP_RX_THREAD_BATCH_512_PLUS: 512 packets or more
+ * @DP_RX_THREAD_BATCH_MAX: max bucket, used as array size
+ */
+enum dp_rx_thread_batch_bucket {
+	DP_RX_THREAD_BATCH_1,
+	DP_RX_THREAD_BATCH_2_7,
+	DP_RX_THREAD_BATCH_8_31,
+	DP_RX_THREAD_BATCH_32_127,
+	DP_RX_THREAD_BATCH_128_511,
+	DP_RX_THREAD_BATCH_512_PLUS,
+	DP_RX_THREAD_BATCH_MAX
+};
+
+/**
+ * enum dp_rx_gro_flush_reason - events on which a DP rx thread flushes GRO
+ * @DP_RX_GRO_FLUSH_END_OF_BATCH: flush indication posted after an rx ring
+ *				  reap
+ * @DP_RX_GRO_FLUSH_LOW_TPUT: flush indication in low throughput, only the
+ *			      GRO_NORMAL list is delivered
+ * @DP_RX_GRO_FLUSH_PKT_BUDGET: packet budget consumed since the last flush
+ * @DP_RX_GRO_FLUSH_TIME_BUDGET: time budget elapsed since the first packet
+ *				 delivered after the last flush
+ * @DP_RX_GRO_FLUSH_LOW_LATENCY: low latency mode, flush after every nbuf list
+ * @DP_RX_GRO_FLUSH_VDEV_DEL: vdev deletion
+ * @DP_RX_GRO_FLUSH_REASON_MAX: max reason, used as array size
+ */
+enum dp_rx_gro_flush_reason {
+	DP_RX_GRO_FLUSH_END_OF_BATCH,
+	DP_RX_GRO_FLUSH_LOW_TPUT,
+	DP_RX_GRO_FLUSH_PKT_BUDGET,
+	DP_RX_GRO_FLUSH_TIME_BUDGET,
+	DP_RX_GRO_FLUSH_LOW_LATENCY,
+	DP_RX_GRO_FLUSH_VDEV_DEL,
+	DP_RX_GRO_FLUSH_REASON_MAX
+};
+
 /*
  * struct dp_rx_tm_handle_cmn - Opaque handle for rx_threads to store
  * rx_tm_handle. This handle will be common for all the threads.
@@ -53,6 +97,11 @@ struct dp_rx_tm_handle_cmn;
  * @dropped_invalid_peer: packets(nbuf_list) dropped due to no peer
  * @dropped_others: packets dropped due to other reasons
  * @dropped_enq_fail: packets dropped due to pending queue full
+ * @budget_exhausted: wakeups which ended with the rx thread budget consumed
+ *		      and packets still pending in the queue
+ * @batch_hist: histogram of packets delivered to the stack per wakeup
+ * @gro_flush_reason: GRO flushes per enum dp_rx_gro_flush_reason
+ * @cpu_acct: CPU usage of the thread wakeups
  */
 struct dp_rx_thread_stats {
 	unsigned int nbuf_queued[DP_RX_TM_MAX_REO_RINGS];
@@ -68,6 +117,10 @@ struct dp_rx_thread_stats {
 	unsigned int dropped_invalid_os_rx_handles;
 	unsigned int dropped_others;
 	unsigned int dropped_enq_fail;
+	unsigned int budget_exhausted;
+	unsigned int batch_hist[DP_RX_THREAD_BATCH_MAX];
+	unsigned int gro_flush_reason[DP_RX_GRO_FLUSH_REASON_MAX];
+	struct cds_cpu_acct cpu_acct;
 };
 
 /**
@@ -104,6 +157,9 @@ enum dp_rx_refill_thread_state {
  *		    structures via APIs.
  * @napi: napi to deliver packet to stack via GRO
  * @netdev: dummy netdev to initialize the napi structure with
+ * @gro_pending_pkts: packets delivered to @napi since the last GRO flush
+ * @gro_pending_ts_us: time of the first packet delivered to @napi since the
+ *		       last GRO flush
  */
 struct dp_rx_thread {
 	uint8_t id;
@@ -122,6 +178,32 @@ struct dp_rx_thread {
 	struct napi_struct napi;
 	qdf_wait_queue_head_t wait_q;
 	struct net_device netdev;
+	uint32_t gro_pending_pkts;
+	uint64_t gro_pending_ts_us;
+};
+
+/**
+ * struct dp_rx_refill_thread_stats - structure holding stats for DP Rx refill
+ *				      thread
+ * @sched_ind: refill requests received from the rx path
+ * @sched_while_pending: refill requests received while the previous request
+ *			 was not yet served, i.e. rx consumed buffers faster
+ *			 than the thread could replenish them
+ * @empty_ring: refill requests raised with the refill buffer pool empty,
+ *		i.e. the rx ring ran out of pre-allocated buffers
+ * @refills: refill passes run on request from the rx path
+ * @predictive_refills: refill passes run ahead of demand in predictive mode
+ * @latency_max_us: max time between a refill request and its completion
+ * @latency_total_us: sum of refill latencies, used to report the average
+ */
+struct dp_rx_refill_thread_stats {
+	unsigned int sched_ind;
+	unsigned int sched_while_pending;
+	unsigned int empty_ring;
+	unsigned int refills;
+	unsigned int predictive_refills;
+	uint64_t latency_max_us;
+	uint64_t latency_total_us;
 };
 
 /**
@@ -136,6 +218,14 @@ struct dp_rx_thread {
  * @enabled: flag to check whether DP Rx refill thread is enabled
  * @soc: abstract DP soc reference used in internal API's
  * @state: state of DP Rx refill thread
+ * @predictive: predictive replenish mode is enabled
+ * @lock: protects the request timestamps, @sched_interval_us and @stats
+ *	  against the rx contexts requesting refills concurrently
+ * @sched_ts_us: timestamp of the oldest refill request not yet served
+ * @last_sched_ts_us: timestamp of the last refill request
+ * @sched_interval_us: moving average of time between refill requests, an
+ *		       estimate of how fast the rx path consumes buffers
+ * @stats: refill thread stats
  */
 struct dp_rx_refill_thread {
 	qdf_thread_t *task;
@@ -148,6 +238,12 @@ struct dp_rx_refill_thread {
 	bool enabled;
 	void *soc;
 	enum dp_rx_refill_thread_state state;
+	bool predictive;
+	qdf_spinlock_t lock;
+	uint64_t sched_ts_us;
+	uint64_t last_sched_ts_us;
+	uint64_t sched_interval_us;
+	struct dp_rx_refill_thread_stats stats;
 };
 
 /**
@@ -165,6 +261,14 @@ enum dp_rx_thread_state {
 	DP_RX_THREADS_SUSPENDED
 };
 
+/**
+ * typedef dp_rx_tm_qdepth_ind_cb - callback indicating that an rx thread
+ *				    queue reached the registered depth
+ * @ctx: context registered along with the callback
+ * @qlen: nbuf queue length of the rx thread
+ */
+typedef void (*dp_rx_tm_qdepth_ind_cb)(void *ctx, uint32_t qlen);
+
 /**
  * struct dp_rx_tm_handle - DP RX thread infrastructure handle
  * @num_dp_rx_threads: number of DP RX threads initialized
@@ -172,6 +276,12 @@ enum dp_rx_thread_state {
  * @state: state of the rx_threads. All of them should be in the same state.
  * @rx_thread: array of pointers of type struct dp_rx_thread
  * @allow_dropping: flag to indicate frame dropping is enabled
+ * @qdepth_ind_cb: callback invoked when an rx thread queue crosses
+ *		   @qdepth_ind_thresh
+ * @qdepth_ind_ctx: context passed to @qdepth_ind_cb
+ * @qdepth_ind_thresh: rx thread queue length to invoke @qdepth_ind_cb at
+ * @qdepth_ind_lock: serializes @qdepth_ind_cb invocations with its
+ *		     (de)registration
  */
 struct dp_rx_tm_handle {
 	uint8_t num_dp_rx_threads;
@@ -179,6 +289,10 @@ struct dp_rx_tm_handle {
 	enum dp_rx_thread_state state;
 	struct dp_rx_thread **rx_thread;
 	qdf_atomic_t allow_dropping;
+	dp_rx_tm_qdepth_ind_cb qdepth_ind_cb;
+	void *qdepth_ind_ctx;
+	uint32_t qdepth_ind_thresh;
+	qdf_spinlock_t qdepth_ind_lock;
 };
 
 /**
@@ -210,6 +324,23 @@ QDF_STATUS dp_rx_refill_thread_init(struct dp_rx_refill_thread *refill_thread);
 QDF_STATUS
 dp_rx_refill_thread_deinit(struct dp_rx_refill_thread *refill_thread);
 
+/**
+ * dp_rx_refill_thread_sched_ind() - request a refill from DP Rx refill thread
+ * @refill_thread: Contains over all rx refill thread info
+ *
+ * Return: None
+ */
+void dp_rx_refill_thread_sched_ind(struct dp_rx_refill_thread *refill_thread);
+
+/**
+ * dp_rx_refill_thread_dump_stats() - dump stats of DP Rx refill thread
+ * @refill_thread: Contains over all rx refill thread info
+ *
+ * Return: QDF_STATUS_SUCCESS
+ */
+QDF_STATUS
+dp_rx_refill_thread_dump_stats(struct dp_rx_refill_thread *refill_thread);
+
 /**
  * dp_rx_tm_init() - initialize DP Rx thread infrastructure
  * @rx_tm_hdl: dp_rx_tm_handle containing the overall thread infrastructure
@@ -228,6 +359,26 @@ QDF_STATUS dp_rx_tm_init(struct dp_rx_tm_handle *rx_tm_hdl,
  */
 QDF_STATUS dp_rx_tm_deinit(struct dp_rx_tm_handle *rx_tm_hdl);
 
+/**
+ * dp_rx_tm_register_qdepth_ind_cb() - register a callback to be invoked when
+ *				       an rx thread queue reaches a depth
+ * @rx_tm_hdl: dp_rx_tm_handle containing the overall thread infrastructure
+ * @thresh: rx thread queue length at which @cb is invoked, 0 to deregister
+ * @cb: callback, invoked from the rx enqueue context, must not sleep
+ * @ctx: context passed to @cb
+ *
+ * @cb is invoked once each time a queue grows from below @thresh to @thresh
+ * or more, so that a consumer can ramp up resources ahead of its periodic
+ * sampling. Once this returns, the previously registered callback is no
+ * longer running and is not invoked again.
+ *
+ * Return: QDF_STATUS_SUCCESS
+ */
+QDF_STATUS dp_rx_tm_register_qdepth_ind_cb(struct dp_rx_tm_handle *rx_tm_hdl,
+					   uint32_t thresh,
+					   dp_rx_tm_qdepth_ind_cb cb,
+					   void *ctx);
+
 /**
  * dp_rx_tm_enqueue_pkt() - enqueue RX packet into RXTI
  * @rx_tm_hdl: dp_rx_tm_handle containing the overall thread infrastructure
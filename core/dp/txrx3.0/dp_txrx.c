@@ -47,8 +47,7 @@ static void dp_rx_refill_thread_schedule(ol_txrx_soc_handle soc)
 		return;
 
 	rx_thread = &dp_ext_hdl->refill_thread;
-	qdf_set_bit(RX_REFILL_POST_EVENT, &rx_thread->event_flag);
-	qdf_wake_up_interruptible(&rx_thread->wait_q);
+	dp_rx_refill_thread_sched_ind(rx_thread);
 }
 #else
 static void dp_rx_refill_thread_schedule(ol_txrx_soc_handle soc)
@@ -95,6 +94,8 @@ QDF_STATUS dp_txrx_init(ol_txrx_soc_handle soc, uint8_t pdev_id,
 	if (wlan_cfg_is_rx_refill_buffer_pool_enabled(dp_soc->wlan_cfg_ctx)) {
 		dp_ext_hdl->refill_thread.soc = soc;
 		dp_ext_hdl->refill_thread.enabled = true;
+		dp_ext_hdl->refill_thread.predictive =
+				dp_ext_hdl->config.rx_refill_predictive;
 		qdf_status =
 			dp_rx_refill_thread_init(&dp_ext_hdl->refill_thread);
 		if (qdf_status != QDF_STATUS_SUCCESS) {
@@ -219,6 +220,7 @@ int dp_rx_tm_get_pending(ol_txrx_soc_handle soc)
  * @va_aligned: aligned virtual address.
  * @pa_unaligned: Unaligned physical address.
  * @pa_aligned: Aligned physical address.
+ * @req_size: size requested by the current user of this element
  */
 
 struct dp_consistent_prealloc {
@@ -229,6 +231,7 @@ struct dp_consistent_prealloc {
 	void *va_aligned;
 	qdf_dma_addr_t pa_unaligned;
 	qdf_dma_addr_t pa_aligned;
+	uint32_t req_size;
 };
 
 /**
@@ -240,6 +243,7 @@ struct dp_consistent_prealloc {
  * @in_use: whether this element is in use (occupied)
  * @cacheable: coherent memory or cacheable memory
  * @pages: multi page information storage
+ * @req_num: number of elements requested by the current user
  */
 struct dp_multi_page_prealloc {
 	enum dp_desc_type desc_type;
@@ -248,6 +252,7 @@ struct dp_multi_page_prealloc {
 	bool in_use;
 	bool cacheable;
 	struct qdf_mem_multi_page_t pages;
+	uint16_t req_num;
 };
 
 /**
@@ -258,6 +263,7 @@ struct dp_multi_page_prealloc {
  * @in_use: whether this element is in use (occupied)
  * @va_unaligned: unaligned virtual address
  * @pa_unaligned: unaligned physical address
+ * @req_size: size requested by the current user of this element
  */
 struct dp_consistent_prealloc_unaligned {
 	enum hal_ring_type ring_type;
@@ -265,6 +271,7 @@ struct dp_consistent_prealloc_unaligned {
 	bool in_use;
 	void *va_unaligned;
 	qdf_dma_addr_t pa_unaligned;
+	uint32_t req_size;
 };
 
 /**
@@ -447,6 +454,224 @@ static struct dp_consistent_prealloc_unaligned
 	 + CE_DESC_RING_ALIGN), false, NULL, 0},
 };
 
+/**
+ * enum dp_prealloc_pool - DP pre-alloc pools
+ * @DP_PREALLOC_POOL_CONTEXT: context memory, keyed by enum dp_ctxt_type
+ * @DP_PREALLOC_POOL_CONSISTENT: aligned consistent ring memory, keyed by
+ *				 enum hal_ring_type
+ * @DP_PREALLOC_POOL_MULTI_PAGE: multi-page descriptor memory, keyed by
+ *				 enum dp_desc_type
+ * @DP_PREALLOC_POOL_UNALIGNED: unaligned consistent memory, keyed by
+ *				enum hal_ring_type
+ * @DP_PREALLOC_POOL_MAX: max pool, used as array size
+ */
+enum dp_prealloc_pool {
+	DP_PREALLOC_POOL_CONTEXT,
+	DP_PREALLOC_POOL_CONSISTENT,
+	DP_PREALLOC_POOL_MULTI_PAGE,
+	DP_PREALLOC_POOL_UNALIGNED,
+	DP_PREALLOC_POOL_MAX
+};
+
+static const char * const dp_prealloc_pool_name[DP_PREALLOC_POOL_MAX] = {
+	[DP_PREALLOC_POOL_CONTEXT] = "context",
+	[DP_PREALLOC_POOL_CONSISTENT] = "consistent",
+	[DP_PREALLOC_POOL_MULTI_PAGE] = "multi_page",
+	[DP_PREALLOC_POOL_UNALIGNED] = "unaligned",
+};
+
+/* Max number of (pool, type) pairs tracked for pre-alloc usage */
+#define DP_PREALLOC_MAX_TYPE_STATS 32
+
+/**
+ * struct dp_prealloc_type_stats - pre-alloc usage of one type in a pool
+ * @pool: pre-alloc pool
+ * @type: ring/descriptor/context type in the pool
+ * @in_use: number of pre-alloc elements of this type currently handed out
+ * @hwm: high watermark of @in_use
+ * @hits: requests served from the pre-alloc pool
+ * @fallbacks: requests not served from the pre-alloc pool, which the caller
+ *	       then allocates at runtime
+ * @max_req_size: largest size requested for this type
+ * @slack: bytes of pre-alloc memory handed out beyond the requested size,
+ *	   for the elements currently in use
+ */
+struct dp_prealloc_type_stats {
+	enum dp_prealloc_pool pool;
+	uint32_t type;
+	uint16_t in_use;
+	uint16_t hwm;
+	uint32_t hits;
+	uint32_t fallbacks;
+	uint32_t max_req_size;
+	uint32_t slack;
+};
+
+static struct dp_prealloc_type_stats
+		g_dp_prealloc_stats[DP_PREALLOC_MAX_TYPE_STATS];
+static uint8_t g_dp_prealloc_num_stats;
+
+/**
+ * dp_prealloc_type_stats_get() - get usage stats entry of a pool type
+ * @pool: pre-alloc pool
+ * @type: type in the pool
+ *
+ * Like the pre-alloc pools, the stats are only updated from init/de-init
+ * contexts and are not protected by a lock.
+ *
+ * Return: stats entry, NULL if no more types can be tracked
+ */
+static struct dp_prealloc_type_stats *
+dp_prealloc_type_stats_get(enum dp_prealloc_pool pool, uint32_t type)
+{
+	struct dp_prealloc_type_stats *ts;
+	int i;
+
+	for (i = 0; i < g_dp_prealloc_num_stats; i++) {
+		ts = &g_dp_prealloc_stats[i];
+		if (ts->pool == pool && ts->type == type)
+			return ts;
+	}
+
+	if (g_dp_prealloc_num_stats == DP_PREALLOC_MAX_TYPE_STATS)
+		return NULL;
+
+	ts = &g_dp_prealloc_stats[g_dp_prealloc_num_stats++];
+	ts->pool = pool;
+	ts->type = type;
+
+	return ts;
+}
+
+/**
+ * dp_prealloc_stats_alloc() - account a pre-alloc request
+ * @pool: pre-alloc pool
+ * @type: type in the pool
+ * @req_size: requested size
+ * @alloc_size: size of the pre-alloc element handed out, 0 on fallback
+ *
+ * Return: None
+ */
+static void dp_prealloc_stats_alloc(enum dp_prealloc_pool pool, uint32_t type,
+				    uint32_t req_size, uint32_t alloc_size)
+{
+	struct dp_prealloc_type_stats *ts;
+
+	ts = dp_prealloc_type_stats_get(pool, type);
+	if (!ts)
+		return;
+
+	if (req_size > ts->max_req_size)
+		ts->max_req_size = req_size;
+
+	if (!alloc_size) {
+		ts->fallbacks++;
+		dp_warn("%s type %u size %u not pre-allocated, falling back to runtime allocation",
+			dp_prealloc_pool_name[pool], type, req_size);
+		return;
+	}
+
+	ts->hits++;
+	ts->in_use++;
+	if (ts->in_use > ts->hwm)
+		ts->hwm = ts->in_use;
+	if (alloc_size > req_size)
+		ts->slack += alloc_size - req_size;
+}
+
+/**
+ * dp_prealloc_stats_free() - account a pre-alloc element put back
+ * @pool: pre-alloc pool
+ * @type: type in the pool
+ * @req_size: size requested when the element was handed out
+ * @alloc_size: size of the pre-alloc element
+ *
+ * Return: None
+ */
+static void dp_prealloc_stats_free(enum dp_prealloc_pool pool, uint32_t type,
+				   uint32_t req_size, uint32_t alloc_size)
+{
+	struct dp_prealloc_type_stats *ts;
+
+	ts = dp_prealloc_type_stats_get(pool, type);
+	if (!ts || !ts->in_use)
+		return;
+
+	ts->in_use--;
+	if (alloc_size > req_size && ts->slack >= alloc_size - req_size)
+		ts->slack -= alloc_size - req_size;
+}
+
+/**
+ * dp_prealloc_num_elements() - number of pre-alloc elements of a pool type
+ * @pool: pre-alloc pool
+ * @type: type in the pool
+ *
+ * Return: number of elements pre-allocated at init for @type
+ */
+static uint32_t dp_prealloc_num_elements(enum dp_prealloc_pool pool,
+					 uint32_t type)
+{
+	uint32_t num = 0;
+	int i;
+
+	switch (pool) {
+	case DP_PREALLOC_POOL_CONTEXT:
+		for (i = 0; i < QDF_ARRAY_SIZE(g_dp_context_allocs); i++)
+			if (g_dp_context_allocs[i].ctxt_type == type &&
+			    g_dp_context_allocs[i].addr)
+				num++;
+		break;
+	case DP_PREALLOC_POOL_CONSISTENT:
+		for (i = 0; i < QDF_ARRAY_SIZE(g_dp_consistent_allocs); i++)
+			if (g_dp_consistent_allocs[i].ring_type == type &&
+			    g_dp_consistent_allocs[i].va_unaligned)
+				num++;
+		break;
+	case DP_PREALLOC_POOL_MULTI_PAGE:
+		for (i = 0; i < QDF_ARRAY_SIZE(g_dp_multi_page_allocs); i++)
+			if (g_dp_multi_page_allocs[i].desc_type == type &&
+			    g_dp_multi_page_allocs[i].pages.num_pages)
+				num++;
+		break;
+	case DP_PREALLOC_POOL_UNALIGNED:
+		for (i = 0;
+		     i < QDF_ARRAY_SIZE(g_dp_consistent_unaligned_allocs); i++)
+			if (g_dp_consistent_unaligned_allocs[i].ring_type ==
+			    type &&
+			    g_dp_consistent_unaligned_allocs[i].va_unaligned)
+				num++;
+		break;
+	default:
+		break;
+	}
+
+	return num;
+}
+
+qdf_size_t dp_prealloc_print_stats(char *buf, qdf_size_t buf_len)
+{
+	struct dp_prealloc_type_stats *ts;
+	qdf_size_t len = 0;
+	int i;
+
+	len += qdf_scnprintf(buf + len, buf_len - len,
+			     "pool type prealloc hwm in_use hits fallbacks max_req_size slack\n");
+	for (i = 0; i < g_dp_prealloc_num_stats && len < buf_len; i++) {
+		ts = &g_dp_prealloc_stats[i];
+		len += qdf_scnprintf(buf + len, buf_len - len,
+				     "%s %u %u %u %u %u %u %u %u\n",
+				     dp_prealloc_pool_name[ts->pool], ts->type,
+				     dp_prealloc_num_elements(ts->pool,
+							      ts->type),
+				     ts->hwm, ts->in_use, ts->hits,
+				     ts->fallbacks, ts->max_req_size,
+				     ts->slack);
+	}
+
+	return len;
+}
+
 void dp_prealloc_deinit(void)
 {
 	int i;
@@ -542,6 +767,9 @@ QDF_STATUS dp_prealloc_init(void)
 		return QDF_STATUS_E_FAILURE;
 	}
 
+	qdf_mem_zero(g_dp_prealloc_stats, sizeof(g_dp_prealloc_stats));
+	g_dp_prealloc_num_stats = 0;
+
 	/*Context pre-alloc*/
 	for (i = 0; i < QDF_ARRAY_SIZE(g_dp_context_allocs); i++) {
 		cp = &g_dp_context_allocs[i];
@@ -651,10 +879,14 @@ void *dp_prealloc_get_context_memory(uint32_t ctxt_type)
 		if ((ctxt_type == cp->ctxt_type) && !cp->in_use &&
 		    cp->addr) {
 			cp->in_use = true;
+			dp_prealloc_stats_alloc(DP_PREALLOC_POOL_CONTEXT,
+						ctxt_type, cp->size, cp->size);
 			return cp->addr;
 		}
 	}
 
+	dp_prealloc_stats_alloc(DP_PREALLOC_POOL_CONTEXT, ctxt_type, 0, 0);
+
 	return NULL;
 }
 
@@ -672,6 +904,8 @@ QDF_STATUS dp_prealloc_put_context_memory(uint32_t ctxt_type, void *vaddr)
 		if ((ctxt_type == cp->ctxt_type) && vaddr == cp->addr) {
 			qdf_mem_zero(cp->addr, cp->size);
 			cp->in_use = false;
+			dp_prealloc_stats_free(DP_PREALLOC_POOL_CONTEXT,
+					       ctxt_type, cp->size, cp->size);
 			return QDF_STATUS_SUCCESS;
 		}
 	}
@@ -686,30 +920,40 @@ void *dp_prealloc_get_coherent(uint32_t *size, void **base_vaddr_unaligned,
 			       uint32_t ring_type)
 {
 	int i;
-	struct dp_consistent_prealloc *p;
+	struct dp_consistent_prealloc *p, *best = NULL;
 	void *va_aligned = NULL;
 
+	/* pick the smallest free element the request fits in */
 	for (i = 0; i < QDF_ARRAY_SIZE(g_dp_consistent_allocs); i++) {
 		p = &g_dp_consistent_allocs[i];
 		if (p->ring_type == ring_type && !p->in_use &&
-		    p->va_unaligned && *size <= p->size) {
-			p->in_use = 1;
-			*base_vaddr_unaligned = p->va_unaligned;
-			*paddr_unaligned = p->pa_unaligned;
-			*paddr_aligned = p->pa_aligned;
-			va_aligned = p->va_aligned;
-			*size = p->size;
-			dp_debug("index %i -> ring type %s va-aligned %pK", i,
-				dp_srng_get_str_from_hal_ring_type(ring_type),
-				va_aligned);
-			break;
-		}
+		    p->va_unaligned && *size <= p->size &&
+		    (!best || p->size < best->size))
+			best = p;
 	}
 
-	if (i == QDF_ARRAY_SIZE(g_dp_consistent_allocs))
+	if (!best) {
 		dp_info("unable to allocate memory for ring type %s (%d) size %d",
 			dp_srng_get_str_from_hal_ring_type(ring_type),
 			ring_type, *size);
+		dp_prealloc_stats_alloc(DP_PREALLOC_POOL_CONSISTENT, ring_type,
+					*size, 0);
+		return NULL;
+	}
+
+	best->in_use = 1;
+	best->req_size = *size;
+	*base_vaddr_unaligned = best->va_unaligned;
+	*paddr_unaligned = best->pa_unaligned;
+	*paddr_aligned = best->pa_aligned;
+	va_aligned = best->va_aligned;
+	dp_prealloc_stats_alloc(DP_PREALLOC_POOL_CONSISTENT, ring_type,
+				*size, best->size);
+	*size = best->size;
+	dp_debug("index %i -> ring type %s va-aligned %pK",
+		 (int)(best - g_dp_consistent_allocs),
+		 dp_srng_get_str_from_hal_ring_type(ring_type), va_aligned);
+
 	return va_aligned;
 }
 
@@ -724,6 +968,9 @@ void dp_prealloc_put_coherent(qdf_size_t size, void *vaddr_unligned,
 		if (p->va_unaligned == vaddr_unligned) {
 			dp_debug("index %d, returned", i);
 			p->in_use = 0;
+			dp_prealloc_stats_free(DP_PREALLOC_POOL_CONSISTENT,
+					       p->ring_type, p->req_size,
+					       p->size);
 			qdf_mem_zero(p->va_unaligned, p->size);
 			break;
 		}
@@ -750,6 +997,12 @@ void dp_prealloc_get_multi_pages(uint32_t desc_type,
 		    element_num <= mp->element_num) {
 			mp->in_use = true;
 			*pages = mp->pages;
+			dp_prealloc_stats_alloc(DP_PREALLOC_POOL_MULTI_PAGE,
+						desc_type,
+						element_size * element_num,
+						mp->element_size *
+						mp->element_num);
+			mp->req_num = element_num;
 
 			dp_info("i %d: desc_type %d cacheable_pages %pK"
 				"dma_pages %pK num_pages %d",
@@ -760,6 +1013,10 @@ void dp_prealloc_get_multi_pages(uint32_t desc_type,
 			break;
 		}
 	}
+
+	if (i == QDF_ARRAY_SIZE(g_dp_multi_page_allocs))
+		dp_prealloc_stats_alloc(DP_PREALLOC_POOL_MULTI_PAGE, desc_type,
+					element_size * element_num, 0);
 }
 
 void dp_prealloc_put_multi_pages(uint32_t desc_type,
@@ -783,6 +1040,12 @@ void dp_prealloc_put_multi_pages(uint32_t desc_type,
 				dp_info("i %d: desc_type %d returned",
 					i, desc_type);
 				mp->in_use = false;
+				dp_prealloc_stats_free(DP_PREALLOC_POOL_MULTI_PAGE,
+						       desc_type,
+						       mp->element_size *
+						       mp->req_num,
+						       mp->element_size *
+						       mp->element_num);
 				qdf_mem_multi_pages_zero(&mp->pages,
 							 mp->cacheable);
 				break;
@@ -803,23 +1066,34 @@ void *dp_prealloc_get_consistent_mem_unaligned(size_t size,
 					       uint32_t ring_type)
 {
 	int i;
-	struct dp_consistent_prealloc_unaligned *up;
+	struct dp_consistent_prealloc_unaligned *up, *best = NULL;
 
+	/* pick the smallest free element the request fits in */
 	for (i = 0; i < QDF_ARRAY_SIZE(g_dp_consistent_unaligned_allocs); i++) {
 		up = &g_dp_consistent_unaligned_allocs[i];
 
-		if (ring_type == up->ring_type && size == up->size &&
-		    up->va_unaligned && !up->in_use) {
-			up->in_use = true;
-			*base_addr = up->pa_unaligned;
-			dp_info("i %d: va unalign %pK pa unalign %pK size %d",
-				i, up->va_unaligned,
-				(void *)up->pa_unaligned, up->size);
-			return up->va_unaligned;
-		}
+		if (ring_type == up->ring_type && size <= up->size &&
+		    up->va_unaligned && !up->in_use &&
+		    (!best || up->size < best->size))
+			best = up;
 	}
 
-	return NULL;
+	if (!best) {
+		dp_prealloc_stats_alloc(DP_PREALLOC_POOL_UNALIGNED, ring_type,
+					size, 0);
+		return NULL;
+	}
+
+	best->in_use = true;
+	best->req_size = size;
+	*base_addr = best->pa_unaligned;
+	dp_prealloc_stats_alloc(DP_PREALLOC_POOL_UNALIGNED, ring_type,
+				size, best->size);
+	dp_info("i %d: va unalign %pK pa unalign %pK size %d",
+		(int)(best - g_dp_consistent_unaligned_allocs),
+		best->va_unaligned, (void *)best->pa_unaligned, best->size);
+
+	return best->va_unaligned;
 }
 
 void dp_prealloc_put_consistent_mem_unaligned(void *va_unaligned)
@@ -833,6 +1107,9 @@ void dp_prealloc_put_consistent_mem_unaligned(void *va_unaligned)
 		if (va_unaligned == up->va_unaligned) {
 			dp_info("index %d, returned", i);
 			up->in_use = false;
+			dp_prealloc_stats_free(DP_PREALLOC_POOL_UNALIGNED,
+					       up->ring_type, up->req_size,
+					       up->size);
 			qdf_mem_zero(up->va_unaligned, up->size);
 			break;
 		}
@@ -28,9 +28,22 @@
 /**
  * struct dp_txrx_config - dp txrx configuration passed to dp txrx modules
  * @enable_dp_rx_threads: enable DP rx threads or not
+ * @rx_thread_budget: max packets delivered by a DP rx thread per wakeup,
+ *		      0 for no limit
+ * @rx_refill_predictive: enable predictive replenish in rx refill thread
+ * @rx_gro_flush_pkt_budget: packets a DP rx thread delivers before it
+ *			     flushes GRO, 0 for no limit
+ * @rx_gro_flush_time_budget_us: max time in us a DP rx thread holds
+ *				 packets in GRO, 0 for no limit
+ * @rx_gro_low_latency: flush GRO after every nbuf list delivered
  */
 struct dp_txrx_config {
 	bool enable_rx_threads;
+	uint32_t rx_thread_budget;
+	bool rx_refill_predictive;
+	uint32_t rx_gro_flush_pkt_budget;
+	uint32_t rx_gro_flush_time_budget_us;
+	bool rx_gro_low_latency;
 };
 
 struct dp_txrx_handle_cmn;
@@ -317,6 +330,35 @@ ret:
 	return qdf_status;
 }
 
+/**
+ * dp_rx_register_qdepth_ind_cb() - register rx thread queue depth callback
+ * @soc: ol_txrx_soc_handle object
+ * @thresh: rx thread queue length at which @cb is invoked, 0 to deregister
+ * @cb: callback, invoked from the rx enqueue context, must not sleep
+ * @ctx: context passed to @cb
+ *
+ * Return: QDF_STATUS_SUCCESS on success, error qdf status on failure
+ */
+static inline
+QDF_STATUS dp_rx_register_qdepth_ind_cb(ol_txrx_soc_handle soc,
+					uint32_t thresh,
+					dp_rx_tm_qdepth_ind_cb cb, void *ctx)
+{
+	struct dp_txrx_handle *dp_ext_hdl;
+
+	if (!soc) {
+		dp_err("invalid input param soc %pK", soc);
+		return QDF_STATUS_E_INVAL;
+	}
+
+	dp_ext_hdl = cdp_soc_get_dp_txrx_handle(soc);
+	if (!dp_ext_hdl)
+		return QDF_STATUS_E_FAULT;
+
+	return dp_rx_tm_register_qdepth_ind_cb(&dp_ext_hdl->rx_tm_hdl, thresh,
+					       cb, ctx);
+}
+
 /**
  * dp_txrx_ext_dump_stats() - dump txrx external module stats
  * @soc: ol_txrx_soc_handle object
@@ -340,10 +382,14 @@ static inline QDF_STATUS dp_txrx_ext_dump_stats(ol_txrx_soc_handle soc,
 		return QDF_STATUS_E_FAULT;
 	}
 
-	if (stats_id == CDP_DP_RX_THREAD_STATS)
+	if (stats_id == CDP_DP_RX_THREAD_STATS) {
 		qdf_status = dp_rx_tm_dump_stats(&dp_ext_hdl->rx_tm_hdl);
-	else
+		if (dp_ext_hdl->refill_thread.enabled)
+			dp_rx_refill_thread_dump_stats(
+						&dp_ext_hdl->refill_thread);
+	} else {
 		qdf_status = QDF_STATUS_E_INVAL;
+	}
 
 	return qdf_status;
 }
@@ -449,6 +495,14 @@ QDF_STATUS dp_rx_gro_flush_ind(ol_txrx_soc_handle soc, int rx_ctx_id,
 	return QDF_STATUS_SUCCESS;
 }
 
+static inline
+QDF_STATUS dp_rx_register_qdepth_ind_cb(ol_txrx_soc_handle soc,
+					uint32_t thresh,
+					dp_rx_tm_qdepth_ind_cb cb, void *ctx)
+{
+	return QDF_STATUS_SUCCESS;
+}
+
 static inline QDF_STATUS dp_txrx_ext_dump_stats(ol_txrx_soc_handle soc,
 						uint8_t stats_id)
 {
@@ -600,11 +654,30 @@ void *dp_prealloc_get_consistent_mem_unaligned(size_t size,
  */
 void dp_prealloc_put_consistent_mem_unaligned(void *va_unaligned);
 
+/**
+ * dp_prealloc_print_stats() - print DP pre-alloc usage per pool and type
+ * @buf: buffer to print into
+ * @buf_len: length of @buf
+ *
+ * For each pool type reports the number of pre-allocated elements, the
+ * high watermark of elements in use, requests served from the pool and
+ * requests which fell back to runtime allocation.
+ *
+ * Return: number of bytes written to @buf
+ */
+qdf_size_t dp_prealloc_print_stats(char *buf, qdf_size_t buf_len);
+
 #else
 static inline QDF_STATUS dp_prealloc_init(void) { return QDF_STATUS_SUCCESS; }
 
 static inline void dp_prealloc_deinit(void) { }
 
+static inline
+qdf_size_t dp_prealloc_print_stats(char *buf, qdf_size_t buf_len)
+{
+	return 0;
+}
+
 #endif
 
 #endif /* _DP_TXRX_H */
@@ -1529,6 +1529,33 @@ struct dhcp_server {
 			CFG_VALUE_OR_DEFAULT, \
 			"Rate limiting for nb commands")
 
+/*
+ * <ini>
+ * sta_stats_cache_ttl - Max age of firmware station stats served from the
+ *			 snapshot cache
+ *
+ * @Min: 0
+ * @Max: 5000
+ * Default: 0
+ *
+ * Station stats requests of an interface, e.g. get_station, station info
+ * and iwpriv queries, are answered from the last firmware response if it
+ * is not older than this many milliseconds. Requests arriving while a
+ * firmware request of the interface is in flight always share its
+ * response, also when the ini is 0.
+ *
+ * Usage: Internal
+ *
+ * </ini>
+ */
+#define CFG_STA_STATS_CACHE_TTL CFG_INI_UINT( \
+			"sta_stats_cache_ttl", \
+			0, \
+			5000, \
+			0, \
+			CFG_VALUE_OR_DEFAULT, \
+			"Station stats snapshot cache ttl")
+
 #ifdef WLAN_FEATURE_PERIODIC_STA_STATS
 /*
  * <ini>
@@ -1593,6 +1620,43 @@ struct dhcp_server {
 #define CFG_WLAN_STA_PERIODIC_STATS
 #endif /* WLAN_FEATURE_PERIODIC_STA_STATS */
 
+#ifdef WLAN_STA_STATS_HIST
+/*
+ * <ini>
+ * sta_stats_hist_interval - Station stats history sampling interval
+ *
+ * @Min: 0
+ * @Max: 10000
+ * Default: 1000
+ *
+ * This ini is used to specify the interval in milliseconds at which the
+ * rate, RSSI, tx retries and tx/rx packet counts of a connected STA are
+ * sampled into the station stats history, read from the sta_stats_hist
+ * sysfs file. The last 60 samples are kept. The firmware station stats are
+ * requested again when they are older than the interval, so intervals
+ * below 500 ms are rejected in favour of the default. 0 disables the
+ * history.
+ *
+ * Supported Feature: STA
+ *
+ * Usage: Internal
+ *
+ * </ini>
+ */
+#define CFG_STA_STATS_HIST_INTERVAL CFG_INI_UINT( \
+			"sta_stats_hist_interval", \
+			0, \
+			10000, \
+			1000, \
+			CFG_VALUE_OR_DEFAULT, \
+			"Station stats history interval")
+
+#define CFG_WLAN_STA_STATS_HIST \
+	 CFG(CFG_STA_STATS_HIST_INTERVAL)
+#else
+#define CFG_WLAN_STA_STATS_HIST
+#endif /* WLAN_STA_STATS_HIST */
+
 #ifdef FEATURE_CLUB_LL_STATS_AND_GET_STATION
 /*
  * <ini>
@@ -1770,6 +1834,7 @@ enum host_log_level {
 	CFG_WLAN_CLUB_GET_STA_IN_LL_STA_REQ \
 	CFG_WLAN_LOGGING_SUPPORT_ALL \
 	CFG_WLAN_STA_PERIODIC_STATS \
+	CFG_WLAN_STA_STATS_HIST \
 	CFG(CFG_ACTION_OUI_CCKM_1X1) \
 	CFG(CFG_ACTION_OUI_CONNECT_1X1) \
 	CFG(CFG_ACTION_OUI_CONNECT_1X1_WITH_1_CHAIN) \
@@ -1802,6 +1867,7 @@ enum host_log_level {
 	CFG(CFG_PROVISION_INTERFACE_POOL) \
 	CFG(CFG_TIMER_MULTIPLIER) \
 	CFG(CFG_NB_COMMANDS_RATE_LIMIT) \
+	CFG(CFG_STA_STATS_CACHE_TTL) \
 	CFG(CFG_HDD_DOT11_MODE) \
 	CFG(CFG_ENABLE_DISABLE_CHANNEL) \
 	CFG(CFG_READ_MAC_ADDR_FROM_MAC_FILE) \
@@ -753,6 +753,88 @@
 		false, \
 		"Control to enable latency critical clients")
 
+/*
+ * <ini>
+ * gBusBwGovernor - Select the bus bandwidth vote governor
+ * @Min: 0
+ * @Max: 1
+ * @Default: 0
+ *
+ * This ini selects how the bus bandwidth level is derived from the tx/rx
+ * packets of each bus bandwidth compute interval.
+ * 0 - threshold: vote the level whose packet threshold the last interval
+ *     crossed
+ * 1 - predictive: vote on an EWMA of the interval packets extrapolated with
+ *     the rising trend, step down only after gBusBwDownHysteresis intervals
+ *     and ramp up early when an rx thread queue reaches
+ *     gBusBwRxQdepthThreshold
+ *
+ * Supported Feature: Bus bandwidth voting
+ *
+ * Usage: Internal
+ *
+ * </ini>
+ */
+#define CFG_DP_BUS_BW_GOVERNOR \
+		CFG_INI_UINT( \
+		"gBusBwGovernor", \
+		0, \
+		1, \
+		0, \
+		CFG_VALUE_OR_DEFAULT, \
+		"Bus bandwidth vote governor")
+
+/*
+ * <ini>
+ * gBusBwDownHysteresis - Intervals to hold a bus bandwidth level
+ * @Min: 0
+ * @Max: 50
+ * @Default: 3
+ *
+ * With the predictive governor, number of consecutive bus bandwidth compute
+ * intervals which must predict a lower level before the vote is lowered.
+ *
+ * Supported Feature: Bus bandwidth voting
+ *
+ * Usage: Internal
+ *
+ * </ini>
+ */
+#define CFG_DP_BUS_BW_DOWN_HYSTERESIS \
+		CFG_INI_UINT( \
+		"gBusBwDownHysteresis", \
+		0, \
+		50, \
+		3, \
+		CFG_VALUE_OR_DEFAULT, \
+		"Bus bandwidth down vote hysteresis")
+
+/*
+ * <ini>
+ * gBusBwRxQdepthThreshold - Rx thread queue depth to ramp up bus bandwidth
+ * @Min: 0
+ * @Max: 65535
+ * @Default: 1024
+ *
+ * With the predictive governor, when a DP rx thread queue grows to this many
+ * packets the bus bandwidth is voted high right away instead of at the end
+ * of the compute interval. 0 disables the early ramp up.
+ *
+ * Supported Feature: Bus bandwidth voting
+ *
+ * Usage: Internal
+ *
+ * </ini>
+ */
+#define CFG_DP_BUS_BW_RX_QDEPTH_THRESHOLD \
+		CFG_INI_UINT( \
+		"gBusBwRxQdepthThreshold", \
+		0, \
+		65535, \
+		1024, \
+		CFG_VALUE_OR_DEFAULT, \
+		"Rx thread queue depth to ramp up bus bandwidth")
+
 #endif /*WLAN_FEATURE_DP_BUS_BANDWIDTH*/
 
 #ifdef QCA_SUPPORT_TXRX_DRIVER_TCP_DEL_ACK
@@ -1043,6 +1125,88 @@
 		false, \
 		"orphaning of Tx packets")
 
+/*
+ * <ini>
+ * dp_tx_orphan_policy - Policy deciding when tx packets are orphaned
+ * @Min: 0
+ * @Max: 1
+ * @Default: 0
+ *
+ * 0 - static, orphan as configured by gEnableTxOrphan
+ * 1 - adaptive, orphan only while the frames in flight or the tx completion
+ *     latency of the interface are above dp_tx_orphan_inflight_thresh or
+ *     dp_tx_orphan_latency_thresh_us, so that TCP small queues keep
+ *     throttling the sockets otherwise
+ *
+ * The adaptive policy relies on the descriptor counts of the ol datapath,
+ * where they are not available the static policy is used instead.
+ *
+ * Related: gEnableTxOrphan, dp_tx_orphan_inflight_thresh,
+ *	    dp_tx_orphan_latency_thresh_us
+ *
+ * Usage: Internal
+ *
+ * </ini>
+ */
+#define CFG_DP_TX_ORPHAN_POLICY \
+		CFG_INI_UINT( \
+		"dp_tx_orphan_policy", \
+		0, 1, 0, \
+		CFG_VALUE_OR_DEFAULT, \
+		"Tx orphan policy")
+
+/*
+ * <ini>
+ * dp_tx_orphan_inflight_thresh - Tx frames in flight above which tx
+ *				  packets are orphaned
+ * @Min: 0
+ * @Max: 8192
+ * @Default: 1024
+ *
+ * Frames in flight are the tx descriptors of the interface not completed
+ * yet, a TSO frame taking one per segment. A configured value of 0 disables
+ * the threshold. Only used with the adaptive dp_tx_orphan_policy, which
+ * relies on the descriptor counts of the ol datapath.
+ *
+ * Related: dp_tx_orphan_policy
+ *
+ * Usage: Internal
+ *
+ * </ini>
+ */
+#define CFG_DP_TX_ORPHAN_INFLIGHT_THRESH \
+		CFG_INI_UINT( \
+		"dp_tx_orphan_inflight_thresh", \
+		0, 8192, 1024, \
+		CFG_VALUE_OR_DEFAULT, \
+		"Tx frames in flight above which tx packets are orphaned")
+
+/*
+ * <ini>
+ * dp_tx_orphan_latency_thresh_us - Tx completion latency in us above which
+ *				    tx packets are orphaned
+ * @Min: 0
+ * @Max: 1000000
+ * @Default: 20000
+ *
+ * The latency is estimated once per bus bandwidth compute interval from
+ * the frames in flight and the completion rate of the interface. A
+ * configured value of 0 disables the threshold. Only used with the
+ * adaptive dp_tx_orphan_policy.
+ *
+ * Related: dp_tx_orphan_policy
+ *
+ * Usage: Internal
+ *
+ * </ini>
+ */
+#define CFG_DP_TX_ORPHAN_LATENCY_THRESH_US \
+		CFG_INI_UINT( \
+		"dp_tx_orphan_latency_thresh_us", \
+		0, 1000000, 20000, \
+		CFG_VALUE_OR_DEFAULT, \
+		"Tx completion latency above which tx packets are orphaned")
+
 /*
  * <ini>
  * rx_mode - Control to decide rx mode for packet procesing
@@ -1201,6 +1365,194 @@
 	1, 4, 1, CFG_VALUE_OR_DEFAULT, \
 	"Control to set the number of dp rx threads")
 
+/*
+ * <ini>
+ * dp_rx_thread_budget - Max number of packets a dp rx thread delivers to
+ *			 the stack per wakeup before yielding the CPU
+ *
+ * @Min: 0
+ * @Max: 8192
+ * @Default: 0
+ *
+ * When the budget is consumed and the thread queue is still not empty, the
+ * dp rx thread flushes GRO if requested, reschedules itself and yields, so
+ * that a long rx burst cannot hold the CPU for other runnable threads.
+ * A configured value of 0 disables the budget and the queue is drained
+ * completely on every wakeup.
+ *
+ * Related: rx_mode, num_dp_rx_threads
+ *
+ * Usage: Internal
+ *
+ * </ini>
+ */
+#define CFG_DP_RX_THREAD_BUDGET \
+	CFG_INI_UINT("dp_rx_thread_budget", \
+	0, 8192, 0, CFG_VALUE_OR_DEFAULT, \
+	"Max packets delivered by a dp rx thread per wakeup")
+
+/*
+ * <ini>
+ * dp_rx_gro_flush_pkt_budget - Packets a dp rx thread delivers to the stack
+ *				before it flushes GRO
+ *
+ * @Min: 0
+ * @Max: 1024
+ * @Default: 0
+ *
+ * Bounds the number of packets GRO may hold in a dp rx thread between two
+ * flushes within a long rx burst, so that TCP ACKs are not compressed into
+ * one large delivery at the end of the burst. A configured value of 0
+ * leaves flushing to the end of batch indication of the rx path.
+ *
+ * Related: rx_mode, dp_rx_gro_flush_time_budget_us
+ *
+ * Usage: Internal
+ *
+ * </ini>
+ */
+#define CFG_DP_RX_GRO_FLUSH_PKT_BUDGET \
+	CFG_INI_UINT("dp_rx_gro_flush_pkt_budget", \
+	0, 1024, 0, CFG_VALUE_OR_DEFAULT, \
+	"Packets delivered by a dp rx thread between GRO flushes")
+
+/*
+ * <ini>
+ * dp_rx_gro_flush_time_budget_us - Max time in us a dp rx thread holds
+ *				    packets in GRO
+ *
+ * @Min: 0
+ * @Max: 100000
+ * @Default: 0
+ *
+ * GRO is flushed once this much time elapsed since the first packet
+ * delivered after the previous flush. A configured value of 0 leaves
+ * flushing to the end of batch indication of the rx path.
+ *
+ * Related: rx_mode, dp_rx_gro_flush_pkt_budget
+ *
+ * Usage: Internal
+ *
+ * </ini>
+ */
+#define CFG_DP_RX_GRO_FLUSH_TIME_BUDGET_US \
+	CFG_INI_UINT("dp_rx_gro_flush_time_budget_us", \
+	0, 100000, 0, CFG_VALUE_OR_DEFAULT, \
+	"Max time in us a dp rx thread holds packets in GRO")
+
+/*
+ * <ini>
+ * dp_rx_gro_low_latency - Flush GRO after every delivery of a dp rx thread
+ *
+ * @Default: false
+ *
+ * Trades GRO aggregation for latency, each list of packets handed to the
+ * stack by a dp rx thread is followed by a GRO flush.
+ *
+ * Related: rx_mode
+ *
+ * Usage: Internal
+ *
+ * </ini>
+ */
+#define CFG_DP_RX_GRO_LOW_LATENCY \
+	CFG_INI_BOOL("dp_rx_gro_low_latency", \
+	false, "Flush GRO after every delivery of a dp rx thread")
+
+/*
+ * <ini>
+ * dp_rx_list_delivery - Deliver rx frames to the stack as a list
+ *
+ * @Default: false
+ *
+ * When enabled, frames received in dp rx thread context which are not
+ * aggregated by GRO/LRO are collected per rx callback batch and handed
+ * to the network stack with one netif_receive_skb_list() call, instead of
+ * one netif_receive_skb() call per frame. Requires kernel 4.19 or later,
+ * otherwise the ini has no effect.
+ *
+ * Related: rx_mode
+ *
+ * Usage: Internal
+ *
+ * </ini>
+ */
+#define CFG_DP_RX_LIST_DELIVERY \
+	CFG_INI_BOOL("dp_rx_list_delivery", \
+	false, "Deliver rx frames to the stack as a list")
+
+/*
+ * <ini>
+ * dp_rx_early_demux - Attach local TCP sockets to rx frames in rx thread
+ *
+ * @Default: false
+ *
+ * When enabled, IPv4 TCP frames received in dp rx thread context which
+ * are not aggregated by GRO/LRO are looked up in the established socket
+ * hash before being handed to the network stack. On a hit the socket is
+ * attached to the frame, together with its cached input route, so the IP
+ * layer skips its own early demux and route lookup. Requires kernel 5.7
+ * or later, otherwise the ini has no effect.
+ *
+ * Related: rx_mode
+ *
+ * Usage: Internal
+ *
+ * </ini>
+ */
+#define CFG_DP_RX_EARLY_DEMUX \
+	CFG_INI_BOOL("dp_rx_early_demux", \
+	false, "Attach local TCP sockets to rx frames in rx thread")
+
+/*
+ * <ini>
+ * dp_rx_refill_predictive - Enable predictive replenish in rx refill thread
+ *
+ * @Default: false
+ *
+ * When enabled, the dp rx refill thread tracks how often the rx path asks
+ * for buffers. While the request rate is high, the thread wakes up on its
+ * own ahead of the next predicted request and tops up the rx refill buffer
+ * pool, instead of waiting for the pool to run low.
+ *
+ * Related: None
+ *
+ * Usage: Internal
+ *
+ * </ini>
+ */
+#define CFG_DP_RX_REFILL_PREDICTIVE \
+	CFG_INI_BOOL("dp_rx_refill_predictive", \
+	false, "Enable predictive replenish in rx refill thread")
+
+/*
+ * <ini>
+ * dp_tx_wmm_port_up_rules - TCP/UDP port ranges with a fixed user priority
+ *
+ * @Default: empty, no port rules
+ *
+ * Comma separated list of up to 8 rules of the form "<port>:<up>" or
+ * "<first port>-<last port>:<up>", with the user priority between 0 and
+ * 7. A TCP or UDP packet whose source or destination port falls in the
+ * range of a rule is queued with the user priority of the first such
+ * rule, in place of the one derived from its DSCP. For example
+ * "5060-5061:6,3478-3497:5" queues SIP signalling to voice and STUN/TURN
+ * to video. Invalid lists are ignored as a whole.
+ *
+ * Related: None
+ *
+ * Usage: Internal
+ *
+ * </ini>
+ */
+#define CFG_DP_TX_WMM_PORT_UP_RULES \
+		CFG_INI_STRING( \
+		"dp_tx_wmm_port_up_rules", \
+		0, \
+		128, \
+		"", \
+		"TCP/UDP port ranges with a fixed user priority")
+
 /*
  * <ini>
  * ce_service_max_rx_ind_flush - Maximum number of HTT messages
@@ -1493,7 +1845,10 @@
 	CFG(CFG_DP_TCP_DELACK_TIMER_COUNT) \
 	CFG(CFG_DP_TCP_TX_HIGH_TPUT_THRESHOLD) \
 	CFG(CFG_DP_BUS_LOW_BW_CNT_THRESHOLD) \
-	CFG(CFG_DP_BUS_HANDLE_LATENCY_CRITICAL_CLIENTS)
+	CFG(CFG_DP_BUS_HANDLE_LATENCY_CRITICAL_CLIENTS) \
+	CFG(CFG_DP_BUS_BW_GOVERNOR) \
+	CFG(CFG_DP_BUS_BW_DOWN_HYSTERESIS) \
+	CFG(CFG_DP_BUS_BW_RX_QDEPTH_THRESHOLD)
 
 #else
 #define CFG_HDD_DP_BUS_BANDWIDTH
@@ -1526,6 +1881,9 @@
 	CFG(CFG_DP_RX_THREAD_UL_CPU_MASK) \
 	CFG(CFG_DP_RPS_RX_QUEUE_CPU_MAP_LIST) \
 	CFG(CFG_DP_TX_ORPHAN_ENABLE) \
+	CFG(CFG_DP_TX_ORPHAN_POLICY) \
+	CFG(CFG_DP_TX_ORPHAN_INFLIGHT_THRESH) \
+	CFG(CFG_DP_TX_ORPHAN_LATENCY_THRESH_US) \
 	CFG(CFG_DP_RX_MODE) \
 	CFG(CFG_DP_TX_COMP_LOOP_PKT_LIMIT)\
 	CFG(CFG_DP_RX_REAP_LOOP_PKT_LIMIT)\
@@ -1537,6 +1895,14 @@
 	CFG(CFG_DP_FILTER_MULTICAST_REPLAY) \
 	CFG(CFG_DP_RX_WAKELOCK_TIMEOUT) \
 	CFG(CFG_DP_NUM_DP_RX_THREADS) \
+	CFG(CFG_DP_RX_THREAD_BUDGET) \
+	CFG(CFG_DP_RX_GRO_FLUSH_PKT_BUDGET) \
+	CFG(CFG_DP_RX_GRO_FLUSH_TIME_BUDGET_US) \
+	CFG(CFG_DP_RX_GRO_LOW_LATENCY) \
+	CFG(CFG_DP_RX_LIST_DELIVERY) \
+	CFG(CFG_DP_RX_EARLY_DEMUX) \
+	CFG(CFG_DP_RX_REFILL_PREDICTIVE) \
+	CFG(CFG_DP_TX_WMM_PORT_UP_RULES) \
 	CFG(CFG_DP_HTC_WMI_CREDIT_CNT) \
 	CFG(CFG_DP_ICMP_REQ_TO_FW_MARK_INTERVAL) \
 	CFG_MSCS_FEATURE_ALL \
@@ -45,6 +45,30 @@ struct hdd_context;
 
 #define CFG_DP_RPS_RX_QUEUE_CPU_MAP_LIST_LEN 30
 
+#define HDD_WMM_MAX_PORT_RULES 8
+
+/**
+ * struct hdd_wmm_port_rule - user priority of a TCP/UDP port range
+ * @first_port: first port of the range
+ * @last_port: last port of the range, inclusive
+ * @user_pri: user priority of packets from or to a port of the range
+ */
+struct hdd_wmm_port_rule {
+	uint16_t first_port;
+	uint16_t last_port;
+	uint8_t user_pri;
+};
+
+/**
+ * struct hdd_wmm_port_rules - parsed dp_tx_wmm_port_up_rules ini
+ * @num_rules: number of valid entries of @rule
+ * @rule: rules, in the order of the ini
+ */
+struct hdd_wmm_port_rules {
+	uint8_t num_rules;
+	struct hdd_wmm_port_rule rule[HDD_WMM_MAX_PORT_RULES];
+};
+
 #define FW_MODULE_LOG_LEVEL_STRING_LENGTH  (512)
 #define TX_SCHED_WRR_PARAMS_NUM            (5)
 
@@ -119,6 +143,9 @@ struct hdd_config {
 	uint16_t sap_tx_leakage_threshold;
 	bool sap_internal_restart;
 	bool tx_orphan_enable;
+	uint8_t tx_orphan_policy;
+	uint32_t tx_orphan_inflight_thresh;
+	uint32_t tx_orphan_latency_thresh_us;
 	bool is_11k_offload_supported;
 	bool action_oui_enable;
 	uint8_t action_oui_str[ACTION_OUI_MAXIMUM_ID][ACTION_OUI_MAX_STR_LEN];
@@ -173,6 +200,9 @@ struct hdd_config {
 	bool     enable_tcp_param_update;
 	uint32_t bus_low_cnt_threshold;
 	bool enable_latency_crit_clients;
+	uint8_t bus_bw_governor;
+	uint32_t bus_bw_down_hysteresis;
+	uint32_t bus_bw_rx_qdepth_thresh;
 #endif /*WLAN_FEATURE_DP_BUS_BANDWIDTH*/
 
 #ifdef WLAN_FEATURE_MSCS
@@ -207,6 +237,14 @@ struct hdd_config {
 	bool multicast_replay_filter;
 	uint32_t rx_wakelock_timeout;
 	uint8_t num_dp_rx_threads;
+	uint32_t rx_thread_budget;
+	uint32_t rx_gro_flush_pkt_budget;
+	uint32_t rx_gro_flush_time_budget_us;
+	bool rx_gro_low_latency;
+	bool rx_list_delivery;
+	bool rx_early_demux;
+	bool rx_refill_predictive;
+	struct hdd_wmm_port_rules wmm_port_rules;
 #ifdef CONFIG_DP_TRACE
 	bool enable_dp_trace;
 	uint8_t dp_trace_config[DP_TRACE_CONFIG_STRING_LENGTH];
@@ -261,7 +299,12 @@ struct hdd_config {
 	/* Duration for which periodic logging should be done */
 	uint32_t periodic_stats_timer_duration;
 #endif /* WLAN_FEATURE_PERIODIC_STA_STATS */
+#ifdef WLAN_STA_STATS_HIST
+	/* Station stats history sampling interval in ms, 0 if disabled */
+	uint32_t sta_stats_hist_interval;
+#endif /* WLAN_STA_STATS_HIST */
 	uint8_t nb_commands_interval;
+	uint32_t sta_stats_cache_ttl;
 
 #ifdef FEATURE_CLUB_LL_STATS_AND_GET_STATION
 	uint32_t sta_stats_cache_expiry_time;
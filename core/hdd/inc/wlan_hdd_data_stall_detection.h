@@ -38,4 +38,62 @@ int hdd_register_data_stall_detect_cb(void);
  * Return: 0 for success or Error code for failure
  */
 int hdd_deregister_data_stall_detect_cb(void);
+
+struct hdd_context;
+
+#ifdef WLAN_DP_STALL_DETECT
+/**
+ * enum hdd_dp_stall_signal - host datapath stall signal
+ * @HDD_DP_STALL_RX_THREAD_BACKLOG: rx thread is not draining its queue
+ * @HDD_DP_STALL_TX_DESC_EXHAUSTED: tx descriptor pool is (nearly) empty
+ * @HDD_DP_STALL_TX_FLOW_PAUSED: a tx flow pool is paused
+ * @HDD_DP_STALL_TX_COMPL_LAG: no tx completion while frames are in flight
+ * @HDD_DP_STALL_RX_RING_STARVED: rx ring is not being replenished
+ * @HDD_DP_STALL_SIGNAL_MAX: number of signals
+ */
+enum hdd_dp_stall_signal {
+	HDD_DP_STALL_RX_THREAD_BACKLOG,
+	HDD_DP_STALL_TX_DESC_EXHAUSTED,
+	HDD_DP_STALL_TX_FLOW_PAUSED,
+	HDD_DP_STALL_TX_COMPL_LAG,
+	HDD_DP_STALL_RX_RING_STARVED,
+	HDD_DP_STALL_SIGNAL_MAX,
+};
+
+/**
+ * struct hdd_dp_stall_det - host datapath stall detector state
+ * @last_check_ms: time of the previous check, 0 before the first one
+ * @since_ms: time each signal was first seen raised, 0 if it is not
+ * @reported: signals reported since they were last clear
+ * @num_stalls: number of stalls reported
+ */
+struct hdd_dp_stall_det {
+	uint32_t last_check_ms;
+	uint32_t since_ms[HDD_DP_STALL_SIGNAL_MAX];
+	uint32_t reported;
+	uint32_t num_stalls;
+};
+
+/**
+ * hdd_dp_stall_detect() - check the host datapath for a data stall
+ * @hdd_ctx: HDD context
+ * @tx_packets: tx packets in the last bus bandwidth interval
+ * @rx_packets: rx packets in the last bus bandwidth interval
+ *
+ * Called every bus bandwidth interval. Samples the rx thread backlog, tx
+ * descriptor and flow pool state, tx completion lag and rx ring fill
+ * level, and logs a snapshot of them when one stays abnormal for a while
+ * with the traffic collapsed.
+ *
+ * Return: None
+ */
+void hdd_dp_stall_detect(struct hdd_context *hdd_ctx, uint64_t tx_packets,
+			 uint64_t rx_packets);
+#else
+static inline
+void hdd_dp_stall_detect(struct hdd_context *hdd_ctx, uint64_t tx_packets,
+			 uint64_t rx_packets)
+{
+}
+#endif
 #endif /* __WLAN_HDD_DATA_STALL_DETECTION_H */
@@ -29,9 +29,187 @@
 #define DEBUGFS_LLSTATS_BUF_SIZE 12288
 #define DEBUGFS_LLSTATS_REQID   4294967295UL
 #define DEBUGFS_LLSTATS_REQMASK 0x7
+#define DEBUGFS_LLSTATS_STREAM_REQID   4294967294UL
 
 #include <wlan_hdd_main.h>
 
+/*
+ * Binary link layer stats stream
+ *
+ * Each poll of the stream emits one snapshot: a sequence of records that
+ * share the same @seq, terminated by a HDD_LL_STATS_REC_END record. Every
+ * record starts with struct hdd_ll_stats_rec_hdr followed by @len bytes of
+ * payload whose layout is given by @type. All fields are in host byte
+ * order. HDD_LL_STATS_STREAM_VERSION is bumped whenever any of the layouts
+ * below change; consumers must skip records of unknown type using @len.
+ */
+#define HDD_LL_STATS_STREAM_MAGIC   0x4c4c5354
+#define HDD_LL_STATS_STREAM_VERSION 1
+
+/**
+ * enum hdd_ll_stats_rec_type - binary LL stats record types
+ * @HDD_LL_STATS_REC_RADIO: struct hdd_ll_stats_rec_radio, followed by
+ *	@num_tx_power_levels uint32_t and @num_channels
+ *	struct hdd_ll_stats_rec_chan
+ * @HDD_LL_STATS_REC_IFACE: struct hdd_ll_stats_rec_iface, followed by
+ *	@num_ac struct hdd_ll_stats_rec_ac
+ * @HDD_LL_STATS_REC_PEER: struct hdd_ll_stats_rec_peer, followed by
+ *	@num_rate struct hdd_ll_stats_rec_rate
+ * @HDD_LL_STATS_REC_END: struct hdd_ll_stats_rec_end
+ */
+enum hdd_ll_stats_rec_type {
+	HDD_LL_STATS_REC_RADIO = 1,
+	HDD_LL_STATS_REC_IFACE = 2,
+	HDD_LL_STATS_REC_PEER = 3,
+	HDD_LL_STATS_REC_END = 4,
+};
+
+/**
+ * struct hdd_ll_stats_rec_hdr - binary LL stats record header
+ * @magic: HDD_LL_STATS_STREAM_MAGIC
+ * @version: HDD_LL_STATS_STREAM_VERSION
+ * @type: enum hdd_ll_stats_rec_type
+ * @len: payload length following the header, in bytes
+ * @seq: snapshot sequence number
+ * @ts_us: time the record was generated, in usec since boot, including the
+ *	time spent in suspend
+ * @vdev_id: vdev the snapshot was taken on
+ * @reserved: reserved, always zero
+ */
+struct hdd_ll_stats_rec_hdr {
+	uint32_t magic;
+	uint16_t version;
+	uint16_t type;
+	uint32_t len;
+	uint32_t seq;
+	uint64_t ts_us;
+	uint8_t vdev_id;
+	uint8_t reserved[7];
+} qdf_packed;
+
+/**
+ * struct hdd_ll_stats_rec_radio - per radio record, see struct
+ *	wifi_radio_stats for the meaning of the fields
+ */
+struct hdd_ll_stats_rec_radio {
+	uint32_t radio;
+	uint32_t on_time;
+	uint32_t tx_time;
+	uint32_t rx_time;
+	uint32_t on_time_scan;
+	uint32_t on_time_nbd;
+	uint32_t on_time_gscan;
+	uint32_t on_time_roam_scan;
+	uint32_t on_time_pno_scan;
+	uint32_t on_time_hs20;
+	uint32_t on_time_host_scan;
+	uint32_t on_time_lpi_scan;
+	uint32_t num_tx_power_levels;
+	uint32_t num_channels;
+} qdf_packed;
+
+/**
+ * struct hdd_ll_stats_rec_chan - per channel entry of a radio record,
+ *	see struct wifi_channel_stats
+ */
+struct hdd_ll_stats_rec_chan {
+	uint32_t width;
+	uint32_t center_freq;
+	uint32_t center_freq0;
+	uint32_t center_freq1;
+	uint32_t on_time;
+	uint32_t cca_busy_time;
+	uint32_t tx_time;
+	uint32_t rx_time;
+} qdf_packed;
+
+/**
+ * struct hdd_ll_stats_rec_iface - interface record, see
+ *	struct wifi_interface_stats
+ */
+struct hdd_ll_stats_rec_iface {
+	uint32_t num_peers;
+	uint32_t beacon_rx;
+	uint32_t mgmt_rx;
+	uint32_t mgmt_action_rx;
+	uint32_t mgmt_action_tx;
+	int32_t rssi_mgmt;
+	int32_t rssi_data;
+	int32_t rssi_ack;
+	uint32_t tx_rts_succ_cnt;
+	uint32_t tx_rts_fail_cnt;
+	uint32_t tx_ppdu_succ_cnt;
+	uint32_t tx_ppdu_fail_cnt;
+	uint32_t connected_duration;
+	uint32_t disconnected_duration;
+	uint32_t num_probes_tx;
+	uint32_t num_beacon_miss;
+	uint32_t num_ac;
+} qdf_packed;
+
+/**
+ * struct hdd_ll_stats_rec_ac - per access category entry of an interface
+ *	record
+ */
+struct hdd_ll_stats_rec_ac {
+	uint32_t ac_type;
+	uint32_t tx_mpdu;
+	uint32_t rx_mpdu;
+	uint32_t tx_mcast;
+	uint32_t rx_mcast;
+	uint32_t rx_ampdu;
+	uint32_t tx_ampdu;
+	uint32_t mpdu_lost;
+	uint32_t retries;
+	uint32_t retries_short;
+	uint32_t retries_long;
+	uint32_t contention_time_min;
+	uint32_t contention_time_max;
+	uint32_t contention_time_avg;
+	uint32_t contention_num_samples;
+	uint32_t tx_pending_msdu;
+} qdf_packed;
+
+/**
+ * struct hdd_ll_stats_rec_peer - per peer record, see struct wifi_peer_info
+ */
+struct hdd_ll_stats_rec_peer {
+	uint32_t type;
+	uint8_t mac[QDF_MAC_ADDR_SIZE];
+	uint16_t reserved;
+	uint32_t capabilities;
+	uint32_t num_rate;
+} qdf_packed;
+
+/**
+ * struct hdd_ll_stats_rec_rate - per rate entry of a peer record, see
+ *	struct wifi_rate_stat
+ */
+struct hdd_ll_stats_rec_rate {
+	uint8_t preamble;
+	uint8_t nss;
+	uint8_t bw;
+	uint8_t mcs;
+	uint32_t bitrate;
+	uint32_t tx_mpdu;
+	uint32_t rx_mpdu;
+	uint32_t mpdu_lost;
+	uint32_t retries;
+	uint32_t retries_short;
+	uint32_t retries_long;
+} qdf_packed;
+
+/**
+ * struct hdd_ll_stats_rec_end - snapshot terminator
+ * @status: 0 if the snapshot is complete, negative errno if the request
+ *	to FW failed or timed out and earlier records may be missing
+ * @dropped: records dropped so far because they did not fit a sub-buffer
+ */
+struct hdd_ll_stats_rec_end {
+	int32_t status;
+	uint32_t dropped;
+} qdf_packed;
+
 #if defined(WLAN_FEATURE_LINK_LAYER_STATS) && defined(WLAN_DEBUGFS)
 /**
  * hdd_debugfs_process_peer_stats() - Parse Peer stats and add it to buffer
@@ -104,4 +282,68 @@ static inline int wlan_hdd_create_ll_stats_file(struct hdd_adapter *adapter)
 	return 0;
 }
 #endif
+
+#if defined(WLAN_FEATURE_LINK_LAYER_STATS) && defined(WLAN_DEBUGFS) && \
+	defined(CONFIG_RELAY)
+/**
+ * hdd_ll_stats_stream_radio() - Write radio stats into the binary stream
+ * @adapter: Pointer to device adapter
+ * @data: Pointer to array of struct wifi_radio_stats
+ * @num_radio: Number of radios
+ *
+ * Return: None
+ */
+void hdd_ll_stats_stream_radio(struct hdd_adapter *adapter, void *data,
+			       uint32_t num_radio);
+
+/**
+ * hdd_ll_stats_stream_iface() - Write interface stats into the binary stream
+ * @adapter: Pointer to device adapter
+ * @data: Pointer to struct wifi_interface_stats
+ * @num_peers: Number of peers
+ *
+ * Return: None
+ */
+void hdd_ll_stats_stream_iface(struct hdd_adapter *adapter, void *data,
+			       uint32_t num_peers);
+
+/**
+ * hdd_ll_stats_stream_peer() - Write peer stats into the binary stream
+ * @adapter: Pointer to device adapter
+ * @data: Pointer to struct wifi_peer_stat
+ *
+ * Return: None
+ */
+void hdd_ll_stats_stream_peer(struct hdd_adapter *adapter, void *data);
+
+/**
+ * wlan_hdd_ll_stats_stream_deinit() - Stop the binary LL stats stream
+ * @adapter: interface adapter pointer
+ *
+ * Cancels the periodic poll and closes the relay channel. Must be called
+ * before the debugfs directory of the adapter is removed.
+ *
+ * Return: None
+ */
+void wlan_hdd_ll_stats_stream_deinit(struct hdd_adapter *adapter);
+#else
+static inline void hdd_ll_stats_stream_radio(struct hdd_adapter *adapter,
+					     void *data, uint32_t num_radio)
+{
+}
+
+static inline void hdd_ll_stats_stream_iface(struct hdd_adapter *adapter,
+					     void *data, uint32_t num_peers)
+{
+}
+
+static inline void hdd_ll_stats_stream_peer(struct hdd_adapter *adapter,
+					    void *data)
+{
+}
+
+static inline void wlan_hdd_ll_stats_stream_deinit(struct hdd_adapter *adapter)
+{
+}
+#endif
 #endif /* #ifndef _WLAN_HDD_DEBUGFS_LLSTAT_H */
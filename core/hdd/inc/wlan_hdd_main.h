@@ -58,6 +58,7 @@
 #include <wlan_hdd_wmm.h>
 #include <wlan_hdd_cfg.h>
 #include <linux/spinlock.h>
+#include <linux/u64_stats_sync.h>
 #include <ani_system_defs.h>
 #if defined(WLAN_OPEN_SOURCE) && defined(CONFIG_HAS_WAKELOCK)
 #include <linux/wakelock.h>
@@ -117,6 +118,8 @@
 #endif
 
 #include "wlan_hdd_sta_info.h"
+#include "wlan_hdd_sta_stats_hist.h"
+#include "wlan_hdd_data_stall_detection.h"
 
 /*
  * Preprocessor definitions and constants
@@ -538,6 +541,8 @@ typedef enum {
  * @is_rx_pm_qos_high	Capture rx_pm_qos voting
  * @is_tx_pm_qos_high	Capture tx_pm_qos voting
  * @qtime		timestamp when the record is added
+ * @predicted_pkts:	packets per interval the governor voted for
+ * @vote_reason:	enum hdd_bus_bw_vote_reason for next_vote_level
  *
  * The structure keeps track of throughput requirements of wlan driver.
  * An entry is added if either of next_vote_level, next_rx_level or
@@ -552,6 +557,101 @@ struct hdd_tx_rx_histogram {
 	bool is_rx_pm_qos_high;
 	bool is_tx_pm_qos_high;
 	uint64_t qtime;
+	uint64_t predicted_pkts;
+	uint8_t vote_reason;
+};
+
+/**
+ * enum hdd_bus_bw_vote_reason - reason for a bus bandwidth vote level
+ * @HDD_BUS_BW_VOTE_THRESHOLD: interval packets crossed the level threshold
+ * @HDD_BUS_BW_VOTE_HIGH_BW_REQ: high bus bandwidth explicitly requested
+ * @HDD_BUS_BW_VOTE_PREDICTED: level of the predicted interval packets
+ * @HDD_BUS_BW_VOTE_HYSTERESIS: current level held by the down hysteresis
+ * @HDD_BUS_BW_VOTE_RX_QDEPTH: ramped up on rx thread queue depth
+ * @HDD_BUS_BW_VOTE_REASON_MAX: max reason
+ */
+enum hdd_bus_bw_vote_reason {
+	HDD_BUS_BW_VOTE_THRESHOLD,
+	HDD_BUS_BW_VOTE_HIGH_BW_REQ,
+	HDD_BUS_BW_VOTE_PREDICTED,
+	HDD_BUS_BW_VOTE_HYSTERESIS,
+	HDD_BUS_BW_VOTE_RX_QDEPTH,
+	HDD_BUS_BW_VOTE_REASON_MAX
+};
+
+/* Max number of ops in a connectivity stats match program */
+#define HDD_CONN_STATS_MAX_OPS 3
+
+/**
+ * struct hdd_conn_stats_prog - connectivity stats match program
+ * @num_ops: number of valid entries in @ip_proto
+ * @ip_proto: IPv4 protocols to inspect, compiled from the tracked
+ *	      connectivity check packet types
+ */
+struct hdd_conn_stats_prog {
+	uint8_t num_ops;
+	uint8_t ip_proto[HDD_CONN_STATS_MAX_OPS];
+};
+
+/**
+ * struct hdd_pkt_stats - interface tx/rx packet and byte counters
+ * @tx_packets: packets handed to the datapath by start_xmit
+ * @tx_bytes: bytes handed to the datapath by start_xmit
+ * @rx_packets: packets delivered to the network stack
+ * @rx_bytes: bytes delivered to the network stack
+ */
+struct hdd_pkt_stats {
+	uint64_t tx_packets;
+	uint64_t tx_bytes;
+	uint64_t rx_packets;
+	uint64_t rx_bytes;
+};
+
+/**
+ * struct hdd_stats_cache - snapshot cache of firmware station stats
+ * @lock: serialises the firmware requests of an adapter
+ * @gen: bumped on every successful firmware response, 0 if none yet
+ * @fetch_ts: time in ms of the last successful firmware response
+ * @req_gen: bumped on every completed firmware request, failed ones included
+ * @req_ret: result of the last completed firmware request
+ * @hits: requests answered from a snapshot within its ttl
+ * @coalesced: requests answered by the result of a firmware request which
+ *	       completed while they waited for it
+ * @misses: requests sent to firmware
+ */
+struct hdd_stats_cache {
+	qdf_mutex_t lock;
+	uint32_t gen;
+	uint32_t fetch_ts;
+	uint32_t req_gen;
+	int req_ret;
+	uint32_t hits;
+	uint32_t coalesced;
+	uint32_t misses;
+};
+
+/**
+ * struct hdd_tx_orphan_ctx - state of the adaptive tx orphan policy
+ * @inflight: tx descriptors of the vdev in flight at the last refresh
+ * @refresh_ticks: system ticks of the last @inflight refresh
+ * @completed: datapath tx completion count at the last bus bw period
+ * @latency_us: tx completion latency estimated over the last period
+ */
+struct hdd_tx_orphan_ctx {
+	uint32_t inflight;
+	unsigned long refresh_ticks;
+	uint32_t completed;
+	uint32_t latency_us;
+};
+
+/**
+ * struct hdd_pcpu_pkt_stats - per-CPU instance of the interface counters
+ * @cnt: counters updated only by the owning CPU
+ * @syncp: sequence counter guarding @cnt on 32-bit hosts
+ */
+struct hdd_pcpu_pkt_stats {
+	struct hdd_pkt_stats cnt;
+	struct u64_stats_sync syncp;
 };
 
 struct hdd_tx_rx_stats {
@@ -559,6 +659,10 @@ struct hdd_tx_rx_stats {
 	__u32    tx_called;
 	__u32    tx_dropped;
 	__u32    tx_orphaned;
+	__u32    tx_orphan_inflight;
+	__u32    tx_orphan_latency;
+	__u32    tx_inflight_max;
+	__u32    tx_comp_latency_max_us;
 	__u32    tx_classified_ac[NUM_TX_QUEUES];
 	__u32    tx_dropped_ac[NUM_TX_QUEUES];
 
@@ -576,6 +680,14 @@ struct hdd_tx_rx_stats {
 	__u32 rx_gro_flush_skip;
 	__u32 rx_gro_low_tput_flush;
 
+	/* rx list delivery */
+	__u32 rx_list_batches;
+	__u32 rx_list_pkts;
+
+	/* rx early demux */
+	__u32 rx_early_demux_hit;
+	__u32 rx_early_demux_miss;
+
 	/* txflow stats */
 	bool     is_txflow_paused;
 	__u32    txflow_pause_cnt;
@@ -1277,8 +1389,18 @@ struct hdd_adapter {
 
 	/**Device TX/RX statistics*/
 	struct net_device_stats stats;
+	/** Per-CPU TX/RX packet and byte counters */
+	struct hdd_pcpu_pkt_stats __percpu *pkt_stats;
+	/** Sum of @pkt_stats at the last reset, reported as 0 */
+	struct hdd_pkt_stats pkt_stats_base;
+	/** Lock serializing the reads of @pkt_stats with a reset */
+	qdf_spinlock_t pkt_stats_lock;
+	/** Adaptive tx orphan policy state */
+	struct hdd_tx_orphan_ctx tx_orphan;
 	/** HDD statistics*/
 	struct hdd_stats hdd_stats;
+	/** Snapshot cache of firmware station stats */
+	struct hdd_stats_cache sta_stats_cache;
 
 	/* estimated link speed */
 	uint32_t estimated_linkspeed;
@@ -1336,6 +1458,8 @@ struct hdd_adapter {
 	struct hdd_sta_info_obj sta_info_list;
 	struct hdd_sta_info_obj cache_sta_info_list;
 	qdf_atomic_t cache_sta_count;
+	/* Last station looked up by the SoftAP tx path, per tx queue */
+	struct hdd_sta_info_hit tx_sta_hit[NUM_TX_QUEUES];
 
 #ifdef FEATURE_WLAN_WAPI
 	struct hdd_wapi_info wapi_info;
@@ -1431,9 +1555,13 @@ struct hdd_adapter {
 
 	/* DSCP to UP QoS Mapping */
 	enum sme_qos_wmmuptype dscp_to_up_map[WLAN_MAX_DSCP + 1];
+	/* DSCP to UP mapping for UDP, with UDP QoS upgrade applied */
+	enum sme_qos_wmmuptype udp_dscp_to_up_map[WLAN_MAX_DSCP + 1];
 
 #ifdef WLAN_FEATURE_LINK_LAYER_STATS
 	bool is_link_layer_stats_set;
+	/* binary LL stats stream, see wlan_hdd_debugfs_llstat.c */
+	struct hdd_ll_stats_stream *ll_stats_stream;
 #endif
 	uint8_t link_status;
 	uint8_t upgrade_udp_qos_threshold;
@@ -1478,6 +1606,7 @@ struct hdd_adapter {
 	bool dad;
 	uint8_t active_ac;
 	uint32_t pkt_type_bitmap;
+	struct hdd_conn_stats_prog conn_stats_prog;
 	uint32_t track_arp_ip;
 	uint8_t dns_payload[256];
 	uint32_t track_dns_domain_len;
@@ -1517,6 +1646,9 @@ struct hdd_adapter {
 	uint32_t periodic_stats_timer_counter;
 	qdf_mutex_t sta_periodic_stats_lock;
 #endif /* WLAN_FEATURE_PERIODIC_STA_STATS */
+#ifdef WLAN_STA_STATS_HIST
+	struct hdd_sta_stats_hist sta_stats_hist;
+#endif
 	qdf_event_t peer_cleanup_done;
 #ifdef FEATURE_OEM_DATA
 	bool oem_data_in_progress;
@@ -1949,7 +2081,21 @@ struct hdd_context {
 	uint64_t prev_tx;
 	qdf_atomic_t low_tput_gro_enable;
 	uint32_t bus_low_vote_cnt;
+	/* predictive bus bandwidth governor state */
+	uint64_t bus_bw_ewma_pkts;
+	uint64_t bus_bw_prev_pkts;
+	uint32_t bus_bw_down_cnt;
+	qdf_atomic_t bus_bw_rx_qdepth_ind;
+	qdf_work_t bus_bw_boost_work;
+	uint32_t bus_bw_boost_cnt;
+	/* cur_vote_level was voted by bus_bw_boost_work */
+	bool bus_bw_boosted;
+	/* serializes the votes of bus_bw_work and bus_bw_boost_work */
+	qdf_mutex_t bus_bw_vote_lock;
 #endif /*WLAN_FEATURE_DP_BUS_BANDWIDTH*/
+#ifdef WLAN_DP_STALL_DETECT
+	struct hdd_dp_stall_det dp_stall_det;
+#endif
 
 	struct completion ready_to_suspend;
 	/* defining the solution type */
@@ -3488,6 +3634,20 @@ int hdd_wlan_clear_stats(struct hdd_adapter *adapter, int stats_id);
  * Return: none
  */
 void wlan_hdd_display_tx_rx_histogram(struct hdd_context *hdd_ctx);
+
+/**
+ * hdd_bus_bw_vote_history_print() - print the bus bandwidth vote decisions
+ * @hdd_ctx: hdd context
+ * @buf: buffer to print into
+ * @buf_len: length of @buf
+ *
+ * Prints the records of the tx rx histogram, oldest first, with the packets
+ * per interval the vote level was derived from and the reason for it.
+ *
+ * Return: number of bytes written to @buf
+ */
+int hdd_bus_bw_vote_history_print(struct hdd_context *hdd_ctx, char *buf,
+				  int buf_len);
 void wlan_hdd_clear_tx_rx_histogram(struct hdd_context *hdd_ctx);
 
 void
@@ -4260,18 +4420,58 @@ static inline void hdd_update_hlp_info(struct net_device *dev,
 {}
 #endif
 
+/**
+ * hdd_pkt_stats_alloc() - allocate the per-CPU tx/rx counters of an adapter
+ * @adapter: adapter being set up
+ *
+ * Return: 0 on success, -ENOMEM otherwise
+ */
+int hdd_pkt_stats_alloc(struct hdd_adapter *adapter);
+
+/**
+ * hdd_pkt_stats_free() - free the per-CPU tx/rx counters of an adapter
+ * @adapter: adapter being torn down
+ *
+ * Return: None
+ */
+void hdd_pkt_stats_free(struct hdd_adapter *adapter);
+
 #if LINUX_VERSION_CODE < KERNEL_VERSION(4, 12, 0)
+static inline void hdd_dev_destructor(struct net_device *dev)
+{
+	hdd_pkt_stats_free(netdev_priv(dev));
+	free_netdev(dev);
+}
+
 static inline void hdd_dev_setup_destructor(struct net_device *dev)
 {
-	dev->destructor = free_netdev;
+	dev->destructor = hdd_dev_destructor;
 }
 #else
+static inline void hdd_dev_priv_destructor(struct net_device *dev)
+{
+	hdd_pkt_stats_free(netdev_priv(dev));
+}
+
 static inline void hdd_dev_setup_destructor(struct net_device *dev)
 {
 	dev->needs_free_netdev = true;
+	dev->priv_destructor = hdd_dev_priv_destructor;
 }
 #endif /* KERNEL_VERSION(4, 12, 0) */
 
+/**
+ * hdd_free_netdev() - free a netdev that never completed registration
+ * @dev: netdev to free
+ *
+ * Return: None
+ */
+static inline void hdd_free_netdev(struct net_device *dev)
+{
+	hdd_pkt_stats_free(netdev_priv(dev));
+	free_netdev(dev);
+}
+
 /**
  * hdd_dp_trace_init() - initialize DP Trace by calling the QDF API
  * @config: hdd config
@@ -4285,6 +4485,26 @@ static inline
 void hdd_dp_trace_init(struct hdd_config *config) {}
 #endif
 
+/**
+ * hdd_dp_trace_set_pkt_trace_user() - gate the per packet DP trace hooks
+ * @config: hdd config
+ * @proto_bitmap: protocols traced by DP trace, 0 if DP trace is off
+ *
+ * The DP trace hooks of the data path only run while DP trace records
+ * any protocol or protocol events are logged. Must be called from process
+ * context.
+ *
+ * Return: None
+ */
+#ifdef CONFIG_DP_TRACE
+void hdd_dp_trace_set_pkt_trace_user(struct hdd_config *config,
+				     uint32_t proto_bitmap);
+#else
+static inline
+void hdd_dp_trace_set_pkt_trace_user(struct hdd_config *config,
+				     uint32_t proto_bitmap) {}
+#endif
+
 /**
  * hdd_set_rx_mode_rps() - Enable/disable RPS in SAP mode
  * @enable: Set true to enable RPS in SAP mode
@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2021 The Linux Foundation. All rights reserved.
+ *
+ * Permission to use, copy, modify, and/or distribute this software for
+ * any purpose with or without fee is hereby granted, provided that the
+ * above copyright notice and this permission notice appear in all
+ * copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+ * WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+ * AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+ * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR
+ * PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+ * TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/**
+ * DOC: wlan_hdd_sta_stats_hist.h
+ *
+ * Station stats history.
+ *
+ * Every sta_stats_hist_interval milliseconds a periodic work of each
+ * connected STA interface samples its link into a ring of the last
+ * HDD_STA_STATS_HIST_LEN samples. The samples use the firmware station
+ * stats, refreshed through the station stats cache when they are older
+ * than the interval, and the host packet counters. Each sample records
+ * when the firmware values were fetched, as a failed refresh leaves the
+ * previous ones in place. The history restarts on every connection.
+ */
+
+#if !defined(WLAN_HDD_STA_STATS_HIST_H)
+#define WLAN_HDD_STA_STATS_HIST_H
+
+#include <qdf_lock.h>
+#include <qdf_periodic_work.h>
+
+struct hdd_context;
+struct hdd_adapter;
+struct hdd_config;
+struct wlan_objmgr_psoc;
+
+/* number of samples kept per interface */
+#define HDD_STA_STATS_HIST_LEN 60
+
+/* shortest sampling interval in msec, a sample may need a firmware request */
+#define HDD_STA_STATS_HIST_MIN_INTERVAL 500
+
+/**
+ * struct hdd_sta_stats_sample - one sample of the station stats history
+ * @ts_ms: sample time, in msec of system uptime
+ * @fw_ts_ms: time the firmware station stats used by @tx_rate, @rx_rate,
+ *	      @rssi and @retries were fetched, in msec of system uptime, 0 if
+ *	      none were fetched yet
+ * @tx_rate: last reported tx rate, in units of 100 kbps
+ * @rx_rate: last reported rx rate, in units of 100 kbps
+ * @rssi: last reported RSSI, in dBm
+ * @reserved: padding, always 0
+ * @retries: tx retries reported since the previous sample
+ * @tx_packets: packets transmitted since the previous sample
+ * @rx_packets: packets received since the previous sample
+ *
+ * This is also the record layout of the binary history read from sysfs,
+ * in host byte order.
+ */
+struct hdd_sta_stats_sample {
+	uint32_t ts_ms;
+	uint32_t fw_ts_ms;
+	uint16_t tx_rate;
+	uint16_t rx_rate;
+	int8_t rssi;
+	uint8_t reserved[3];
+	uint32_t retries;
+	uint32_t tx_packets;
+	uint32_t rx_packets;
+};
+
+/**
+ * struct hdd_sta_stats_hist - station stats history of an interface
+ * @lock: protects the ring against the sysfs readers
+ * @work: samples the interface every sampling interval while connected
+ * @initialized: @lock and @work were created
+ * @samples: ring of samples
+ * @head: index of the next sample to write
+ * @count: number of valid samples
+ * @prev_retries: tx retry count at the last sample
+ * @prev_tx_packets: tx packet count at the last sample
+ * @prev_rx_packets: rx packet count at the last sample
+ * @binary: sysfs reads return the binary records instead of CSV
+ */
+struct hdd_sta_stats_hist {
+	qdf_spinlock_t lock;
+	struct qdf_periodic_work work;
+	bool initialized;
+	struct hdd_sta_stats_sample samples[HDD_STA_STATS_HIST_LEN];
+	uint32_t head;
+	uint32_t count;
+	uint32_t prev_retries;
+	uint64_t prev_tx_packets;
+	uint64_t prev_rx_packets;
+	bool binary;
+};
+
+#ifdef WLAN_STA_STATS_HIST
+/**
+ * hdd_sta_stats_hist_config() - read the station stats history ini
+ * @config: Pointer to hdd configuration
+ * @psoc: Pointer to psoc
+ *
+ * An interval below HDD_STA_STATS_HIST_MIN_INTERVAL is rejected in favour
+ * of the default one.
+ *
+ * Return: none
+ */
+void hdd_sta_stats_hist_config(struct hdd_config *config,
+			       struct wlan_objmgr_psoc *psoc);
+
+/**
+ * hdd_sta_stats_hist_init() - initialize the history of an interface
+ * @adapter: Pointer to the station adapter
+ *
+ * Return: none
+ */
+void hdd_sta_stats_hist_init(struct hdd_adapter *adapter);
+
+/**
+ * hdd_sta_stats_hist_deinit() - release the history of an interface
+ * @adapter: Pointer to the station adapter
+ *
+ * Return: none
+ */
+void hdd_sta_stats_hist_deinit(struct hdd_adapter *adapter);
+
+/**
+ * hdd_sta_stats_hist_reset() - restart the history of an interface
+ * @adapter: Pointer to the station adapter
+ *
+ * Called on connection, starts the sampling work which runs until the
+ * interface disconnects.
+ *
+ * Return: none
+ */
+void hdd_sta_stats_hist_reset(struct hdd_adapter *adapter);
+
+/**
+ * hdd_sta_stats_hist_read() - copy out the history of an interface
+ * @adapter: Pointer to the station adapter
+ * @buf: buffer to fill, oldest sample first
+ * @buf_len: size of @buf
+ *
+ * Depending on the format selected for the interface @buf is filled with
+ * CSV text, one line per sample after a header line, or with the struct
+ * hdd_sta_stats_sample records.
+ *
+ * Return: number of bytes written to @buf
+ */
+ssize_t hdd_sta_stats_hist_read(struct hdd_adapter *adapter, char *buf,
+				size_t buf_len);
+
+/**
+ * hdd_sta_stats_hist_set_binary() - select the format of the history reads
+ * @adapter: Pointer to the station adapter
+ * @binary: true for binary records, false for CSV
+ *
+ * Return: none
+ */
+void hdd_sta_stats_hist_set_binary(struct hdd_adapter *adapter, bool binary);
+#else
+static inline void
+hdd_sta_stats_hist_config(struct hdd_config *config,
+			  struct wlan_objmgr_psoc *psoc) {}
+
+static inline void hdd_sta_stats_hist_init(struct hdd_adapter *adapter) {}
+
+static inline void hdd_sta_stats_hist_deinit(struct hdd_adapter *adapter) {}
+
+static inline void hdd_sta_stats_hist_reset(struct hdd_adapter *adapter) {}
+#endif /* WLAN_STA_STATS_HIST */
+
+#endif /* WLAN_HDD_STA_STATS_HIST_H */
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2021 The Linux Foundation. All rights reserved.
+ *
+ * Permission to use, copy, modify, and/or distribute this software for
+ * any purpose with or without fee is hereby granted, provided that the
+ * above copyright notice and this permission notice appear in all
+ * copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+ * WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+ * AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+ * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR
+ * PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+ * TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/**
+ * DOC: wlan_hdd_sysfs_bus_bw.h
+ *
+ * Implementation to add sysfs node bus_bw_history
+ */
+
+#ifndef _WLAN_HDD_SYSFS_BUS_BW_H_
+#define _WLAN_HDD_SYSFS_BUS_BW_H_
+
+#if defined(WLAN_SYSFS) && defined(WLAN_FEATURE_DP_BUS_BANDWIDTH)
+/**
+ * hdd_sysfs_bus_bw_history_create() - Create bus_bw_history sysfs node
+ * @driver_kobject: Driver kobject
+ *
+ * bus_bw_history lists the recent bus bandwidth vote decisions, with the
+ * packets per interval each vote was derived from and the reason for it.
+ *
+ * file path: /sys/kernel/wifi/bus_bw_history
+ *
+ * usage: cat /sys/kernel/wifi/bus_bw_history
+ *
+ * Return: 0 on success and errno on failure
+ */
+int hdd_sysfs_bus_bw_history_create(struct kobject *driver_kobject);
+
+/**
+ * hdd_sysfs_bus_bw_history_destroy() - Destroy bus_bw_history sysfs node
+ * @driver_kobject: Driver kobject
+ *
+ * Return: None
+ */
+void hdd_sysfs_bus_bw_history_destroy(struct kobject *driver_kobject);
+#else
+static inline int
+hdd_sysfs_bus_bw_history_create(struct kobject *driver_kobject)
+{
+	return 0;
+}
+
+static inline void
+hdd_sysfs_bus_bw_history_destroy(struct kobject *driver_kobject)
+{
+}
+#endif /* WLAN_SYSFS && WLAN_FEATURE_DP_BUS_BANDWIDTH */
+#endif /* _WLAN_HDD_SYSFS_BUS_BW_H_ */
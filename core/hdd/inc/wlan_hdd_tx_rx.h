@@ -29,6 +29,8 @@
 #include <wlan_hdd_includes.h>
 #include <cds_api.h>
 #include <linux/skbuff.h>
+#include <linux/jump_label.h>
+#include <cds_pkt_trace.h>
 #include "cdp_txrx_flow_ctrl_legacy.h"
 
 struct hdd_netif_queue_history;
@@ -67,6 +69,8 @@ struct hdd_context;
 #define hdd_dp_exit() hdd_dp_debug("exit")
 
 #define HDD_ETHERTYPE_802_1_X              0x888E
+#define HDD_DHCP_SERVER_PORT               67
+#define HDD_DHCP_CLIENT_PORT               68
 #ifdef FEATURE_WLAN_WAPI
 #define HDD_ETHERTYPE_WAI                  0x88b4
 #define IS_HDD_ETHERTYPE_WAI(_skb) (ntohs(_skb->protocol) == \
@@ -168,6 +172,18 @@ static inline QDF_STATUS hdd_rx_fisa_flush_by_vdev_id(void *dp_soc,
 }
 #endif
 
+/**
+ * struct hdd_rx_batch - rx frames batched for list delivery to the stack
+ * @list: frames waiting to be handed to netif_receive_skb_list()
+ * @count: number of frames on @list
+ * @enabled: list delivery is possible for the current rx batch
+ */
+struct hdd_rx_batch {
+	struct list_head list;
+	uint32_t count;
+	bool enabled;
+};
+
 /**
  * hdd_rx_deliver_to_stack() - HDD helper function to deliver RX pkts to stack
  * @adapter: pointer to HDD adapter context
@@ -182,6 +198,50 @@ static inline QDF_STATUS hdd_rx_fisa_flush_by_vdev_id(void *dp_soc,
 QDF_STATUS hdd_rx_deliver_to_stack(struct hdd_adapter *adapter,
 				   struct sk_buff *skb);
 
+/**
+ * hdd_rx_batch_init() - prepare an rx batch for one rx callback invocation
+ * @adapter: pointer to HDD adapter context
+ * @batch: batch to initialize
+ *
+ * List delivery is enabled for the batch only if it is configured and the
+ * frames are received in dp rx thread context.
+ *
+ * Return: None
+ */
+void hdd_rx_batch_init(struct hdd_adapter *adapter,
+		       struct hdd_rx_batch *batch);
+
+/**
+ * hdd_rx_deliver_to_stack_batch() - deliver an RX pkt, batching if possible
+ * @adapter: pointer to HDD adapter context
+ * @skb: pointer to skb
+ * @batch: rx batch from hdd_rx_batch_init()
+ *
+ * Same as hdd_rx_deliver_to_stack(), except that frames which would be
+ * passed to netif_receive_skb() from dp rx thread context are queued on
+ * @batch instead, and handed to the stack by hdd_rx_batch_flush().
+ *
+ * Return: QDF_STATUS_E_PENDING if the frame is queued on @batch,
+ *	   QDF_STATUS_E_FAILURE if any errors encountered,
+ *	   QDF_STATUS_SUCCESS otherwise
+ */
+QDF_STATUS hdd_rx_deliver_to_stack_batch(struct hdd_adapter *adapter,
+					 struct sk_buff *skb,
+					 struct hdd_rx_batch *batch);
+
+/**
+ * hdd_rx_batch_flush() - hand the frames queued on an rx batch to the stack
+ * @adapter: pointer to HDD adapter context
+ * @batch: rx batch
+ *
+ * netif_receive_skb_list() has no per frame result, frames the stack drops
+ * are accounted by the stack.
+ *
+ * Return: number of frames handed to the stack
+ */
+uint32_t hdd_rx_batch_flush(struct hdd_adapter *adapter,
+			    struct hdd_rx_batch *batch);
+
 /**
  * hdd_rx_thread_gro_flush_ind_cbk() - receive handler to flush GRO packets
  * @adapter: pointer to HDD adapter
@@ -242,6 +302,162 @@ void hdd_disable_rx_ol_for_low_tput(struct hdd_context *hdd_ctx, bool disable);
  */
 void hdd_reset_all_adapters_connectivity_stats(struct hdd_context *hdd_ctx);
 
+/**
+ * hdd_conn_stats_set_bitmap() - set the tracked connectivity check packets
+ * @adapter: pointer to vdev apdapter
+ * @pkt_type_bitmap: CONNECTIVITY_CHECK_SET_* packet types to track
+ *
+ * Compiles @pkt_type_bitmap into the match program run by
+ * hdd_tx_rx_collect_connectivity_stats_info(), and enables the
+ * connectivity stats static key while any adapter tracks packets.
+ * Must be called from process context.
+ *
+ * Return: None
+ */
+void hdd_conn_stats_set_bitmap(struct hdd_adapter *adapter,
+			       uint32_t pkt_type_bitmap);
+
+#if (LINUX_VERSION_CODE >= KERNEL_VERSION(4, 3, 0))
+DECLARE_STATIC_KEY_FALSE(hdd_conn_stats_key);
+
+/**
+ * hdd_conn_stats_enabled() - check if packets are tracked for connectivity
+ *			      stats on an adapter
+ * @adapter: pointer to vdev apdapter
+ *
+ * Return: true if packets of @adapter need to be inspected
+ */
+static inline bool hdd_conn_stats_enabled(struct hdd_adapter *adapter)
+{
+	return static_branch_unlikely(&hdd_conn_stats_key) &&
+	       READ_ONCE(adapter->conn_stats_prog.num_ops);
+}
+#else
+static inline bool hdd_conn_stats_enabled(struct hdd_adapter *adapter)
+{
+	return READ_ONCE(adapter->conn_stats_prog.num_ops);
+}
+#endif
+
+/**
+ * hdd_pkt_stats_tx_add() - account transmitted frames on the local CPU
+ * @adapter: adapter the frames were sent on
+ * @packets: number of packets
+ * @bytes: number of bytes
+ *
+ * Bottom halves are disabled around the update so the xmit, NAPI and rx
+ * thread writers of a CPU never nest on its sequence counter.
+ *
+ * Return: None
+ */
+static inline void hdd_pkt_stats_tx_add(struct hdd_adapter *adapter,
+					uint32_t packets, uint32_t bytes)
+{
+	struct hdd_pcpu_pkt_stats *stats;
+
+	local_bh_disable();
+	stats = this_cpu_ptr(adapter->pkt_stats);
+	u64_stats_update_begin(&stats->syncp);
+	stats->cnt.tx_packets += packets;
+	stats->cnt.tx_bytes += bytes;
+	u64_stats_update_end(&stats->syncp);
+	local_bh_enable();
+}
+
+/**
+ * hdd_pkt_stats_rx_add() - account received frames on the local CPU
+ * @adapter: adapter the frames were delivered on
+ * @packets: number of packets
+ * @bytes: number of bytes
+ *
+ * Return: None
+ */
+static inline void hdd_pkt_stats_rx_add(struct hdd_adapter *adapter,
+					uint32_t packets, uint32_t bytes)
+{
+	struct hdd_pcpu_pkt_stats *stats;
+
+	local_bh_disable();
+	stats = this_cpu_ptr(adapter->pkt_stats);
+	u64_stats_update_begin(&stats->syncp);
+	stats->cnt.rx_packets += packets;
+	stats->cnt.rx_bytes += bytes;
+	u64_stats_update_end(&stats->syncp);
+	local_bh_enable();
+}
+
+/**
+ * hdd_get_pkt_stats() - sum the per-CPU tx/rx counters of an adapter
+ * @adapter: adapter to read
+ * @total: filled with the aggregated counters
+ *
+ * Return: None
+ */
+void hdd_get_pkt_stats(struct hdd_adapter *adapter,
+		       struct hdd_pkt_stats *total);
+
+/**
+ * hdd_reset_pkt_stats() - clear the per-CPU tx/rx counters of an adapter
+ * @adapter: adapter to reset
+ *
+ * The per-CPU counters are only written by their own CPU. The reset reads
+ * them through their u64_stats_sync instead and records the sum as the
+ * base that hdd_get_pkt_stats() subtracts, so it never races a writer.
+ *
+ * Return: None
+ */
+void hdd_reset_pkt_stats(struct hdd_adapter *adapter);
+
+/**
+ * enum hdd_tx_orphan_policy - when start_xmit orphans tx skbs
+ * @HDD_TX_ORPHAN_POLICY_STATIC: as configured by gEnableTxOrphan and the
+ *				 legacy tx flow control watermark
+ * @HDD_TX_ORPHAN_POLICY_ADAPTIVE: only while the frames in flight or the tx
+ *				   completion latency of the adapter are above
+ *				   their thresholds, keeping TCP small queues
+ *				   backpressure otherwise
+ */
+enum hdd_tx_orphan_policy {
+	HDD_TX_ORPHAN_POLICY_STATIC,
+	HDD_TX_ORPHAN_POLICY_ADAPTIVE,
+};
+
+/**
+ * hdd_tx_orphan_adaptive() - check if the adaptive tx orphan policy is on
+ * @hdd_ctx: HDD context
+ *
+ * Return: true if tx skbs are orphaned by hdd_tx_orphan_policy_check()
+ */
+static inline bool hdd_tx_orphan_adaptive(struct hdd_context *hdd_ctx)
+{
+	return hdd_ctx->config->tx_orphan_policy ==
+					HDD_TX_ORPHAN_POLICY_ADAPTIVE;
+}
+
+/**
+ * hdd_tx_orphan_policy_check() - decide if a tx skb is to be orphaned
+ * @adapter: adapter the skb is sent on
+ *
+ * The tx descriptors in flight are read from the datapath at most once per
+ * system tick.
+ *
+ * Return: true if the tx descriptors in flight or the tx completion latency
+ *	   of @adapter crossed their configured threshold
+ */
+bool hdd_tx_orphan_policy_check(struct hdd_adapter *adapter);
+
+/**
+ * hdd_tx_orphan_policy_update() - refresh the tx completion latency
+ * @adapter: adapter to update
+ *
+ * Called from the bus bandwidth work once per period. The completion
+ * latency is estimated as the tx descriptors in flight over the rate the
+ * datapath completed descriptors at during the period.
+ *
+ * Return: None
+ */
+void hdd_tx_orphan_policy_update(struct hdd_adapter *adapter);
+
 /**
  * hdd_tx_rx_collect_connectivity_stats_info() - collect connectivity stats
  * @skb: pointer to skb data
@@ -450,7 +666,25 @@ static inline bool hdd_is_current_high_throughput(struct hdd_context *hdd_ctx)
 #endif
 
 #ifdef FEATURE_WLAN_DIAG_SUPPORT
-void hdd_event_eapol_log(struct sk_buff *skb, enum qdf_proto_dir dir);
+void __hdd_event_eapol_log(struct sk_buff *skb, enum qdf_proto_dir dir);
+
+/**
+ * hdd_event_eapol_log() - send EAPOL frame event to wlan diag
+ * @skb: skb ptr
+ * @dir: direction
+ *
+ * Diag events are only delivered while multicast logging is enabled, so
+ * the per packet EAPOL classification is patched out otherwise.
+ *
+ * Return: None
+ */
+static inline
+void hdd_event_eapol_log(struct sk_buff *skb, enum qdf_proto_dir dir)
+{
+	if (cds_pkt_trace_enabled() &&
+	    cds_pkt_trace_user_enabled(CDS_PKT_TRACE_USER_DIAG))
+		__hdd_event_eapol_log(skb, dir);
+}
 #else
 static inline
 void hdd_event_eapol_log(struct sk_buff *skb, enum qdf_proto_dir dir)
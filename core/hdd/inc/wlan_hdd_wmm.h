@@ -191,6 +191,22 @@ struct hdd_wmm_status {
 	bool qos_connection;
 };
 
+/**
+ * struct hdd_wmm_pkt_info - headers of a tx packet, parsed once per hook
+ * @ether_type: ether type of an untagged Ethernet II packet, 0 otherwise
+ * @ip_proto: IPv4 protocol or IPv6 next header, 0 for non IP packets
+ * @tos: IPv4 TOS or IPv6 traffic class, 0 for non IP packets
+ * @src_port: TCP or UDP source port, 0 for other packets
+ * @dst_port: TCP or UDP destination port, 0 for other packets
+ */
+struct hdd_wmm_pkt_info {
+	uint16_t ether_type;
+	uint8_t ip_proto;
+	uint8_t tos;
+	uint16_t src_port;
+	uint16_t dst_port;
+};
+
 extern const uint8_t hdd_qdisc_ac_to_tl_ac[];
 extern const uint8_t hdd_wmm_up_to_ac_map[];
 extern const uint8_t hdd_linux_up_to_ac_map[];
@@ -228,6 +244,46 @@ QDF_STATUS hdd_send_dscp_up_map_to_fw(struct hdd_adapter *adapter);
  */
 QDF_STATUS hdd_wmm_dscp_initial_state(struct hdd_adapter *adapter);
 
+/**
+ * hdd_wmm_parse_pkt() - Parse the L2/L3/L4 headers of an OS packet
+ * @skb: [in]  pointer to network buffer
+ * @info: [out] parsed header information
+ *
+ * Both the tx queue selection and wlan_hdd_classify_pkt() classify a packet
+ * from @info, each parsing the headers once. The qdisc owns skb->cb in
+ * between, so the result cannot be carried from one to the other.
+ *
+ * Only the TOS of IPv4 is taken from VLAN tagged and 802.3 LLC/SNAP framed
+ * packets, as the tx path always did; all other fields are left 0 for
+ * them.
+ *
+ * Return: None
+ */
+void hdd_wmm_parse_pkt(struct sk_buff *skb, struct hdd_wmm_pkt_info *info);
+
+/**
+ * hdd_wmm_parse_port_rules() - Parse the dp_tx_wmm_port_up_rules ini
+ * @str: [in]  comma separated list of "<port>[-<port>]:<up>" rules
+ * @rules: [out] parsed rules, no rules if @str is invalid
+ *
+ * Return: QDF_STATUS_SUCCESS, or QDF_STATUS_E_INVAL if @str is invalid
+ */
+QDF_STATUS hdd_wmm_parse_port_rules(const char *str,
+				    struct hdd_wmm_port_rules *rules);
+
+/**
+ * hdd_wmm_compile_dscp_map() - precompute the per packet DSCP lookup tables
+ * @adapter : [in]  pointer to Adapter context
+ *
+ * Folds the UDP QoS upgrade threshold into a copy of the DSCP-to-UP map,
+ * so that the tx queue selection classifies a packet with one table
+ * lookup. Must be called whenever the DSCP-to-UP map or the UDP QoS
+ * upgrade threshold of the adapter changes.
+ *
+ * Return: None
+ */
+void hdd_wmm_compile_dscp_map(struct hdd_adapter *adapter);
+
 /**
  * hdd_wmm_adapter_init() - initialize the WMM configuration of an adapter
  * @adapter: [in]  pointer to Adapter context
@@ -251,6 +307,24 @@ QDF_STATUS hdd_wmm_adapter_init(struct hdd_adapter *adapter);
  */
 QDF_STATUS hdd_wmm_adapter_close(struct hdd_adapter *adapter);
 
+#ifdef WLAN_HDD_WMM_BENCH
+/**
+ * hdd_wmm_bench() - run the tx WMM classification microbenchmark
+ *
+ * Classifies a mixed set of synthetic IPv4/IPv6 TCP/UDP, VLAN, ARP and
+ * EAPOL frames on a private adapter, once with the DSCP tables only and
+ * once with a full set of port rules. Logs ns/packet of each run.
+ *
+ * Return: number of misclassified frames and failed runs
+ */
+uint32_t hdd_wmm_bench(void);
+#else
+static inline uint32_t hdd_wmm_bench(void)
+{
+	return 0;
+}
+#endif /* WLAN_HDD_WMM_BENCH */
+
 /**
  * hdd_select_queue() - Return queue to be used.
  * @dev:	Pointer to the WLAN device.
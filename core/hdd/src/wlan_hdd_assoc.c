@@ -3677,6 +3677,7 @@ hdd_association_completion_handler(struct hdd_adapter *adapter,
 	}
 
 	hdd_periodic_sta_stats_start(adapter);
+	hdd_sta_stats_hist_reset(adapter);
 
 	return QDF_STATUS_SUCCESS;
 }
@@ -13819,8 +13819,9 @@ static int hdd_set_clear_connectivity_check_stats_info(
 			if (is_set_stats) {
 				arp_stats_params->pkt_type_bitmap = pkt_bitmap;
 				arp_stats_params->flag = true;
-				adapter->pkt_type_bitmap |=
-					arp_stats_params->pkt_type_bitmap;
+				hdd_conn_stats_set_bitmap(adapter,
+					adapter->pkt_type_bitmap |
+					arp_stats_params->pkt_type_bitmap);
 
 				if (pkt_bitmap & CONNECTIVITY_CHECK_SET_ARP) {
 					if (!tb[STATS_GW_IPV4]) {
@@ -13897,8 +13898,9 @@ static int hdd_set_clear_connectivity_check_stats_info(
 				/* clear stats command received */
 				arp_stats_params->pkt_type_bitmap = pkt_bitmap;
 				arp_stats_params->flag = false;
-				adapter->pkt_type_bitmap &=
-					(~arp_stats_params->pkt_type_bitmap);
+				hdd_conn_stats_set_bitmap(adapter,
+					adapter->pkt_type_bitmap &
+					~arp_stats_params->pkt_type_bitmap);
 
 				if (pkt_bitmap & CONNECTIVITY_CHECK_SET_ARP) {
 					arp_stats_params->pkt_type =
@@ -14168,8 +14170,9 @@ static int __wlan_hdd_cfg80211_set_nud_stats(struct wiphy *wiphy,
 
 			arp_stats_params.pkt_type_bitmap =
 						CONNECTIVITY_CHECK_SET_ARP;
-			adapter->pkt_type_bitmap |=
-					arp_stats_params.pkt_type_bitmap;
+			hdd_conn_stats_set_bitmap(adapter,
+					adapter->pkt_type_bitmap |
+					arp_stats_params.pkt_type_bitmap);
 			arp_stats_params.flag = true;
 			arp_stats_params.ip_addr =
 					nla_get_u32(tb[STATS_GW_IPV4]);
@@ -14194,8 +14197,9 @@ static int __wlan_hdd_cfg80211_set_nud_stats(struct wiphy *wiphy,
 		} else {
 			arp_stats_params.pkt_type_bitmap =
 						CONNECTIVITY_CHECK_SET_ARP;
-			adapter->pkt_type_bitmap &=
-					(~arp_stats_params.pkt_type_bitmap);
+			hdd_conn_stats_set_bitmap(adapter,
+					adapter->pkt_type_bitmap &
+					~arp_stats_params.pkt_type_bitmap);
 			arp_stats_params.flag = false;
 			qdf_mem_zero(&adapter->hdd_stats.hdd_arp_stats,
 				     sizeof(adapter->hdd_stats.hdd_arp_stats));
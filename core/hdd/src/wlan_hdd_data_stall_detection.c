@@ -29,6 +29,7 @@
 #include "cdp_txrx_cmn.h"
 #include "cdp_txrx_misc.h"
 #include "ol_txrx_types.h"
+#include "ol_txrx_api.h"
 #include "ol_defines.h"
 #ifdef FEATURE_WLAN_DIAG_SUPPORT
 #include "host_diag_core_event.h"
@@ -143,3 +144,147 @@ int hdd_deregister_data_stall_detect_cb(void)
 					      hdd_data_stall_process_cb);
 	return qdf_status_to_os_return(status);
 }
+
+#ifdef WLAN_DP_STALL_DETECT
+/* a signal has to hold this long for a stall to be reported */
+#define HDD_DP_STALL_HOLD_MS 2000
+/* rx packet batches queued to the rx thread */
+#define HDD_DP_STALL_RX_QUEUE_HIGH 2000
+/* free tx descriptors, in percent of the pool */
+#define HDD_DP_STALL_TX_DESC_LOW_PCT 5
+/* time without tx completion while frames are in flight */
+#define HDD_DP_STALL_TX_COMPL_LAG_MS 1000
+/* buffers in the rx ring, in percent of its fill level */
+#define HDD_DP_STALL_RX_RING_LOW_PCT 25
+
+static const char * const hdd_dp_stall_signal_names[] = {
+	[HDD_DP_STALL_RX_THREAD_BACKLOG] = "rx_thread_backlog",
+	[HDD_DP_STALL_TX_DESC_EXHAUSTED] = "tx_desc_exhausted",
+	[HDD_DP_STALL_TX_FLOW_PAUSED] = "tx_flow_paused",
+	[HDD_DP_STALL_TX_COMPL_LAG] = "tx_compl_lag",
+	[HDD_DP_STALL_RX_RING_STARVED] = "rx_ring_starved",
+};
+
+/**
+ * hdd_dp_stall_signals_raised() - evaluate the datapath state
+ * @dp: sampled datapath state
+ *
+ * Return: bitmap of the raised enum hdd_dp_stall_signal
+ */
+static uint32_t
+hdd_dp_stall_signals_raised(struct ol_txrx_stall_signals *dp)
+{
+	uint32_t raised = 0;
+
+	if (dp->rx_thread_queue_len >= HDD_DP_STALL_RX_QUEUE_HIGH)
+		raised |= BIT(HDD_DP_STALL_RX_THREAD_BACKLOG);
+
+	if (dp->tx_desc_pool_size &&
+	    dp->tx_desc_free * 100 <
+	    dp->tx_desc_pool_size * HDD_DP_STALL_TX_DESC_LOW_PCT)
+		raised |= BIT(HDD_DP_STALL_TX_DESC_EXHAUSTED);
+
+	if (dp->tx_flow_pools_paused)
+		raised |= BIT(HDD_DP_STALL_TX_FLOW_PAUSED);
+
+	if (dp->tx_desc_free < dp->tx_desc_pool_size &&
+	    dp->tx_compl_age_ms >= HDD_DP_STALL_TX_COMPL_LAG_MS)
+		raised |= BIT(HDD_DP_STALL_TX_COMPL_LAG);
+
+	if (dp->rx_ring_fill_level &&
+	    dp->rx_ring_fill_cnt * 100 <
+	    dp->rx_ring_fill_level * HDD_DP_STALL_RX_RING_LOW_PCT)
+		raised |= BIT(HDD_DP_STALL_RX_RING_STARVED);
+
+	return raised;
+}
+
+/**
+ * hdd_dp_stall_report() - log the snapshot of a detected stall
+ * @det: stall detector state
+ * @stalled: signals which triggered the report
+ * @now_ms: current time
+ * @dp: datapath state at the time of the stall
+ * @tx_packets: tx packets in the last bus bandwidth interval
+ * @rx_packets: rx packets in the last bus bandwidth interval
+ *
+ * Return: None
+ */
+static void hdd_dp_stall_report(struct hdd_dp_stall_det *det,
+				uint32_t stalled, uint32_t now_ms,
+				struct ol_txrx_stall_signals *dp,
+				uint64_t tx_packets, uint64_t rx_packets)
+{
+	uint32_t pause_ms = 0;
+	int i;
+
+	det->num_stalls++;
+
+	for (i = 0; i < HDD_DP_STALL_SIGNAL_MAX; i++) {
+		if (stalled & BIT(i))
+			hdd_err("data stall %u: %s for %u ms", det->num_stalls,
+				hdd_dp_stall_signal_names[i],
+				now_ms - det->since_ms[i]);
+	}
+
+	if (det->since_ms[HDD_DP_STALL_TX_FLOW_PAUSED])
+		pause_ms = now_ms - det->since_ms[HDD_DP_STALL_TX_FLOW_PAUSED];
+
+	hdd_err("data stall %u: rx_thread_q %u tx_desc_free %u/%u flow_pools_paused %u (%u ms) tx_compl_age %u ms rx_ring %u/%u tx_pkts %llu rx_pkts %llu",
+		det->num_stalls, dp->rx_thread_queue_len, dp->tx_desc_free,
+		dp->tx_desc_pool_size, dp->tx_flow_pools_paused, pause_ms,
+		dp->tx_compl_age_ms, dp->rx_ring_fill_cnt,
+		dp->rx_ring_fill_level, tx_packets, rx_packets);
+}
+
+void hdd_dp_stall_detect(struct hdd_context *hdd_ctx, uint64_t tx_packets,
+			 uint64_t rx_packets)
+{
+	struct hdd_dp_stall_det *det = &hdd_ctx->dp_stall_det;
+	void *soc = cds_get_context(QDF_MODULE_ID_SOC);
+	struct ol_txrx_stall_signals dp;
+	uint32_t now_ms, max_gap_ms, raised, stalled = 0;
+	int i;
+
+	if (!soc || !cdp_cfg_get(soc, cfg_dp_enable_data_stall))
+		return;
+
+	if (QDF_IS_STATUS_ERROR(ol_txrx_get_stall_signals(&dp)))
+		return;
+
+	/* keep 0 free to mean "not raised" */
+	now_ms = qdf_system_ticks_to_msecs(qdf_system_ticks()) | 1;
+	/* the work was not run for a while, e.g. it was stopped meanwhile */
+	max_gap_ms = 2 * hdd_ctx->config->bus_bw_compute_interval;
+	if (det->last_check_ms && now_ms - det->last_check_ms > max_gap_ms) {
+		qdf_mem_zero(det->since_ms, sizeof(det->since_ms));
+		det->reported = 0;
+	}
+	det->last_check_ms = now_ms;
+
+	raised = hdd_dp_stall_signals_raised(&dp);
+	for (i = 0; i < HDD_DP_STALL_SIGNAL_MAX; i++) {
+		if (!(raised & BIT(i))) {
+			det->since_ms[i] = 0;
+			det->reported &= ~BIT(i);
+			continue;
+		}
+
+		if (!det->since_ms[i])
+			det->since_ms[i] = now_ms;
+		else if (now_ms - det->since_ms[i] >= HDD_DP_STALL_HOLD_MS)
+			stalled |= BIT(i);
+	}
+
+	/* a raised signal with traffic still flowing is congestion */
+	if (tx_packets + rx_packets >= hdd_ctx->config->bus_bw_low_threshold)
+		return;
+
+	stalled &= ~det->reported;
+	if (!stalled)
+		return;
+
+	det->reported |= stalled;
+	hdd_dp_stall_report(det, stalled, now_ms, &dp, tx_packets, rx_packets);
+}
+#endif /* WLAN_DP_STALL_DETECT */
@@ -567,6 +567,7 @@ QDF_STATUS hdd_debugfs_init(struct hdd_adapter *adapter)
  */
 void hdd_debugfs_exit(struct hdd_adapter *adapter)
 {
+	wlan_hdd_ll_stats_stream_deinit(adapter);
 	debugfs_remove_recursive(adapter->debugfs_phy);
 }
 #endif /* #ifdef WLAN_OPEN_SOURCE */
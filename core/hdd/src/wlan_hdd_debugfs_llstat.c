@@ -28,6 +28,9 @@
 #include <wlan_hdd_debugfs_llstat.h>
 #include <wlan_hdd_stats.h>
 #include <wma_api.h>
+#ifdef CONFIG_RELAY
+#include <linux/relay.h>
+#endif
 
 struct ll_stats_buf {
 	ssize_t len;
@@ -536,11 +539,614 @@ static const struct file_operations fops_ll_stats_debugfs = {
 	.llseek = default_llseek,
 };
 
+#ifdef CONFIG_RELAY
+#define HDD_LL_STATS_STREAM_SUBBUF_SIZE   16384
+#define HDD_LL_STATS_STREAM_N_SUBBUFS     8
+#define HDD_LL_STATS_STREAM_PAYLOAD_MAX \
+	(HDD_LL_STATS_STREAM_SUBBUF_SIZE - sizeof(struct hdd_ll_stats_rec_hdr))
+#define HDD_LL_STATS_STREAM_MIN_PERIOD_MS 100
+#define HDD_LL_STATS_STREAM_MAX_PERIOD_MS 60000
+#define HDD_LL_STATS_STREAM_CMD_SIZE      16
+
+/**
+ * struct hdd_ll_stats_stream - binary LL stats stream context
+ * @adapter: adapter the stream belongs to
+ * @chan: relay channel with a single global buffer, exposed as
+ *	ll_stats_bin0 in the debugfs directory of the adapter; opened on
+ *	first start
+ * @work: periodic LL stats poll
+ * @period_ms: poll period, 0 when the stream is stopped
+ * @seq: sequence number of the current snapshot
+ * @snapshots: number of polls that completed successfully
+ * @failed: number of polls for which the request to FW failed
+ * @dropped: records dropped because they did not fit in a sub-buffer
+ * @rec: scratch buffer a record is assembled in before it is relayed
+ */
+struct hdd_ll_stats_stream {
+	struct hdd_adapter *adapter;
+	struct rchan *chan;
+	struct qdf_delayed_work work;
+	uint32_t period_ms;
+	uint32_t seq;
+	uint32_t snapshots;
+	uint32_t failed;
+	uint32_t dropped;
+	uint8_t rec[HDD_LL_STATS_STREAM_SUBBUF_SIZE];
+};
+
+/* Protects adapter->ll_stats_stream and the record scratch buffer */
+static DEFINE_MUTEX(llstats_stream_mutex);
+
+/**
+ * hdd_ll_stats_stream_get() - Get the stream of an adapter if it is open
+ * @adapter: Pointer to device adapter
+ *
+ * Caller must hold llstats_stream_mutex.
+ *
+ * Return: stream context, NULL if there is no open relay channel
+ */
+static struct hdd_ll_stats_stream *
+hdd_ll_stats_stream_get(struct hdd_adapter *adapter)
+{
+	struct hdd_ll_stats_stream *stream = adapter->ll_stats_stream;
+
+	if (!stream || !stream->chan)
+		return NULL;
+
+	return stream;
+}
+
+/**
+ * hdd_ll_stats_stream_payload() - Get the payload area of the scratch record
+ * @stream: stream context
+ *
+ * Return: pointer to HDD_LL_STATS_STREAM_PAYLOAD_MAX bytes of payload
+ */
+static inline void *
+hdd_ll_stats_stream_payload(struct hdd_ll_stats_stream *stream)
+{
+	return stream->rec + sizeof(struct hdd_ll_stats_rec_hdr);
+}
+
+/**
+ * hdd_ll_stats_stream_emit() - Relay the record assembled in scratch buffer
+ * @stream: stream context
+ * @type: enum hdd_ll_stats_rec_type
+ * @len: length of the payload already written to the scratch buffer
+ *
+ * Caller must hold llstats_stream_mutex.
+ *
+ * Return: None
+ */
+static void hdd_ll_stats_stream_emit(struct hdd_ll_stats_stream *stream,
+				     uint16_t type, uint32_t len)
+{
+	struct hdd_ll_stats_rec_hdr *hdr =
+		(struct hdd_ll_stats_rec_hdr *)stream->rec;
+
+	qdf_mem_zero(hdr, sizeof(*hdr));
+	hdr->magic = HDD_LL_STATS_STREAM_MAGIC;
+	hdr->version = HDD_LL_STATS_STREAM_VERSION;
+	hdr->type = type;
+	hdr->len = len;
+	hdr->seq = stream->seq;
+	hdr->ts_us = qdf_get_monotonic_boottime();
+	hdr->vdev_id = stream->adapter->vdev_id;
+
+	relay_write(stream->chan, stream->rec, sizeof(*hdr) + len);
+}
+
+void hdd_ll_stats_stream_radio(struct hdd_adapter *adapter, void *data,
+			       uint32_t num_radio)
+{
+	struct wifi_radio_stats *radio_stat = data;
+	struct wifi_channel_stats *chan_stat;
+	struct hdd_ll_stats_stream *stream;
+	struct hdd_ll_stats_rec_radio *rec;
+	struct hdd_ll_stats_rec_chan *chan_rec;
+	uint32_t *pwr_level;
+	uint64_t len;
+	int i, j;
+
+	mutex_lock(&llstats_stream_mutex);
+	stream = hdd_ll_stats_stream_get(adapter);
+	if (!stream)
+		goto unlock;
+
+	for (i = 0; i < num_radio; i++, radio_stat++) {
+		len = sizeof(*rec) +
+		      (uint64_t)radio_stat->total_num_tx_power_levels *
+		      sizeof(*pwr_level) +
+		      (uint64_t)radio_stat->num_channels * sizeof(*chan_rec);
+		if (len > HDD_LL_STATS_STREAM_PAYLOAD_MAX) {
+			stream->dropped++;
+			continue;
+		}
+
+		rec = hdd_ll_stats_stream_payload(stream);
+		rec->radio = radio_stat->radio;
+		rec->on_time = radio_stat->on_time;
+		rec->tx_time = radio_stat->tx_time;
+		rec->rx_time = radio_stat->rx_time;
+		rec->on_time_scan = radio_stat->on_time_scan;
+		rec->on_time_nbd = radio_stat->on_time_nbd;
+		rec->on_time_gscan = radio_stat->on_time_gscan;
+		rec->on_time_roam_scan = radio_stat->on_time_roam_scan;
+		rec->on_time_pno_scan = radio_stat->on_time_pno_scan;
+		rec->on_time_hs20 = radio_stat->on_time_hs20;
+		rec->on_time_host_scan = radio_stat->on_time_host_scan;
+		rec->on_time_lpi_scan = radio_stat->on_time_lpi_scan;
+		rec->num_tx_power_levels =
+				radio_stat->total_num_tx_power_levels;
+		rec->num_channels = radio_stat->num_channels;
+
+		pwr_level = (uint32_t *)(rec + 1);
+		for (j = 0; j < rec->num_tx_power_levels; j++)
+			pwr_level[j] = radio_stat->tx_time_per_power_level[j];
+
+		chan_rec = (struct hdd_ll_stats_rec_chan *)
+				(pwr_level + rec->num_tx_power_levels);
+		for (j = 0; j < rec->num_channels; j++, chan_rec++) {
+			chan_stat = &radio_stat->channels[j];
+			chan_rec->width = chan_stat->channel.width;
+			chan_rec->center_freq = chan_stat->channel.center_freq;
+			chan_rec->center_freq0 =
+					chan_stat->channel.center_freq0;
+			chan_rec->center_freq1 =
+					chan_stat->channel.center_freq1;
+			chan_rec->on_time = chan_stat->on_time;
+			chan_rec->cca_busy_time = chan_stat->cca_busy_time;
+			chan_rec->tx_time = chan_stat->tx_time;
+			chan_rec->rx_time = chan_stat->rx_time;
+		}
+
+		hdd_ll_stats_stream_emit(stream, HDD_LL_STATS_REC_RADIO, len);
+	}
+
+unlock:
+	mutex_unlock(&llstats_stream_mutex);
+}
+
+void hdd_ll_stats_stream_iface(struct hdd_adapter *adapter, void *data,
+			       uint32_t num_peers)
+{
+	struct wifi_interface_stats *iface_stat = data;
+	wmi_iface_link_stats *link_stats = &iface_stat->link_stats;
+	wmi_wmm_ac_stats *ac_stats;
+	struct hdd_ll_stats_stream *stream;
+	struct hdd_ll_stats_rec_iface *rec;
+	struct hdd_ll_stats_rec_ac *ac_rec;
+	int i;
+
+	mutex_lock(&llstats_stream_mutex);
+	stream = hdd_ll_stats_stream_get(adapter);
+	if (!stream)
+		goto unlock;
+
+	rec = hdd_ll_stats_stream_payload(stream);
+	rec->num_peers = num_peers;
+	rec->beacon_rx = link_stats->beacon_rx;
+	rec->mgmt_rx = link_stats->mgmt_rx;
+	rec->mgmt_action_rx = link_stats->mgmt_action_rx;
+	rec->mgmt_action_tx = link_stats->mgmt_action_tx;
+	rec->rssi_mgmt = link_stats->rssi_mgmt;
+	rec->rssi_data = link_stats->rssi_data;
+	rec->rssi_ack = link_stats->rssi_ack;
+	rec->tx_rts_succ_cnt = link_stats->tx_rts_succ_cnt;
+	rec->tx_rts_fail_cnt = link_stats->tx_rts_fail_cnt;
+	rec->tx_ppdu_succ_cnt = link_stats->tx_ppdu_succ_cnt;
+	rec->tx_ppdu_fail_cnt = link_stats->tx_ppdu_fail_cnt;
+	rec->connected_duration = link_stats->connected_duration;
+	rec->disconnected_duration = link_stats->disconnected_duration;
+	rec->num_probes_tx = link_stats->num_probes_tx;
+	rec->num_beacon_miss = link_stats->num_beacon_miss;
+	rec->num_ac = QDF_MIN(link_stats->num_ac, WIFI_AC_MAX);
+
+	ac_rec = (struct hdd_ll_stats_rec_ac *)(rec + 1);
+	for (i = 0; i < rec->num_ac; i++, ac_rec++) {
+		ac_stats = &iface_stat->ac_stats[i];
+		ac_rec->ac_type = ac_stats->ac_type;
+		ac_rec->tx_mpdu = ac_stats->tx_mpdu;
+		ac_rec->rx_mpdu = ac_stats->rx_mpdu;
+		ac_rec->tx_mcast = ac_stats->tx_mcast;
+		ac_rec->rx_mcast = ac_stats->rx_mcast;
+		ac_rec->rx_ampdu = ac_stats->rx_ampdu;
+		ac_rec->tx_ampdu = ac_stats->tx_ampdu;
+		ac_rec->mpdu_lost = ac_stats->mpdu_lost;
+		ac_rec->retries = ac_stats->retries;
+		ac_rec->retries_short = ac_stats->retries_short;
+		ac_rec->retries_long = ac_stats->retries_long;
+		ac_rec->contention_time_min = ac_stats->contention_time_min;
+		ac_rec->contention_time_max = ac_stats->contention_time_max;
+		ac_rec->contention_time_avg = ac_stats->contention_time_avg;
+		ac_rec->contention_num_samples =
+					ac_stats->contention_num_samples;
+		ac_rec->tx_pending_msdu = ac_stats->tx_pending_msdu;
+	}
+
+	hdd_ll_stats_stream_emit(stream, HDD_LL_STATS_REC_IFACE,
+				 sizeof(*rec) + rec->num_ac * sizeof(*ac_rec));
+
+unlock:
+	mutex_unlock(&llstats_stream_mutex);
+}
+
+void hdd_ll_stats_stream_peer(struct hdd_adapter *adapter, void *data)
+{
+	struct wifi_peer_stat *peer_stat = data;
+	struct wifi_peer_info *peer_info;
+	struct wifi_rate_stat *rate_stat;
+	struct hdd_ll_stats_stream *stream;
+	struct hdd_ll_stats_rec_peer *rec;
+	struct hdd_ll_stats_rec_rate *rate_rec;
+	uint64_t len;
+	int i, j;
+
+	mutex_lock(&llstats_stream_mutex);
+	stream = hdd_ll_stats_stream_get(adapter);
+	if (!stream)
+		goto unlock;
+
+	peer_info = peer_stat->peer_info;
+	for (i = 0; i < peer_stat->num_peers; i++) {
+		len = sizeof(*rec) +
+		      (uint64_t)peer_info->num_rate * sizeof(*rate_rec);
+		if (len > HDD_LL_STATS_STREAM_PAYLOAD_MAX) {
+			stream->dropped++;
+			goto next_peer;
+		}
+
+		rec = hdd_ll_stats_stream_payload(stream);
+		rec->type = wmi_to_sir_peer_type(peer_info->type);
+		qdf_mem_copy(rec->mac, peer_info->peer_macaddr.bytes,
+			     QDF_MAC_ADDR_SIZE);
+		rec->reserved = 0;
+		rec->capabilities = peer_info->capabilities;
+		rec->num_rate = peer_info->num_rate;
+
+		rate_rec = (struct hdd_ll_stats_rec_rate *)(rec + 1);
+		for (j = 0; j < rec->num_rate; j++, rate_rec++) {
+			rate_stat = &peer_info->rate_stats[j];
+			rate_rec->preamble = rate_stat->rate.preamble;
+			rate_rec->nss = rate_stat->rate.nss;
+			rate_rec->bw = rate_stat->rate.bw;
+			rate_rec->mcs = rate_stat->rate.rate_or_mcs_index;
+			rate_rec->bitrate = rate_stat->rate.bitrate;
+			rate_rec->tx_mpdu = rate_stat->tx_mpdu;
+			rate_rec->rx_mpdu = rate_stat->rx_mpdu;
+			rate_rec->mpdu_lost = rate_stat->mpdu_lost;
+			rate_rec->retries = rate_stat->retries;
+			rate_rec->retries_short = rate_stat->retries_short;
+			rate_rec->retries_long = rate_stat->retries_long;
+		}
+
+		hdd_ll_stats_stream_emit(stream, HDD_LL_STATS_REC_PEER, len);
+next_peer:
+		peer_info = (struct wifi_peer_info *)((uint8_t *)peer_info +
+				sizeof(*peer_info) +
+				peer_info->num_rate * sizeof(*rate_stat));
+	}
+
+unlock:
+	mutex_unlock(&llstats_stream_mutex);
+}
+
+/**
+ * hdd_ll_stats_stream_work() - Periodic LL stats poll of the binary stream
+ * @context: stream context
+ *
+ * Requests LL stats from FW with DEBUGFS_LLSTATS_STREAM_REQID; the
+ * responses are serialized by the hdd_ll_stats_stream_*() helpers from the
+ * LL stats callback. Once the request completes the snapshot is closed with
+ * an end record and the relay channel is flushed so readers are woken up.
+ *
+ * Return: None
+ */
+static void hdd_ll_stats_stream_work(void *context)
+{
+	struct hdd_ll_stats_stream *stream = context;
+	struct hdd_adapter *adapter = stream->adapter;
+	struct hdd_ll_stats_rec_end *end;
+	struct osif_vdev_sync *vdev_sync;
+	int errno;
+
+	mutex_lock(&llstats_stream_mutex);
+	stream->seq++;
+	mutex_unlock(&llstats_stream_mutex);
+
+	errno = osif_vdev_sync_op_start(adapter->dev, &vdev_sync);
+	if (!errno) {
+		errno = wlan_hdd_ll_stats_try_get(adapter,
+						  DEBUGFS_LLSTATS_STREAM_REQID,
+						  DEBUGFS_LLSTATS_REQMASK);
+		osif_vdev_sync_op_stop(vdev_sync);
+	}
+
+	mutex_lock(&llstats_stream_mutex);
+	if (errno)
+		stream->failed++;
+	else
+		stream->snapshots++;
+
+	end = hdd_ll_stats_stream_payload(stream);
+	end->status = errno;
+	end->dropped = stream->dropped;
+	hdd_ll_stats_stream_emit(stream, HDD_LL_STATS_REC_END, sizeof(*end));
+	relay_flush(stream->chan);
+	mutex_unlock(&llstats_stream_mutex);
+
+	if (stream->period_ms)
+		qdf_delayed_work_start(&stream->work, stream->period_ms);
+}
+
+static struct dentry *
+hdd_ll_stats_stream_create_buf_file(const char *filename,
+				    struct dentry *parent, umode_t mode,
+				    struct rchan_buf *buf, int *is_global)
+{
+	/* one buffer for all CPUs, so snapshots read back in emit order */
+	*is_global = 1;
+
+	return debugfs_create_file(filename, mode, parent, buf,
+				   &relay_file_operations);
+}
+
+static int hdd_ll_stats_stream_remove_buf_file(struct dentry *dentry)
+{
+	debugfs_remove(dentry);
+
+	return 0;
+}
+
+static struct rchan_callbacks hdd_ll_stats_stream_relay_cbs = {
+	.create_buf_file = hdd_ll_stats_stream_create_buf_file,
+	.remove_buf_file = hdd_ll_stats_stream_remove_buf_file,
+};
+
+/**
+ * hdd_ll_stats_stream_set_period() - Start, stop or retune the stream
+ * @adapter: Pointer to device adapter
+ * @period_ms: poll period, 0 to stop
+ *
+ * Return: 0 on success and errno on failure
+ */
+static int hdd_ll_stats_stream_set_period(struct hdd_adapter *adapter,
+					  uint32_t period_ms)
+{
+	struct hdd_ll_stats_stream *stream;
+	bool running;
+
+	if (period_ms &&
+	    (period_ms < HDD_LL_STATS_STREAM_MIN_PERIOD_MS ||
+	     period_ms > HDD_LL_STATS_STREAM_MAX_PERIOD_MS)) {
+		hdd_err_rl("Invalid period %u, expected 0 or [%d, %d]",
+			   period_ms, HDD_LL_STATS_STREAM_MIN_PERIOD_MS,
+			   HDD_LL_STATS_STREAM_MAX_PERIOD_MS);
+		return -EINVAL;
+	}
+
+	mutex_lock(&llstats_stream_mutex);
+	stream = adapter->ll_stats_stream;
+	if (!stream) {
+		mutex_unlock(&llstats_stream_mutex);
+		return -ENODEV;
+	}
+
+	if (period_ms && !stream->chan) {
+		stream->chan = relay_open("ll_stats_bin", adapter->debugfs_phy,
+					  HDD_LL_STATS_STREAM_SUBBUF_SIZE,
+					  HDD_LL_STATS_STREAM_N_SUBBUFS,
+					  &hdd_ll_stats_stream_relay_cbs,
+					  NULL);
+		if (!stream->chan) {
+			mutex_unlock(&llstats_stream_mutex);
+			hdd_err("Failed to open LL stats relay channel");
+			return -ENOMEM;
+		}
+	}
+
+	running = !!stream->period_ms;
+	stream->period_ms = period_ms;
+	mutex_unlock(&llstats_stream_mutex);
+
+	hdd_debug("LL stats stream period %u ms", period_ms);
+
+	if (!period_ms)
+		qdf_delayed_work_stop_sync(&stream->work);
+	else if (!running)
+		qdf_delayed_work_start(&stream->work, 0);
+
+	return 0;
+}
+
+/**
+ * __wlan_hdd_write_ll_stats_stream_debugfs() - Set the stream poll period
+ * @net_dev: net_device context used to register the debugfs file
+ * @buf: text being written to the debugfs
+ * @count: size of @buf
+ *
+ * Return: number of bytes processed or errno
+ */
+static ssize_t
+__wlan_hdd_write_ll_stats_stream_debugfs(struct net_device *net_dev,
+					 const char __user *buf, size_t count)
+{
+	struct hdd_adapter *adapter = WLAN_HDD_GET_PRIV_PTR(net_dev);
+	char cmd[HDD_LL_STATS_STREAM_CMD_SIZE + 1];
+	uint32_t period_ms;
+	int errno;
+
+	errno = hdd_validate_adapter(adapter);
+	if (errno)
+		return errno;
+
+	errno = wlan_hdd_validate_context(WLAN_HDD_GET_CTX(adapter));
+	if (errno)
+		return errno;
+
+	if (!count || count > HDD_LL_STATS_STREAM_CMD_SIZE)
+		return -EINVAL;
+
+	if (copy_from_user(cmd, buf, count))
+		return -EFAULT;
+	cmd[count] = '\0';
+
+	if (kstrtou32(cmd, 0, &period_ms))
+		return -EINVAL;
+
+	errno = hdd_ll_stats_stream_set_period(adapter, period_ms);
+	if (errno)
+		return errno;
+
+	return count;
+}
+
+/**
+ * wlan_hdd_write_ll_stats_stream_debugfs() - SSR wrapper to set the stream
+ *	poll period
+ * @file: file pointer
+ * @buf: buffer
+ * @count: count
+ * @pos: position pointer
+ *
+ * Return: number of bytes processed or errno
+ */
+static ssize_t wlan_hdd_write_ll_stats_stream_debugfs(struct file *file,
+						      const char __user *buf,
+						      size_t count,
+						      loff_t *pos)
+{
+	struct net_device *net_dev = file_inode(file)->i_private;
+	struct osif_vdev_sync *vdev_sync;
+	ssize_t err_size;
+
+	err_size = osif_vdev_sync_op_start(net_dev, &vdev_sync);
+	if (err_size)
+		return err_size;
+
+	err_size = __wlan_hdd_write_ll_stats_stream_debugfs(net_dev, buf,
+							    count);
+
+	osif_vdev_sync_op_stop(vdev_sync);
+
+	return err_size;
+}
+
+/**
+ * wlan_hdd_read_ll_stats_stream_debugfs() - Read the stream state
+ * @file: file pointer
+ * @buf: buffer
+ * @count: count
+ * @pos: position pointer
+ *
+ * Return: Number of bytes read on success, error number otherwise
+ */
+static ssize_t wlan_hdd_read_ll_stats_stream_debugfs(struct file *file,
+						     char __user *buf,
+						     size_t count, loff_t *pos)
+{
+	struct net_device *net_dev = file_inode(file)->i_private;
+	struct hdd_adapter *adapter = WLAN_HDD_GET_PRIV_PTR(net_dev);
+	struct hdd_ll_stats_stream *stream;
+	char state[128];
+	ssize_t len = 0;
+
+	mutex_lock(&llstats_stream_mutex);
+	stream = adapter->ll_stats_stream;
+	if (stream)
+		len = scnprintf(state, sizeof(state),
+				"version %u period_ms %u seq %u snapshots %u failed %u dropped %u\n",
+				HDD_LL_STATS_STREAM_VERSION, stream->period_ms,
+				stream->seq, stream->snapshots, stream->failed,
+				stream->dropped);
+	mutex_unlock(&llstats_stream_mutex);
+
+	return simple_read_from_buffer(buf, count, pos, state, len);
+}
+
+static const struct file_operations fops_ll_stats_stream_debugfs = {
+	.read = wlan_hdd_read_ll_stats_stream_debugfs,
+	.write = wlan_hdd_write_ll_stats_stream_debugfs,
+	.open = simple_open,
+	.owner = THIS_MODULE,
+	.llseek = default_llseek,
+};
+
+/**
+ * wlan_hdd_create_ll_stats_stream_file() - Create the binary LL stats stream
+ *	control file
+ * @adapter: interface adapter pointer
+ *
+ * Writing a period in ms to "ll_stats_stream" starts periodic LL stats
+ * snapshots into the ll_stats_bin0 relay file, writing 0 stops them.
+ *
+ * Return: 0 on success and errno on failure
+ */
+static int wlan_hdd_create_ll_stats_stream_file(struct hdd_adapter *adapter)
+{
+	struct hdd_ll_stats_stream *stream;
+	QDF_STATUS status;
+
+	stream = qdf_mem_malloc(sizeof(*stream));
+	if (!stream)
+		return -ENOMEM;
+
+	stream->adapter = adapter;
+	status = qdf_delayed_work_create(&stream->work,
+					 hdd_ll_stats_stream_work, stream);
+	if (QDF_IS_STATUS_ERROR(status)) {
+		qdf_mem_free(stream);
+		return qdf_status_to_os_return(status);
+	}
+
+	if (!debugfs_create_file("ll_stats_stream", 0600,
+				 adapter->debugfs_phy, adapter->dev,
+				 &fops_ll_stats_stream_debugfs)) {
+		qdf_delayed_work_destroy(&stream->work);
+		qdf_mem_free(stream);
+		return -EINVAL;
+	}
+
+	mutex_lock(&llstats_stream_mutex);
+	adapter->ll_stats_stream = stream;
+	mutex_unlock(&llstats_stream_mutex);
+
+	return 0;
+}
+
+void wlan_hdd_ll_stats_stream_deinit(struct hdd_adapter *adapter)
+{
+	struct hdd_ll_stats_stream *stream;
+
+	mutex_lock(&llstats_stream_mutex);
+	stream = adapter->ll_stats_stream;
+	adapter->ll_stats_stream = NULL;
+	if (stream)
+		stream->period_ms = 0;
+	mutex_unlock(&llstats_stream_mutex);
+
+	if (!stream)
+		return;
+
+	qdf_delayed_work_stop_sync(&stream->work);
+	qdf_delayed_work_destroy(&stream->work);
+	if (stream->chan)
+		relay_close(stream->chan);
+	qdf_mem_free(stream);
+}
+#else
+static inline int
+wlan_hdd_create_ll_stats_stream_file(struct hdd_adapter *adapter)
+{
+	return 0;
+}
+#endif /* CONFIG_RELAY */
+
 int wlan_hdd_create_ll_stats_file(struct hdd_adapter *adapter)
 {
 	if (!debugfs_create_file("ll_stats", 0444, adapter->debugfs_phy,
 				 adapter->dev, &fops_ll_stats_debugfs))
 		return -EINVAL;
 
-	return 0;
+	return wlan_hdd_create_ll_stats_stream_file(adapter);
 }
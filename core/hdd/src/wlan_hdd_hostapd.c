@@ -3454,7 +3454,7 @@ const struct net_device_ops net_ops_struct = {
 	.ndo_uninit = hdd_hostapd_uninit,
 	.ndo_start_xmit = hdd_softap_hard_start_xmit,
 	.ndo_tx_timeout = hdd_softap_tx_timeout,
-	.ndo_get_stats = hdd_get_stats,
+	.ndo_get_stats64 = hdd_get_stats64,
 	.ndo_set_mac_address = hdd_hostapd_set_mac_address,
 	.ndo_do_ioctl = hdd_ioctl,
 	.ndo_change_mtu = hdd_hostapd_change_mtu,
@@ -3754,6 +3754,14 @@ struct hdd_adapter *hdd_wlan_create_ap_dev(struct hdd_context *hdd_ctx,
 	adapter->magic = WLAN_HDD_ADAPTER_MAGIC;
 	adapter->vdev_id = WLAN_UMAC_VDEV_ID_MAX;
 
+	if (hdd_pkt_stats_alloc(adapter)) {
+		hdd_err("failed to allocate tx/rx counters");
+		free_netdev(dev);
+		return NULL;
+	}
+
+	qdf_mutex_create(&adapter->sta_stats_cache.lock);
+
 	hdd_debug("dev = %pK, adapter = %pK, concurrency_mode=0x%x",
 		dev, adapter,
 		(int)policy_mgr_get_concurrency_mode(hdd_ctx->psoc));
@@ -3780,7 +3788,7 @@ struct hdd_adapter *hdd_wlan_create_ap_dev(struct hdd_context *hdd_ctx,
 			&adapter->qdf_session_open_event);
 	if (!QDF_IS_STATUS_SUCCESS(qdf_status)) {
 		hdd_err("failed to create session open QDF event!");
-		free_netdev(adapter->dev);
+		hdd_free_netdev(adapter->dev);
 		return NULL;
 	}
 
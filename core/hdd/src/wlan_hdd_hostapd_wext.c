@@ -956,6 +956,7 @@ static __iw_softap_setparam(struct net_device *dev,
 		case CDP_HDD_STATS:
 			memset(&adapter->stats, 0,
 						sizeof(adapter->stats));
+			hdd_reset_pkt_stats(adapter);
 			memset(&adapter->hdd_stats, 0,
 					sizeof(adapter->hdd_stats));
 			break;
@@ -498,8 +498,7 @@ void hdd_ipa_send_nbuf_to_network(qdf_nbuf_t nbuf, qdf_netdev_t dev)
 	 * For SAP as part of IPA HW stats are updated.
 	 */
 
-	++adapter->stats.rx_packets;
-	adapter->stats.rx_bytes += nbuf->len;
+	hdd_pkt_stats_rx_add(adapter, 1, nbuf->len);
 
 	result = hdd_ipa_aggregated_rx_ind(nbuf);
 	if (result == NET_RX_SUCCESS)
@@ -124,6 +124,7 @@
 #include <dispatcher_init_deinit.h>
 #include "wlan_hdd_object_manager.h"
 #include "cds_utils.h"
+#include "cds_pkt_trace.h"
 #include <cdp_txrx_handle.h>
 #include <qca_vendor.h>
 #include "wlan_pmo_ucfg_api.h"
@@ -5149,7 +5150,7 @@ static const struct net_device_ops wlan_drv_ops = {
 	.ndo_fix_features = hdd_fix_features,
 	.ndo_set_features = hdd_set_features,
 	.ndo_tx_timeout = hdd_tx_timeout,
-	.ndo_get_stats = hdd_get_stats,
+	.ndo_get_stats64 = hdd_get_stats64,
 	.ndo_do_ioctl = hdd_ioctl,
 	.ndo_set_mac_address = hdd_set_mac_address,
 	.ndo_select_queue = hdd_select_queue,
@@ -5161,7 +5162,7 @@ static const struct net_device_ops wlan_drv_ops = {
 static const struct net_device_ops wlan_mon_drv_ops = {
 	.ndo_open = hdd_mon_open,
 	.ndo_stop = hdd_stop,
-	.ndo_get_stats = hdd_get_stats,
+	.ndo_get_stats64 = hdd_get_stats64,
 };
 
 /**
@@ -5217,7 +5218,7 @@ static void hdd_set_mon_ops(struct net_device *dev)
 static const struct net_device_ops wlan_pktcapture_drv_ops = {
 	.ndo_open = hdd_pktcapture_open,
 	.ndo_stop = hdd_stop,
-	.ndo_get_stats = hdd_get_stats,
+	.ndo_get_stats64 = hdd_get_stats64,
 };
 
 static void hdd_set_pktcapture_ops(struct net_device *dev)
@@ -5230,6 +5231,29 @@ static void hdd_set_pktcapture_ops(struct net_device *dev)
 }
 #endif
 
+int hdd_pkt_stats_alloc(struct hdd_adapter *adapter)
+{
+	adapter->pkt_stats = netdev_alloc_pcpu_stats(struct hdd_pcpu_pkt_stats);
+	if (!adapter->pkt_stats)
+		return -ENOMEM;
+
+	qdf_spinlock_create(&adapter->pkt_stats_lock);
+	qdf_mem_zero(&adapter->pkt_stats_base,
+		     sizeof(adapter->pkt_stats_base));
+
+	return 0;
+}
+
+void hdd_pkt_stats_free(struct hdd_adapter *adapter)
+{
+	if (!adapter->pkt_stats)
+		return;
+
+	qdf_spinlock_destroy(&adapter->pkt_stats_lock);
+	free_percpu(adapter->pkt_stats);
+	adapter->pkt_stats = NULL;
+}
+
 /**
  * hdd_alloc_station_adapter() - allocate the station hdd adapter
  * @hdd_ctx: global hdd context
@@ -5278,6 +5302,11 @@ hdd_alloc_station_adapter(struct hdd_context *hdd_ctx, tSirMacAddr mac_addr,
 	adapter->magic = WLAN_HDD_ADAPTER_MAGIC;
 	adapter->vdev_id = WLAN_UMAC_VDEV_ID_MAX;
 
+	if (hdd_pkt_stats_alloc(adapter))
+		goto free_net_dev;
+
+	qdf_mutex_create(&adapter->sta_stats_cache.lock);
+
 	qdf_status = qdf_event_create(&adapter->qdf_session_open_event);
 	if (QDF_IS_STATUS_ERROR(qdf_status))
 		goto free_net_dev;
@@ -5333,7 +5362,7 @@ hdd_alloc_station_adapter(struct hdd_context *hdd_ctx, tSirMacAddr mac_addr,
 	return adapter;
 
 free_net_dev:
-	free_netdev(adapter->dev);
+	hdd_free_netdev(adapter->dev);
 
 	return NULL;
 }
@@ -6042,9 +6071,12 @@ static void hdd_cleanup_adapter(struct hdd_context *hdd_ctx,
 	}
 
 	hdd_nud_deinit_tracking(adapter);
+	hdd_conn_stats_set_bitmap(adapter, 0);
 	hdd_mic_deinit_work(adapter);
 	qdf_mutex_destroy(&adapter->disconnection_status_lock);
+	qdf_mutex_destroy(&adapter->sta_stats_cache.lock);
 	hdd_periodic_sta_stats_mutex_destroy(adapter);
+	hdd_sta_stats_hist_deinit(adapter);
 	hdd_apf_context_destroy(adapter);
 	qdf_spinlock_destroy(&adapter->vdev_lock);
 	hdd_sta_info_deinit(&adapter->sta_info_list);
@@ -6767,6 +6799,7 @@ struct hdd_adapter *hdd_open_adapter(struct hdd_context *hdd_ctx, uint8_t sessio
 
 		qdf_mutex_create(&adapter->disconnection_status_lock);
 		hdd_periodic_sta_stats_mutex_create(adapter);
+		hdd_sta_stats_hist_init(adapter);
 
 		break;
 
@@ -6854,6 +6887,7 @@ struct hdd_adapter *hdd_open_adapter(struct hdd_context *hdd_ctx, uint8_t sessio
 		goto err_cleanup_adapter;
 
 	adapter->upgrade_udp_qos_threshold = QCA_WLAN_AC_BK;
+	hdd_wmm_compile_dscp_map(adapter);
 	qdf_spinlock_create(&adapter->vdev_lock);
 	qdf_atomic_init(&hdd_ctx->num_latency_critical_clients);
 
@@ -6915,7 +6949,7 @@ err_cleanup_adapter:
 
 err_free_netdev:
 	if (ndev)
-		free_netdev(ndev);
+		hdd_free_netdev(ndev);
 
 	return NULL;
 }
@@ -9982,6 +10016,330 @@ static inline void hdd_low_tput_gro_flush_skip_handler(
 	}
 }
 
+/**
+ * enum hdd_bus_bw_governor_type - bus bandwidth vote governors
+ * @HDD_BUS_BW_GOVERNOR_THRESHOLD: vote on the last interval packet count
+ * @HDD_BUS_BW_GOVERNOR_PREDICTIVE: vote on the predicted packet count with
+ *				    down hysteresis
+ * @HDD_BUS_BW_GOVERNOR_MAX: max governor
+ */
+enum hdd_bus_bw_governor_type {
+	HDD_BUS_BW_GOVERNOR_THRESHOLD,
+	HDD_BUS_BW_GOVERNOR_PREDICTIVE,
+	HDD_BUS_BW_GOVERNOR_MAX
+};
+
+/**
+ * struct hdd_bus_bw_governor - bus bandwidth vote governor
+ * @name: governor name
+ * @get_vote_level: derive the next vote level from the packets of the last
+ *		    bus bandwidth compute interval, fill the packet count
+ *		    voted for and the reason for the level
+ */
+struct hdd_bus_bw_governor {
+	const char *name;
+	enum pld_bus_width_type
+	(*get_vote_level)(struct hdd_context *hdd_ctx, uint64_t total_pkts,
+			  uint64_t *vote_pkts,
+			  enum hdd_bus_bw_vote_reason *reason);
+};
+
+/* EWMA weight of the latest interval for the predictive governor, 1/4 */
+#define HDD_BUS_BW_EWMA_SHIFT 2
+
+/**
+ * hdd_bus_bw_pkts_to_level() - map packets per interval to a vote level
+ * @hdd_ctx: handle to hdd context
+ * @pkts: packets per bus bandwidth compute interval
+ *
+ * Return: bus bandwidth level for @pkts
+ */
+static enum pld_bus_width_type
+hdd_bus_bw_pkts_to_level(struct hdd_context *hdd_ctx, uint64_t pkts)
+{
+	if (pkts > hdd_ctx->config->bus_bw_very_high_threshold)
+		return PLD_BUS_WIDTH_VERY_HIGH;
+	else if (pkts > hdd_ctx->config->bus_bw_high_threshold)
+		return PLD_BUS_WIDTH_HIGH;
+	else if (pkts > hdd_ctx->config->bus_bw_medium_threshold)
+		return PLD_BUS_WIDTH_MEDIUM;
+	else if (pkts > hdd_ctx->config->bus_bw_low_threshold)
+		return PLD_BUS_WIDTH_LOW;
+
+	return PLD_BUS_WIDTH_IDLE;
+}
+
+static enum pld_bus_width_type
+hdd_bus_bw_threshold_get_vote_level(struct hdd_context *hdd_ctx,
+				    uint64_t total_pkts, uint64_t *vote_pkts,
+				    enum hdd_bus_bw_vote_reason *reason)
+{
+	*vote_pkts = total_pkts;
+	*reason = HDD_BUS_BW_VOTE_THRESHOLD;
+
+	return hdd_bus_bw_pkts_to_level(hdd_ctx, total_pkts);
+}
+
+/**
+ * hdd_bus_bw_predictive_get_vote_level() - predictive vote level
+ * @hdd_ctx: handle to hdd context
+ * @total_pkts: tx + rx packets of the last interval
+ * @vote_pkts: packets per interval the level is derived from
+ * @reason: reason for the returned level
+ *
+ * The interval packets are smoothed with an EWMA and a rising trend is
+ * extrapolated one interval ahead, so that bursts ramp the vote up a step
+ * earlier. A lower level is voted only once it was predicted for more than
+ * gBusBwDownHysteresis consecutive intervals, and a queue depth indication
+ * from the rx threads holds the vote at least at PLD_BUS_WIDTH_HIGH.
+ *
+ * Return: next bus bandwidth level
+ */
+static enum pld_bus_width_type
+hdd_bus_bw_predictive_get_vote_level(struct hdd_context *hdd_ctx,
+				     uint64_t total_pkts, uint64_t *vote_pkts,
+				     enum hdd_bus_bw_vote_reason *reason)
+{
+	enum pld_bus_width_type cur_level = hdd_ctx->cur_vote_level;
+	enum pld_bus_width_type next_level;
+	uint64_t ewma = hdd_ctx->bus_bw_ewma_pkts;
+	uint64_t predicted;
+
+	if (total_pkts >= ewma)
+		ewma += (total_pkts - ewma) >> HDD_BUS_BW_EWMA_SHIFT;
+	else
+		ewma -= (ewma - total_pkts) >> HDD_BUS_BW_EWMA_SHIFT;
+	hdd_ctx->bus_bw_ewma_pkts = ewma;
+
+	predicted = qdf_max(ewma, total_pkts);
+	if (total_pkts > hdd_ctx->bus_bw_prev_pkts)
+		predicted += total_pkts - hdd_ctx->bus_bw_prev_pkts;
+	hdd_ctx->bus_bw_prev_pkts = total_pkts;
+
+	*vote_pkts = predicted;
+	*reason = HDD_BUS_BW_VOTE_PREDICTED;
+	next_level = hdd_bus_bw_pkts_to_level(hdd_ctx, predicted);
+
+	if (qdf_atomic_read(&hdd_ctx->bus_bw_rx_qdepth_ind)) {
+		qdf_atomic_set(&hdd_ctx->bus_bw_rx_qdepth_ind, 0);
+		if (next_level < PLD_BUS_WIDTH_HIGH) {
+			next_level = PLD_BUS_WIDTH_HIGH;
+			*reason = HDD_BUS_BW_VOTE_RX_QDEPTH;
+		}
+	}
+
+	if (next_level >= cur_level || cur_level == PLD_BUS_WIDTH_NONE) {
+		hdd_ctx->bus_bw_down_cnt = 0;
+		return next_level;
+	}
+
+	if (++hdd_ctx->bus_bw_down_cnt <=
+	    hdd_ctx->config->bus_bw_down_hysteresis) {
+		*vote_pkts = total_pkts;
+		*reason = HDD_BUS_BW_VOTE_HYSTERESIS;
+		return cur_level;
+	}
+
+	hdd_ctx->bus_bw_down_cnt = 0;
+
+	return next_level;
+}
+
+static const struct hdd_bus_bw_governor
+hdd_bus_bw_governors[HDD_BUS_BW_GOVERNOR_MAX] = {
+	[HDD_BUS_BW_GOVERNOR_THRESHOLD] = {
+		.name = "threshold",
+		.get_vote_level = hdd_bus_bw_threshold_get_vote_level,
+	},
+	[HDD_BUS_BW_GOVERNOR_PREDICTIVE] = {
+		.name = "predictive",
+		.get_vote_level = hdd_bus_bw_predictive_get_vote_level,
+	},
+};
+
+/**
+ * hdd_bus_bw_get_governor() - get the configured bus bandwidth governor
+ * @hdd_ctx: handle to hdd context
+ *
+ * Return: bus bandwidth governor
+ */
+static const struct hdd_bus_bw_governor *
+hdd_bus_bw_get_governor(struct hdd_context *hdd_ctx)
+{
+	uint8_t governor = hdd_ctx->config->bus_bw_governor;
+
+	if (governor >= HDD_BUS_BW_GOVERNOR_MAX)
+		governor = HDD_BUS_BW_GOVERNOR_THRESHOLD;
+
+	return &hdd_bus_bw_governors[governor];
+}
+
+/**
+ * hdd_bus_bw_vote() - vote a bus bandwidth level
+ * @hdd_ctx: handle to hdd context
+ * @next_vote_level: bus bandwidth level to vote
+ * @boost: vote of a rx queue depth indication
+ *
+ * Common vote path of the bus bandwidth compute work and of the rx queue
+ * depth boost. Votes @next_vote_level, along with the PM QoS and RPS
+ * settings of that level, if it differs from the current vote or the
+ * current vote is a boost. A boost only raises the vote. The vote and its
+ * bookkeeping are made under bus_bw_vote_lock, so that the current vote
+ * level always matches the last vote.
+ *
+ * Return: true if @next_vote_level was voted
+ */
+static bool hdd_bus_bw_vote(struct hdd_context *hdd_ctx,
+			    enum pld_bus_width_type next_vote_level,
+			    bool boost)
+{
+	int cur_vote_level;
+	bool vote;
+
+	qdf_mutex_acquire(&hdd_ctx->bus_bw_vote_lock);
+
+	cur_vote_level = hdd_ctx->cur_vote_level;
+	if (boost)
+		vote = cur_vote_level < (int)next_vote_level;
+	else
+		vote = cur_vote_level != next_vote_level ||
+		       hdd_ctx->bus_bw_boosted;
+	if (!vote)
+		goto unlock;
+
+	/*
+	 * 11g/a clients are latency sensitive, and any delay in DDR
+	 * access for fetching the packet can cause throughput drop.
+	 * For 11g/a clients LOW voting level is not sufficient for
+	 * peak throughput. Vote for higher DDR frequency if latency
+	 * critical connections are present.
+	 */
+	if (hdd_ctx->config->enable_latency_crit_clients &&
+	    (next_vote_level == PLD_BUS_WIDTH_LOW ||
+	     next_vote_level == PLD_BUS_WIDTH_IDLE) &&
+	    qdf_atomic_read(&hdd_ctx->num_latency_critical_clients))
+		pld_request_bus_bandwidth(hdd_ctx->parent_dev,
+					  PLD_BUS_WIDTH_LOW_LATENCY);
+	else
+		pld_request_bus_bandwidth(hdd_ctx->parent_dev,
+					  next_vote_level);
+
+	if ((next_vote_level == PLD_BUS_WIDTH_LOW) ||
+	    (next_vote_level == PLD_BUS_WIDTH_IDLE)) {
+		if (hdd_ctx->hbw_requested &&
+		    !hdd_ctx->pm_qos_request) {
+			PLD_REMOVE_PM_QOS(hdd_ctx->parent_dev);
+			hdd_ctx->hbw_requested = false;
+		}
+		if (hdd_ctx->dynamic_rps)
+			hdd_clear_rps_cpu_mask(hdd_ctx);
+	} else {
+		if (!hdd_ctx->hbw_requested) {
+			PLD_REQUEST_PM_QOS(hdd_ctx->parent_dev, 1);
+			hdd_ctx->hbw_requested = true;
+		}
+		if (hdd_ctx->dynamic_rps)
+			hdd_set_rps_cpu_mask(hdd_ctx);
+	}
+
+	/* read locklessly by the rx queue depth indication */
+	WRITE_ONCE(hdd_ctx->cur_vote_level, next_vote_level);
+	hdd_ctx->bus_bw_boosted = boost;
+	if (boost)
+		hdd_ctx->bus_bw_boost_cnt++;
+
+unlock:
+	qdf_mutex_release(&hdd_ctx->bus_bw_vote_lock);
+
+	return vote;
+}
+
+/**
+ * hdd_bus_bw_boost_work_handler() - vote high bus bandwidth right away
+ * @context: handle to hdd context
+ *
+ * Scheduled on a queue depth indication from the rx threads. The bus
+ * bandwidth compute work picks the indication up at its next interval and
+ * keeps the vote at least at this level. A boost vote is marked as such,
+ * so that the compute work votes its own level again, along with the
+ * settings of that level which only it applies, instead of leaving the
+ * boosted vote in place.
+ *
+ * Return: None
+ */
+static void hdd_bus_bw_boost_work_handler(void *context)
+{
+	struct hdd_context *hdd_ctx = context;
+
+	if (wlan_hdd_validate_context(hdd_ctx))
+		return;
+
+	if (!qdf_atomic_read(&hdd_ctx->bus_bw_rx_qdepth_ind))
+		return;
+
+	if (hdd_bus_bw_vote(hdd_ctx, PLD_BUS_WIDTH_HIGH, true))
+		hdd_debug("rx queue depth, ramped up BW vote");
+}
+
+/**
+ * hdd_bus_bw_rx_qdepth_ind() - rx thread queue depth indication
+ * @ctx: handle to hdd context
+ * @qlen: rx thread queue length
+ *
+ * Invoked from the rx enqueue context, must not sleep.
+ *
+ * Return: None
+ */
+static void hdd_bus_bw_rx_qdepth_ind(void *ctx, uint32_t qlen)
+{
+	struct hdd_context *hdd_ctx = ctx;
+
+	if (qdf_atomic_read(&hdd_ctx->bus_bw_rx_qdepth_ind))
+		return;
+
+	qdf_atomic_set(&hdd_ctx->bus_bw_rx_qdepth_ind, 1);
+	if (READ_ONCE(hdd_ctx->cur_vote_level) < PLD_BUS_WIDTH_HIGH)
+		qdf_sched_work(0, &hdd_ctx->bus_bw_boost_work);
+}
+
+/**
+ * hdd_bus_bw_governor_start() - start the bus bandwidth governor
+ * @hdd_ctx: handle to hdd context
+ *
+ * Return: None
+ */
+static void hdd_bus_bw_governor_start(struct hdd_context *hdd_ctx)
+{
+	hdd_ctx->bus_bw_ewma_pkts = 0;
+	hdd_ctx->bus_bw_prev_pkts = 0;
+	hdd_ctx->bus_bw_down_cnt = 0;
+	hdd_ctx->bus_bw_boosted = false;
+	qdf_atomic_set(&hdd_ctx->bus_bw_rx_qdepth_ind, 0);
+
+	if (hdd_ctx->config->bus_bw_governor != HDD_BUS_BW_GOVERNOR_PREDICTIVE)
+		return;
+
+	dp_rx_register_qdepth_ind_cb(cds_get_context(QDF_MODULE_ID_SOC),
+				     hdd_ctx->config->bus_bw_rx_qdepth_thresh,
+				     hdd_bus_bw_rx_qdepth_ind, hdd_ctx);
+}
+
+/**
+ * hdd_bus_bw_governor_stop() - stop the bus bandwidth governor
+ * @hdd_ctx: handle to hdd context
+ *
+ * Return: None
+ */
+static void hdd_bus_bw_governor_stop(struct hdd_context *hdd_ctx)
+{
+	if (hdd_ctx->config->bus_bw_governor != HDD_BUS_BW_GOVERNOR_PREDICTIVE)
+		return;
+
+	dp_rx_register_qdepth_ind_cb(cds_get_context(QDF_MODULE_ID_SOC), 0,
+				     NULL, NULL);
+	qdf_flush_work(&hdd_ctx->bus_bw_boost_work);
+}
+
 /**
  * hdd_pld_request_bus_bandwidth() - Function to control bus bandwidth
  * @hdd_ctx - handle to hdd context
@@ -10018,21 +10376,19 @@ static void hdd_pld_request_bus_bandwidth(struct hdd_context *hdd_ctx,
 	bool is_rx_pm_qos_high = false;
 	bool is_tx_pm_qos_high = false;
 	bool legacy_client = false;
+	const struct hdd_bus_bw_governor *governor;
+	enum hdd_bus_bw_vote_reason vote_reason;
+	uint64_t vote_pkts;
 
 	cpumask_clear(&pm_qos_cpu_mask);
 
-	if (hdd_ctx->high_bus_bw_request)
-		next_vote_level = PLD_BUS_WIDTH_VERY_HIGH;
-	else if (total_pkts > hdd_ctx->config->bus_bw_very_high_threshold)
+	governor = hdd_bus_bw_get_governor(hdd_ctx);
+	next_vote_level = governor->get_vote_level(hdd_ctx, total_pkts,
+						   &vote_pkts, &vote_reason);
+	if (hdd_ctx->high_bus_bw_request) {
 		next_vote_level = PLD_BUS_WIDTH_VERY_HIGH;
-	else if (total_pkts > hdd_ctx->config->bus_bw_high_threshold)
-		next_vote_level = PLD_BUS_WIDTH_HIGH;
-	else if (total_pkts > hdd_ctx->config->bus_bw_medium_threshold)
-		next_vote_level = PLD_BUS_WIDTH_MEDIUM;
-	else if (total_pkts > hdd_ctx->config->bus_bw_low_threshold)
-		next_vote_level = PLD_BUS_WIDTH_LOW;
-	else
-		next_vote_level = PLD_BUS_WIDTH_IDLE;
+		vote_reason = HDD_BUS_BW_VOTE_HIGH_BW_REQ;
+	}
 
 	dptrace_high_tput_req =
 			next_vote_level > PLD_BUS_WIDTH_IDLE ? true : false;
@@ -10043,47 +10399,11 @@ static void hdd_pld_request_bus_bandwidth(struct hdd_context *hdd_ctx,
 	hdd_low_tput_gro_flush_skip_handler(hdd_ctx, next_vote_level,
 					    legacy_client);
 
-	if (hdd_ctx->cur_vote_level != next_vote_level) {
-		hdd_debug("BW Vote level %d, tx_packets: %lld, rx_packets: %lld",
-			  next_vote_level, tx_packets, rx_packets);
-
-		hdd_ctx->cur_vote_level = next_vote_level;
-		vote_level_change = true;
-
-		/*
-		 * 11g/a clients are latency sensitive, and any delay in DDR
-		 * access for fetching the packet can cause throughput drop.
-		 * For 11g/a clients LOW voting level is not sufficient for
-		 * peak throughput. Vote for higher DDR frequency if latency
-		 * critical connections are present.
-		 */
-		if (hdd_ctx->config->enable_latency_crit_clients &&
-		    (next_vote_level == PLD_BUS_WIDTH_LOW ||
-		     next_vote_level == PLD_BUS_WIDTH_IDLE) &&
-		    qdf_atomic_read(&hdd_ctx->num_latency_critical_clients))
-			pld_request_bus_bandwidth(hdd_ctx->parent_dev,
-						  PLD_BUS_WIDTH_LOW_LATENCY);
-		else
-			pld_request_bus_bandwidth(hdd_ctx->parent_dev,
-						  next_vote_level);
-
-		if ((next_vote_level == PLD_BUS_WIDTH_LOW) ||
-		    (next_vote_level == PLD_BUS_WIDTH_IDLE)) {
-			if (hdd_ctx->hbw_requested &&
-			    !hdd_ctx->pm_qos_request) {
-				PLD_REMOVE_PM_QOS(hdd_ctx->parent_dev);
-				hdd_ctx->hbw_requested = false;
-			}
-			if (hdd_ctx->dynamic_rps)
-				hdd_clear_rps_cpu_mask(hdd_ctx);
-		} else {
-			if (!hdd_ctx->hbw_requested) {
-				PLD_REQUEST_PM_QOS(hdd_ctx->parent_dev, 1);
-				hdd_ctx->hbw_requested = true;
-			}
-			if (hdd_ctx->dynamic_rps)
-				hdd_set_rps_cpu_mask(hdd_ctx);
-		}
+	vote_level_change = hdd_bus_bw_vote(hdd_ctx, next_vote_level, false);
+	if (vote_level_change) {
+		hdd_debug("BW Vote level %d, tx_packets: %lld, rx_packets: %lld, %s vote_pkts %llu reason %d",
+			  next_vote_level, tx_packets, rx_packets,
+			  governor->name, vote_pkts, vote_reason);
 
 		if (hdd_ctx->config->rx_thread_ul_affinity_mask) {
 			if (next_vote_level == PLD_BUS_WIDTH_HIGH &&
@@ -10247,6 +10567,8 @@ static void hdd_pld_request_bus_bandwidth(struct hdd_context *hdd_ctx,
 		hdd_ctx->hdd_txrx_hist[index].interval_rx = rx_packets;
 		hdd_ctx->hdd_txrx_hist[index].interval_tx = tx_packets;
 		hdd_ctx->hdd_txrx_hist[index].qtime = qdf_get_log_timestamp();
+		hdd_ctx->hdd_txrx_hist[index].predicted_pkts = vote_pkts;
+		hdd_ctx->hdd_txrx_hist[index].vote_reason = vote_reason;
 		hdd_ctx->hdd_txrx_hist_idx++;
 		hdd_ctx->hdd_txrx_hist_idx &= NUM_TX_RX_HISTOGRAM_MASK;
 
@@ -10395,6 +10717,8 @@ static void __hdd_bus_bw_work_handler(struct hdd_context *hdd_ctx)
 	bool connected = false;
 	uint32_t ipa_tx_packets = 0, ipa_rx_packets = 0;
 	uint64_t sta_tx_bytes = 0, sap_tx_bytes = 0;
+	struct hdd_pkt_stats pkt_stats;
+	unsigned long cur_tx_packets, cur_rx_packets, cur_tx_bytes;
 	wlan_net_dev_ref_dbgid dbgid = NET_DEV_HOLD_BUS_BW_WORK_HANDLER;
 
 	if (wlan_hdd_validate_context(hdd_ctx))
@@ -10429,13 +10753,20 @@ static void __hdd_bus_bw_work_handler(struct hdd_context *hdd_ctx)
 			continue;
 		}
 
-		tx_packets += HDD_BW_GET_DIFF(adapter->stats.tx_packets,
+		hdd_get_pkt_stats(adapter, &pkt_stats);
+		cur_tx_packets = pkt_stats.tx_packets;
+		cur_rx_packets = pkt_stats.rx_packets;
+		cur_tx_bytes = pkt_stats.tx_bytes;
+
+		tx_packets += HDD_BW_GET_DIFF(cur_tx_packets,
 					      adapter->prev_tx_packets);
-		rx_packets += HDD_BW_GET_DIFF(adapter->stats.rx_packets,
+		rx_packets += HDD_BW_GET_DIFF(cur_rx_packets,
 					      adapter->prev_rx_packets);
-		tx_bytes = HDD_BW_GET_DIFF(adapter->stats.tx_bytes,
+		tx_bytes = HDD_BW_GET_DIFF(cur_tx_bytes,
 					   adapter->prev_tx_bytes);
 
+		hdd_tx_orphan_policy_update(adapter);
+
 		if (adapter->device_mode == QDF_STA_MODE &&
 		   hdd_conn_is_connected(WLAN_HDD_GET_STATION_CTX_PTR(adapter)))
 			hdd_send_mscs_action_frame(hdd_ctx, adapter);
@@ -10460,11 +10791,11 @@ static void __hdd_bus_bw_work_handler(struct hdd_context *hdd_ctx)
 
 		if (adapter->device_mode == QDF_SAP_MODE) {
 			con_sap_adapter = adapter;
-			sap_tx_bytes = adapter->stats.tx_bytes;
+			sap_tx_bytes = pkt_stats.tx_bytes;
 		}
 
 		if (adapter->device_mode == QDF_STA_MODE)
-			sta_tx_bytes = adapter->stats.tx_bytes;
+			sta_tx_bytes = pkt_stats.tx_bytes;
 
 		hdd_set_driver_del_ack_enable(adapter->vdev_id, hdd_ctx,
 					      rx_packets);
@@ -10472,15 +10803,15 @@ static void __hdd_bus_bw_work_handler(struct hdd_context *hdd_ctx)
 		hdd_set_vdev_bundle_require_flag(adapter->vdev_id, hdd_ctx,
 						 tx_bytes);
 
-		total_rx += adapter->stats.rx_packets;
-		total_tx += adapter->stats.tx_packets;
+		total_rx += cur_rx_packets;
+		total_tx += cur_tx_packets;
 
 		qdf_spin_lock_bh(&hdd_ctx->bus_bw_lock);
-		adapter->prev_tx_packets = adapter->stats.tx_packets;
-		adapter->prev_rx_packets = adapter->stats.rx_packets;
+		adapter->prev_tx_packets = cur_tx_packets;
+		adapter->prev_rx_packets = cur_rx_packets;
 		adapter->prev_fwd_tx_packets = fwd_tx_packets;
 		adapter->prev_fwd_rx_packets = fwd_rx_packets;
-		adapter->prev_tx_bytes = adapter->stats.tx_bytes;
+		adapter->prev_tx_bytes = cur_tx_bytes;
 		qdf_spin_unlock_bh(&hdd_ctx->bus_bw_lock);
 		connected = true;
 		hdd_adapter_dev_put_debug(adapter, dbgid);
@@ -10501,12 +10832,14 @@ static void __hdd_bus_bw_work_handler(struct hdd_context *hdd_ctx)
 	hdd_ipa_set_perf_level(hdd_ctx, &tx_packets, &rx_packets,
 			       &ipa_tx_packets, &ipa_rx_packets);
 	if (con_sap_adapter) {
-		con_sap_adapter->stats.tx_packets += ipa_tx_packets;
-		con_sap_adapter->stats.rx_packets += ipa_rx_packets;
+		hdd_pkt_stats_tx_add(con_sap_adapter, ipa_tx_packets, 0);
+		hdd_pkt_stats_rx_add(con_sap_adapter, ipa_rx_packets, 0);
 	}
 
 	hdd_pld_request_bus_bandwidth(hdd_ctx, tx_packets, rx_packets);
 
+	hdd_dp_stall_detect(hdd_ctx, tx_packets, rx_packets);
+
 	return;
 
 stop_work:
@@ -10533,9 +10866,13 @@ int hdd_bus_bandwidth_init(struct hdd_context *hdd_ctx)
 	hdd_enter();
 
 	qdf_spinlock_create(&hdd_ctx->bus_bw_lock);
+	qdf_mutex_create(&hdd_ctx->bus_bw_vote_lock);
 
 	hdd_pm_qos_add_request(hdd_ctx);
 
+	qdf_create_work(0, &hdd_ctx->bus_bw_boost_work,
+			hdd_bus_bw_boost_work_handler, hdd_ctx);
+
 	status = qdf_periodic_work_create(&hdd_ctx->bus_bw_work,
 					  hdd_bus_bw_work_handler,
 					  hdd_ctx);
@@ -10555,6 +10892,8 @@ void hdd_bus_bandwidth_deinit(struct hdd_context *hdd_ctx)
 	QDF_BUG(!qdf_periodic_work_stop_sync(&hdd_ctx->bus_bw_work));
 
 	qdf_periodic_work_destroy(&hdd_ctx->bus_bw_work);
+	qdf_destroy_work(0, &hdd_ctx->bus_bw_boost_work);
+	qdf_mutex_destroy(&hdd_ctx->bus_bw_vote_lock);
 	qdf_spinlock_destroy(&hdd_ctx->bus_bw_lock);
 	hdd_pm_qos_remove_request(hdd_ctx);
 
@@ -10688,6 +11027,31 @@ void hdd_adapter_feature_update_work_deinit(struct hdd_adapter *adapter)
 	hdd_exit();
 }
 
+/**
+ * hdd_bus_bw_vote_reason_to_string() - convert a bus bandwidth vote reason
+ *					to a string
+ * @reason: enum hdd_bus_bw_vote_reason
+ *
+ * Return: reason name
+ */
+static const char *hdd_bus_bw_vote_reason_to_string(uint8_t reason)
+{
+	switch (reason) {
+	case HDD_BUS_BW_VOTE_THRESHOLD:
+		return "THRESHOLD";
+	case HDD_BUS_BW_VOTE_HIGH_BW_REQ:
+		return "HIGH_BW_REQ";
+	case HDD_BUS_BW_VOTE_PREDICTED:
+		return "PREDICTED";
+	case HDD_BUS_BW_VOTE_HYSTERESIS:
+		return "HYSTERESIS";
+	case HDD_BUS_BW_VOTE_RX_QDEPTH:
+		return "RX_QDEPTH";
+	default:
+		return "INVAL";
+	}
+}
+
 static uint8_t *convert_level_to_string(uint32_t level)
 {
 	switch (level) {
@@ -10759,6 +11123,7 @@ int hdd_wlan_dump_stats(struct hdd_adapter *adapter, int stats_id)
 	case CDP_DP_RX_THREAD_STATS:
 		dp_txrx_ext_dump_stats(cds_get_context(QDF_MODULE_ID_SOC),
 				       CDP_DP_RX_THREAD_STATS);
+		cds_ol_rx_thread_dump_stats();
 		break;
 	case CDP_DISCONNECT_STATS:
 		sme_display_disconnect_stats(hdd_ctx->mac_handle,
@@ -10786,6 +11151,7 @@ int hdd_wlan_clear_stats(struct hdd_adapter *adapter, int stats_id)
 	switch (stats_id) {
 	case CDP_HDD_STATS:
 		memset(&adapter->stats, 0, sizeof(adapter->stats));
+		hdd_reset_pkt_stats(adapter);
 		memset(&adapter->hdd_stats, 0, sizeof(adapter->hdd_stats));
 		break;
 	case CDP_TXRX_HIST_STATS:
@@ -10832,17 +11198,22 @@ void wlan_hdd_display_tx_rx_histogram(struct hdd_context *hdd_ctx)
 		       hdd_ctx->config->tcp_delack_thres_low);
 	hdd_nofl_debug("TCP TX HIGH TP TH: %d (Use to set tcp_output_bytes_limit)",
 		       hdd_ctx->config->tcp_tx_high_tput_thres);
+	hdd_nofl_debug("BW governor: %s down hysteresis: %u rx qdepth TH: %u rx qdepth boosts: %u",
+		       hdd_bus_bw_get_governor(hdd_ctx)->name,
+		       hdd_ctx->config->bus_bw_down_hysteresis,
+		       hdd_ctx->config->bus_bw_rx_qdepth_thresh,
+		       hdd_ctx->bus_bw_boost_cnt);
 #endif /*WLAN_FEATURE_DP_BUS_BANDWIDTH*/
 
 	hdd_nofl_debug("Total entries: %d Current index: %d",
 		       NUM_TX_RX_HISTOGRAM, hdd_ctx->hdd_txrx_hist_idx);
 
-	hdd_nofl_debug("[index][timestamp]: interval_rx, interval_tx, bus_bw_level, RX TP Level, TX TP Level, Rx:Tx pm_qos");
+	hdd_nofl_debug("[index][timestamp]: interval_rx, interval_tx, bus_bw_level, RX TP Level, TX TP Level, Rx:Tx pm_qos, vote_pkts, vote_reason");
 
 	for (i = 0; i < NUM_TX_RX_HISTOGRAM; i++) {
 		/* using hdd_log to avoid printing function name */
 		if (hdd_ctx->hdd_txrx_hist[i].qtime > 0)
-			hdd_nofl_debug("[%3d][%15llu]: %6llu, %6llu, %s, %s, %s, %s:%s",
+			hdd_nofl_debug("[%3d][%15llu]: %6llu, %6llu, %s, %s, %s, %s:%s, %6llu, %s",
 				       i, hdd_ctx->hdd_txrx_hist[i].qtime,
 				       hdd_ctx->hdd_txrx_hist[i].interval_rx,
 				       hdd_ctx->hdd_txrx_hist[i].interval_tx,
@@ -10858,8 +11229,44 @@ void wlan_hdd_display_tx_rx_histogram(struct hdd_context *hdd_ctx)
 				hdd_ctx->hdd_txrx_hist[i].is_rx_pm_qos_high ?
 				"HIGH" : "LOW",
 				hdd_ctx->hdd_txrx_hist[i].is_tx_pm_qos_high ?
-				"HIGH" : "LOW");
+				"HIGH" : "LOW",
+				hdd_ctx->hdd_txrx_hist[i].predicted_pkts,
+				hdd_bus_bw_vote_reason_to_string(
+					hdd_ctx->hdd_txrx_hist[i].vote_reason));
+	}
+}
+
+int hdd_bus_bw_vote_history_print(struct hdd_context *hdd_ctx, char *buf,
+				  int buf_len)
+{
+	struct hdd_tx_rx_histogram *hist;
+	int len = 0;
+	int i, index;
+
+	if (!hdd_ctx->hdd_txrx_hist)
+		return 0;
+
+	len += scnprintf(buf + len, buf_len - len,
+			 "timestamp interval_rx interval_tx vote_pkts bus_bw_level vote_reason\n");
+
+	/* oldest record first */
+	for (i = 0; i < NUM_TX_RX_HISTOGRAM && len < buf_len; i++) {
+		index = (hdd_ctx->hdd_txrx_hist_idx + i) &
+			NUM_TX_RX_HISTOGRAM_MASK;
+		hist = &hdd_ctx->hdd_txrx_hist[index];
+		if (!hist->qtime)
+			continue;
+
+		len += scnprintf(buf + len, buf_len - len,
+				 "%llu %llu %llu %llu %s %s\n",
+				 hist->qtime, hist->interval_rx,
+				 hist->interval_tx, hist->predicted_pkts,
+				 convert_level_to_string(hist->next_vote_level),
+				 hdd_bus_bw_vote_reason_to_string(
+							hist->vote_reason));
 	}
+
+	return len;
 }
 
 /**
@@ -12465,8 +12872,10 @@ static void hdd_cfg_params_init(struct hdd_context *hdd_ctx)
 	config->is_wow_disabled = cfg_get(psoc, CFG_WOW_DISABLE);
 	config->nb_commands_interval =
 				cfg_get(psoc, CFG_NB_COMMANDS_RATE_LIMIT);
+	config->sta_stats_cache_ttl = cfg_get(psoc, CFG_STA_STATS_CACHE_TTL);
 
 	hdd_periodic_sta_stats_config(config, psoc);
+	hdd_sta_stats_hist_config(config, psoc);
 	hdd_init_vc_mode_cfg_bitmap(config, psoc);
 	hdd_init_runtime_pm(config, psoc);
 	hdd_init_wlan_auto_shutdown(config, psoc);
@@ -12831,6 +13240,14 @@ static int hdd_update_cds_config(struct hdd_context *hdd_ctx)
 	cds_cfg->uc_offload_enabled = ucfg_ipa_uc_is_enabled();
 
 	cds_cfg->enable_rxthread = hdd_ctx->enable_rxthread;
+	cds_cfg->dp_rx_thread_budget = hdd_ctx->config->rx_thread_budget;
+	cds_cfg->dp_rx_gro_flush_pkt_budget =
+		hdd_ctx->config->rx_gro_flush_pkt_budget;
+	cds_cfg->dp_rx_gro_flush_time_budget_us =
+		hdd_ctx->config->rx_gro_flush_time_budget_us;
+	cds_cfg->dp_rx_gro_low_latency = hdd_ctx->config->rx_gro_low_latency;
+	cds_cfg->dp_rx_refill_predictive =
+		hdd_ctx->config->rx_refill_predictive;
 	ucfg_mlme_get_sap_max_peers(hdd_ctx->psoc, &value);
 	cds_cfg->max_station = value;
 	cds_cfg->sub_20_channel_width = WLAN_SUB_20_CH_WIDTH_NONE;
@@ -14638,6 +15055,13 @@ static void wlan_init_bug_report_lock(void)
 }
 
 #ifdef CONFIG_DP_TRACE
+void hdd_dp_trace_set_pkt_trace_user(struct hdd_config *config,
+				     uint32_t proto_bitmap)
+{
+	cds_pkt_trace_user_set(CDS_PKT_TRACE_USER_DP_TRACE,
+			       proto_bitmap || config->dp_proto_event_bitmap);
+}
+
 void hdd_dp_trace_init(struct hdd_config *config)
 {
 	bool live_mode = DP_TRACE_CONFIG_DEFAULT_LIVE_MODE;
@@ -14653,6 +15077,7 @@ void hdd_dp_trace_init(struct hdd_config *config)
 
 	if (!config->enable_dp_trace) {
 		hdd_err("dp trace is disabled from ini");
+		hdd_dp_trace_set_pkt_trace_user(config, 0);
 		return;
 	}
 
@@ -14690,7 +15115,7 @@ void hdd_dp_trace_init(struct hdd_config *config)
 
 	qdf_dp_trace_init(live_mode, thresh, thresh_time_limit,
 			verbosity, proto_bitmap);
-
+	hdd_dp_trace_set_pkt_trace_user(config, proto_bitmap);
 }
 #endif
 
@@ -15854,8 +16279,9 @@ bool hdd_is_any_adapter_connected(struct hdd_context *hdd_ctx)
 #ifdef WLAN_FEATURE_DP_BUS_BANDWIDTH
 static void __hdd_bus_bw_compute_timer_start(struct hdd_context *hdd_ctx)
 {
-	qdf_periodic_work_start(&hdd_ctx->bus_bw_work,
-				hdd_ctx->config->bus_bw_compute_interval);
+	if (qdf_periodic_work_start(&hdd_ctx->bus_bw_work,
+				    hdd_ctx->config->bus_bw_compute_interval))
+		hdd_bus_bw_governor_start(hdd_ctx);
 }
 
 void hdd_bus_bw_compute_timer_start(struct hdd_context *hdd_ctx)
@@ -15882,6 +16308,7 @@ static void __hdd_bus_bw_compute_timer_stop(struct hdd_context *hdd_ctx)
 	if (!qdf_periodic_work_stop_sync(&hdd_ctx->bus_bw_work))
 		goto exit;
 
+	hdd_bus_bw_governor_stop(hdd_ctx);
 	ucfg_ipa_set_perf_level(hdd_ctx->pdev, 0, 0);
 	hdd_reset_tcp_delack(hdd_ctx);
 	hdd_reset_tcp_adv_win_scale(hdd_ctx);
@@ -15926,11 +16353,14 @@ void hdd_bus_bw_compute_timer_try_stop(struct hdd_context *hdd_ctx)
 void hdd_bus_bw_compute_prev_txrx_stats(struct hdd_adapter *adapter)
 {
 	struct hdd_context *hdd_ctx = WLAN_HDD_GET_CTX(adapter);
+	struct hdd_pkt_stats pkt_stats;
+
+	hdd_get_pkt_stats(adapter, &pkt_stats);
 
 	qdf_spin_lock_bh(&hdd_ctx->bus_bw_lock);
-	adapter->prev_tx_packets = adapter->stats.tx_packets;
-	adapter->prev_rx_packets = adapter->stats.rx_packets;
-	adapter->prev_tx_bytes = adapter->stats.tx_bytes;
+	adapter->prev_tx_packets = pkt_stats.tx_packets;
+	adapter->prev_rx_packets = pkt_stats.rx_packets;
+	adapter->prev_tx_bytes = pkt_stats.tx_bytes;
 	cdp_get_intra_bss_fwd_pkts_count(cds_get_context(QDF_MODULE_ID_SOC),
 					 adapter->vdev_id,
 					 &adapter->prev_fwd_tx_packets,
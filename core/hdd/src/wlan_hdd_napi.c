@@ -25,6 +25,7 @@
 
 #include "wlan_hdd_napi.h"
 #include "cds_api.h"       /* cds_get_context */
+#include "cds_cpu_acct.h"  /* cds_cpu_acct_start/end */
 #include "hif.h"           /* hif_map_service...*/
 #include "wlan_hdd_main.h" /* hdd_err/warn... */
 #include "qdf_types.h"     /* QDF_MODULE_ID_... */
@@ -32,6 +33,8 @@
 
 /*  guaranteed to be initialized to zero/NULL by the standard */
 static struct qca_napi_data *hdd_napi_ctx;
+/* CPU usage of the NAPI instances, indexed by CE id */
+static struct cds_cpu_acct hdd_napi_cpu_acct[CE_COUNT_MAX];
 
 /**
  * hdd_napi_get_all() - return the whole NAPI structure from HIF
@@ -451,12 +454,27 @@ int hdd_napi_serialize(int is_on)
  * NOTE FOR THE MAINTAINER:
  *   Make sure this is very close to the ce_tasklet code.
  *
+ * The CPU time spent in the poll is accounted to the NAPI instance.
+ *
  * Return:
  *   int: the amount of work done ( <= budget )
  */
 int hdd_napi_poll(struct napi_struct *napi, int budget)
 {
-	return hif_napi_poll(cds_get_context(QDF_MODULE_ID_HIF), napi, budget);
+	struct qca_napi_info *napii;
+	uint64_t start_ns;
+	int work_done;
+
+	start_ns = cds_cpu_acct_start();
+	work_done = hif_napi_poll(cds_get_context(QDF_MODULE_ID_HIF), napi,
+				  budget);
+
+	napii = container_of(napi, struct qca_napi_info, napi);
+	if (napii->id < CE_COUNT_MAX)
+		cds_cpu_acct_end(&hdd_napi_cpu_acct[napii->id], start_ns,
+				 work_done, work_done >= budget);
+
+	return work_done;
 }
 
 /**
@@ -478,6 +496,7 @@ int hdd_display_napi_stats(void)
 	 * the end of the "buf" arrary for end of string char.
 	 */
 	char buf[6 * QCA_NAPI_NUM_BUCKETS + 1] = {'\0'};
+	char acct_buf[192];
 
 	napid = hdd_napi_get_all();
 	if (!napid) {
@@ -522,6 +541,19 @@ int hdd_display_napi_stats(void)
 			}
 		}
 
+	for (i = 0; i < CE_COUNT_MAX; i++) {
+		if (!(napid->ce_map & (0x01 << i)))
+			continue;
+
+		for (j = 0; j < CDS_CPU_ACCT_MAX_CPUS; j++) {
+			if (!cds_cpu_acct_scnprintf(&hdd_napi_cpu_acct[i], j,
+						    acct_buf,
+						    sizeof(acct_buf)))
+				continue;
+			hdd_nofl_info("NAPI[%2d]CPU[%d]: %s", i, j, acct_buf);
+		}
+	}
+
 	hif_napi_stats(napid);
 	return 0;
 }
@@ -554,5 +586,7 @@ int hdd_clear_napi_stats(void)
 			}
 		}
 
+	qdf_mem_zero(hdd_napi_cpu_acct, sizeof(hdd_napi_cpu_acct));
+
 	return 0;
 }
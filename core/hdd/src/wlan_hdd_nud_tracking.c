@@ -22,6 +22,7 @@
 
 #include "osif_sync.h"
 #include "wlan_hdd_main.h"
+#include "wlan_hdd_tx_rx.h"
 #include "wlan_blm_ucfg_api.h"
 #include "hdd_dp_cfg.h"
 #include <cdp_txrx_misc.h>
@@ -157,21 +158,25 @@ static void hdd_nud_stats_info(struct hdd_adapter *adapter)
 static void hdd_nud_capture_stats(struct hdd_adapter *adapter,
 				  uint8_t nud_state)
 {
+	struct hdd_pkt_stats pkt_stats;
+
+	hdd_get_pkt_stats(adapter, &pkt_stats);
+
 	switch (nud_state) {
 	case NUD_INCOMPLETE:
 	case NUD_PROBE:
 		adapter->nud_tracking.tx_rx_stats.pre_tx_packets =
-				adapter->stats.tx_packets;
+				pkt_stats.tx_packets;
 		adapter->nud_tracking.tx_rx_stats.pre_rx_packets =
-				adapter->stats.rx_packets;
+				pkt_stats.rx_packets;
 		adapter->nud_tracking.tx_rx_stats.pre_tx_acked =
 				hdd_txrx_get_tx_ack_count(adapter);
 		break;
 	case NUD_FAILED:
 		adapter->nud_tracking.tx_rx_stats.post_tx_packets =
-				adapter->stats.tx_packets;
+				pkt_stats.tx_packets;
 		adapter->nud_tracking.tx_rx_stats.post_rx_packets =
-				adapter->stats.rx_packets;
+				pkt_stats.rx_packets;
 		adapter->nud_tracking.tx_rx_stats.post_tx_acked =
 				hdd_txrx_get_tx_ack_count(adapter);
 		break;
@@ -1135,10 +1135,12 @@ __hdd_indicate_mgmt_frame_to_user(struct hdd_adapter *adapter,
 	/* Channel indicated may be wrong. TODO */
 	/* Indicate an action frame. */
 
-	if (hdd_is_qos_action_frame(pb_frames, frm_len))
+	if (hdd_is_qos_action_frame(pb_frames, frm_len)) {
 		sme_update_dsc_pto_up_mapping(hdd_ctx->mac_handle,
 					      adapter->dscp_to_up_map,
 					      adapter->vdev_id);
+		hdd_wmm_compile_dscp_map(adapter);
+	}
 
 	/* Indicate Frame Over Normal Interface */
 	hdd_debug("Indicate Frame over NL80211 sessionid : %d, idx :%d",
@@ -36,6 +36,7 @@ void hdd_rx_monitor_callback(ol_osif_vdev_handle context,
 	struct sk_buff *skb;
 	struct sk_buff *skb_next;
 	unsigned int cpu_index;
+	uint32_t rx_packets = 0, rx_bytes = 0;
 
 	qdf_assert(context);
 	qdf_assert(rxbuf);
@@ -56,8 +57,8 @@ void hdd_rx_monitor_callback(ol_osif_vdev_handle context,
 		skb->dev = adapter->dev;
 
 		++adapter->hdd_stats.tx_rx_stats.rx_packets[cpu_index];
-		++adapter->stats.rx_packets;
-		adapter->stats.rx_bytes += skb->len;
+		rx_packets++;
+		rx_bytes += skb->len;
 
 		/* Remove SKB from internal tracking table before submitting
 		 * it to stack
@@ -86,6 +87,8 @@ void hdd_rx_monitor_callback(ol_osif_vdev_handle context,
 
 		skb = skb_next;
 	}
+
+	hdd_pkt_stats_rx_add(adapter, rx_packets, rx_bytes);
 }
 
 void hdd_monitor_set_rx_monitor_cb(struct ol_txrx_ops *txrx,
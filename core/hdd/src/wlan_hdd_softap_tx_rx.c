@@ -170,7 +170,9 @@ static inline struct sk_buff *hdd_skb_orphan(struct hdd_adapter *adapter,
 	struct hdd_context *hdd_ctx = WLAN_HDD_GET_CTX(adapter);
 	int need_orphan = 0;
 
-	if (adapter->tx_flow_low_watermark > 0) {
+	if (hdd_tx_orphan_adaptive(hdd_ctx)) {
+		need_orphan = hdd_tx_orphan_policy_check(adapter);
+	} else if (adapter->tx_flow_low_watermark > 0) {
 #if (LINUX_VERSION_CODE > KERNEL_VERSION(3, 19, 0))
 		/*
 		 * The TCP TX throttling logic is changed a little after
@@ -217,13 +219,18 @@ static inline struct sk_buff *hdd_skb_orphan(struct hdd_adapter *adapter,
 		struct sk_buff *skb) {
 
 	struct sk_buff *nskb;
-#if (LINUX_VERSION_CODE > KERNEL_VERSION(3, 19, 0))
 	struct hdd_context *hdd_ctx = WLAN_HDD_GET_CTX(adapter);
-#endif
 
 	hdd_skb_fill_gso_size(adapter->dev, skb);
 
 	nskb = skb_unshare(skb, GFP_ATOMIC);
+	if (hdd_tx_orphan_adaptive(hdd_ctx)) {
+		if (nskb && hdd_tx_orphan_policy_check(adapter)) {
+			++adapter->hdd_stats.tx_rx_stats.tx_orphaned;
+			skb_orphan(nskb);
+		}
+		return nskb;
+	}
 #if (LINUX_VERSION_CODE > KERNEL_VERSION(3, 19, 0))
 	if (unlikely(hdd_ctx->config->tx_orphan_enable) && (nskb == skb)) {
 		/*
@@ -544,6 +551,8 @@ static void hdd_softap_notify_dhcp_ind(void *context, struct sk_buff *netbuf)
  * __hdd_softap_hard_start_xmit() - Transmit a frame
  * @skb: pointer to OS packet (sk_buff)
  * @dev: pointer to network device
+ * @txq_locked: true when called by the network stack with the tx queue
+ *	lock of @skb held, which serializes the per tx queue station cache
  *
  * Function registered with the Linux OS for transmitting
  * packets. This version of the function directly passes
@@ -554,7 +563,8 @@ static void hdd_softap_notify_dhcp_ind(void *context, struct sk_buff *netbuf)
  * Return: None
  */
 static void __hdd_softap_hard_start_xmit(struct sk_buff *skb,
-					 struct net_device *dev)
+					 struct net_device *dev,
+					 bool txq_locked)
 {
 	sme_ac_enum_type ac = SME_AC_BE;
 	struct hdd_adapter *adapter = (struct hdd_adapter *) netdev_priv(dev);
@@ -565,10 +575,14 @@ static void __hdd_softap_hard_start_xmit(struct sk_buff *skb,
 	void *soc = cds_get_context(QDF_MODULE_ID_SOC);
 	uint32_t num_seg;
 	struct hdd_station_info *sta_info = NULL;
+	struct hdd_sta_info_hit *hit = NULL;
 
 	++adapter->hdd_stats.tx_rx_stats.tx_called;
 	adapter->hdd_stats.tx_rx_stats.cont_txtimeout_cnt = 0;
 
+	/* sta_info is looked up without a reference, see below */
+	rcu_read_lock();
+
 	/* Prevent this function from being called during SSR since TL
 	 * context may not be reinitialized at this time which may
 	 * lead to a crash.
@@ -627,9 +641,16 @@ static void __hdd_softap_hard_start_xmit(struct sk_buff *skb,
 	else
 		mac_addr = dest_mac_addr;
 
-	sta_info = hdd_get_sta_info_by_mac(&adapter->sta_info_list,
-					   mac_addr->bytes,
-					   STA_INFO_SOFTAP_HARD_START_XMIT);
+	if (txq_locked &&
+	    skb->queue_mapping < QDF_ARRAY_SIZE(adapter->tx_sta_hit))
+		hit = &adapter->tx_sta_hit[skb->queue_mapping];
+
+	/*
+	 * The station is only used until the end of the RCU read-side
+	 * section, so skip the sta_info reference and container lock.
+	 */
+	sta_info = hdd_get_sta_info_by_mac_rcu(&adapter->sta_info_list,
+					       mac_addr->bytes, hit);
 
 	if (!QDF_NBUF_CB_GET_IS_BCAST(skb) && !QDF_NBUF_CB_GET_IS_MCAST(skb)) {
 		if (!sta_info) {
@@ -704,22 +725,20 @@ static void __hdd_softap_hard_start_xmit(struct sk_buff *skb,
 	 */
 	qdf_net_buf_debug_acquire_skb(skb, __FILE__, __LINE__);
 
-	adapter->stats.tx_bytes += skb->len;
-
+	num_seg = 0;
 	if (sta_info) {
 		sta_info->tx_bytes += skb->len;
 
 		if (qdf_nbuf_is_tso(skb)) {
 			num_seg = qdf_nbuf_get_tso_num_seg(skb);
-			adapter->stats.tx_packets += num_seg;
-			sta_info->tx_packets += num_seg;
 		} else {
-			++adapter->stats.tx_packets;
-			sta_info->tx_packets++;
+			num_seg = 1;
 			hdd_ctx->no_tx_offload_pkt_cnt++;
 		}
+		sta_info->tx_packets += num_seg;
 		sta_info->last_tx_rx_ts = qdf_system_ticks();
 	}
+	hdd_pkt_stats_tx_add(adapter, num_seg, skb->len);
 
 	QDF_NBUF_CB_TX_EXTRA_FRAG_FLAGS_NOTIFY_COMP(skb) = 0;
 
@@ -755,8 +774,7 @@ static void __hdd_softap_hard_start_xmit(struct sk_buff *skb,
 	netif_trans_update(dev);
 
 	wlan_hdd_sar_unsolicited_timer_start(hdd_ctx);
-	hdd_put_sta_info_ref(&adapter->sta_info_list, &sta_info, true,
-			     STA_INFO_SOFTAP_HARD_START_XMIT);
+	rcu_read_unlock();
 
 	return;
 
@@ -769,15 +787,14 @@ drop_pkt:
 	kfree_skb(skb);
 
 drop_pkt_accounting:
-	if (sta_info)
-		hdd_put_sta_info_ref(&adapter->sta_info_list, &sta_info, true,
-				     STA_INFO_SOFTAP_HARD_START_XMIT);
+	rcu_read_unlock();
 	++adapter->stats.tx_dropped;
 	++adapter->hdd_stats.tx_rx_stats.tx_dropped;
 }
 
-netdev_tx_t hdd_softap_hard_start_xmit(struct sk_buff *skb,
-				       struct net_device *net_dev)
+static netdev_tx_t hdd_softap_start_xmit(struct sk_buff *skb,
+					 struct net_device *net_dev,
+					 bool txq_locked)
 {
 	struct osif_vdev_sync *vdev_sync;
 
@@ -787,18 +804,25 @@ netdev_tx_t hdd_softap_hard_start_xmit(struct sk_buff *skb,
 		return NETDEV_TX_OK;
 	}
 
-	__hdd_softap_hard_start_xmit(skb, net_dev);
+	__hdd_softap_hard_start_xmit(skb, net_dev, txq_locked);
 
 	osif_vdev_sync_op_stop(vdev_sync);
 
 	return NETDEV_TX_OK;
 }
 
+netdev_tx_t hdd_softap_hard_start_xmit(struct sk_buff *skb,
+				       struct net_device *net_dev)
+{
+	return hdd_softap_start_xmit(skb, net_dev, true);
+}
+
 QDF_STATUS hdd_softap_ipa_start_xmit(qdf_nbuf_t nbuf, qdf_netdev_t dev)
 {
-	if (NETDEV_TX_OK == hdd_softap_hard_start_xmit(
-					(struct sk_buff *)nbuf,
-					(struct net_device *)dev))
+	/* IPA intra-BSS frames are sent without the netdev tx queue lock */
+	if (NETDEV_TX_OK == hdd_softap_start_xmit((struct sk_buff *)nbuf,
+						  (struct net_device *)dev,
+						  false))
 		return QDF_STATUS_SUCCESS;
 	else
 		return QDF_STATUS_E_FAILURE;
@@ -886,6 +910,7 @@ void hdd_softap_tx_timeout(struct net_device *net_dev)
 void hdd_softap_init_tx_rx(struct hdd_adapter *adapter)
 {
 	qdf_mem_zero(&adapter->stats, sizeof(struct net_device_stats));
+	hdd_reset_pkt_stats(adapter);
 }
 
 QDF_STATUS hdd_softap_deinit_tx_rx(struct hdd_adapter *adapter)
@@ -1098,6 +1123,10 @@ QDF_STATUS hdd_softap_rx_packet_cbk(void *adapter_context, qdf_nbuf_t rx_buf)
 	struct hdd_context *hdd_ctx = NULL;
 	struct qdf_mac_addr *src_mac;
 	struct hdd_station_info *sta_info;
+	bool wake_lock_check;
+	bool wake_lock = false;
+	struct hdd_rx_batch batch;
+	uint32_t rx_packets = 0, rx_bytes = 0;
 
 	/* Sanity check on inputs */
 	if (unlikely((!adapter_context) || (!rx_buf))) {
@@ -1121,6 +1150,10 @@ QDF_STATUS hdd_softap_rx_packet_cbk(void *adapter_context, qdf_nbuf_t rx_buf)
 		return QDF_STATUS_E_FAILURE;
 	}
 
+	wake_lock_check = !hdd_is_current_high_throughput(hdd_ctx) &&
+			  hdd_ctx->config->rx_wakelock_timeout;
+	hdd_rx_batch_init(adapter, &batch);
+
 	/* walk the chain until all are processed */
 	next = (struct sk_buff *)rx_buf;
 
@@ -1149,10 +1182,9 @@ QDF_STATUS hdd_softap_rx_packet_cbk(void *adapter_context, qdf_nbuf_t rx_buf)
 		}
 		cpu_index = wlan_hdd_get_cpu();
 		++adapter->hdd_stats.tx_rx_stats.rx_packets[cpu_index];
-		++adapter->stats.rx_packets;
 		/* count aggregated RX frame into stats */
-		adapter->stats.rx_packets += qdf_nbuf_get_gso_segs(skb);
-		adapter->stats.rx_bytes += skb->len;
+		rx_packets += 1 + qdf_nbuf_get_gso_segs(skb);
+		rx_bytes += skb->len;
 
 		/* Send DHCP Indication to FW */
 		src_mac = (struct qdf_mac_addr *)(skb->data +
@@ -1195,17 +1227,10 @@ QDF_STATUS hdd_softap_rx_packet_cbk(void *adapter_context, qdf_nbuf_t rx_buf)
 		skb->protocol = eth_type_trans(skb, skb->dev);
 
 		/* hold configurable wakelock for unicast traffic */
-		if (!hdd_is_current_high_throughput(hdd_ctx) &&
-		    hdd_ctx->config->rx_wakelock_timeout &&
+		if (wake_lock_check &&
 		    skb->pkt_type != PACKET_BROADCAST &&
-		    skb->pkt_type != PACKET_MULTICAST) {
-			cds_host_diag_log_work(&hdd_ctx->rx_wake_lock,
-						   hdd_ctx->config->rx_wakelock_timeout,
-						   WIFI_POWER_EVENT_WAKELOCK_HOLD_RX);
-			qdf_wake_lock_timeout_acquire(&hdd_ctx->rx_wake_lock,
-							  hdd_ctx->config->
-								  rx_wakelock_timeout);
-		}
+		    skb->pkt_type != PACKET_MULTICAST)
+			wake_lock = true;
 
 		/* Remove SKB from internal tracking table before submitting
 		 * it to stack
@@ -1214,7 +1239,10 @@ QDF_STATUS hdd_softap_rx_packet_cbk(void *adapter_context, qdf_nbuf_t rx_buf)
 
 		hdd_softap_tsf_timestamp_rx(hdd_ctx, skb);
 
-		qdf_status = hdd_rx_deliver_to_stack(adapter, skb);
+		qdf_status = hdd_rx_deliver_to_stack_batch(adapter, skb,
+							   &batch);
+		if (qdf_status == QDF_STATUS_E_PENDING)
+			continue;
 
 		if (QDF_IS_STATUS_SUCCESS(qdf_status))
 			++adapter->hdd_stats.tx_rx_stats.rx_delivered[cpu_index];
@@ -1222,6 +1250,21 @@ QDF_STATUS hdd_softap_rx_packet_cbk(void *adapter_context, qdf_nbuf_t rx_buf)
 			++adapter->hdd_stats.tx_rx_stats.rx_refused[cpu_index];
 	}
 
+	/* before the batched frames are handed to the stack */
+	if (wake_lock) {
+		cds_host_diag_log_work(&hdd_ctx->rx_wake_lock,
+				       hdd_ctx->config->rx_wakelock_timeout,
+				       WIFI_POWER_EVENT_WAKELOCK_HOLD_RX);
+		qdf_wake_lock_timeout_acquire(&hdd_ctx->rx_wake_lock,
+					      hdd_ctx->config->
+						rx_wakelock_timeout);
+	}
+
+	cpu_index = wlan_hdd_get_cpu();
+	adapter->hdd_stats.tx_rx_stats.rx_delivered[cpu_index] +=
+		hdd_rx_batch_flush(adapter, &batch);
+	hdd_pkt_stats_rx_add(adapter, rx_packets, rx_bytes);
+
 	return QDF_STATUS_SUCCESS;
 }
 
@@ -25,9 +25,25 @@
 
 #include <wlan_hdd_includes.h>
 #include "wlan_hdd_sta_info.h"
+#include "cds_lock_prof.h"
 
 #define HDD_MAX_PEERS 32
 
+/**
+ * hdd_sta_info_hash() - Get the hash bucket of a station MAC address
+ * @mac_addr: MAC address of the station
+ *
+ * The OUI bytes are mostly shared by the stations of a BSS, so only the
+ * NIC specific bytes are folded.
+ *
+ * Return: bucket index in the container hash
+ */
+static inline uint32_t hdd_sta_info_hash(const uint8_t *mac_addr)
+{
+	return (mac_addr[3] ^ mac_addr[4] ^ mac_addr[5]) &
+	       (HDD_STA_INFO_HASH_SIZE - 1);
+}
+
 char *sta_info_string_from_dbgid(wlan_sta_info_dbgid id)
 {
 	static const char *strings[] = {
@@ -76,6 +92,8 @@ char *sta_info_string_from_dbgid(wlan_sta_info_dbgid id)
 
 QDF_STATUS hdd_sta_info_init(struct hdd_sta_info_obj *sta_info_container)
 {
+	int i;
+
 	if (!sta_info_container) {
 		hdd_err("Parameter null");
 		return QDF_STATUS_E_INVAL;
@@ -83,6 +101,8 @@ QDF_STATUS hdd_sta_info_init(struct hdd_sta_info_obj *sta_info_container)
 
 	qdf_spinlock_create(&sta_info_container->sta_obj_lock);
 	qdf_list_create(&sta_info_container->sta_obj, HDD_MAX_PEERS);
+	for (i = 0; i < HDD_STA_INFO_HASH_SIZE; i++)
+		INIT_HLIST_HEAD(&sta_info_container->sta_hash[i]);
 
 	return QDF_STATUS_SUCCESS;
 }
@@ -94,6 +114,9 @@ void hdd_sta_info_deinit(struct hdd_sta_info_obj *sta_info_container)
 		return;
 	}
 
+	/* Flush the sta_info frees deferred past lockless lookups */
+	rcu_barrier();
+
 	qdf_list_destroy(&sta_info_container->sta_obj);
 	qdf_spinlock_destroy(&sta_info_container->sta_obj_lock);
 }
@@ -106,15 +129,20 @@ QDF_STATUS hdd_sta_info_attach(struct hdd_sta_info_obj *sta_info_container,
 		return QDF_STATUS_E_INVAL;
 	}
 
-	qdf_spin_lock_bh(&sta_info_container->sta_obj_lock);
+	cds_lock_prof_spin_lock_bh(&sta_info_container->sta_obj_lock,
+				   CDS_LOCK_SITE_HDD_STA_OBJ);
 
 	hdd_take_sta_info_ref(sta_info_container, sta_info, false,
 			      STA_INFO_ATTACH_DETACH);
 	qdf_list_insert_front(&sta_info_container->sta_obj,
 			      &sta_info->sta_node);
+	hlist_add_head_rcu(&sta_info->sta_hash_node,
+			   &sta_info_container->sta_hash[
+				hdd_sta_info_hash(sta_info->sta_mac.bytes)]);
 	sta_info->is_attached = true;
 
-	qdf_spin_unlock_bh(&sta_info_container->sta_obj_lock);
+	cds_lock_prof_spin_unlock_bh(&sta_info_container->sta_obj_lock,
+				     CDS_LOCK_SITE_HDD_STA_OBJ);
 
 	return QDF_STATUS_SUCCESS;
 }
@@ -134,7 +162,8 @@ void hdd_sta_info_detach(struct hdd_sta_info_obj *sta_info_container,
 	if (!info)
 		return;
 
-	qdf_spin_lock_bh(&sta_info_container->sta_obj_lock);
+	cds_lock_prof_spin_lock_bh(&sta_info_container->sta_obj_lock,
+				   CDS_LOCK_SITE_HDD_STA_OBJ);
 
 	if (info->is_attached) {
 		info->is_attached = false;
@@ -144,7 +173,8 @@ void hdd_sta_info_detach(struct hdd_sta_info_obj *sta_info_container,
 		hdd_info("Stainfo is already detached");
 	}
 
-	qdf_spin_unlock_bh(&sta_info_container->sta_obj_lock);
+	cds_lock_prof_spin_unlock_bh(&sta_info_container->sta_obj_lock,
+				     CDS_LOCK_SITE_HDD_STA_OBJ);
 }
 
 struct hdd_station_info *hdd_get_sta_info_by_mac(
@@ -153,29 +183,90 @@ struct hdd_station_info *hdd_get_sta_info_by_mac(
 				wlan_sta_info_dbgid sta_info_dbgid)
 {
 	struct hdd_station_info *sta_info = NULL;
+	struct hlist_head *bucket;
 
 	if (!mac_addr || !sta_info_container) {
 		hdd_err("Parameter(s) null");
 		return NULL;
 	}
 
-	qdf_spin_lock_bh(&sta_info_container->sta_obj_lock);
+	bucket = &sta_info_container->sta_hash[hdd_sta_info_hash(mac_addr)];
 
-	qdf_list_for_each(&sta_info_container->sta_obj, sta_info, sta_node) {
+	cds_lock_prof_spin_lock_bh(&sta_info_container->sta_obj_lock,
+				   CDS_LOCK_SITE_HDD_STA_OBJ);
+
+	hlist_for_each_entry(sta_info, bucket, sta_hash_node) {
 		if (qdf_is_macaddr_equal(&sta_info->sta_mac,
 					 (struct qdf_mac_addr *)mac_addr)) {
 			hdd_take_sta_info_ref(sta_info_container,
 					      sta_info, false, sta_info_dbgid);
-			qdf_spin_unlock_bh(&sta_info_container->sta_obj_lock);
+			cds_lock_prof_spin_unlock_bh(
+					&sta_info_container->sta_obj_lock,
+					CDS_LOCK_SITE_HDD_STA_OBJ);
 			return sta_info;
 		}
 	}
 
-	qdf_spin_unlock_bh(&sta_info_container->sta_obj_lock);
+	cds_lock_prof_spin_unlock_bh(&sta_info_container->sta_obj_lock,
+				     CDS_LOCK_SITE_HDD_STA_OBJ);
 
 	return NULL;
 }
 
+struct hdd_station_info *
+hdd_get_sta_info_by_mac_rcu(struct hdd_sta_info_obj *sta_info_container,
+			    const uint8_t *mac_addr,
+			    struct hdd_sta_info_hit *hit)
+{
+	struct hdd_station_info *sta_info;
+	struct hlist_head *bucket;
+	uint32_t gen;
+
+	/*
+	 * Pairs with the smp_wmb() in hdd_put_sta_info_ref(): once the new
+	 * generation is seen, the dropped reference of the freed sta_info
+	 * is seen as well, so it is never cached under the new generation.
+	 */
+	gen = READ_ONCE(sta_info_container->gen);
+	smp_rmb();
+
+	if (hit && hit->sta_info && hit->gen == gen &&
+	    qdf_is_macaddr_equal(&hit->sta_info->sta_mac,
+				 (struct qdf_mac_addr *)mac_addr))
+		return hit->sta_info;
+
+	bucket = &sta_info_container->sta_hash[hdd_sta_info_hash(mac_addr)];
+
+	hlist_for_each_entry_rcu(sta_info, bucket, sta_hash_node) {
+		if (!qdf_is_macaddr_equal(&sta_info->sta_mac,
+					  (struct qdf_mac_addr *)mac_addr))
+			continue;
+
+		if (!qdf_atomic_read(&sta_info->ref_cnt))
+			return NULL;
+
+		if (hit) {
+			hit->sta_info = sta_info;
+			hit->gen = gen;
+		}
+
+		return sta_info;
+	}
+
+	return NULL;
+}
+
+/**
+ * hdd_sta_info_free_rcu() - Free a sta_info once lockless lookups are done
+ * @rcu: RCU head of the sta_info
+ *
+ * Return: None
+ */
+static void hdd_sta_info_free_rcu(struct rcu_head *rcu)
+{
+	qdf_mem_free(container_of(rcu, struct hdd_station_info, rcu));
+}
+
 void hdd_take_sta_info_ref(struct hdd_sta_info_obj *sta_info_container,
 			   struct hdd_station_info *sta_info,
 			   bool lock_required,
@@ -259,7 +350,10 @@ hdd_put_sta_info_ref(struct hdd_sta_info_obj *sta_info_container,
 	}
 
 	qdf_list_remove_node(&sta_info_container->sta_obj, &info->sta_node);
-	qdf_mem_free(info);
+	hlist_del_rcu(&info->sta_hash_node);
+	smp_wmb();
+	WRITE_ONCE(sta_info_container->gen, sta_info_container->gen + 1);
+	call_rcu(&info->rcu, hdd_sta_info_free_rcu);
 	*sta_info = NULL;
 
 	if (lock_required)
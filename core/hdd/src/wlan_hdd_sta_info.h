@@ -33,11 +33,15 @@
 #include "cdp_txrx_cmn_struct.h"
 #include "sir_mac_prot_def.h"
 #include <linux/ieee80211.h>
+#include <linux/rculist.h>
 #include <wlan_mlme_public_struct.h>
 
 /* Opaque handle for abstraction */
 #define hdd_sta_info_entry qdf_list_node_t
 
+/* Number of buckets of the station info MAC address hash */
+#define HDD_STA_INFO_HASH_SIZE 32
+
 /**
  * struct dhcp_phase - Per Peer DHCP Phases
  * @DHCP_PHASE_ACK: upon receiving DHCP_ACK/NAK message in REQUEST phase or
@@ -164,6 +168,8 @@ char *sta_info_string_from_dbgid(wlan_sta_info_dbgid id);
  * struct hdd_station_info - Per station structure kept in HDD for
  *                                     multiple station support for SoftAP
  * @sta_node: The sta_info node for the station info list maintained in adapter
+ * @sta_hash_node: The sta_info node in the MAC address hash of the container
+ * @rcu: RCU head used to defer freeing past lockless lookups
  * @in_use: Is the station entry in use?
  * @sta_id: Station ID reported back from HAL (through SAP).
  *           Broadcast uses station ID zero by default.
@@ -232,6 +238,8 @@ char *sta_info_string_from_dbgid(wlan_sta_info_dbgid id);
  */
 struct hdd_station_info {
 	qdf_list_node_t sta_node;
+	struct hlist_node sta_hash_node;
+	struct rcu_head rcu;
 	bool in_use;
 	uint8_t sta_id;
 	eStationType sta_type;
@@ -296,10 +304,28 @@ struct hdd_station_info {
  * struct hdd_sta_info_obj - Station info container structure
  * @sta_obj: The sta info object that stores the sta_info
  * @sta_obj_lock: Lock to protect the sta_obj read/write access
+ * @sta_hash: The sta_info objects hashed by MAC address, written under
+ *            @sta_obj_lock and walked under RCU by lockless lookups
+ * @gen: Generation bumped each time a sta_info is removed, used to
+ *       invalidate &struct hdd_sta_info_hit entries
  */
 struct hdd_sta_info_obj {
 	qdf_list_t sta_obj;
 	qdf_spinlock_t sta_obj_lock;
+	struct hlist_head sta_hash[HDD_STA_INFO_HASH_SIZE];
+	uint32_t gen;
+};
+
+/**
+ * struct hdd_sta_info_hit - One entry cache of the last station looked up
+ * @sta_info: Station returned by the last lookup
+ * @gen: Generation of the container when @sta_info was cached
+ *
+ * An entry must only be used by one context at a time, e.g. per tx queue.
+ */
+struct hdd_sta_info_hit {
+	struct hdd_station_info *sta_info;
+	uint32_t gen;
 };
 
 /**
@@ -573,6 +599,27 @@ struct hdd_station_info *hdd_get_sta_info_by_mac(
 				const uint8_t *mac_addr,
 				wlan_sta_info_dbgid sta_info_dbgid);
 
+/**
+ * hdd_get_sta_info_by_mac_rcu() - Find the sta_info structure by mac addr
+ *                                 without taking the container lock
+ * @sta_info_container: The station info container obj that stores and maintains
+ *                      the sta_info obj.
+ * @mac_addr: The mac addr by which the sta_info has to be fetched.
+ * @hit: Optional last-hit cache consulted before, and updated after, the
+ *       hash lookup
+ *
+ * The caller must be in an RCU read-side critical section, e.g. the
+ * ndo_start_xmit path. No reference is taken: the returned sta_info may be
+ * detached concurrently but is not freed until the critical section ends.
+ *
+ * Return: Pointer to the hdd_station_info structure which contains the mac
+ *         address passed, NULL if not found
+ */
+struct hdd_station_info *
+hdd_get_sta_info_by_mac_rcu(struct hdd_sta_info_obj *sta_info_container,
+			    const uint8_t *mac_addr,
+			    struct hdd_sta_info_hit *hit);
+
 /**
  * hdd_clear_cached_sta_info() - Clear the cached sta info from the container
  * @sta_info_container: The station info container obj that stores and maintains
@@ -0,0 +1,292 @@
+/*
+ * Copyright (c) 2021 The Linux Foundation. All rights reserved.
+ *
+ * Permission to use, copy, modify, and/or distribute this software for
+ * any purpose with or without fee is hereby granted, provided that the
+ * above copyright notice and this permission notice appear in all
+ * copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+ * WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+ * AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+ * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR
+ * PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+ * TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+ * PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/**
+ * DOC: wlan_hdd_sta_stats_hist.c
+ *
+ * WLAN Host Device Driver station stats history implementation
+ */
+
+#include "wlan_hdd_main.h"
+#include "wlan_hdd_tx_rx.h"
+#include "wlan_hdd_stats.h"
+#include "cfg_ucfg_api.h"
+#include "wlan_hdd_sta_stats_hist.h"
+
+void hdd_sta_stats_hist_config(struct hdd_config *config,
+			       struct wlan_objmgr_psoc *psoc)
+{
+	uint32_t interval = cfg_get(psoc, CFG_STA_STATS_HIST_INTERVAL);
+
+	if (interval && interval < HDD_STA_STATS_HIST_MIN_INTERVAL) {
+		hdd_err("sta_stats_hist_interval %u below %u ms, using %u",
+			interval, HDD_STA_STATS_HIST_MIN_INTERVAL,
+			cfg_default(CFG_STA_STATS_HIST_INTERVAL));
+		interval = cfg_default(CFG_STA_STATS_HIST_INTERVAL);
+	}
+
+	config->sta_stats_hist_interval = interval;
+}
+
+static void hdd_sta_stats_hist_work(void *context);
+
+void hdd_sta_stats_hist_init(struct hdd_adapter *adapter)
+{
+	struct hdd_sta_stats_hist *hist = &adapter->sta_stats_hist;
+
+	qdf_mem_zero(hist, sizeof(*hist));
+	qdf_spinlock_create(&hist->lock);
+	if (QDF_IS_STATUS_ERROR(qdf_periodic_work_create(
+					&hist->work, hdd_sta_stats_hist_work,
+					adapter))) {
+		qdf_spinlock_destroy(&hist->lock);
+		return;
+	}
+	hist->initialized = true;
+}
+
+void hdd_sta_stats_hist_deinit(struct hdd_adapter *adapter)
+{
+	struct hdd_sta_stats_hist *hist = &adapter->sta_stats_hist;
+
+	if (!hist->initialized)
+		return;
+
+	qdf_periodic_work_stop_sync(&hist->work);
+	qdf_periodic_work_destroy(&hist->work);
+	qdf_spinlock_destroy(&hist->lock);
+	hist->initialized = false;
+}
+
+/**
+ * hdd_sta_stats_hist_counters_get() - read the cumulative link counters
+ * @adapter: Pointer to the station adapter
+ * @retries: filled with the tx retries of the last firmware stats
+ * @pkt_stats: filled with the host packet counters
+ *
+ * Return: none
+ */
+static void hdd_sta_stats_hist_counters_get(struct hdd_adapter *adapter,
+					    uint32_t *retries,
+					    struct hdd_pkt_stats *pkt_stats)
+{
+	tCsrSummaryStatsInfo *summary = &adapter->hdd_stats.summary_stat;
+	int i;
+
+	*retries = 0;
+	for (i = 0; i < WIFI_MAX_AC; i++)
+		*retries += summary->multiple_retry_cnt[i];
+
+	hdd_get_pkt_stats(adapter, pkt_stats);
+}
+
+void hdd_sta_stats_hist_reset(struct hdd_adapter *adapter)
+{
+	struct hdd_sta_stats_hist *hist = &adapter->sta_stats_hist;
+	uint32_t interval = adapter->hdd_ctx->config->sta_stats_hist_interval;
+	struct hdd_pkt_stats pkt_stats;
+	uint32_t retries;
+
+	if (adapter->device_mode != QDF_STA_MODE || !hist->initialized)
+		return;
+
+	hdd_sta_stats_hist_counters_get(adapter, &retries, &pkt_stats);
+
+	qdf_spin_lock_bh(&hist->lock);
+	hist->head = 0;
+	hist->count = 0;
+	hist->prev_retries = retries;
+	hist->prev_tx_packets = pkt_stats.tx_packets;
+	hist->prev_rx_packets = pkt_stats.rx_packets;
+	qdf_spin_unlock_bh(&hist->lock);
+
+	if (interval)
+		qdf_periodic_work_start(&hist->work, interval);
+}
+
+/**
+ * hdd_sta_stats_hist_delta() - difference of two cumulative counter reads
+ * @cur: current value
+ * @prev: previous value
+ *
+ * The counters go back to 0 when they are reset, in which case everything
+ * counted since is new.
+ *
+ * Return: counted since @prev, saturated to 32 bits
+ */
+static uint32_t hdd_sta_stats_hist_delta(uint64_t cur, uint64_t prev)
+{
+	uint64_t delta = cur >= prev ? cur - prev : cur;
+
+	return qdf_min(delta, (uint64_t)U32_MAX);
+}
+
+/**
+ * hdd_sta_stats_hist_add() - add a sample to the history of an interface
+ * @adapter: Pointer to the connected station adapter
+ * @now_ms: current time, never 0
+ *
+ * Return: none
+ */
+static void hdd_sta_stats_hist_add(struct hdd_adapter *adapter,
+				   uint32_t now_ms)
+{
+	struct hdd_sta_stats_hist *hist = &adapter->sta_stats_hist;
+	tCsrGlobalClassAStatsInfo *class_a = &adapter->hdd_stats.class_a_stat;
+	struct hdd_sta_stats_sample *sample;
+	struct hdd_pkt_stats pkt_stats;
+	uint32_t retries;
+
+	hdd_sta_stats_hist_counters_get(adapter, &retries, &pkt_stats);
+
+	qdf_spin_lock_bh(&hist->lock);
+	sample = &hist->samples[hist->head];
+	qdf_mem_zero(sample, sizeof(*sample));
+	sample->ts_ms = now_ms;
+	if (READ_ONCE(adapter->sta_stats_cache.gen))
+		sample->fw_ts_ms = READ_ONCE(adapter->sta_stats_cache.fetch_ts);
+	sample->tx_rate = qdf_min(class_a->tx_rate, (uint32_t)U16_MAX);
+	sample->rx_rate = qdf_min(class_a->rx_rate, (uint32_t)U16_MAX);
+	sample->rssi = adapter->rssi;
+	sample->retries = hdd_sta_stats_hist_delta(retries,
+						   hist->prev_retries);
+	sample->tx_packets = hdd_sta_stats_hist_delta(pkt_stats.tx_packets,
+						      hist->prev_tx_packets);
+	sample->rx_packets = hdd_sta_stats_hist_delta(pkt_stats.rx_packets,
+						      hist->prev_rx_packets);
+
+	hist->prev_retries = retries;
+	hist->prev_tx_packets = pkt_stats.tx_packets;
+	hist->prev_rx_packets = pkt_stats.rx_packets;
+	hist->head = (hist->head + 1) % HDD_STA_STATS_HIST_LEN;
+	if (hist->count < HDD_STA_STATS_HIST_LEN)
+		hist->count++;
+	qdf_spin_unlock_bh(&hist->lock);
+}
+
+/**
+ * hdd_sta_stats_hist_fw_refresh() - refresh the firmware station stats
+ * @adapter: Pointer to the connected station adapter
+ * @interval: sampling interval in msec
+ *
+ * Only requests the stats when the cached ones are older than @interval,
+ * requests made for other readers in between are used as they are.
+ *
+ * Return: none
+ */
+static void hdd_sta_stats_hist_fw_refresh(struct hdd_adapter *adapter,
+					  uint32_t interval)
+{
+	struct hdd_stats_cache *cache = &adapter->sta_stats_cache;
+	uint32_t now_ms = qdf_system_ticks_to_msecs(qdf_system_ticks());
+
+	if (READ_ONCE(cache->gen) &&
+	    now_ms - READ_ONCE(cache->fetch_ts) < interval)
+		return;
+
+	if (wlan_hdd_get_station_stats(adapter))
+		hdd_debug_rl("station stats refresh failed, sampling cached");
+}
+
+/**
+ * hdd_sta_stats_hist_work() - sample the link of a connected interface
+ * @context: Pointer to the station adapter
+ *
+ * Stops itself once the interface is disconnected, until the next
+ * connection restarts the history.
+ *
+ * Return: none
+ */
+static void hdd_sta_stats_hist_work(void *context)
+{
+	struct hdd_adapter *adapter = context;
+	struct hdd_context *hdd_ctx = adapter->hdd_ctx;
+	struct hdd_station_ctx *sta_ctx;
+	struct qdf_op_sync *op_sync;
+	uint32_t interval;
+	uint32_t now_ms;
+
+	if (qdf_op_protect(&op_sync))
+		return;
+
+	interval = hdd_ctx->config->sta_stats_hist_interval;
+	sta_ctx = WLAN_HDD_GET_STATION_CTX_PTR(adapter);
+	if (!interval || wlan_hdd_validate_context(hdd_ctx) ||
+	    !hdd_conn_is_connected(sta_ctx)) {
+		qdf_periodic_work_stop_async(&adapter->sta_stats_hist.work);
+		goto unprotect;
+	}
+
+	hdd_sta_stats_hist_fw_refresh(adapter, interval);
+
+	/* 0 marks an empty history */
+	now_ms = qdf_system_ticks_to_msecs(qdf_system_ticks()) | 1;
+	hdd_sta_stats_hist_add(adapter, now_ms);
+
+unprotect:
+	qdf_op_unprotect(op_sync);
+}
+
+ssize_t hdd_sta_stats_hist_read(struct hdd_adapter *adapter, char *buf,
+				size_t buf_len)
+{
+	struct hdd_sta_stats_hist *hist = &adapter->sta_stats_hist;
+	struct hdd_sta_stats_sample *sample;
+	uint32_t idx, i;
+	ssize_t len = 0;
+
+	qdf_spin_lock_bh(&hist->lock);
+	idx = (hist->head + HDD_STA_STATS_HIST_LEN - hist->count) %
+	      HDD_STA_STATS_HIST_LEN;
+
+	if (!hist->binary)
+		len += scnprintf(buf, buf_len,
+				 "ts_ms,fw_ts_ms,tx_rate,rx_rate,rssi,retries,tx_packets,rx_packets\n");
+
+	for (i = 0; i < hist->count; i++) {
+		sample = &hist->samples[idx];
+		idx = (idx + 1) % HDD_STA_STATS_HIST_LEN;
+
+		if (hist->binary) {
+			if (len + sizeof(*sample) > buf_len)
+				break;
+			qdf_mem_copy(buf + len, sample, sizeof(*sample));
+			len += sizeof(*sample);
+			continue;
+		}
+
+		len += scnprintf(buf + len, buf_len - len,
+				 "%u,%u,%u,%u,%d,%u,%u,%u\n",
+				 sample->ts_ms, sample->fw_ts_ms,
+				 sample->tx_rate, sample->rx_rate,
+				 sample->rssi, sample->retries,
+				 sample->tx_packets, sample->rx_packets);
+	}
+	qdf_spin_unlock_bh(&hist->lock);
+
+	return len;
+}
+
+void hdd_sta_stats_hist_set_binary(struct hdd_adapter *adapter, bool binary)
+{
+	struct hdd_sta_stats_hist *hist = &adapter->sta_stats_hist;
+
+	qdf_spin_lock_bh(&hist->lock);
+	hist->binary = binary;
+	qdf_spin_unlock_bh(&hist->lock);
+}
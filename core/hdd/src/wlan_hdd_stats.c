@@ -45,6 +45,7 @@
 #include "cdp_txrx_misc.h"
 #include "cdp_txrx_host_stats.h"
 #include "wlan_hdd_object_manager.h"
+#include "wlan_hdd_tx_rx.h"
 
 #if (LINUX_VERSION_CODE < KERNEL_VERSION(4, 0, 0)) && !defined(WITH_BACKPORTS)
 #define HDD_INFO_SIGNAL                 STATION_INFO_SIGNAL
@@ -200,6 +201,43 @@ static bool wlan_hdd_is_he_mcs_12_13_supported(uint16_t he_mcs_12_13_map)
 
 static bool get_station_fw_request_needed = true;
 
+/**
+ * hdd_sta_stats_cache_req_done() - record the result of a firmware station
+ *				    stats request
+ * @adapter: adapter whose station stats were requested
+ * @ret: result of the request
+ *
+ * Requests which waited for the cache lock meanwhile return @ret.
+ * Must be called with the cache lock held.
+ *
+ * Return: None
+ */
+static void hdd_sta_stats_cache_req_done(struct hdd_adapter *adapter, int ret)
+{
+	struct hdd_stats_cache *cache = &adapter->sta_stats_cache;
+
+	cache->req_ret = ret;
+	WRITE_ONCE(cache->req_gen, cache->req_gen + 1);
+}
+
+/**
+ * hdd_sta_stats_cache_update() - record a firmware station stats response
+ * @adapter: adapter whose station stats were refreshed
+ *
+ * Must be called with the cache lock held.
+ *
+ * Return: None
+ */
+static void hdd_sta_stats_cache_update(struct hdd_adapter *adapter)
+{
+	struct hdd_stats_cache *cache = &adapter->sta_stats_cache;
+
+	cache->fetch_ts = qdf_system_ticks_to_msecs(qdf_system_ticks());
+	/* 0 is reserved for no snapshot yet */
+	WRITE_ONCE(cache->gen, cache->gen + 1 ? cache->gen + 1 : 1);
+	hdd_sta_stats_cache_req_done(adapter, 0);
+}
+
 #ifdef WLAN_FEATURE_BIG_DATA_STATS
 /*
  * copy_station_big_data_stats_to_adapter() - Copy big data stats to adapter
@@ -234,11 +272,32 @@ hdd_update_station_stats_cached_timestamp(struct hdd_adapter *adapter)
 	adapter->hdd_stats.sta_stats_cached_timestamp =
 				qdf_system_ticks_to_msecs(qdf_system_ticks());
 }
+
+/**
+ * hdd_club_sta_stats_cache_update() - record station stats received along
+ *				       with link layer stats
+ * @adapter: adapter whose link layer stats were requested
+ *
+ * Return: None
+ */
+static void hdd_club_sta_stats_cache_update(struct hdd_adapter *adapter)
+{
+	if (!adapter->hdd_ctx->is_get_station_clubbed_in_ll_stats_req)
+		return;
+
+	qdf_mutex_acquire(&adapter->sta_stats_cache.lock);
+	hdd_sta_stats_cache_update(adapter);
+	qdf_mutex_release(&adapter->sta_stats_cache.lock);
+}
 #else
 static void
 hdd_update_station_stats_cached_timestamp(struct hdd_adapter *adapter)
 {
 }
+
+static void hdd_club_sta_stats_cache_update(struct hdd_adapter *adapter)
+{
+}
 #endif /* FEATURE_CLUB_LL_STATS_AND_GET_STATION */
 
 #ifdef WLAN_FEATURE_LINK_LAYER_STATS
@@ -1317,6 +1376,48 @@ static void hdd_debugfs_process_ll_stats(struct hdd_adapter *adapter,
 		osif_request_complete(request);
 }
 
+/**
+ * hdd_ll_stats_stream_process() - Emit LL stats response into binary stream
+ * @adapter: Pointer to device adapter
+ * @results: LL stats response from FW
+ * @request: osif request of the stream poll
+ *
+ * Same bookkeeping of the pending response bitmap as
+ * hdd_debugfs_process_ll_stats(), but the stats are serialized as binary
+ * records into the per adapter relay channel instead of a text buffer.
+ *
+ * Return: None
+ */
+static void hdd_ll_stats_stream_process(struct hdd_adapter *adapter,
+					tSirLLStatsResults *results,
+					struct osif_request *request)
+{
+	struct hdd_ll_stats_priv *priv = osif_request_priv(request);
+
+	if (results->paramId & WMI_LINK_STATS_RADIO) {
+		hdd_ll_stats_stream_radio(adapter, results->results,
+					  results->num_radio);
+		if (!results->moreResultToFollow)
+			priv->request_bitmap &= ~(WMI_LINK_STATS_RADIO);
+	} else if (results->paramId & WMI_LINK_STATS_IFACE) {
+		hdd_ll_stats_stream_iface(adapter, results->results,
+					  results->num_peers);
+		if (!results->num_peers)
+			priv->request_bitmap &= ~(WMI_LINK_STATS_ALL_PEER);
+
+		priv->request_bitmap &= ~(WMI_LINK_STATS_IFACE);
+	} else if (results->paramId & WMI_LINK_STATS_ALL_PEER) {
+		hdd_ll_stats_stream_peer(adapter, results->results);
+		if (!results->moreResultToFollow)
+			priv->request_bitmap &= ~(WMI_LINK_STATS_ALL_PEER);
+	} else {
+		hdd_err("INVALID LL_STATS_NOTIFY RESPONSE");
+	}
+
+	if (!priv->request_bitmap)
+		osif_request_complete(request);
+}
+
 void wlan_hdd_cfg80211_link_layer_stats_callback(hdd_handle_t hdd_handle,
 						 int indication_type,
 						 tSirLLStatsResults *results,
@@ -1368,7 +1469,9 @@ void wlan_hdd_cfg80211_link_layer_stats_callback(hdd_handle_t hdd_handle,
 
 		if (results->rspId == DEBUGFS_LLSTATS_REQID) {
 			hdd_debugfs_process_ll_stats(adapter, results, request);
-		 } else {
+		} else if (results->rspId == DEBUGFS_LLSTATS_STREAM_REQID) {
+			hdd_ll_stats_stream_process(adapter, results, request);
+		} else {
 			qdf_spin_lock(&priv->ll_stats_lock);
 			if (priv->request_bitmap)
 				hdd_process_ll_stats(results, request);
@@ -1956,6 +2059,7 @@ static int wlan_hdd_send_ll_stats_req(struct hdd_adapter *adapter,
 		ret = -ETIMEDOUT;
 	} else {
 		hdd_update_station_stats_cached_timestamp(adapter);
+		hdd_club_sta_stats_cache_update(adapter);
 	}
 	qdf_spin_lock(&priv->ll_stats_lock);
 	status = qdf_list_remove_front(&priv->ll_stats_q, &ll_node);
@@ -1979,16 +2083,17 @@ exit:
 	return ret;
 }
 
-int wlan_hdd_ll_stats_get(struct hdd_adapter *adapter, uint32_t req_id,
-			  uint32_t req_mask)
+/**
+ * wlan_hdd_ll_stats_get_allowed() - Check if LL stats can be requested
+ * @adapter: Pointer to device adapter
+ *
+ * Return: 0 if the request can be sent and error code otherwise
+ */
+static int wlan_hdd_ll_stats_get_allowed(struct hdd_adapter *adapter)
 {
-	int errno;
-	tSirLLStatsGetReq get_req;
 	struct hdd_station_ctx *hddstactx =
 					WLAN_HDD_GET_STATION_CTX_PTR(adapter);
 
-	hdd_enter_dev(adapter->dev);
-
 	if (QDF_GLOBAL_FTM_MODE == hdd_get_conparam()) {
 		hdd_warn("Command not allowed in FTM mode");
 		return -EPERM;
@@ -2004,6 +2109,21 @@ int wlan_hdd_ll_stats_get(struct hdd_adapter *adapter, uint32_t req_id,
 		return -EINVAL;
 	}
 
+	return 0;
+}
+
+int wlan_hdd_ll_stats_get(struct hdd_adapter *adapter, uint32_t req_id,
+			  uint32_t req_mask)
+{
+	int errno;
+	tSirLLStatsGetReq get_req;
+
+	hdd_enter_dev(adapter->dev);
+
+	errno = wlan_hdd_ll_stats_get_allowed(adapter);
+	if (errno)
+		return errno;
+
 	get_req.reqId = req_id;
 	get_req.paramIdMask = req_mask;
 	get_req.staId = adapter->vdev_id;
@@ -2020,6 +2140,32 @@ int wlan_hdd_ll_stats_get(struct hdd_adapter *adapter, uint32_t req_id,
 	return errno;
 }
 
+int wlan_hdd_ll_stats_try_get(struct hdd_adapter *adapter, uint32_t req_id,
+			      uint32_t req_mask)
+{
+	int errno;
+	tSirLLStatsGetReq get_req;
+
+	errno = wlan_hdd_ll_stats_get_allowed(adapter);
+	if (errno)
+		return errno;
+
+	get_req.reqId = req_id;
+	get_req.paramIdMask = req_mask;
+	get_req.staId = adapter->vdev_id;
+
+	if (!rtnl_trylock())
+		return -EBUSY;
+
+	errno = wlan_hdd_send_ll_stats_req(adapter, &get_req);
+	rtnl_unlock();
+	if (errno)
+		hdd_debug("LL stats req failed, id:%u, mask:%d, session:%d",
+			  req_id, req_mask, adapter->vdev_id);
+
+	return errno;
+}
+
 /**
  * __wlan_hdd_cfg80211_ll_stats_get() - get link layer stats
  * @wiphy: Pointer to wiphy
@@ -5295,6 +5441,7 @@ static int wlan_hdd_get_sta_stats(struct wiphy *wiphy,
 	int link_speed_rssi_low = 0;
 	uint32_t link_speed_rssi_report = 0;
 	struct wlan_objmgr_vdev *vdev;
+	struct hdd_pkt_stats pkt_stats;
 
 	qdf_mtrace(QDF_MODULE_ID_HDD, QDF_MODULE_ID_HDD,
 		   TRACE_CODE_HDD_CFG80211_GET_STA,
@@ -5477,9 +5624,10 @@ static int wlan_hdd_get_sta_stats(struct wiphy *wiphy,
 	wlan_hdd_fill_summary_stats(&adapter->hdd_stats.summary_stat,
 				    sinfo,
 				    adapter->vdev_id);
-	sinfo->tx_bytes = adapter->stats.tx_bytes;
-	sinfo->rx_bytes = adapter->stats.rx_bytes;
-	sinfo->rx_packets = adapter->stats.rx_packets;
+	hdd_get_pkt_stats(adapter, &pkt_stats);
+	sinfo->tx_bytes = pkt_stats.tx_bytes;
+	sinfo->rx_bytes = pkt_stats.rx_bytes;
+	sinfo->rx_packets = pkt_stats.rx_packets;
 
 	hdd_fill_fcs_and_mpdu_count(adapter, sinfo);
 
@@ -5702,22 +5850,46 @@ int wlan_hdd_cfg80211_dump_station(struct wiphy *wiphy,
 }
 
 /**
- * hdd_get_stats() - Function to retrieve interface statistics
+ * __hdd_get_stats64() - fill interface statistics
  * @dev: pointer to network device
+ * @stats: statistics to fill
  *
- * This function is the ndo_get_stats method for all netdevs
- * registered with the kernel
+ * The packet and byte counters are summed from the per-CPU counters,
+ * everything else comes from the adapter net_device_stats.
  *
- * Return: pointer to net_device_stats structure
+ * Return: None
  */
-struct net_device_stats *hdd_get_stats(struct net_device *dev)
+static void __hdd_get_stats64(struct net_device *dev,
+			      struct rtnl_link_stats64 *stats)
 {
 	struct hdd_adapter *adapter = WLAN_HDD_GET_PRIV_PTR(dev);
+	struct hdd_pkt_stats pkt_stats;
 
 	hdd_enter_dev(dev);
-	return &adapter->stats;
+
+	netdev_stats_to_stats64(stats, &adapter->stats);
+	hdd_get_pkt_stats(adapter, &pkt_stats);
+	stats->tx_packets = pkt_stats.tx_packets;
+	stats->tx_bytes = pkt_stats.tx_bytes;
+	stats->rx_packets = pkt_stats.rx_packets;
+	stats->rx_bytes = pkt_stats.rx_bytes;
 }
 
+#if (LINUX_VERSION_CODE >= KERNEL_VERSION(4, 11, 0))
+void hdd_get_stats64(struct net_device *dev, struct rtnl_link_stats64 *stats)
+{
+	__hdd_get_stats64(dev, stats);
+}
+#else
+struct rtnl_link_stats64 *hdd_get_stats64(struct net_device *dev,
+					  struct rtnl_link_stats64 *stats)
+{
+	__hdd_get_stats64(dev, stats);
+
+	return stats;
+}
+#endif
+
 
 /*
  * time = cycle_count * cycle
@@ -6481,24 +6653,74 @@ int wlan_hdd_get_link_speed(struct hdd_adapter *adapter, uint32_t *link_speed)
 	return 0;
 }
 
+/**
+ * hdd_sta_stats_cache_valid() - check if a station stats snapshot can be used
+ * @adapter: adapter for which statistics are desired
+ * @req_gen: request generation seen before waiting for the cache lock
+ * @ret: filled with the result to return if the request is answered
+ *
+ * A request which completed while waiting for the cache lock answers this
+ * one, with its own result if it failed.
+ * Must be called with the cache lock held.
+ *
+ * Return: true if the request is answered without a firmware request
+ */
+static bool hdd_sta_stats_cache_valid(struct hdd_adapter *adapter,
+				      uint32_t req_gen, int *ret)
+{
+	struct hdd_stats_cache *cache = &adapter->sta_stats_cache;
+	uint32_t ttl = adapter->hdd_ctx->config->sta_stats_cache_ttl;
+
+	if (cache->req_gen != req_gen) {
+		cache->coalesced++;
+		*ret = cache->req_ret;
+		return true;
+	}
+
+	if (ttl && cache->gen &&
+	    qdf_system_ticks_to_msecs(qdf_system_ticks()) - cache->fetch_ts <=
+	    ttl) {
+		cache->hits++;
+		return true;
+	}
+
+	cache->misses++;
+	return false;
+}
+
 int wlan_hdd_get_station_stats(struct hdd_adapter *adapter)
 {
 	int ret = 0;
 	struct stats_event *stats;
 	struct wlan_objmgr_vdev *vdev;
+	struct hdd_stats_cache *cache = &adapter->sta_stats_cache;
+	uint32_t req_gen;
 
 	if (!get_station_fw_request_needed) {
 		hdd_debug("return cached get_station stats");
 		return 0;
 	}
 
+	/*
+	 * Requests which queue up behind a firmware request in flight are
+	 * answered by its result instead of issuing one each, so that a
+	 * firmware timeout is not waited for once per queued request.
+	 */
+	req_gen = READ_ONCE(cache->req_gen);
+	qdf_mutex_acquire(&cache->lock);
+	if (hdd_sta_stats_cache_valid(adapter, req_gen, &ret))
+		goto unlock;
+
 	vdev = hdd_objmgr_get_vdev(adapter);
-	if (!vdev)
-		return -EINVAL;
+	if (!vdev) {
+		ret = -EINVAL;
+		goto unlock;
+	}
 
 	stats = wlan_cfg80211_mc_cp_stats_get_station_stats(vdev, &ret);
 	if (ret || !stats) {
 		wlan_cfg80211_mc_cp_stats_free_stats_event(stats);
+		hdd_sta_stats_cache_req_done(adapter, ret);
 		goto out;
 	}
 
@@ -6507,8 +6729,12 @@ int wlan_hdd_get_station_stats(struct hdd_adapter *adapter)
 	copy_station_stats_to_adapter(adapter, stats);
 	wlan_cfg80211_mc_cp_stats_free_stats_event(stats);
 
+	hdd_sta_stats_cache_update(adapter);
+
 out:
 	hdd_objmgr_put_vdev(vdev);
+unlock:
+	qdf_mutex_release(&cache->lock);
 	return ret;
 }
 
@@ -6661,6 +6887,13 @@ void wlan_hdd_display_txrx_stats(struct hdd_context *ctx)
 		hdd_debug("TX - called %u, dropped %u orphan %u",
 			  stats->tx_called, stats->tx_dropped,
 			  stats->tx_orphaned);
+		hdd_debug("TX orphan policy - by inflight %u by latency %u inflight %u max %u comp latency %uus max %uus",
+			  stats->tx_orphan_inflight,
+			  stats->tx_orphan_latency,
+			  adapter->tx_orphan.inflight,
+			  stats->tx_inflight_max,
+			  adapter->tx_orphan.latency_us,
+			  stats->tx_comp_latency_max_us);
 
 		for (i = 0; i < NUM_CPUS; i++) {
 			if (stats->rx_packets[i] == 0)
@@ -6679,6 +6912,11 @@ void wlan_hdd_display_txrx_stats(struct hdd_context *ctx)
 			  stats->rx_gro_low_tput_flush,
 			  qdf_atomic_read(&ctx->disable_rx_ol_in_concurrency),
 			  qdf_atomic_read(&ctx->disable_rx_ol_in_low_tput));
+		hdd_debug("RX list - batches %u pkts %u",
+			  stats->rx_list_batches, stats->rx_list_pkts);
+		hdd_debug("RX early demux - hit %u miss %u",
+			  stats->rx_early_demux_hit,
+			  stats->rx_early_demux_miss);
 	}
 }
 
@@ -220,6 +220,22 @@ bool hdd_get_interface_info(struct hdd_adapter *adapter,
 int wlan_hdd_ll_stats_get(struct hdd_adapter *adapter, uint32_t req_id,
 			  uint32_t req_mask);
 
+/**
+ * wlan_hdd_ll_stats_try_get() - Get Link Layer statistics without blocking
+ *	on the rtnl lock
+ * @adapter: Pointer to device adapter
+ * @req_id: request id
+ * @req_mask: bitmask used by FW for the request
+ *
+ * Same as wlan_hdd_ll_stats_get() but fails with -EBUSY instead of waiting
+ * when the rtnl lock is already held. Meant for deferred work that may be
+ * flushed from a context holding the rtnl lock.
+ *
+ * Return: 0 on success and error code otherwise
+ */
+int wlan_hdd_ll_stats_try_get(struct hdd_adapter *adapter, uint32_t req_id,
+			      uint32_t req_mask);
+
 /**
  * wlan_hdd_cfg80211_link_layer_stats_callback() - This function is called
  * @hdd_handle: Handle to HDD context
@@ -285,6 +301,13 @@ wlan_hdd_ll_stats_get(struct hdd_adapter *adapter, uint32_t req_id,
 	return -EINVAL;
 }
 
+static inline int
+wlan_hdd_ll_stats_try_get(struct hdd_adapter *adapter, uint32_t req_id,
+			  uint32_t req_mask)
+{
+	return -EINVAL;
+}
+
 static inline void
 wlan_hdd_clear_link_layer_stats(struct hdd_adapter *adapter)
 {
@@ -363,7 +386,22 @@ int wlan_hdd_cfg80211_dump_station(struct wiphy *wiphy,
 				int idx, u8 *mac,
 				struct station_info *sinfo);
 
-struct net_device_stats *hdd_get_stats(struct net_device *dev);
+/**
+ * hdd_get_stats64() - Function to retrieve interface statistics
+ * @dev: pointer to network device
+ * @stats: statistics to fill
+ *
+ * This function is the ndo_get_stats64 method for all netdevs
+ * registered with the kernel
+ *
+ * Return: None, or @stats on kernels older than 4.11
+ */
+#if (LINUX_VERSION_CODE >= KERNEL_VERSION(4, 11, 0))
+void hdd_get_stats64(struct net_device *dev, struct rtnl_link_stats64 *stats);
+#else
+struct rtnl_link_stats64 *hdd_get_stats64(struct net_device *dev,
+					  struct rtnl_link_stats64 *stats);
+#endif
 
 int wlan_hdd_cfg80211_dump_survey(struct wiphy *wiphy,
 				  struct net_device *dev,
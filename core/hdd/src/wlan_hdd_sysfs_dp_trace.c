@@ -22,6 +22,7 @@
  * dp_trace
  * dump_dp_trace
  * clear_dp_trace
+ * pkt_trace
  */
 
 #include <wlan_hdd_includes.h>
@@ -29,6 +30,10 @@
 #include <wlan_hdd_sysfs.h>
 #include <wlan_hdd_sysfs_dp_trace.h>
 #include "qdf_trace.h"
+#include <cds_pkt_trace.h>
+
+/* max length of one pkt_trace output line */
+#define HDD_SYSFS_PKT_TRACE_LINE_LEN 64
 
 static ssize_t
 __hdd_sysfs_dp_trace_store(struct hdd_context *hdd_ctx,
@@ -79,6 +84,7 @@ __hdd_sysfs_dp_trace_store(struct hdd_context *hdd_ctx,
 		return -EINVAL;
 
 	qdf_dp_trace_set_value(val1, val2, val3);
+	hdd_dp_trace_set_pkt_trace_user(hdd_ctx->config, val1);
 
 	return count;
 }
@@ -298,6 +304,143 @@ static struct kobj_attribute clear_dp_trace_attribute =
 	__ATTR(clear_dp_trace, 0220, NULL,
 	       hdd_sysfs_clear_dp_trace_store);
 
+static ssize_t
+__hdd_sysfs_pkt_trace_store(struct hdd_context *hdd_ctx,
+			    struct kobj_attribute *attr,
+			    char const *buf, size_t count)
+{
+	char buf_local[MAX_SYSFS_USER_COMMAND_SIZE_LENGTH + 1];
+	char *sptr, *token;
+	uint32_t value;
+	int ret;
+
+	if (!wlan_hdd_validate_modules_state(hdd_ctx))
+		return -EINVAL;
+
+	ret = hdd_sysfs_validate_and_copy_buf(buf_local, sizeof(buf_local),
+					      buf, count);
+	if (ret) {
+		hdd_err_rl("invalid input");
+		return ret;
+	}
+
+	sptr = buf_local;
+	token = strsep(&sptr, " ");
+	if (!token)
+		return -EINVAL;
+	if (kstrtou32(token, 0, &value))
+		return -EINVAL;
+
+	hdd_debug("pkt_trace %u", value);
+
+	switch (value) {
+	case HDD_SYSFS_PKT_TRACE_DISABLE:
+		ret = cds_pkt_trace_user_set(CDS_PKT_TRACE_USER_RING, false);
+		break;
+	case HDD_SYSFS_PKT_TRACE_ENABLE:
+		ret = cds_pkt_trace_user_set(CDS_PKT_TRACE_USER_RING, true);
+		break;
+	case HDD_SYSFS_PKT_TRACE_CLEAR:
+		cds_pkt_trace_clear();
+		break;
+	default:
+		hdd_err_rl("invalid input");
+		return -EINVAL;
+	}
+
+	if (ret)
+		return ret;
+
+	return count;
+}
+
+static ssize_t hdd_sysfs_pkt_trace_store(struct kobject *kobj,
+					 struct kobj_attribute *attr,
+					 char const *buf, size_t count)
+{
+	struct osif_psoc_sync *psoc_sync;
+	struct hdd_context *hdd_ctx = cds_get_context(QDF_MODULE_ID_HDD);
+	ssize_t errno_size;
+	int ret;
+
+	ret = wlan_hdd_validate_context(hdd_ctx);
+	if (ret != 0)
+		return ret;
+
+	errno_size = osif_psoc_sync_op_start(wiphy_dev(hdd_ctx->wiphy),
+					     &psoc_sync);
+	if (errno_size)
+		return errno_size;
+
+	errno_size = __hdd_sysfs_pkt_trace_store(hdd_ctx, attr, buf, count);
+
+	osif_psoc_sync_op_stop(psoc_sync);
+
+	return errno_size;
+}
+
+static ssize_t
+__hdd_sysfs_pkt_trace_show(struct hdd_context *hdd_ctx,
+			   struct kobj_attribute *attr, char *buf)
+{
+	struct cds_pkt_trace_rec *recs;
+	uint32_t max, num, i;
+	ssize_t len;
+
+	if (!wlan_hdd_validate_modules_state(hdd_ctx))
+		return -EINVAL;
+
+	len = scnprintf(buf, PAGE_SIZE, "enabled %u\n",
+			cds_pkt_trace_user_enabled(CDS_PKT_TRACE_USER_RING));
+
+	max = (PAGE_SIZE - len) / HDD_SYSFS_PKT_TRACE_LINE_LEN;
+	recs = qdf_mem_malloc(max * sizeof(*recs));
+	if (!recs)
+		return len;
+
+	num = cds_pkt_trace_read(recs, max);
+	for (i = 0; i < num; i++)
+		len += scnprintf(buf + len, PAGE_SIZE - len,
+				 "%llu cpu%u %s vdev %u len %u id %u st %u\n",
+				 recs[i].ts_ns, recs[i].cpu,
+				 cds_pkt_trace_event_name(recs[i].event),
+				 recs[i].vdev_id, recs[i].len,
+				 recs[i].msdu_id, recs[i].status);
+
+	qdf_mem_free(recs);
+
+	return len;
+}
+
+static ssize_t hdd_sysfs_pkt_trace_show(struct kobject *kobj,
+					struct kobj_attribute *attr,
+					char *buf)
+{
+	struct osif_psoc_sync *psoc_sync;
+	struct hdd_context *hdd_ctx = cds_get_context(QDF_MODULE_ID_HDD);
+	ssize_t errno_size;
+	int ret;
+
+	ret = wlan_hdd_validate_context(hdd_ctx);
+	if (ret != 0)
+		return ret;
+
+	errno_size = osif_psoc_sync_op_start(wiphy_dev(hdd_ctx->wiphy),
+					     &psoc_sync);
+	if (errno_size)
+		return errno_size;
+
+	errno_size = __hdd_sysfs_pkt_trace_show(hdd_ctx, attr, buf);
+
+	osif_psoc_sync_op_stop(psoc_sync);
+
+	return errno_size;
+}
+
+static struct kobj_attribute pkt_trace_attribute =
+	__ATTR(pkt_trace, 0660, hdd_sysfs_pkt_trace_show,
+	       hdd_sysfs_pkt_trace_store);
+
 int hdd_sysfs_dp_trace_create(struct kobject *driver_kobject)
 {
 	int error;
@@ -322,6 +465,11 @@ int hdd_sysfs_dp_trace_create(struct kobject *driver_kobject)
 	if (error)
 		hdd_err("could not create clear_dp_trace sysfs file");
 
+	error = sysfs_create_file(driver_kobject,
+				  &pkt_trace_attribute.attr);
+	if (error)
+		hdd_err("could not create pkt_trace sysfs file");
+
 	return error;
 }
 
@@ -332,6 +480,7 @@ hdd_sysfs_dp_trace_destroy(struct kobject *driver_kobject)
 		hdd_err("could not get driver kobject!");
 		return;
 	}
+	sysfs_remove_file(driver_kobject, &pkt_trace_attribute.attr);
 	sysfs_remove_file(driver_kobject, &clear_dp_trace_attribute.attr);
 	sysfs_remove_file(driver_kobject, &dump_dp_trace_attribute.attr);
 	sysfs_remove_file(driver_kobject, &dp_trace_attribute.attr);
@@ -22,6 +22,7 @@
  * dp_trace
  * dump_dp_trace
  * clear_dp_trace
+ * pkt_trace
  */
 
 #ifndef _WLAN_HDD_SYSFS_DP_TRACE_H
@@ -33,6 +34,10 @@
 #define HDD_SYSFS_ENABLE_DP_TRACE_LIVE_MODE 1
 #define HDD_SYSFS_DUMP_DP_TRACE 2
 
+#define HDD_SYSFS_PKT_TRACE_DISABLE 0
+#define HDD_SYSFS_PKT_TRACE_ENABLE 1
+#define HDD_SYSFS_PKT_TRACE_CLEAR 2
+
 /**
  * hdd_sysfs_dp_trace_create() - API to create dp trace related files
  * @driver_kobject: sysfs driver kobject
@@ -40,6 +45,7 @@
  * file path: /sys/kernel/wifi/dp_trace
  *            /sys/kernel/wifi/dump_dp_trace
  *            /sys/kernel/wifi/clear_dp_trace
+ *            /sys/kernel/wifi/pkt_trace
  *
  * usage:
  *      echo [arg_0] [arg_1] [arg_2]> dp_trace
@@ -47,6 +53,13 @@
  *      echo 2 [count] > dump_dp_trace
  *      cat dump_dp_trace
  *      echo 1 > clear_dp_trace
+ *      echo [0/1] > pkt_trace
+ *      echo 2 > pkt_trace
+ *      cat pkt_trace
+ *
+ * pkt_trace enables (1), disables (0) or clears (2) the per CPU packet
+ * trace rings; reading it returns the most recent records of all CPUs
+ * merged by timestamp.
  *
  * Return: 0 on success and errno on failure
  */
@@ -19,7 +19,8 @@
 /**
  *  DOC: wlan_hdd_sysfs_mem_stats.c
  *
- *  Implementation to add sysfs node wlan_mem_stats
+ *  Implementation to add sysfs nodes wlan_mem_stats,
+ *  wlan_dp_prealloc_stats and wlan_mem_acct
  *
  */
 
@@ -28,6 +29,8 @@
 #include <wlan_hdd_sysfs.h>
 #include <qdf_mem.h>
 #include <wlan_hdd_sysfs_mem_stats.h>
+#include <dp_txrx.h>
+#include <cds_mem_acct.h>
 
 static ssize_t __hdd_wlan_mem_stats_show(char *buf)
 {
@@ -62,9 +65,170 @@ static ssize_t hdd_wlan_mem_stats_show(struct kobject *kobj,
 	return length;
 }
 
+static ssize_t hdd_wlan_dp_prealloc_stats_show(struct kobject *kobj,
+					       struct kobj_attribute *attr,
+					       char *buf)
+{
+	struct hdd_context *hdd_ctx = cds_get_context(QDF_MODULE_ID_HDD);
+	struct osif_psoc_sync *psoc_sync;
+	ssize_t length;
+	int errno;
+
+	errno = wlan_hdd_validate_context(hdd_ctx);
+	if (errno)
+		return errno;
+
+	errno = osif_psoc_sync_op_start(hdd_ctx->parent_dev, &psoc_sync);
+	if (errno)
+		return errno;
+
+	length = dp_prealloc_print_stats(buf, PAGE_SIZE);
+
+	osif_psoc_sync_op_stop(psoc_sync);
+
+	return length;
+}
+
+static ssize_t __hdd_wlan_mem_acct_show(char *buf)
+{
+	struct cds_mem_acct_snapshot snap;
+	enum cds_mem_tag tag;
+	ssize_t length;
+
+	length = scnprintf(buf, PAGE_SIZE,
+			   "%-12s %12s %12s %12s %10s %8s %10s\n",
+			   "tag", "cur", "peak", "allocs", "allocs/s",
+			   "fail_int", "injected");
+
+	for (tag = 0; tag < CDS_MEM_TAG_MAX; tag++) {
+		cds_mem_acct_get(tag, &snap);
+		length += scnprintf(buf + length, PAGE_SIZE - length,
+				    "%-12s %12llu %12llu %12llu %10u %8u %10llu\n",
+				    cds_mem_acct_tag_name(tag), snap.cur,
+				    snap.peak, snap.allocs, snap.alloc_rate,
+				    snap.fail_interval, snap.injected);
+	}
+
+	return length;
+}
+
+static ssize_t hdd_wlan_mem_acct_show(struct kobject *kobj,
+				      struct kobj_attribute *attr,
+				      char *buf)
+{
+	struct hdd_context *hdd_ctx = cds_get_context(QDF_MODULE_ID_HDD);
+	struct osif_psoc_sync *psoc_sync;
+	ssize_t length;
+	int errno;
+
+	errno = wlan_hdd_validate_context(hdd_ctx);
+	if (errno)
+		return errno;
+
+	errno = osif_psoc_sync_op_start(hdd_ctx->parent_dev, &psoc_sync);
+	if (errno)
+		return errno;
+
+	length = __hdd_wlan_mem_acct_show(buf);
+
+	osif_psoc_sync_op_stop(psoc_sync);
+
+	return length;
+}
+
+static int hdd_wlan_mem_acct_get_tag(const char *name, enum cds_mem_tag *tag)
+{
+	enum cds_mem_tag i;
+
+	for (i = 0; i < CDS_MEM_TAG_MAX; i++) {
+		if (!strcmp(name, cds_mem_acct_tag_name(i))) {
+			*tag = i;
+			return 0;
+		}
+	}
+
+	return -EINVAL;
+}
+
+static ssize_t
+__hdd_wlan_mem_acct_store(const char *buf, size_t count)
+{
+	char buf_local[MAX_SYSFS_USER_COMMAND_SIZE_LENGTH + 1];
+	char *sptr, *cmd, *token;
+	enum cds_mem_tag tag;
+	uint32_t interval;
+	int ret;
+
+	ret = hdd_sysfs_validate_and_copy_buf(buf_local, sizeof(buf_local),
+					      buf, count);
+	if (ret) {
+		hdd_err_rl("invalid input");
+		return ret;
+	}
+
+	sptr = buf_local;
+	cmd = strsep(&sptr, " ");
+	if (!cmd)
+		return -EINVAL;
+
+	token = strsep(&sptr, " ");
+	if (!token || hdd_wlan_mem_acct_get_tag(token, &tag))
+		return -EINVAL;
+
+	if (!strcmp(cmd, "reset_peak")) {
+		cds_mem_acct_reset_peak(tag);
+	} else if (!strcmp(cmd, "fail")) {
+		token = strsep(&sptr, " ");
+		if (!token)
+			return -EINVAL;
+		if (kstrtou32(token, 0, &interval))
+			return -EINVAL;
+		cds_mem_acct_set_fail_interval(tag, interval);
+	} else {
+		hdd_err_rl("invalid command %s", cmd);
+		return -EINVAL;
+	}
+
+	hdd_debug("wlan_mem_acct %s %s", cmd, cds_mem_acct_tag_name(tag));
+
+	return count;
+}
+
+static ssize_t hdd_wlan_mem_acct_store(struct kobject *kobj,
+				       struct kobj_attribute *attr,
+				       char const *buf, size_t count)
+{
+	struct hdd_context *hdd_ctx = cds_get_context(QDF_MODULE_ID_HDD);
+	struct osif_psoc_sync *psoc_sync;
+	ssize_t errno_size;
+	int ret;
+
+	ret = wlan_hdd_validate_context(hdd_ctx);
+	if (ret)
+		return ret;
+
+	errno_size = osif_psoc_sync_op_start(hdd_ctx->parent_dev, &psoc_sync);
+	if (errno_size)
+		return errno_size;
+
+	errno_size = __hdd_wlan_mem_acct_store(buf, count);
+
+	osif_psoc_sync_op_stop(psoc_sync);
+
+	return errno_size;
+}
+
 static struct kobj_attribute mem_stats_attribute =
 	__ATTR(wlan_mem_stats, 0440, hdd_wlan_mem_stats_show, NULL);
 
+static struct kobj_attribute dp_prealloc_stats_attribute =
+	__ATTR(wlan_dp_prealloc_stats, 0440, hdd_wlan_dp_prealloc_stats_show,
+	       NULL);
+
+static struct kobj_attribute mem_acct_attribute =
+	__ATTR(wlan_mem_acct, 0660, hdd_wlan_mem_acct_show,
+	       hdd_wlan_mem_acct_store);
+
 int hdd_sysfs_mem_stats_create(struct kobject *wlan_kobject)
 {
 	int error;
@@ -77,6 +241,13 @@ int hdd_sysfs_mem_stats_create(struct kobject *wlan_kobject)
 	if (error)
 		hdd_err("Failed to create sysfs file wlan_mem_stats");
 
+	if (sysfs_create_file(wlan_kobject,
+			      &dp_prealloc_stats_attribute.attr))
+		hdd_err("Failed to create sysfs file wlan_dp_prealloc_stats");
+
+	if (sysfs_create_file(wlan_kobject, &mem_acct_attribute.attr))
+		hdd_err("Failed to create sysfs file wlan_mem_acct");
+
 	return error;
 }
 
@@ -86,6 +257,8 @@ void hdd_sysfs_mem_stats_destroy(struct kobject *wlan_kobject)
 		hdd_err("Could not get wlan kobject!");
 		return;
 	}
+	sysfs_remove_file(wlan_kobject, &mem_acct_attribute.attr);
+	sysfs_remove_file(wlan_kobject, &dp_prealloc_stats_attribute.attr);
 	sysfs_remove_file(wlan_kobject, &mem_stats_attribute.attr);
 }
 
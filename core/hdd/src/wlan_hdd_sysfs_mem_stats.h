@@ -35,6 +35,17 @@
  *
  * usage: cat /sys/kernel/wifi/wlan/wlan_mem_stats
  *
+ * Also creates wlan_mem_acct, which shows the current, peak and allocation
+ * rate of each accounted subsystem, and injects allocation failures:
+ *
+ * file path: /sys/kernel/wifi/wlan/wlan_mem_acct
+ *
+ * usage: cat /sys/kernel/wifi/wlan/wlan_mem_acct
+ *        echo "fail <tag> <N>" > /sys/kernel/wifi/wlan/wlan_mem_acct
+ *        echo "reset_peak <tag>" > /sys/kernel/wifi/wlan/wlan_mem_acct
+ *
+ * where every Nth allocation of <tag> fails, 0 stops the injection.
+ *
  * Return: 0 on success and errno on failure
  */
 int hdd_sysfs_mem_stats_create(struct kobject *wlan_kobject);
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2021 The Linux Foundation. All rights reserved.
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/**
+ * DOC: wlan_hdd_sysfs_sta_stats_hist.h
+ *
+ * implementation for creating sysfs file sta_stats_hist
+ */
+
+#ifndef _WLAN_HDD_SYSFS_STA_STATS_HIST_H
+#define _WLAN_HDD_SYSFS_STA_STATS_HIST_H
+
+#if defined(WLAN_SYSFS) && defined(WLAN_STA_STATS_HIST)
+/**
+ * hdd_sysfs_sta_stats_hist_create() - API to create sta_stats_hist
+ * @adapter: pointer to adapter
+ *
+ * this file is created per adapter.
+ * file path: /sys/class/net/wlanxx/sta_stats_hist
+ *                (wlanxx is adapter name)
+ * usage:
+ *      echo [csv|bin] > sta_stats_hist
+ *      cat sta_stats_hist
+ *
+ * Reading returns the station stats history, oldest sample first, as CSV
+ * (the default) or as struct hdd_sta_stats_sample records after "bin" was
+ * written. The rate, RSSI and retry fields come from the last firmware
+ * station stats, fetched at fw_ts_ms; consecutive samples with the same
+ * fw_ts_ms repeat the same firmware values.
+ *
+ * Return: 0 on success and errno on failure
+ */
+int hdd_sysfs_sta_stats_hist_create(struct hdd_adapter *adapter);
+
+/**
+ * hdd_sysfs_sta_stats_hist_destroy() - API to destroy sta_stats_hist
+ * @adapter: pointer to adapter
+ *
+ * Return: none
+ */
+void hdd_sysfs_sta_stats_hist_destroy(struct hdd_adapter *adapter);
+#else
+static inline int
+hdd_sysfs_sta_stats_hist_create(struct hdd_adapter *adapter)
+{
+	return 0;
+}
+
+static inline void
+hdd_sysfs_sta_stats_hist_destroy(struct hdd_adapter *adapter)
+{
+}
+#endif
+#endif /* #ifndef _WLAN_HDD_SYSFS_STA_STATS_HIST_H */
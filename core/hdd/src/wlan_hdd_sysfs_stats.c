@@ -100,6 +100,25 @@ static void hdd_sysfs_get_stats(struct hdd_adapter *adapter, ssize_t *length,
 		stats->txflow_pause_cnt,
 		stats->txflow_unpause_cnt);
 
+	len += scnprintf(buffer + len, buf_len - len,
+		"\nTX_ORPHAN"
+		"\norphaned by inflight %u, by latency %u"
+		"\ninflight %u, max %u"
+		"\ncompletion latency %u us, max %u us\n",
+		stats->tx_orphan_inflight,
+		stats->tx_orphan_latency,
+		adapter->tx_orphan.inflight,
+		stats->tx_inflight_max,
+		adapter->tx_orphan.latency_us,
+		stats->tx_comp_latency_max_us);
+
+	len += scnprintf(buffer + len, buf_len - len,
+		"\nSTA_STATS_CACHE"
+		"\nhits %u, coalesced %u, misses %u\n",
+		adapter->sta_stats_cache.hits,
+		adapter->sta_stats_cache.coalesced,
+		adapter->sta_stats_cache.misses);
+
 	len += cdp_stats(cds_get_context(QDF_MODULE_ID_SOC),
 			 adapter->vdev_id, &buffer[len], (buf_len - len));
 	*length = len + 1;
@@ -29,6 +29,43 @@
 #include "cdp_txrx_cmn_struct.h"
 #include "cdp_txrx_cmn.h"
 
+static ssize_t
+__hdd_sysfs_txrx_stats_show(struct net_device *net_dev, char *buf)
+{
+	struct hdd_adapter *adapter = netdev_priv(net_dev);
+	struct hdd_pkt_stats pkt_stats;
+
+	if (hdd_validate_adapter(adapter))
+		return -EINVAL;
+
+	hdd_get_pkt_stats(adapter, &pkt_stats);
+
+	return scnprintf(buf, PAGE_SIZE,
+			 "tx_packets %llu tx_bytes %llu rx_packets %llu rx_bytes %llu\n",
+			 pkt_stats.tx_packets, pkt_stats.tx_bytes,
+			 pkt_stats.rx_packets, pkt_stats.rx_bytes);
+}
+
+static ssize_t
+hdd_sysfs_txrx_stats_show(struct device *dev,
+			  struct device_attribute *attr,
+			  char *buf)
+{
+	struct net_device *net_dev = container_of(dev, struct net_device, dev);
+	struct osif_vdev_sync *vdev_sync;
+	ssize_t err_size;
+
+	err_size = osif_vdev_sync_op_start(net_dev, &vdev_sync);
+	if (err_size)
+		return err_size;
+
+	err_size = __hdd_sysfs_txrx_stats_show(net_dev, buf);
+
+	osif_vdev_sync_op_stop(vdev_sync);
+
+	return err_size;
+}
+
 static ssize_t
 __hdd_sysfs_txrx_stats_store(struct net_device *net_dev,
 			     char const *buf, size_t count)
@@ -131,8 +168,8 @@ hdd_sysfs_txrx_stats_store(struct device *dev,
 	return errno_size;
 }
 
-static DEVICE_ATTR(txrx_stats, 0220,
-		   NULL, hdd_sysfs_txrx_stats_store);
+static DEVICE_ATTR(txrx_stats, 0660,
+		   hdd_sysfs_txrx_stats_show, hdd_sysfs_txrx_stats_store);
 
 int hdd_sysfs_txrx_stats_create(struct hdd_adapter *adapter)
 {
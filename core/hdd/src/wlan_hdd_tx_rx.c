@@ -65,6 +65,7 @@
 #include <net/ieee80211_radiotap.h>
 #endif
 #include <ol_defines.h>
+#include <ol_txrx_api.h>
 #include "cfg_ucfg_api.h"
 #include "target_type.h"
 #include "wlan_hdd_object_manager.h"
@@ -238,7 +239,9 @@ static inline struct sk_buff *hdd_skb_orphan(struct hdd_adapter *adapter,
 	struct hdd_context *hdd_ctx = WLAN_HDD_GET_CTX(adapter);
 	int need_orphan = 0;
 
-	if (adapter->tx_flow_low_watermark > 0) {
+	if (hdd_tx_orphan_adaptive(hdd_ctx)) {
+		need_orphan = hdd_tx_orphan_policy_check(adapter);
+	} else if (adapter->tx_flow_low_watermark > 0) {
 #if (LINUX_VERSION_CODE > KERNEL_VERSION(3, 19, 0))
 		/*
 		 * The TCP TX throttling logic is changed a little after
@@ -397,13 +400,18 @@ static inline struct sk_buff *hdd_skb_orphan(struct hdd_adapter *adapter,
 		struct sk_buff *skb) {
 
 	struct sk_buff *nskb;
-#if (LINUX_VERSION_CODE > KERNEL_VERSION(3, 19, 0))
 	struct hdd_context *hdd_ctx = WLAN_HDD_GET_CTX(adapter);
-#endif
 
 	hdd_skb_fill_gso_size(adapter->dev, skb);
 
 	nskb = skb_unshare(skb, GFP_ATOMIC);
+	if (hdd_tx_orphan_adaptive(hdd_ctx)) {
+		if (nskb && hdd_tx_orphan_policy_check(adapter)) {
+			++adapter->hdd_stats.tx_rx_stats.tx_orphaned;
+			skb_orphan(nskb);
+		}
+		return nskb;
+	}
 #if (LINUX_VERSION_CODE > KERNEL_VERSION(3, 19, 0))
 	if (unlikely(hdd_ctx->config->tx_orphan_enable) && (nskb == skb)) {
 		/*
@@ -427,14 +435,13 @@ uint32_t hdd_txrx_get_tx_ack_count(struct hdd_adapter *adapter)
 
 #ifdef FEATURE_WLAN_DIAG_SUPPORT
 /**
- * qdf_event_eapol_log() - send event to wlan diag
+ * __hdd_event_eapol_log() - send event to wlan diag
  * @skb: skb ptr
  * @dir: direction
- * @eapol_key_info: eapol key info
  *
  * Return: None
  */
-void hdd_event_eapol_log(struct sk_buff *skb, enum qdf_proto_dir dir)
+void __hdd_event_eapol_log(struct sk_buff *skb, enum qdf_proto_dir dir)
 {
 	int16_t eapol_key_info;
 
@@ -484,21 +491,40 @@ int hdd_set_udp_qos_upgrade_config(struct hdd_adapter *adapter,
 	}
 
 	adapter->upgrade_udp_qos_threshold = priority;
+	hdd_wmm_compile_dscp_map(adapter);
 
 	hdd_debug("UDP packets qos upgrade to: %d", priority);
 
 	return 0;
 }
 
+/**
+ * wlan_hdd_is_dhcp_port() - check for the DHCP server and client ports
+ * @info: parsed header information of an UDP packet
+ *
+ * Return: true if the packet is sent between the DHCP ports
+ */
+static bool wlan_hdd_is_dhcp_port(struct hdd_wmm_pkt_info *info)
+{
+	return (info->src_port == HDD_DHCP_SERVER_PORT &&
+		info->dst_port == HDD_DHCP_CLIENT_PORT) ||
+	       (info->src_port == HDD_DHCP_CLIENT_PORT &&
+		info->dst_port == HDD_DHCP_SERVER_PORT);
+}
+
 /**
  * wlan_hdd_classify_pkt() - classify packet
  * @skb - sk buff
  *
+ * The headers are parsed once by hdd_wmm_parse_pkt(), the packet type is
+ * then derived from the parsed information.
+ *
  * Return: none
  */
 void wlan_hdd_classify_pkt(struct sk_buff *skb)
 {
 	struct ethhdr *eh = (struct ethhdr *)skb->data;
+	struct hdd_wmm_pkt_info info;
 
 	qdf_mem_zero(skb->cb, sizeof(skb->cb));
 
@@ -508,24 +534,38 @@ void wlan_hdd_classify_pkt(struct sk_buff *skb)
 	else if (is_multicast_ether_addr((uint8_t *)eh))
 		QDF_NBUF_CB_GET_IS_MCAST(skb) = true;
 
-	if (qdf_nbuf_is_ipv4_arp_pkt(skb))
+	hdd_wmm_parse_pkt(skb, &info);
+
+	switch (info.ether_type) {
+	case ETH_P_ARP:
 		QDF_NBUF_CB_GET_PACKET_TYPE(skb) =
 			QDF_NBUF_CB_PACKET_TYPE_ARP;
-	else if (qdf_nbuf_is_ipv4_dhcp_pkt(skb))
-		QDF_NBUF_CB_GET_PACKET_TYPE(skb) =
-			QDF_NBUF_CB_PACKET_TYPE_DHCP;
-	else if (qdf_nbuf_is_ipv4_eapol_pkt(skb))
+		break;
+	case HDD_ETHERTYPE_802_1_X:
 		QDF_NBUF_CB_GET_PACKET_TYPE(skb) =
 			QDF_NBUF_CB_PACKET_TYPE_EAPOL;
-	else if (qdf_nbuf_is_ipv4_wapi_pkt(skb))
+		break;
+	case ETH_P_WAI:
 		QDF_NBUF_CB_GET_PACKET_TYPE(skb) =
 			QDF_NBUF_CB_PACKET_TYPE_WAPI;
-	else if (qdf_nbuf_is_icmp_pkt(skb))
-		QDF_NBUF_CB_GET_PACKET_TYPE(skb) =
-			QDF_NBUF_CB_PACKET_TYPE_ICMP;
-	else if (qdf_nbuf_is_icmpv6_pkt(skb))
-		QDF_NBUF_CB_GET_PACKET_TYPE(skb) =
-			QDF_NBUF_CB_PACKET_TYPE_ICMPv6;
+		break;
+	case ETH_P_IP:
+		if (info.ip_proto == IPPROTO_UDP &&
+		    wlan_hdd_is_dhcp_port(&info))
+			QDF_NBUF_CB_GET_PACKET_TYPE(skb) =
+				QDF_NBUF_CB_PACKET_TYPE_DHCP;
+		else if (info.ip_proto == IPPROTO_ICMP)
+			QDF_NBUF_CB_GET_PACKET_TYPE(skb) =
+				QDF_NBUF_CB_PACKET_TYPE_ICMP;
+		break;
+	case ETH_P_IPV6:
+		if (info.ip_proto == IPPROTO_ICMPV6)
+			QDF_NBUF_CB_GET_PACKET_TYPE(skb) =
+				QDF_NBUF_CB_PACKET_TYPE_ICMPv6;
+		break;
+	default:
+		break;
+	}
 }
 
 /**
@@ -545,7 +585,7 @@ static void hdd_clear_tx_rx_connectivity_stats(struct hdd_adapter *adapter)
 		     sizeof(adapter->hdd_stats.hdd_tcp_stats));
 	qdf_mem_zero(&adapter->hdd_stats.hdd_icmpv4_stats,
 		     sizeof(adapter->hdd_stats.hdd_icmpv4_stats));
-	adapter->pkt_type_bitmap = 0;
+	hdd_conn_stats_set_bitmap(adapter, 0);
 	adapter->track_arp_ip = 0;
 	qdf_mem_zero(adapter->dns_payload, adapter->track_dns_domain_len);
 	adapter->track_dns_domain_len = 0;
@@ -572,6 +612,150 @@ void hdd_reset_all_adapters_connectivity_stats(struct hdd_context *hdd_ctx)
 	hdd_exit();
 }
 
+/**
+ * hdd_sum_pkt_stats() - sum the per-CPU tx/rx counters since allocation
+ * @adapter: adapter to read
+ * @total: filled with the aggregated counters
+ *
+ * Return: None
+ */
+static void hdd_sum_pkt_stats(struct hdd_adapter *adapter,
+			      struct hdd_pkt_stats *total)
+{
+	struct hdd_pcpu_pkt_stats *stats;
+	struct hdd_pkt_stats cnt;
+	unsigned int start;
+	int cpu;
+
+	qdf_mem_zero(total, sizeof(*total));
+	for_each_possible_cpu(cpu) {
+		stats = per_cpu_ptr(adapter->pkt_stats, cpu);
+		do {
+			start = u64_stats_fetch_begin(&stats->syncp);
+			cnt = stats->cnt;
+		} while (u64_stats_fetch_retry(&stats->syncp, start));
+
+		total->tx_packets += cnt.tx_packets;
+		total->tx_bytes += cnt.tx_bytes;
+		total->rx_packets += cnt.rx_packets;
+		total->rx_bytes += cnt.rx_bytes;
+	}
+}
+
+void hdd_get_pkt_stats(struct hdd_adapter *adapter,
+		       struct hdd_pkt_stats *total)
+{
+	struct hdd_pkt_stats *base = &adapter->pkt_stats_base;
+
+	if (!adapter->pkt_stats) {
+		qdf_mem_zero(total, sizeof(*total));
+		return;
+	}
+
+	qdf_spin_lock_bh(&adapter->pkt_stats_lock);
+	hdd_sum_pkt_stats(adapter, total);
+	total->tx_packets -= base->tx_packets;
+	total->tx_bytes -= base->tx_bytes;
+	total->rx_packets -= base->rx_packets;
+	total->rx_bytes -= base->rx_bytes;
+	qdf_spin_unlock_bh(&adapter->pkt_stats_lock);
+}
+
+void hdd_reset_pkt_stats(struct hdd_adapter *adapter)
+{
+	if (!adapter->pkt_stats)
+		return;
+
+	qdf_spin_lock_bh(&adapter->pkt_stats_lock);
+	hdd_sum_pkt_stats(adapter, &adapter->pkt_stats_base);
+	qdf_spin_unlock_bh(&adapter->pkt_stats_lock);
+}
+
+/**
+ * hdd_tx_orphan_inflight_get() - tx descriptors in flight on an adapter
+ * @adapter: adapter the skb is sent on
+ *
+ * Return: the datapath count, refreshed at most once per system tick
+ */
+static uint32_t hdd_tx_orphan_inflight_get(struct hdd_adapter *adapter)
+{
+	struct hdd_tx_orphan_ctx *ctx = &adapter->tx_orphan;
+	struct ol_txrx_vdev_tx_load load;
+	unsigned long now = qdf_system_ticks();
+
+	if (READ_ONCE(ctx->refresh_ticks) != now) {
+		if (QDF_IS_STATUS_ERROR(
+			ol_txrx_get_vdev_tx_load(adapter->vdev_id, &load)))
+			load.inflight = 0;
+		WRITE_ONCE(ctx->inflight, load.inflight);
+		WRITE_ONCE(ctx->refresh_ticks, now);
+	}
+
+	return READ_ONCE(ctx->inflight);
+}
+
+bool hdd_tx_orphan_policy_check(struct hdd_adapter *adapter)
+{
+	struct hdd_config *config = adapter->hdd_ctx->config;
+	struct hdd_tx_rx_stats *stats = &adapter->hdd_stats.tx_rx_stats;
+
+	if (config->tx_orphan_inflight_thresh &&
+	    hdd_tx_orphan_inflight_get(adapter) >=
+	    config->tx_orphan_inflight_thresh) {
+		stats->tx_orphan_inflight++;
+		return true;
+	}
+
+	if (config->tx_orphan_latency_thresh_us &&
+	    READ_ONCE(adapter->tx_orphan.latency_us) >=
+	    config->tx_orphan_latency_thresh_us) {
+		stats->tx_orphan_latency++;
+		return true;
+	}
+
+	return false;
+}
+
+void hdd_tx_orphan_policy_update(struct hdd_adapter *adapter)
+{
+	struct hdd_tx_orphan_ctx *ctx = &adapter->tx_orphan;
+	struct hdd_tx_rx_stats *stats = &adapter->hdd_stats.tx_rx_stats;
+	uint32_t interval_us =
+		adapter->hdd_ctx->config->bus_bw_compute_interval * 1000;
+	struct ol_txrx_vdev_tx_load load;
+	uint32_t latency_us;
+	uint32_t completed;
+
+	if (!hdd_tx_orphan_adaptive(adapter->hdd_ctx))
+		return;
+
+	if (QDF_IS_STATUS_ERROR(ol_txrx_get_vdev_tx_load(adapter->vdev_id,
+							 &load))) {
+		WRITE_ONCE(ctx->latency_us, 0);
+		return;
+	}
+
+	/* the datapath count wraps around */
+	completed = load.completed - ctx->completed;
+	ctx->completed = load.completed;
+	WRITE_ONCE(ctx->inflight, load.inflight);
+
+	if (!load.inflight)
+		latency_us = 0;
+	else if (!completed)
+		latency_us = interval_us;
+	else
+		latency_us = qdf_do_div((uint64_t)load.inflight * interval_us,
+					completed);
+
+	WRITE_ONCE(ctx->latency_us, latency_us);
+
+	if (load.inflight > stats->tx_inflight_max)
+		stats->tx_inflight_max = load.inflight;
+	if (latency_us > stats->tx_comp_latency_max_us)
+		stats->tx_comp_latency_max_us = latency_us;
+}
+
 /**
  * hdd_is_tx_allowed() - check if Tx is allowed based on current peer state
  * @skb: pointer to OS packet (sk_buff)
@@ -637,12 +821,306 @@ static bool hdd_tx_rx_is_dns_domain_name_match(struct sk_buff *skb,
 		return false;
 }
 
+/**
+ * hdd_conn_stats_icmpv4() - track ICMPv4 ping packets for connectivity stats
+ * @skb: pointer to skb
+ * @adapter: pointer to adapter
+ * @action: action done on pkt
+ * @pkt_type: data pkt type
+ *
+ * Return: None
+ */
+static void
+hdd_conn_stats_icmpv4(struct sk_buff *skb, struct hdd_adapter *adapter,
+		      enum connectivity_stats_pkt_status action,
+		      uint8_t *pkt_type)
+{
+	switch (action) {
+	case PKT_TYPE_REQ:
+	case PKT_TYPE_TX_HOST_FW_SENT:
+		if (qdf_nbuf_data_is_icmpv4_req(skb) &&
+		    (adapter->track_dest_ipv4 ==
+				qdf_nbuf_get_icmpv4_tgt_ip(skb))) {
+			*pkt_type = CONNECTIVITY_CHECK_SET_ICMPV4;
+			if (action == PKT_TYPE_REQ) {
+				++adapter->hdd_stats.hdd_icmpv4_stats.
+						tx_icmpv4_req_count;
+				QDF_TRACE(QDF_MODULE_ID_HDD_DATA,
+					  QDF_TRACE_LEVEL_INFO_HIGH,
+					  "%s : ICMPv4 Req packet",
+					  __func__);
+			} else
+				/* host receives tx completion */
+				++adapter->hdd_stats.hdd_icmpv4_stats.
+							tx_host_fw_sent;
+		}
+		break;
+	case PKT_TYPE_RSP:
+		if (qdf_nbuf_data_is_icmpv4_rsp(skb) &&
+		    (adapter->track_dest_ipv4 ==
+				qdf_nbuf_get_icmpv4_src_ip(skb))) {
+			++adapter->hdd_stats.hdd_icmpv4_stats.
+						rx_icmpv4_rsp_count;
+			*pkt_type = CONNECTIVITY_CHECK_SET_ICMPV4;
+			QDF_TRACE(QDF_MODULE_ID_HDD_DATA,
+				  QDF_TRACE_LEVEL_INFO_HIGH,
+				  "%s : ICMPv4 Res packet", __func__);
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+/**
+ * hdd_conn_stats_tcp() - track TCP handshake packets for connectivity stats
+ * @skb: pointer to skb
+ * @adapter: pointer to adapter
+ * @action: action done on pkt
+ * @pkt_type: data pkt type
+ *
+ * Return: None
+ */
+static void
+hdd_conn_stats_tcp(struct sk_buff *skb, struct hdd_adapter *adapter,
+		   enum connectivity_stats_pkt_status action,
+		   uint8_t *pkt_type)
+{
+	switch (action) {
+	case PKT_TYPE_REQ:
+	case PKT_TYPE_TX_HOST_FW_SENT:
+		if (qdf_nbuf_data_is_tcp_syn(skb) &&
+		    (adapter->track_dest_port ==
+				qdf_nbuf_data_get_tcp_dst_port(skb))) {
+			*pkt_type = CONNECTIVITY_CHECK_SET_TCP_SYN;
+			if (action == PKT_TYPE_REQ) {
+				++adapter->hdd_stats.hdd_tcp_stats.
+						tx_tcp_syn_count;
+				QDF_TRACE(QDF_MODULE_ID_HDD_DATA,
+					  QDF_TRACE_LEVEL_INFO_HIGH,
+					  "%s : TCP Syn packet",
+					  __func__);
+			} else
+				/* host receives tx completion */
+				++adapter->hdd_stats.hdd_tcp_stats.
+						tx_tcp_syn_host_fw_sent;
+		} else if ((adapter->hdd_stats.hdd_tcp_stats.
+			    is_tcp_syn_ack_rcv || adapter->hdd_stats.
+				hdd_tcp_stats.is_tcp_ack_sent) &&
+			   qdf_nbuf_data_is_tcp_ack(skb) &&
+			   (adapter->track_dest_port ==
+			    qdf_nbuf_data_get_tcp_dst_port(skb))) {
+			*pkt_type = CONNECTIVITY_CHECK_SET_TCP_ACK;
+			if (action == PKT_TYPE_REQ &&
+				adapter->hdd_stats.hdd_tcp_stats.
+						is_tcp_syn_ack_rcv) {
+				++adapter->hdd_stats.hdd_tcp_stats.
+						tx_tcp_ack_count;
+				adapter->hdd_stats.hdd_tcp_stats.
+					is_tcp_syn_ack_rcv = false;
+				adapter->hdd_stats.hdd_tcp_stats.
+					is_tcp_ack_sent = true;
+				QDF_TRACE(QDF_MODULE_ID_HDD_DATA,
+					  QDF_TRACE_LEVEL_INFO_HIGH,
+					  "%s : TCP Ack packet",
+					  __func__);
+			} else if (action == PKT_TYPE_TX_HOST_FW_SENT &&
+				adapter->hdd_stats.hdd_tcp_stats.
+						is_tcp_ack_sent) {
+				/* host receives tx completion */
+				++adapter->hdd_stats.hdd_tcp_stats.
+						tx_tcp_ack_host_fw_sent;
+				adapter->hdd_stats.hdd_tcp_stats.
+						is_tcp_ack_sent = false;
+			}
+		}
+		break;
+	case PKT_TYPE_RSP:
+		if (qdf_nbuf_data_is_tcp_syn_ack(skb) &&
+		    (adapter->track_dest_port ==
+				qdf_nbuf_data_get_tcp_src_port(skb))) {
+			++adapter->hdd_stats.hdd_tcp_stats.
+						rx_tcp_syn_ack_count;
+			adapter->hdd_stats.hdd_tcp_stats.
+				is_tcp_syn_ack_rcv = true;
+			*pkt_type = CONNECTIVITY_CHECK_SET_TCP_SYN_ACK;
+			QDF_TRACE(QDF_MODULE_ID_HDD_DATA,
+				  QDF_TRACE_LEVEL_INFO_HIGH,
+				  "%s : TCP Syn ack packet", __func__);
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+/**
+ * hdd_conn_stats_dns() - track DNS packets for connectivity stats
+ * @skb: pointer to skb
+ * @adapter: pointer to adapter
+ * @action: action done on pkt
+ * @pkt_type: data pkt type
+ *
+ * Return: None
+ */
+static void
+hdd_conn_stats_dns(struct sk_buff *skb, struct hdd_adapter *adapter,
+		   enum connectivity_stats_pkt_status action,
+		   uint8_t *pkt_type)
+{
+	switch (action) {
+	case PKT_TYPE_REQ:
+	case PKT_TYPE_TX_HOST_FW_SENT:
+		if (qdf_nbuf_data_is_dns_query(skb) &&
+		    hdd_tx_rx_is_dns_domain_name_match(skb, adapter)) {
+			*pkt_type = CONNECTIVITY_CHECK_SET_DNS;
+			if (action == PKT_TYPE_REQ) {
+				++adapter->hdd_stats.hdd_dns_stats.
+						tx_dns_req_count;
+				QDF_TRACE(QDF_MODULE_ID_HDD_DATA,
+					  QDF_TRACE_LEVEL_INFO_HIGH,
+					  "%s : DNS query packet",
+					  __func__);
+			} else
+				/* host receives tx completion */
+				++adapter->hdd_stats.hdd_dns_stats.
+							tx_host_fw_sent;
+		}
+		break;
+	case PKT_TYPE_RSP:
+		if (qdf_nbuf_data_is_dns_response(skb) &&
+		    hdd_tx_rx_is_dns_domain_name_match(skb, adapter)) {
+			++adapter->hdd_stats.hdd_dns_stats.
+						rx_dns_rsp_count;
+			*pkt_type = CONNECTIVITY_CHECK_SET_DNS;
+			QDF_TRACE(QDF_MODULE_ID_HDD_DATA,
+				  QDF_TRACE_LEVEL_INFO_HIGH,
+				  "%s : DNS response packet", __func__);
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+/**
+ * hdd_conn_stats_run_op() - run one op of the connectivity stats program
+ * @ip_proto: IPv4 protocol the op matches
+ * @skb: pointer to skb
+ * @adapter: pointer to adapter
+ * @action: action done on pkt
+ * @pkt_type: data pkt type
+ *
+ * Return: None
+ */
+static void hdd_conn_stats_run_op(uint8_t ip_proto, struct sk_buff *skb,
+				  struct hdd_adapter *adapter,
+				  enum connectivity_stats_pkt_status action,
+				  uint8_t *pkt_type)
+{
+	switch (ip_proto) {
+	case IPPROTO_ICMP:
+		hdd_conn_stats_icmpv4(skb, adapter, action, pkt_type);
+		break;
+	case IPPROTO_TCP:
+		hdd_conn_stats_tcp(skb, adapter, action, pkt_type);
+		break;
+	case IPPROTO_UDP:
+		hdd_conn_stats_dns(skb, adapter, action, pkt_type);
+		break;
+	default:
+		break;
+	}
+}
+
+/**
+ * hdd_conn_stats_match() - run the connectivity stats program on a packet
+ * @skb: pointer to skb
+ * @adapter: pointer to adapter
+ * @action: action done on pkt
+ * @pkt_type: data pkt type
+ *
+ * The IPv4 header is read once and only the op compiled for its protocol,
+ * if any, inspects the packet further.
+ *
+ * Return: None
+ */
+static void hdd_conn_stats_match(struct sk_buff *skb,
+				 struct hdd_adapter *adapter,
+				 enum connectivity_stats_pkt_status action,
+				 uint8_t *pkt_type)
+{
+	struct hdd_conn_stats_prog *prog = &adapter->conn_stats_prog;
+	uint8_t ip_proto;
+	uint8_t i;
+
+	if (!qdf_nbuf_is_ipv4_pkt(skb))
+		return;
+
+	ip_proto = qdf_nbuf_data_get_ipv4_proto(qdf_nbuf_data(skb));
+	for (i = 0; i < prog->num_ops; i++) {
+		if (prog->ip_proto[i] == ip_proto) {
+			hdd_conn_stats_run_op(ip_proto, skb, adapter, action,
+					      pkt_type);
+			break;
+		}
+	}
+}
+
+#if (LINUX_VERSION_CODE >= KERNEL_VERSION(4, 3, 0))
+DEFINE_STATIC_KEY_FALSE(hdd_conn_stats_key);
+
+static inline void hdd_conn_stats_key_inc(void)
+{
+	static_branch_inc(&hdd_conn_stats_key);
+}
+
+static inline void hdd_conn_stats_key_dec(void)
+{
+	static_branch_dec(&hdd_conn_stats_key);
+}
+#else
+static inline void hdd_conn_stats_key_inc(void)
+{
+}
+
+static inline void hdd_conn_stats_key_dec(void)
+{
+}
+#endif
+
+void hdd_conn_stats_set_bitmap(struct hdd_adapter *adapter,
+			       uint32_t pkt_type_bitmap)
+{
+	struct hdd_conn_stats_prog *prog = &adapter->conn_stats_prog;
+	uint8_t old_num_ops = prog->num_ops;
+	uint8_t num_ops = 0;
+
+	/* ARP is tracked separately in the rx path, see hdd_rx_packet_cbk */
+	if (pkt_type_bitmap & CONNECTIVITY_CHECK_SET_ICMPV4)
+		prog->ip_proto[num_ops++] = IPPROTO_ICMP;
+	if (pkt_type_bitmap & (CONNECTIVITY_CHECK_SET_TCP_HANDSHAKE |
+			       CONNECTIVITY_CHECK_SET_TCP_SYN |
+			       CONNECTIVITY_CHECK_SET_TCP_SYN_ACK |
+			       CONNECTIVITY_CHECK_SET_TCP_ACK))
+		prog->ip_proto[num_ops++] = IPPROTO_TCP;
+	if (pkt_type_bitmap & CONNECTIVITY_CHECK_SET_DNS)
+		prog->ip_proto[num_ops++] = IPPROTO_UDP;
+
+	WRITE_ONCE(prog->num_ops, num_ops);
+	adapter->pkt_type_bitmap = pkt_type_bitmap;
+
+	if (!old_num_ops && num_ops)
+		hdd_conn_stats_key_inc();
+	else if (old_num_ops && !num_ops)
+		hdd_conn_stats_key_dec();
+}
+
 void hdd_tx_rx_collect_connectivity_stats_info(struct sk_buff *skb,
 			void *context,
 			enum connectivity_stats_pkt_status action,
 			uint8_t *pkt_type)
 {
-	uint32_t pkt_type_bitmap;
 	struct hdd_adapter *adapter = NULL;
 
 	adapter = (struct hdd_adapter *)context;
@@ -654,135 +1132,14 @@ void hdd_tx_rx_collect_connectivity_stats_info(struct sk_buff *skb,
 	}
 
 	/* ARP tracking is done already. */
-	pkt_type_bitmap = adapter->pkt_type_bitmap;
-	pkt_type_bitmap &= ~CONNECTIVITY_CHECK_SET_ARP;
-
-	if (!pkt_type_bitmap)
+	if (!hdd_conn_stats_enabled(adapter))
 		return;
 
 	switch (action) {
 	case PKT_TYPE_REQ:
 	case PKT_TYPE_TX_HOST_FW_SENT:
-		if (qdf_nbuf_is_icmp_pkt(skb)) {
-			if (qdf_nbuf_data_is_icmpv4_req(skb) &&
-			    (adapter->track_dest_ipv4 ==
-					qdf_nbuf_get_icmpv4_tgt_ip(skb))) {
-				*pkt_type = CONNECTIVITY_CHECK_SET_ICMPV4;
-				if (action == PKT_TYPE_REQ) {
-					++adapter->hdd_stats.hdd_icmpv4_stats.
-							tx_icmpv4_req_count;
-					QDF_TRACE(QDF_MODULE_ID_HDD_DATA,
-						  QDF_TRACE_LEVEL_INFO_HIGH,
-						  "%s : ICMPv4 Req packet",
-						  __func__);
-				} else
-					/* host receives tx completion */
-					++adapter->hdd_stats.hdd_icmpv4_stats.
-								tx_host_fw_sent;
-			}
-		} else if (qdf_nbuf_is_ipv4_tcp_pkt(skb)) {
-			if (qdf_nbuf_data_is_tcp_syn(skb) &&
-			    (adapter->track_dest_port ==
-					qdf_nbuf_data_get_tcp_dst_port(skb))) {
-				*pkt_type = CONNECTIVITY_CHECK_SET_TCP_SYN;
-				if (action == PKT_TYPE_REQ) {
-					++adapter->hdd_stats.hdd_tcp_stats.
-							tx_tcp_syn_count;
-					QDF_TRACE(QDF_MODULE_ID_HDD_DATA,
-						  QDF_TRACE_LEVEL_INFO_HIGH,
-						  "%s : TCP Syn packet",
-						  __func__);
-				} else
-					/* host receives tx completion */
-					++adapter->hdd_stats.hdd_tcp_stats.
-							tx_tcp_syn_host_fw_sent;
-			} else if ((adapter->hdd_stats.hdd_tcp_stats.
-				    is_tcp_syn_ack_rcv || adapter->hdd_stats.
-					hdd_tcp_stats.is_tcp_ack_sent) &&
-				   qdf_nbuf_data_is_tcp_ack(skb) &&
-				   (adapter->track_dest_port ==
-				    qdf_nbuf_data_get_tcp_dst_port(skb))) {
-				*pkt_type = CONNECTIVITY_CHECK_SET_TCP_ACK;
-				if (action == PKT_TYPE_REQ &&
-					adapter->hdd_stats.hdd_tcp_stats.
-							is_tcp_syn_ack_rcv) {
-					++adapter->hdd_stats.hdd_tcp_stats.
-							tx_tcp_ack_count;
-					adapter->hdd_stats.hdd_tcp_stats.
-						is_tcp_syn_ack_rcv = false;
-					adapter->hdd_stats.hdd_tcp_stats.
-						is_tcp_ack_sent = true;
-					QDF_TRACE(QDF_MODULE_ID_HDD_DATA,
-						  QDF_TRACE_LEVEL_INFO_HIGH,
-						  "%s : TCP Ack packet",
-						  __func__);
-				} else if (action == PKT_TYPE_TX_HOST_FW_SENT &&
-					adapter->hdd_stats.hdd_tcp_stats.
-							is_tcp_ack_sent) {
-					/* host receives tx completion */
-					++adapter->hdd_stats.hdd_tcp_stats.
-							tx_tcp_ack_host_fw_sent;
-					adapter->hdd_stats.hdd_tcp_stats.
-							is_tcp_ack_sent = false;
-				}
-			}
-		} else if (qdf_nbuf_is_ipv4_udp_pkt(skb)) {
-			if (qdf_nbuf_data_is_dns_query(skb) &&
-			    hdd_tx_rx_is_dns_domain_name_match(skb, adapter)) {
-				*pkt_type = CONNECTIVITY_CHECK_SET_DNS;
-				if (action == PKT_TYPE_REQ) {
-					++adapter->hdd_stats.hdd_dns_stats.
-							tx_dns_req_count;
-					QDF_TRACE(QDF_MODULE_ID_HDD_DATA,
-						  QDF_TRACE_LEVEL_INFO_HIGH,
-						  "%s : DNS query packet",
-						  __func__);
-				} else
-					/* host receives tx completion */
-					++adapter->hdd_stats.hdd_dns_stats.
-								tx_host_fw_sent;
-			}
-		}
-		break;
-
 	case PKT_TYPE_RSP:
-		if (qdf_nbuf_is_icmp_pkt(skb)) {
-			if (qdf_nbuf_data_is_icmpv4_rsp(skb) &&
-			    (adapter->track_dest_ipv4 ==
-					qdf_nbuf_get_icmpv4_src_ip(skb))) {
-				++adapter->hdd_stats.hdd_icmpv4_stats.
-							rx_icmpv4_rsp_count;
-				*pkt_type =
-				CONNECTIVITY_CHECK_SET_ICMPV4;
-				QDF_TRACE(QDF_MODULE_ID_HDD_DATA,
-					  QDF_TRACE_LEVEL_INFO_HIGH,
-					  "%s : ICMPv4 Res packet", __func__);
-			}
-		} else if (qdf_nbuf_is_ipv4_tcp_pkt(skb)) {
-			if (qdf_nbuf_data_is_tcp_syn_ack(skb) &&
-			    (adapter->track_dest_port ==
-					qdf_nbuf_data_get_tcp_src_port(skb))) {
-				++adapter->hdd_stats.hdd_tcp_stats.
-							rx_tcp_syn_ack_count;
-				adapter->hdd_stats.hdd_tcp_stats.
-					is_tcp_syn_ack_rcv = true;
-				*pkt_type =
-				CONNECTIVITY_CHECK_SET_TCP_SYN_ACK;
-				QDF_TRACE(QDF_MODULE_ID_HDD_DATA,
-					  QDF_TRACE_LEVEL_INFO_HIGH,
-					  "%s : TCP Syn ack packet", __func__);
-			}
-		} else if (qdf_nbuf_is_ipv4_udp_pkt(skb)) {
-			if (qdf_nbuf_data_is_dns_response(skb) &&
-			    hdd_tx_rx_is_dns_domain_name_match(skb, adapter)) {
-				++adapter->hdd_stats.hdd_dns_stats.
-							rx_dns_rsp_count;
-				*pkt_type = CONNECTIVITY_CHECK_SET_DNS;
-				QDF_TRACE(QDF_MODULE_ID_HDD_DATA,
-					  QDF_TRACE_LEVEL_INFO_HIGH,
-					  "%s : DNS response packet", __func__);
-			}
-		}
+		hdd_conn_stats_match(skb, adapter, action, pkt_type);
 		break;
 
 	case PKT_TYPE_TX_DROPPED:
@@ -1107,7 +1464,7 @@ static void __hdd_hard_start_xmit(struct sk_buff *skb,
 	}
 
 	/* track connectivity stats */
-	if (adapter->pkt_type_bitmap)
+	if (hdd_conn_stats_enabled(adapter))
 		hdd_tx_rx_collect_connectivity_stats_info(skb, adapter,
 						PKT_TYPE_REQ, &pkt_type);
 
@@ -1212,8 +1569,6 @@ static void __hdd_hard_start_xmit(struct sk_buff *skb,
 		skb->queue_mapping = hdd_linux_up_to_ac_map[up];
 	}
 
-	adapter->stats.tx_bytes += skb->len;
-
 	vdev = hdd_objmgr_get_vdev(adapter);
 	if (vdev) {
 		ucfg_tdls_update_tx_pkt_cnt(vdev, &mac_addr);
@@ -1221,9 +1576,10 @@ static void __hdd_hard_start_xmit(struct sk_buff *skb,
 	}
 
 	if (qdf_nbuf_is_tso(skb)) {
-		adapter->stats.tx_packets += qdf_nbuf_get_tso_num_seg(skb);
+		hdd_pkt_stats_tx_add(adapter, qdf_nbuf_get_tso_num_seg(skb),
+				     skb->len);
 	} else {
-		++adapter->stats.tx_packets;
+		hdd_pkt_stats_tx_add(adapter, 1, skb->len);
 		hdd_ctx->no_tx_offload_pkt_cnt++;
 	}
 
@@ -1292,7 +1648,7 @@ drop_pkt_and_release_skb:
 drop_pkt:
 
 	/* track connectivity stats */
-	if (adapter->pkt_type_bitmap)
+	if (hdd_conn_stats_enabled(adapter))
 		hdd_tx_rx_collect_connectivity_stats_info(skb, adapter,
 							  PKT_TYPE_TX_DROPPED,
 							  &pkt_type);
@@ -1499,6 +1855,7 @@ QDF_STATUS hdd_mon_rx_packet_cbk(void *context, qdf_nbuf_t rxbuf)
 	struct sk_buff *skb;
 	struct sk_buff *skb_next;
 	unsigned int cpu_index;
+	uint32_t rx_packets = 0, rx_bytes = 0;
 
 	/* Sanity check on inputs */
 	if ((!context) || (!rxbuf)) {
@@ -1523,8 +1880,8 @@ QDF_STATUS hdd_mon_rx_packet_cbk(void *context, qdf_nbuf_t rxbuf)
 		skb->dev = adapter->dev;
 
 		++adapter->hdd_stats.tx_rx_stats.rx_packets[cpu_index];
-		++adapter->stats.rx_packets;
-		adapter->stats.rx_bytes += skb->len;
+		rx_packets++;
+		rx_bytes += skb->len;
 
 		/* Remove SKB from internal tracking table before submitting
 		 * it to stack
@@ -1554,6 +1911,8 @@ QDF_STATUS hdd_mon_rx_packet_cbk(void *context, qdf_nbuf_t rxbuf)
 		skb = skb_next;
 	}
 
+	hdd_pkt_stats_rx_add(adapter, rx_packets, rx_bytes);
+
 	return QDF_STATUS_SUCCESS;
 }
 #endif
@@ -2159,9 +2518,201 @@ QDF_STATUS hdd_rx_pkt_thread_enqueue_cbk(void *adapter,
 	return dp_rx_enqueue_pkt(cds_get_context(QDF_MODULE_ID_SOC), nbuf_list);
 }
 
-#ifdef CONFIG_HL_SUPPORT
+#if (LINUX_VERSION_CODE >= KERNEL_VERSION(4, 19, 0)) && \
+	!defined(CONFIG_HL_SUPPORT)
+void hdd_rx_batch_init(struct hdd_adapter *adapter,
+		       struct hdd_rx_batch *batch)
+{
+	struct hdd_context *hdd_ctx = adapter->hdd_ctx;
+
+	INIT_LIST_HEAD(&batch->list);
+	batch->count = 0;
+	batch->enabled = hdd_ctx->config->rx_list_delivery &&
+			 (hdd_ctx->enable_dp_rx_threads ||
+			  hdd_ctx->enable_rxthread) &&
+			 !adapter->runtime_disable_rx_thread;
+}
+
+/**
+ * hdd_rx_batch_add() - queue an rx frame on a batch for list delivery
+ * @batch: rx batch, may be NULL
+ * @skb: frame to be queued
+ *
+ * Only frames not taken by GRO are batched. GRO eligible frames go to
+ * napi_gro_receive() of the rx thread's NAPI through receive_offload_cb,
+ * which already hands its output to the stack as a list.
+ *
+ * Return: true if the frame is queued, false if it has to be delivered
+ *	   by the caller
+ */
+static inline bool hdd_rx_batch_add(struct hdd_rx_batch *batch,
+				    struct sk_buff *skb)
+{
+	if (!batch || !batch->enabled)
+		return false;
+
+	list_add_tail(&skb->list, &batch->list);
+	batch->count++;
+
+	return true;
+}
+
+uint32_t hdd_rx_batch_flush(struct hdd_adapter *adapter,
+			    struct hdd_rx_batch *batch)
+{
+	uint32_t count = batch->count;
+
+	if (!count)
+		return 0;
+
+	local_bh_disable();
+	netif_receive_skb_list(&batch->list);
+	local_bh_enable();
+
+	adapter->hdd_stats.tx_rx_stats.rx_list_batches++;
+	adapter->hdd_stats.tx_rx_stats.rx_list_pkts += count;
+
+	INIT_LIST_HEAD(&batch->list);
+	batch->count = 0;
+
+	return count;
+}
+#else
+void hdd_rx_batch_init(struct hdd_adapter *adapter,
+		       struct hdd_rx_batch *batch)
+{
+	INIT_LIST_HEAD(&batch->list);
+	batch->count = 0;
+	batch->enabled = false;
+}
+
+static inline bool hdd_rx_batch_add(struct hdd_rx_batch *batch,
+				    struct sk_buff *skb)
+{
+	return false;
+}
+
+uint32_t hdd_rx_batch_flush(struct hdd_adapter *adapter,
+			    struct hdd_rx_batch *batch)
+{
+	return 0;
+}
+#endif
+
+#if (LINUX_VERSION_CODE >= KERNEL_VERSION(5, 7, 0))
+#if (LINUX_VERSION_CODE >= KERNEL_VERSION(6, 1, 0))
+#define hdd_tcp_hashinfo(net) ((net)->ipv4.tcp_death_row.hashinfo)
+#else
+#define hdd_tcp_hashinfo(net) (&tcp_hashinfo)
+#endif
+
+#if (LINUX_VERSION_CODE >= KERNEL_VERSION(5, 16, 0))
+#define hdd_sk_rx_dst(sk) rcu_dereference((sk)->sk_rx_dst)
+#else
+#define hdd_sk_rx_dst(sk) READ_ONCE((sk)->sk_rx_dst)
+#endif
+
+#if (LINUX_VERSION_CODE >= KERNEL_VERSION(5, 15, 0))
+#define hdd_sk_rx_dst_ifindex(sk) ((sk)->sk_rx_dst_ifindex)
+#else
+#define hdd_sk_rx_dst_ifindex(sk) (inet_sk(sk)->rx_dst_ifindex)
+#endif
+
+/**
+ * hdd_rx_early_demux() - Attach an established TCP socket to an rx frame
+ * @adapter: pointer to adapter context
+ * @skb: frame to be delivered, after eth_type_trans()
+ *
+ * Looks up the established TCP socket of a locally terminated IPv4 frame
+ * and attaches it, together with the input route cached on the socket,
+ * as a prefetched socket. The IP layer then skips its own early demux and
+ * route lookup and tcp_v4_rcv() uses the socket without a second lookup.
+ * Frames which do not match are left untouched.
+ *
+ * Return: None
+ */
+static void hdd_rx_early_demux(struct hdd_adapter *adapter,
+			       struct sk_buff *skb)
+{
+	struct net_device *dev = skb->dev;
+	struct net *net = dev_net(dev);
+	const struct iphdr *iph;
+	const struct tcphdr *th;
+	struct dst_entry *dst;
+	struct sock *sk;
+
+	if (skb->protocol != htons(ETH_P_IP) ||
+	    skb->pkt_type != PACKET_HOST || skb->sk)
+		return;
+
+	if (!pskb_may_pull(skb, sizeof(*iph)))
+		return;
+
+	/*
+	 * Nothing on the rx path has set the network header yet, it is set
+	 * here from the frame and set again by the stack on delivery.
+	 */
+	skb_reset_network_header(skb);
+	iph = ip_hdr(skb);
+	if (iph->ihl < 5 || iph->protocol != IPPROTO_TCP ||
+	    ip_is_fragment(iph))
+		return;
+
+	if (!pskb_may_pull(skb, iph->ihl * 4 + sizeof(*th)))
+		return;
+
+	iph = ip_hdr(skb);
+	skb_set_transport_header(skb, iph->ihl * 4);
+	th = tcp_hdr(skb);
+
+	rcu_read_lock();
+	sk = __inet_lookup_established(net, hdd_tcp_hashinfo(net),
+				       iph->saddr, th->source,
+				       iph->daddr, ntohs(th->dest),
+				       dev->ifindex, 0);
+	if (!sk) {
+		rcu_read_unlock();
+		adapter->hdd_stats.tx_rx_stats.rx_early_demux_miss++;
+		return;
+	}
+
+	if (!sk_fullsock(sk)) {
+		rcu_read_unlock();
+		sock_gen_put(sk);
+		adapter->hdd_stats.tx_rx_stats.rx_early_demux_miss++;
+		return;
+	}
+
+	skb->sk = sk;
+	skb->destructor = sock_pfree;
+
+	dst = hdd_sk_rx_dst(sk);
+	if (dst)
+		dst = dst_check(dst, 0);
+	if (dst && hdd_sk_rx_dst_ifindex(sk) == dev->ifindex &&
+	    dst_hold_safe(dst))
+		skb_dst_set(skb, dst);
+	rcu_read_unlock();
+
+	adapter->hdd_stats.tx_rx_stats.rx_early_demux_hit++;
+}
+#else
+static inline void hdd_rx_early_demux(struct hdd_adapter *adapter,
+				      struct sk_buff *skb)
+{
+}
+#endif
+
 QDF_STATUS hdd_rx_deliver_to_stack(struct hdd_adapter *adapter,
 				   struct sk_buff *skb)
+{
+	return hdd_rx_deliver_to_stack_batch(adapter, skb, NULL);
+}
+
+#ifdef CONFIG_HL_SUPPORT
+QDF_STATUS hdd_rx_deliver_to_stack_batch(struct hdd_adapter *adapter,
+					 struct sk_buff *skb,
+					 struct hdd_rx_batch *batch)
 {
 	struct hdd_context *hdd_ctx = adapter->hdd_ctx;
 	int status = QDF_STATUS_E_FAILURE;
@@ -2273,8 +2824,9 @@ reset_wl:
 	}
 }
 
-QDF_STATUS hdd_rx_deliver_to_stack(struct hdd_adapter *adapter,
-				   struct sk_buff *skb)
+QDF_STATUS hdd_rx_deliver_to_stack_batch(struct hdd_adapter *adapter,
+					 struct sk_buff *skb,
+					 struct hdd_rx_batch *batch)
 {
 	struct hdd_context *hdd_ctx = adapter->hdd_ctx;
 	int status = QDF_STATUS_E_FAILURE;
@@ -2324,6 +2876,12 @@ QDF_STATUS hdd_rx_deliver_to_stack(struct hdd_adapter *adapter,
 	if (qdf_likely((hdd_ctx->enable_dp_rx_threads ||
 		        hdd_ctx->enable_rxthread) &&
 		        !adapter->runtime_disable_rx_thread)) {
+		if (hdd_ctx->config->rx_early_demux)
+			hdd_rx_early_demux(adapter, skb);
+
+		if (hdd_rx_batch_add(batch, skb))
+			return QDF_STATUS_E_PENDING;
+
 		local_bh_disable();
 		netif_status = netif_receive_skb(skb);
 		local_bh_enable();
@@ -2348,8 +2906,9 @@ QDF_STATUS hdd_rx_deliver_to_stack(struct hdd_adapter *adapter,
 
 #else /* WLAN_FEATURE_DYNAMIC_RX_AGGREGATION */
 
-QDF_STATUS hdd_rx_deliver_to_stack(struct hdd_adapter *adapter,
-				   struct sk_buff *skb)
+QDF_STATUS hdd_rx_deliver_to_stack_batch(struct hdd_adapter *adapter,
+					 struct sk_buff *skb,
+					 struct hdd_rx_batch *batch)
 {
 	struct hdd_context *hdd_ctx = adapter->hdd_ctx;
 	int status = QDF_STATUS_E_FAILURE;
@@ -2383,6 +2942,12 @@ QDF_STATUS hdd_rx_deliver_to_stack(struct hdd_adapter *adapter,
 	if (qdf_likely((hdd_ctx->enable_dp_rx_threads ||
 		        hdd_ctx->enable_rxthread) &&
 		        !adapter->runtime_disable_rx_thread)) {
+		if (hdd_ctx->config->rx_early_demux)
+			hdd_rx_early_demux(adapter, skb);
+
+		if (hdd_rx_batch_add(batch, skb))
+			return QDF_STATUS_E_PENDING;
+
 		local_bh_disable();
 		netif_status = netif_receive_skb(skb);
 		local_bh_enable();
@@ -2484,6 +3049,9 @@ QDF_STATUS hdd_rx_packet_cbk(void *adapter_context,
 	unsigned int cpu_index;
 	struct qdf_mac_addr *mac_addr, *dest_mac_addr;
 	bool wake_lock = false;
+	bool wake_lock_check;
+	uint32_t rx_packets = 0, rx_bytes = 0;
+	struct hdd_rx_batch batch;
 	uint8_t pkt_type = 0;
 	bool track_arp = false;
 	struct wlan_objmgr_vdev *vdev;
@@ -2515,6 +3083,17 @@ QDF_STATUS hdd_rx_packet_cbk(void *adapter_context,
 
 	cpu_index = wlan_hdd_get_cpu();
 
+	/*
+	 * Per adapter state which cannot change within one rx batch is
+	 * looked up once here rather than for every frame of the batch.
+	 */
+	sta_ctx = WLAN_HDD_GET_STATION_CTX_PTR(adapter);
+	vdev = hdd_objmgr_get_vdev(adapter);
+	wake_lock_check = !hdd_is_current_high_throughput(hdd_ctx) &&
+			  hdd_ctx->config->rx_wakelock_timeout &&
+			  sta_ctx->conn_info.is_authenticated;
+	hdd_rx_batch_init(adapter, &batch);
+
 	next = (struct sk_buff *)rxBuf;
 
 	while (next) {
@@ -2560,11 +3139,10 @@ QDF_STATUS hdd_rx_packet_cbk(void *adapter_context,
 			}
 		}
 		/* track connectivity stats */
-		if (adapter->pkt_type_bitmap)
+		if (hdd_conn_stats_enabled(adapter))
 			hdd_tx_rx_collect_connectivity_stats_info(skb, adapter,
 						PKT_TYPE_RSP, &pkt_type);
 
-		sta_ctx = WLAN_HDD_GET_STATION_CTX_PTR(adapter);
 		if ((sta_ctx->conn_info.proxy_arp_service) &&
 		    hdd_is_gratuitous_arp_unsolicited_na(skb)) {
 			qdf_atomic_inc(&adapter->hdd_stats.tx_rx_stats.
@@ -2593,20 +3171,16 @@ QDF_STATUS hdd_rx_packet_cbk(void *adapter_context,
 		dest_mac_addr = (struct qdf_mac_addr *)(skb->data);
 		mac_addr = (struct qdf_mac_addr *)(skb->data+QDF_MAC_ADDR_SIZE);
 
-		vdev = hdd_objmgr_get_vdev(adapter);
-		if (vdev) {
+		if (vdev)
 			ucfg_tdls_update_rx_pkt_cnt(vdev, mac_addr,
 						    dest_mac_addr);
-			hdd_objmgr_put_vdev(vdev);
-		}
 
 		skb->dev = adapter->dev;
 		skb->protocol = eth_type_trans(skb, skb->dev);
 		++adapter->hdd_stats.tx_rx_stats.rx_packets[cpu_index];
-		++adapter->stats.rx_packets;
 		/* count aggregated RX frame into stats */
-		adapter->stats.rx_packets += qdf_nbuf_get_gso_segs(skb);
-		adapter->stats.rx_bytes += skb->len;
+		rx_packets += 1 + qdf_nbuf_get_gso_segs(skb);
+		rx_bytes += skb->len;
 
 		/* Incr GW Rx count for NUD tracking based on GW mac addr */
 		hdd_nud_incr_gw_rx_pkt_cnt(adapter, mac_addr);
@@ -2621,20 +3195,9 @@ QDF_STATUS hdd_rx_packet_cbk(void *adapter_context,
 		}
 
 		/* hold configurable wakelock for unicast traffic */
-		if (!hdd_is_current_high_throughput(hdd_ctx) &&
-		    hdd_ctx->config->rx_wakelock_timeout &&
-		    sta_ctx->conn_info.is_authenticated)
+		if (wake_lock_check && !wake_lock)
 			wake_lock = hdd_is_rx_wake_lock_needed(skb);
 
-		if (wake_lock) {
-			cds_host_diag_log_work(&hdd_ctx->rx_wake_lock,
-						   hdd_ctx->config->rx_wakelock_timeout,
-						   WIFI_POWER_EVENT_WAKELOCK_HOLD_RX);
-			qdf_wake_lock_timeout_acquire(&hdd_ctx->rx_wake_lock,
-							  hdd_ctx->config->
-								  rx_wakelock_timeout);
-		}
-
 		/* Remove SKB from internal tracking table before submitting
 		 * it to stack
 		 */
@@ -2642,7 +3205,18 @@ QDF_STATUS hdd_rx_packet_cbk(void *adapter_context,
 
 		hdd_tsf_timestamp_rx(hdd_ctx, skb, ktime_to_us(skb->tstamp));
 
-		qdf_status = hdd_rx_deliver_to_stack(adapter, skb);
+		/*
+		 * frames with per frame delivery accounting are not batched,
+		 * the list delivery has no per frame result
+		 */
+		if (track_arp || is_eapol || is_dhcp ||
+		    hdd_conn_stats_enabled(adapter))
+			qdf_status = hdd_rx_deliver_to_stack(adapter, skb);
+		else
+			qdf_status = hdd_rx_deliver_to_stack_batch(adapter, skb,
+								   &batch);
+		if (qdf_status == QDF_STATUS_E_PENDING)
+			continue;
 
 		if (QDF_IS_STATUS_SUCCESS(qdf_status)) {
 			++adapter->hdd_stats.tx_rx_stats.
@@ -2658,7 +3232,7 @@ QDF_STATUS hdd_rx_packet_cbk(void *adapter_context,
 				rx_delivered[subtype - QDF_PROTO_DHCP_DISCOVER];
 
 			/* track connectivity stats */
-			if (adapter->pkt_type_bitmap)
+			if (hdd_conn_stats_enabled(adapter))
 				hdd_tx_rx_collect_connectivity_stats_info(
 					skb, adapter,
 					PKT_TYPE_RX_DELIVERED, &pkt_type);
@@ -2675,13 +3249,30 @@ QDF_STATUS hdd_rx_packet_cbk(void *adapter_context,
 				  rx_refused[subtype - QDF_PROTO_DHCP_DISCOVER];
 
 			/* track connectivity stats */
-			if (adapter->pkt_type_bitmap)
+			if (hdd_conn_stats_enabled(adapter))
 				hdd_tx_rx_collect_connectivity_stats_info(
 					skb, adapter,
 					PKT_TYPE_RX_REFUSED, &pkt_type);
 		}
 	}
 
+	/* before the batched frames are handed to the stack */
+	if (wake_lock) {
+		cds_host_diag_log_work(&hdd_ctx->rx_wake_lock,
+				       hdd_ctx->config->rx_wakelock_timeout,
+				       WIFI_POWER_EVENT_WAKELOCK_HOLD_RX);
+		qdf_wake_lock_timeout_acquire(&hdd_ctx->rx_wake_lock,
+					      hdd_ctx->config->
+						rx_wakelock_timeout);
+	}
+
+	adapter->hdd_stats.tx_rx_stats.rx_delivered[cpu_index] +=
+		hdd_rx_batch_flush(adapter, &batch);
+	hdd_pkt_stats_rx_add(adapter, rx_packets, rx_bytes);
+
+	if (vdev)
+		hdd_objmgr_put_vdev(vdev);
+
 	return QDF_STATUS_SUCCESS;
 }
 
@@ -3516,6 +4107,11 @@ static void hdd_ini_bus_bandwidth(struct hdd_config *config,
 		cfg_get(psoc, CFG_DP_BUS_LOW_BW_CNT_THRESHOLD);
 	config->enable_latency_crit_clients =
 		cfg_get(psoc, CFG_DP_BUS_HANDLE_LATENCY_CRITICAL_CLIENTS);
+	config->bus_bw_governor = cfg_get(psoc, CFG_DP_BUS_BW_GOVERNOR);
+	config->bus_bw_down_hysteresis =
+		cfg_get(psoc, CFG_DP_BUS_BW_DOWN_HYSTERESIS);
+	config->bus_bw_rx_qdepth_thresh =
+		cfg_get(psoc, CFG_DP_BUS_BW_RX_QDEPTH_THRESHOLD);
 }
 
 /**
@@ -3720,6 +4316,16 @@ void hdd_dp_cfg_update(struct wlan_objmgr_psoc *psoc,
 			      cfg_len);
 	}
 	config->tx_orphan_enable = cfg_get(psoc, CFG_DP_TX_ORPHAN_ENABLE);
+	config->tx_orphan_policy = cfg_get(psoc, CFG_DP_TX_ORPHAN_POLICY);
+	if (config->tx_orphan_policy == HDD_TX_ORPHAN_POLICY_ADAPTIVE &&
+	    !ol_txrx_vdev_tx_load_supported()) {
+		hdd_warn("adaptive tx orphan policy not supported, using static");
+		config->tx_orphan_policy = HDD_TX_ORPHAN_POLICY_STATIC;
+	}
+	config->tx_orphan_inflight_thresh =
+		cfg_get(psoc, CFG_DP_TX_ORPHAN_INFLIGHT_THRESH);
+	config->tx_orphan_latency_thresh_us =
+		cfg_get(psoc, CFG_DP_TX_ORPHAN_LATENCY_THRESH_US);
 	config->rx_mode = cfg_get(psoc, CFG_DP_RX_MODE);
 	hdd_set_rx_mode_value(hdd_ctx);
 	config->multicast_replay_filter =
@@ -3727,6 +4333,22 @@ void hdd_dp_cfg_update(struct wlan_objmgr_psoc *psoc,
 	config->rx_wakelock_timeout =
 		cfg_get(psoc, CFG_DP_RX_WAKELOCK_TIMEOUT);
 	config->num_dp_rx_threads = cfg_get(psoc, CFG_DP_NUM_DP_RX_THREADS);
+	config->rx_thread_budget = cfg_get(psoc, CFG_DP_RX_THREAD_BUDGET);
+	config->rx_gro_flush_pkt_budget =
+		cfg_get(psoc, CFG_DP_RX_GRO_FLUSH_PKT_BUDGET);
+	config->rx_gro_flush_time_budget_us =
+		cfg_get(psoc, CFG_DP_RX_GRO_FLUSH_TIME_BUDGET_US);
+	config->rx_gro_low_latency = cfg_get(psoc, CFG_DP_RX_GRO_LOW_LATENCY);
+	config->rx_list_delivery = cfg_get(psoc, CFG_DP_RX_LIST_DELIVERY);
+	config->rx_early_demux = cfg_get(psoc, CFG_DP_RX_EARLY_DEMUX);
+	config->rx_refill_predictive =
+		cfg_get(psoc, CFG_DP_RX_REFILL_PREDICTIVE);
+	if (QDF_IS_STATUS_ERROR(hdd_wmm_parse_port_rules(
+			cfg_get(psoc, CFG_DP_TX_WMM_PORT_UP_RULES),
+			&config->wmm_port_rules))) {
+		hdd_err("invalid dp_tx_wmm_port_up_rules, ignored");
+		config->wmm_port_rules.num_rules = 0;
+	}
 	config->cfg_wmi_credit_cnt = cfg_get(psoc, CFG_DP_HTC_WMI_CREDIT_CNT);
 	config->icmp_req_to_fw_mark_interval =
 		cfg_get(psoc, CFG_DP_ICMP_REQ_TO_FW_MARK_INTERVAL);
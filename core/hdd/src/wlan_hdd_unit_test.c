@@ -34,6 +34,8 @@
 #include "qdf_tracker_test.h"
 #include "qdf_types_test.h"
 #include "wlan_dsc_test.h"
+#include "ol_txrx_bench.h"
+#include "wlan_hdd_wmm.h"
 #include "wlan_hdd_unit_test.h"
 
 typedef uint32_t (*hdd_ut_callback)(void);
@@ -45,6 +47,8 @@ struct hdd_ut_entry {
 
 struct hdd_ut_entry hdd_ut_entries[] = {
 	{ .name = "dsc", .callback = dsc_unit_test },
+	{ .name = "hdd_wmm_bench", .callback = hdd_wmm_bench },
+	{ .name = "ol_txrx_bench", .callback = ol_txrx_bench },
 	{ .name = "qdf_delayed_work", .callback = qdf_delayed_work_unit_test },
 	{ .name = "qdf_ht", .callback = qdf_ht_unit_test },
 	{ .name = "qdf_periodic_work",
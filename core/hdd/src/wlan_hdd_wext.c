@@ -5896,6 +5896,7 @@ static int __iw_set_three_ints_getnone(struct net_device *dev,
 		break;
 	case WE_SET_DP_TRACE:
 		qdf_dp_trace_set_value(value[1], value[2], value[3]);
+		hdd_dp_trace_set_pkt_trace_user(hdd_ctx->config, value[1]);
 		break;
 
 	case WE_SET_DUAL_MAC_SCAN_CONFIG:
@@ -1638,6 +1638,8 @@ QDF_STATUS hdd_wmm_dscp_initial_state(struct hdd_adapter *adapter)
 		status = hdd_send_dscp_up_map_to_fw(adapter);
 	}
 
+	hdd_wmm_compile_dscp_map(adapter);
+
 	return status;
 }
 
@@ -1745,48 +1747,228 @@ QDF_STATUS hdd_wmm_adapter_close(struct hdd_adapter *adapter)
 }
 
 /**
- * hdd_check_and_upgrade_udp_qos() - Check and upgrade the qos for UDP packets
- *				     if the current set priority is below the
- *				     pre-configured threshold for upgrade.
+ * hdd_wmm_udp_upgrade_up() - Upgrade the user priority of an UDP packet
  * @adapter: [in] pointer to the adapter context (Should not be invalid)
- * @skb: [in] pointer to the packet to be transmitted
- * @user_pri: [out] priority set for this packet
+ * @user_pri: [in] priority derived from the DSCP of the packet
  *
- * This function checks if the packet is a UDP packet and upgrades its
- * priority if its below the pre-configured upgrade threshold.
- * The upgrade order is as below:
+ * This function upgrades the priority of an UDP packet if its below the
+ * pre-configured upgrade threshold. The upgrade order is as below:
  * BK -> BE -> VI -> VO
  *
- * Return: none
+ * Return: user priority to be used for the UDP packet
  */
-static inline void
-hdd_check_and_upgrade_udp_qos(struct hdd_adapter *adapter,
-			      qdf_nbuf_t skb,
-			      enum sme_qos_wmmuptype *user_pri)
+static enum sme_qos_wmmuptype
+hdd_wmm_udp_upgrade_up(struct hdd_adapter *adapter,
+		       enum sme_qos_wmmuptype user_pri)
 {
-	/* Upgrade UDP pkt priority alone */
-	if (!(qdf_nbuf_is_ipv4_udp_pkt(skb) || qdf_nbuf_is_ipv6_udp_pkt(skb)))
-		return;
-
 	switch (adapter->upgrade_udp_qos_threshold) {
 	case QCA_WLAN_AC_BK:
 		break;
 	case QCA_WLAN_AC_BE:
-		if (*user_pri == qca_wlan_ac_to_sme_qos(QCA_WLAN_AC_BK))
-			*user_pri = qca_wlan_ac_to_sme_qos(QCA_WLAN_AC_BE);
+		if (user_pri == qca_wlan_ac_to_sme_qos(QCA_WLAN_AC_BK))
+			user_pri = qca_wlan_ac_to_sme_qos(QCA_WLAN_AC_BE);
 
 		break;
 	case QCA_WLAN_AC_VI:
 	case QCA_WLAN_AC_VO:
-		if (*user_pri <
+		if (user_pri <
 		    qca_wlan_ac_to_sme_qos(adapter->upgrade_udp_qos_threshold))
-			*user_pri = qca_wlan_ac_to_sme_qos(
+			user_pri = qca_wlan_ac_to_sme_qos(
 					adapter->upgrade_udp_qos_threshold);
 
 		break;
 	default:
 		break;
 	}
+
+	return user_pri;
+}
+
+void hdd_wmm_compile_dscp_map(struct hdd_adapter *adapter)
+{
+	uint8_t dscp;
+
+	for (dscp = 0; dscp <= WLAN_MAX_DSCP; dscp++)
+		adapter->udp_dscp_to_up_map[dscp] =
+			hdd_wmm_udp_upgrade_up(adapter,
+					       adapter->dscp_to_up_map[dscp]);
+}
+
+/**
+ * hdd_wmm_parse_l4() - Parse the TCP or UDP ports of an IP packet
+ * @skb: pointer to network buffer
+ * @l4: start of the L4 header
+ * @info: parsed header information, with @ip_proto filled
+ *
+ * Return: None
+ */
+static void hdd_wmm_parse_l4(struct sk_buff *skb, unsigned char *l4,
+			     struct hdd_wmm_pkt_info *info)
+{
+	__be16 *ports = (__be16 *)l4;
+
+	if (info->ip_proto != IPPROTO_TCP && info->ip_proto != IPPROTO_UDP)
+		return;
+
+	if (l4 + 2 * sizeof(*ports) > skb->data + skb_headlen(skb))
+		return;
+
+	info->src_port = ntohs(ports[0]);
+	info->dst_port = ntohs(ports[1]);
+}
+
+/**
+ * hdd_wmm_encap_ipv4_tos() - TOS of a VLAN tagged or LLC/SNAP IPv4 packet
+ * @eth_hdr: L2 header of the packet
+ *
+ * Return: IPv4 TOS, 0 for other packets
+ */
+static uint8_t hdd_wmm_encap_ipv4_tos(union generic_ethhdr *eth_hdr)
+{
+	unsigned char *pkt = (unsigned char *)eth_hdr;
+	struct wlan_snap_hdr *snap = &eth_hdr->eth_8023.h_snap;
+	__be16 proto = eth_hdr->eth_II.h_proto;
+	struct iphdr *ip_hdr = (struct iphdr *)&pkt[sizeof(eth_hdr->eth_II)];
+	bool vlan = false;
+
+	if (proto == htons(ETH_P_8021Q)) {
+		vlan = true;
+		proto = eth_hdr->eth_IIv.h_vlan_encapsulated_proto;
+		snap = &eth_hdr->eth_8023v.h_snap;
+		ip_hdr = (struct iphdr *)&pkt[sizeof(eth_hdr->eth_IIv)];
+	}
+
+	if (ntohs(proto) < WLAN_MIN_PROTO) {
+		if (snap->dsap != WLAN_SNAP_DSAP ||
+		    snap->ssap != WLAN_SNAP_SSAP ||
+		    snap->ctrl != WLAN_SNAP_CTRL)
+			return 0;
+
+		if (vlan) {
+			proto = eth_hdr->eth_8023v.h_proto;
+			ip_hdr = (struct iphdr *)
+				 &pkt[sizeof(eth_hdr->eth_8023v)];
+		} else {
+			proto = eth_hdr->eth_8023.h_proto;
+			ip_hdr = (struct iphdr *)
+				 &pkt[sizeof(eth_hdr->eth_8023)];
+		}
+	}
+
+	if (proto != htons(ETH_P_IP))
+		return 0;
+
+	return ip_hdr->tos;
+}
+
+void hdd_wmm_parse_pkt(struct sk_buff *skb, struct hdd_wmm_pkt_info *info)
+{
+	unsigned char *pkt = skb->data;
+	union generic_ethhdr *eth_hdr = (union generic_ethhdr *)pkt;
+	struct iphdr *ip_hdr;
+	struct ipv6hdr *ipv6hdr;
+
+	qdf_mem_zero(info, sizeof(*info));
+	info->ether_type = ntohs(eth_hdr->eth_II.h_proto);
+
+	switch (info->ether_type) {
+	case ETH_P_IP:
+		ip_hdr = (struct iphdr *)&pkt[sizeof(eth_hdr->eth_II)];
+		info->tos = ip_hdr->tos;
+		info->ip_proto = ip_hdr->protocol;
+		hdd_wmm_parse_l4(skb, (unsigned char *)ip_hdr + ip_hdr->ihl * 4,
+				 info);
+		break;
+	case ETH_P_IPV6:
+		ipv6hdr = ipv6_hdr(skb);
+		info->tos = ntohs(*(const __be16 *)ipv6hdr) >> 4;
+		info->ip_proto = ipv6hdr->nexthdr;
+		hdd_wmm_parse_l4(skb, (unsigned char *)(ipv6hdr + 1), info);
+		break;
+	case ETH_P_8021Q:
+		info->ether_type = 0;
+		info->tos = hdd_wmm_encap_ipv4_tos(eth_hdr);
+		break;
+	default:
+		if (info->ether_type < WLAN_MIN_PROTO) {
+			info->ether_type = 0;
+			info->tos = hdd_wmm_encap_ipv4_tos(eth_hdr);
+		}
+		break;
+	}
+}
+
+QDF_STATUS hdd_wmm_parse_port_rules(const char *str,
+				    struct hdd_wmm_port_rules *rules)
+{
+	struct hdd_wmm_port_rule *rule;
+	uint16_t first_port, last_port;
+	uint8_t user_pri;
+	int len;
+
+	rules->num_rules = 0;
+	str = skip_spaces(str);
+
+	while (*str) {
+		if (rules->num_rules == HDD_WMM_MAX_PORT_RULES)
+			goto invalid;
+
+		if (sscanf(str, "%hu-%hu:%hhu%n", &first_port, &last_port,
+			   &user_pri, &len) != 3) {
+			if (sscanf(str, "%hu:%hhu%n", &first_port, &user_pri,
+				   &len) != 2)
+				goto invalid;
+			last_port = first_port;
+		}
+
+		if (first_port > last_port || user_pri > SME_QOS_WMM_UP_NC)
+			goto invalid;
+
+		rule = &rules->rule[rules->num_rules++];
+		rule->first_port = first_port;
+		rule->last_port = last_port;
+		rule->user_pri = user_pri;
+
+		str = skip_spaces(str + len);
+		if (*str == ',')
+			str = skip_spaces(str + 1);
+		else if (*str)
+			goto invalid;
+	}
+
+	return QDF_STATUS_SUCCESS;
+
+invalid:
+	rules->num_rules = 0;
+
+	return QDF_STATUS_E_INVAL;
+}
+
+/**
+ * hdd_wmm_port_rule_up() - Apply the port rules to a TCP or UDP packet
+ * @port_rules: port rules to match
+ * @info: parsed header information of the packet
+ * @user_pri: [in/out] user priority of the packet
+ *
+ * Return: None
+ */
+static void hdd_wmm_port_rule_up(const struct hdd_wmm_port_rules *port_rules,
+				 struct hdd_wmm_pkt_info *info,
+				 enum sme_qos_wmmuptype *user_pri)
+{
+	const struct hdd_wmm_port_rule *rule;
+	uint8_t i;
+
+	for (i = 0; i < port_rules->num_rules; i++) {
+		rule = &port_rules->rule[i];
+		if ((info->dst_port >= rule->first_port &&
+		     info->dst_port <= rule->last_port) ||
+		    (info->src_port >= rule->first_port &&
+		     info->src_port <= rule->last_port)) {
+			*user_pri = rule->user_pri;
+			return;
+		}
+	}
 }
 
 /**
@@ -1795,129 +1977,49 @@ hdd_check_and_upgrade_udp_qos(struct hdd_adapter *adapter,
  *
  * @adapter: adapter upon which the packet is being transmitted
  * @skb: pointer to network buffer
+ * @info: parsed header information of the packet
  * @user_pri: user priority of the OS packet
  * @is_eapol: eapol packet flag
+ * @port_rules: TCP/UDP port rules, see hdd_wmm_parse_port_rules()
+ *
+ * The user priority is looked up in the per adapter DSCP tables, where
+ * the UDP table already has the UDP QoS upgrade threshold applied, see
+ * hdd_wmm_compile_dscp_map(). A matching port rule then overrides the
+ * user priority of a TCP or UDP packet.
  *
  * Return: None
  */
 static
 void hdd_wmm_classify_pkt(struct hdd_adapter *adapter,
 			  struct sk_buff *skb,
+			  struct hdd_wmm_pkt_info *info,
 			  enum sme_qos_wmmuptype *user_pri,
-			  bool *is_eapol)
+			  bool *is_eapol,
+			  const struct hdd_wmm_port_rules *port_rules)
 {
 	unsigned char dscp;
-	unsigned char tos;
-	union generic_ethhdr *eth_hdr;
-	struct iphdr *ip_hdr;
-	struct ipv6hdr *ipv6hdr;
-	unsigned char *pkt;
-
-	/* this code is executed for every packet therefore
-	 * all debug code is kept conditional
-	 */
-
-#ifdef HDD_WMM_DEBUG
-	hdd_enter();
-#endif /* HDD_WMM_DEBUG */
-
-	pkt = skb->data;
-	eth_hdr = (union generic_ethhdr *)pkt;
-
-#ifdef HDD_WMM_DEBUG
-	hdd_debug("proto is 0x%04x", skb->protocol);
-#endif /* HDD_WMM_DEBUG */
 
-	if (eth_hdr->eth_II.h_proto == htons(ETH_P_IP)) {
-		/* case 1: Ethernet II IP packet */
-		ip_hdr = (struct iphdr *)&pkt[sizeof(eth_hdr->eth_II)];
-		tos = ip_hdr->tos;
-#ifdef HDD_WMM_DEBUG
-		hdd_debug("Ethernet II IP Packet, tos is %d", tos);
-#endif /* HDD_WMM_DEBUG */
+	hdd_wmm_parse_pkt(skb, info);
 
-	} else if (eth_hdr->eth_II.h_proto == htons(ETH_P_IPV6)) {
-		ipv6hdr = ipv6_hdr(skb);
-		tos = ntohs(*(const __be16 *)ipv6hdr) >> 4;
-#ifdef HDD_WMM_DEBUG
-		hdd_debug("Ethernet II IPv6 Packet, tos is %d", tos);
-#endif /* HDD_WMM_DEBUG */
-	} else if ((ntohs(eth_hdr->eth_II.h_proto) < WLAN_MIN_PROTO) &&
-		  (eth_hdr->eth_8023.h_snap.dsap == WLAN_SNAP_DSAP) &&
-		  (eth_hdr->eth_8023.h_snap.ssap == WLAN_SNAP_SSAP) &&
-		  (eth_hdr->eth_8023.h_snap.ctrl == WLAN_SNAP_CTRL) &&
-		  (eth_hdr->eth_8023.h_proto == htons(ETH_P_IP))) {
-		/* case 2: 802.3 LLC/SNAP IP packet */
-		ip_hdr = (struct iphdr *)&pkt[sizeof(eth_hdr->eth_8023)];
-		tos = ip_hdr->tos;
-#ifdef HDD_WMM_DEBUG
-		hdd_debug("802.3 LLC/SNAP IP Packet, tos is %d", tos);
-#endif /* HDD_WMM_DEBUG */
-	} else if (eth_hdr->eth_II.h_proto == htons(ETH_P_8021Q)) {
-		/* VLAN tagged */
-
-		if (eth_hdr->eth_IIv.h_vlan_encapsulated_proto ==
-			htons(ETH_P_IP)) {
-			/* case 3: Ethernet II vlan-tagged IP packet */
-			ip_hdr =
-				(struct iphdr *)
-				&pkt[sizeof(eth_hdr->eth_IIv)];
-			tos = ip_hdr->tos;
-#ifdef HDD_WMM_DEBUG
-			hdd_debug("Ether II VLAN tagged IP Packet, tos is %d",
-				 tos);
-#endif /* HDD_WMM_DEBUG */
-		} else if ((ntohs(eth_hdr->eth_IIv.h_vlan_encapsulated_proto)
-			< WLAN_MIN_PROTO) &&
-			(eth_hdr->eth_8023v.h_snap.dsap ==
-			WLAN_SNAP_DSAP)
-			&& (eth_hdr->eth_8023v.h_snap.ssap ==
-			WLAN_SNAP_SSAP)
-			&& (eth_hdr->eth_8023v.h_snap.ctrl ==
-			WLAN_SNAP_CTRL)
-			&& (eth_hdr->eth_8023v.h_proto ==
-			htons(ETH_P_IP))) {
-			/* case 4: 802.3 LLC/SNAP vlan-tagged IP packet */
-			ip_hdr =
-				(struct iphdr *)
-				&pkt[sizeof(eth_hdr->eth_8023v)];
-			tos = ip_hdr->tos;
-#ifdef HDD_WMM_DEBUG
-			hdd_debug("802.3 LLC/SNAP VLAN tagged IP Packet, tos is %d",
-				 tos);
-#endif /* HDD_WMM_DEBUG */
-		} else {
-			/* default */
-#ifdef HDD_WMM_DEBUG
-			hdd_warn("VLAN tagged Unhandled Protocol, using default tos");
-#endif /* HDD_WMM_DEBUG */
-			tos = 0;
-		}
-	} else {
-		/* default */
-#ifdef HDD_WMM_DEBUG
-		hdd_warn("Unhandled Protocol, using default tos");
-#endif /* HDD_WMM_DEBUG */
-		/* Give the highest priority to 802.1x packet */
-		if (eth_hdr->eth_II.h_proto ==
-			htons(HDD_ETHERTYPE_802_1_X)) {
-			tos = 0xC0;
-			*is_eapol = true;
-		} else
-			tos = 0;
+	/* Give the highest priority to 802.1x packet */
+	if (info->ether_type == HDD_ETHERTYPE_802_1_X) {
+		info->tos = 0xC0;
+		*is_eapol = true;
 	}
 
-	dscp = (tos >> 2) & 0x3f;
-	*user_pri = adapter->dscp_to_up_map[dscp];
+	dscp = (info->tos >> 2) & 0x3f;
+	if (info->ip_proto == IPPROTO_UDP)
+		*user_pri = adapter->udp_dscp_to_up_map[dscp];
+	else
+		*user_pri = adapter->dscp_to_up_map[dscp];
 
-	/*
-	 * Upgrade the priority, if the user priority of this packet is
-	 * less than the configured threshold.
-	 */
-	hdd_check_and_upgrade_udp_qos(adapter, skb, user_pri);
+	if (port_rules->num_rules &&
+	    (info->ip_proto == IPPROTO_TCP || info->ip_proto == IPPROTO_UDP))
+		hdd_wmm_port_rule_up(port_rules, info, user_pri);
 
 #ifdef HDD_WMM_DEBUG
-	hdd_debug("tos is %d, dscp is %d, up is %d", tos, dscp, *user_pri);
+	hdd_debug("ether_type 0x%04x ip_proto %d tos %d dscp %d up %d",
+		  info->ether_type, info->ip_proto, info->tos, dscp, *user_pri);
 #endif /* HDD_WMM_DEBUG */
 }
 
@@ -1972,6 +2074,7 @@ static uint16_t hdd_wmm_select_queue(struct net_device *dev,
 				     struct sk_buff *skb)
 {
 	enum sme_qos_wmmuptype up = SME_QOS_WMM_UP_BE;
+	struct hdd_wmm_pkt_info info;
 	uint16_t index;
 	struct hdd_adapter *adapter = WLAN_HDD_GET_PRIV_PTR(dev);
 	bool is_crtical = false;
@@ -1986,13 +2089,15 @@ static uint16_t hdd_wmm_select_queue(struct net_device *dev,
 	}
 
 	/* Get the user priority from IP header */
-	hdd_wmm_classify_pkt(adapter, skb, &up, &is_crtical);
+	hdd_wmm_classify_pkt(adapter, skb, &info, &up, &is_crtical,
+			     &hdd_ctx->config->wmm_port_rules);
 	spin_lock_bh(&adapter->pause_map_lock);
 	if ((adapter->pause_map & (1 <<  WLAN_DATA_FLOW_CONTROL)) &&
 	   !(adapter->pause_map & (1 <<  WLAN_DATA_FLOW_CONTROL_PRIORITY))) {
-		if (qdf_nbuf_is_ipv4_arp_pkt(skb))
+		if (info.ether_type == ETH_P_ARP)
 			is_crtical = true;
-		else if (qdf_nbuf_is_icmpv6_pkt(skb)) {
+		else if (info.ether_type == ETH_P_IPV6 &&
+			 info.ip_proto == IPPROTO_ICMPV6) {
 			proto_subtype = qdf_nbuf_get_icmpv6_subtype(skb);
 			switch (proto_subtype) {
 			case QDF_PROTO_ICMPV6_NA:
@@ -2352,6 +2457,8 @@ QDF_STATUS hdd_wmm_assoc(struct hdd_adapter *adapter,
 
 	if (!QDF_IS_STATUS_SUCCESS(status))
 		hdd_wmm_dscp_initial_state(adapter);
+	else
+		hdd_wmm_compile_dscp_map(adapter);
 
 	hdd_exit();
 
@@ -3059,3 +3166,222 @@ int wlan_hdd_cfg80211_config_tspec(struct wiphy *wiphy,
 
 	return errno;
 }
+
+#ifdef WLAN_HDD_WMM_BENCH
+#define HDD_WMM_BENCH_ROUNDS 20000
+#define HDD_WMM_BENCH_FRAME_LEN 128
+
+/* eight rules, the one the bench traffic hits last */
+#define HDD_WMM_BENCH_PORT_RULES \
+	"1000-1999:1,2000:2,3000-3099:3,4000:4,6000-6999:2,7000:1," \
+	"8000-8999:3,5060-5061:6"
+
+/**
+ * struct hdd_wmm_bench_pkt - synthetic frame of the mixed traffic set
+ * @name: name of the frame in error logs
+ * @vlan: whether the frame carries a VLAN tag
+ * @ether_type: ether type of the frame, after the VLAN tag
+ * @ip_proto: IPv4 protocol or IPv6 next header
+ * @dscp: IPv4 or IPv6 DSCP
+ * @src_port: TCP or UDP source port
+ * @dst_port: TCP or UDP destination port
+ * @up: expected user priority without port rules
+ * @port_up: expected user priority with HDD_WMM_BENCH_PORT_RULES
+ */
+struct hdd_wmm_bench_pkt {
+	const char *name;
+	bool vlan;
+	uint16_t ether_type;
+	uint8_t ip_proto;
+	uint8_t dscp;
+	uint16_t src_port;
+	uint16_t dst_port;
+	enum sme_qos_wmmuptype up;
+	enum sme_qos_wmmuptype port_up;
+};
+
+static const struct hdd_wmm_bench_pkt hdd_wmm_bench_pkts[] = {
+	{ "ipv4_tcp", false, ETH_P_IP, IPPROTO_TCP, 0, 40000, 443,
+	  SME_QOS_WMM_UP_BE, SME_QOS_WMM_UP_BE },
+	{ "ipv4_tcp_ack", false, ETH_P_IP, IPPROTO_TCP, 0, 443, 40000,
+	  SME_QOS_WMM_UP_BE, SME_QOS_WMM_UP_BE },
+	{ "ipv4_udp_ef", false, ETH_P_IP, IPPROTO_UDP, 46, 40002, 5004,
+	  SME_QOS_WMM_UP_VO, SME_QOS_WMM_UP_VO },
+	{ "ipv4_udp_sip", false, ETH_P_IP, IPPROTO_UDP, 0, 5060, 5060,
+	  SME_QOS_WMM_UP_BE, SME_QOS_WMM_UP_VO },
+	{ "ipv6_tcp_af41", false, ETH_P_IPV6, IPPROTO_TCP, 34, 40004, 443,
+	  SME_QOS_WMM_UP_CL, SME_QOS_WMM_UP_CL },
+	{ "ipv6_udp_cs1", false, ETH_P_IPV6, IPPROTO_UDP, 8, 40006, 53,
+	  SME_QOS_WMM_UP_BK, SME_QOS_WMM_UP_BK },
+	{ "vlan_ipv4_ef", true, ETH_P_IP, IPPROTO_UDP, 46, 40008, 5004,
+	  SME_QOS_WMM_UP_VO, SME_QOS_WMM_UP_VO },
+	{ "arp", false, ETH_P_ARP, 0, 0, 0, 0,
+	  SME_QOS_WMM_UP_BE, SME_QOS_WMM_UP_BE },
+	{ "eapol", false, HDD_ETHERTYPE_802_1_X, 0, 0, 0, 0,
+	  SME_QOS_WMM_UP_VO, SME_QOS_WMM_UP_VO },
+};
+
+static struct sk_buff *
+hdd_wmm_bench_frame_alloc(const struct hdd_wmm_bench_pkt *pkt)
+{
+	struct sk_buff *skb;
+	struct ethhdr *eth;
+	struct vlan_ethhdr *veth;
+	struct iphdr *iph;
+	struct ipv6hdr *ip6h;
+	unsigned char *data;
+	__be16 *ports = NULL;
+	int l3;
+
+	skb = alloc_skb(HDD_WMM_BENCH_FRAME_LEN, GFP_KERNEL);
+	if (!skb)
+		return NULL;
+
+	data = skb_put(skb, HDD_WMM_BENCH_FRAME_LEN);
+	qdf_mem_zero(data, HDD_WMM_BENCH_FRAME_LEN);
+
+	if (pkt->vlan) {
+		veth = (struct vlan_ethhdr *)data;
+		veth->h_vlan_proto = htons(ETH_P_8021Q);
+		veth->h_vlan_encapsulated_proto = htons(pkt->ether_type);
+		l3 = VLAN_ETH_HLEN;
+	} else {
+		eth = (struct ethhdr *)data;
+		eth->h_proto = htons(pkt->ether_type);
+		l3 = ETH_HLEN;
+	}
+	skb_set_network_header(skb, l3);
+
+	switch (pkt->ether_type) {
+	case ETH_P_IP:
+		iph = (struct iphdr *)&data[l3];
+		iph->version = 4;
+		iph->ihl = 5;
+		iph->tos = pkt->dscp << 2;
+		iph->protocol = pkt->ip_proto;
+		ports = (__be16 *)(iph + 1);
+		break;
+	case ETH_P_IPV6:
+		ip6h = (struct ipv6hdr *)&data[l3];
+		*(__be32 *)ip6h = htonl(0x60000000 | (pkt->dscp << 22));
+		ip6h->nexthdr = pkt->ip_proto;
+		ports = (__be16 *)(ip6h + 1);
+		break;
+	default:
+		break;
+	}
+
+	if (ports) {
+		ports[0] = htons(pkt->src_port);
+		ports[1] = htons(pkt->dst_port);
+	}
+
+	return skb;
+}
+
+/**
+ * hdd_wmm_bench_classify() - classify the mixed traffic set
+ * @adapter: adapter holding the DSCP tables
+ * @skbs: frames of hdd_wmm_bench_pkts
+ * @port_rules: port rules to classify with
+ * @with_rules: whether to expect the user priorities with port rules
+ *
+ * Checks the user priority of every frame once, then classifies the set
+ * HDD_WMM_BENCH_ROUNDS times and logs the time per frame.
+ *
+ * Return: number of misclassified frames
+ */
+static uint32_t
+hdd_wmm_bench_classify(struct hdd_adapter *adapter, struct sk_buff **skbs,
+		       const struct hdd_wmm_port_rules *port_rules,
+		       bool with_rules)
+{
+	const struct hdd_wmm_bench_pkt *pkt;
+	struct hdd_wmm_pkt_info info;
+	enum sme_qos_wmmuptype up, expected;
+	uint32_t i, round, pkts, errors = 0;
+	bool is_eapol;
+	uint64_t start, ns;
+
+	for (i = 0; i < ARRAY_SIZE(hdd_wmm_bench_pkts); i++) {
+		pkt = &hdd_wmm_bench_pkts[i];
+		expected = with_rules ? pkt->port_up : pkt->up;
+		up = SME_QOS_WMM_UP_BE;
+		is_eapol = false;
+		hdd_wmm_classify_pkt(adapter, skbs[i], &info, &up, &is_eapol,
+				     port_rules);
+		if (up != expected) {
+			qdf_nofl_err("hdd_wmm_bench: %s: up %d, expected %d",
+				     pkt->name, up, expected);
+			errors++;
+		}
+	}
+
+	if (errors)
+		return errors;
+
+	start = qdf_get_monotonic_boottime_ns();
+	for (round = 0; round < HDD_WMM_BENCH_ROUNDS; round++) {
+		for (i = 0; i < ARRAY_SIZE(hdd_wmm_bench_pkts); i++)
+			hdd_wmm_classify_pkt(adapter, skbs[i], &info, &up,
+					     &is_eapol, port_rules);
+	}
+	ns = qdf_get_monotonic_boottime_ns() - start;
+
+	pkts = HDD_WMM_BENCH_ROUNDS * ARRAY_SIZE(hdd_wmm_bench_pkts);
+	qdf_nofl_info("hdd_wmm_bench: %s: %u pkts %llu ns/pkt",
+		      with_rules ? "dscp_port_rules" : "dscp", pkts,
+		      qdf_do_div(ns, pkts));
+
+	return 0;
+}
+
+uint32_t hdd_wmm_bench(void)
+{
+	struct sk_buff *skbs[ARRAY_SIZE(hdd_wmm_bench_pkts)] = { NULL };
+	struct hdd_wmm_port_rules *port_rules;
+	struct hdd_adapter *adapter;
+	uint32_t errors = 0;
+	uint32_t i;
+
+	adapter = qdf_mem_malloc(sizeof(*adapter));
+	port_rules = qdf_mem_malloc(sizeof(*port_rules));
+	if (!adapter || !port_rules) {
+		errors = 1;
+		goto free;
+	}
+
+	hdd_fill_dscp_to_up_map(adapter->dscp_to_up_map);
+	adapter->upgrade_udp_qos_threshold = QCA_WLAN_AC_BK;
+	hdd_wmm_compile_dscp_map(adapter);
+
+	for (i = 0; i < ARRAY_SIZE(hdd_wmm_bench_pkts); i++) {
+		skbs[i] = hdd_wmm_bench_frame_alloc(&hdd_wmm_bench_pkts[i]);
+		if (!skbs[i]) {
+			errors = 1;
+			goto free;
+		}
+	}
+
+	errors += hdd_wmm_bench_classify(adapter, skbs, port_rules, false);
+
+	if (QDF_IS_STATUS_ERROR(hdd_wmm_parse_port_rules(
+			HDD_WMM_BENCH_PORT_RULES, port_rules)) ||
+	    port_rules->num_rules != HDD_WMM_MAX_PORT_RULES) {
+		qdf_nofl_err("hdd_wmm_bench: port rules not parsed");
+		errors++;
+		goto free;
+	}
+
+	errors += hdd_wmm_bench_classify(adapter, skbs, port_rules, true);
+
+free:
+	for (i = 0; i < ARRAY_SIZE(hdd_wmm_bench_pkts); i++)
+		if (skbs[i])
+			kfree_skb(skbs[i]);
+	qdf_mem_free(port_rules);
+	qdf_mem_free(adapter);
+
+	return errors;
+}
+#endif /* WLAN_HDD_WMM_BENCH */
@@ -139,6 +139,8 @@ struct obss_detection_cfg {
  * @prev_auth_seq_num: Sequence number of previously received auth frame to
  * detect duplicate frames.
  * @prev_auth_mac_addr: mac_addr of the sta correspond to @prev_auth_seq_num
+ * @mem_acct_size: bytes of the session tables and templates accounted
+ * under CDS_MEM_TAG_PE_SESSION
  */
 struct pe_session {
 	/* To check session table is in use or free */
@@ -377,6 +379,7 @@ struct pe_session {
 	 * for assignment.
 	 */
 	uint8_t *gpLimPeerIdxpool;
+	uint32_t mem_acct_size;
 	uint8_t freePeerIdxHead;
 	uint8_t freePeerIdxTail;
 	uint16_t gLimNumOfCurrentSTAs;
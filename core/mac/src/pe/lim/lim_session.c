@@ -38,6 +38,7 @@
 #include "sch_api.h"
 #include "lim_send_messages.h"
 #include "cfg_ucfg_api.h"
+#include <cds_mem_acct.h>
 
 #ifdef WLAN_ALLOCATE_GLOBAL_BUFFERS_DYNAMICALLY
 static struct sDphHashNode *g_dph_node_array;
@@ -563,6 +564,11 @@ struct pe_session *pe_create_session(struct mac_context *mac,
 		return NULL;
 	}
 
+	if (cds_mem_acct_inject_fail(CDS_MEM_TAG_PE_SESSION)) {
+		pe_err("Session can't be created. Injected alloc failure");
+		return NULL;
+	}
+
 	session_ptr = &mac->lim.gpSession[i];
 	qdf_mem_zero((void *)session_ptr, sizeof(struct pe_session));
 	/* Allocate space for Station Table for this session. */
@@ -695,6 +701,16 @@ struct pe_session *pe_create_session(struct mac_context *mac,
 	/* following is invalid value since seq number is 12 bit */
 	session_ptr->prev_auth_seq_num = 0xFFFF;
 
+	session_ptr->mem_acct_size =
+		sizeof(tpDphHashNode) * (numSta + 1) +
+		sizeof(*(session_ptr->gpLimPeerIdxpool)) *
+		lim_get_peer_idxpool_size(numSta, bssType);
+	if (bssType == eSIR_INFRA_AP_MODE)
+		session_ptr->mem_acct_size += SIR_MAX_PROBE_RESP_SIZE +
+					      2 * SIR_MAX_BEACON_SIZE;
+	cds_mem_acct_alloc(CDS_MEM_TAG_PE_SESSION,
+			   session_ptr->mem_acct_size, 1);
+
 	return &mac->lim.gpSession[i];
 
 free_session_attrs:
@@ -863,6 +879,9 @@ void pe_delete_session(struct mac_context *mac_ctx, struct pe_session *session)
 	lim_reset_bcn_probe_filter(mac_ctx, session);
 	lim_sae_auth_cleanup_retry(mac_ctx, session->vdev_id);
 
+	cds_mem_acct_free(CDS_MEM_TAG_PE_SESSION, session->mem_acct_size);
+	session->mem_acct_size = 0;
+
 	/* Restore default failure timeout */
 	if (session->defaultAuthFailureTimeout) {
 		pe_debug("Restore default failure timeout");